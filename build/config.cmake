@@ -51,6 +51,23 @@ IF (WALRUS_JIT)
     SET (WALRUS_DEFINITIONS ${WALRUS_DEFINITIONS} -DWALRUS_ENABLE_JIT)
 ENDIF()
 
+# Serialized modules are only accepted by the build which created them.
+# Packagers may pass their own identifier with -DWALRUS_BUILD_ID=<id>.
+IF (NOT DEFINED WALRUS_BUILD_ID)
+    FIND_PACKAGE (Git QUIET)
+    IF (GIT_FOUND)
+        EXECUTE_PROCESS (COMMAND ${GIT_EXECUTABLE} describe --always --dirty --abbrev=40 --match=NoTagWithThisName
+                         WORKING_DIRECTORY ${WALRUS_ROOT}
+                         OUTPUT_VARIABLE WALRUS_BUILD_ID
+                         OUTPUT_STRIP_TRAILING_WHITESPACE
+                         ERROR_QUIET)
+    ENDIF()
+    IF (NOT WALRUS_BUILD_ID)
+        SET (WALRUS_BUILD_ID "unknown")
+    ENDIF()
+ENDIF()
+SET (WALRUS_DEFINITIONS ${WALRUS_DEFINITIONS} -DWALRUS_BUILD_ID=${WALRUS_BUILD_ID})
+
 #######################################################
 # FLAGS FOR TEST
 #######################################################
@@ -39,9 +39,6 @@ IF (WALRUS_COVERAGE)
     SET (WALRUS_LDFLAGS ${WALRUS_LDFLAGS} --coverage)
     SET (WALRUS_LIBRARIES ${WALRUS_LIBRARIES} gcov)
 ENDIF()
-IF (WALRUS_JITPERF)
-    SET (WALRUS_CXXFLAGS ${WALRUS_CXXFLAGS} -DWALRUS_JITPERF)
-ENDIF()
 
 # SOURCE FILES
 FILE (GLOB_RECURSE WALRUS_SRC ${WALRUS_ROOT}/src/*.cpp)
@@ -144,9 +141,47 @@ ELSEIF (${WALRUS_OUTPUT} STREQUAL "api_test")
     c_api_example(multi)
     c_api_example(memory)
     c_api_example(reflect)
-#c_api_example(serialize)
+    c_api_example(serialize)
 #c_api_example(start)
     c_api_example(table)
 #c_api_example(trap)
 #c_api_example(threads)
+
+    # Benchmarks and tests of test/api, which share test/api/Benchmark.h.
+    # The C programs use the C API, the C++ programs the internal interface.
+    function(api_program EXENAME NAME)
+        if (EXISTS ${WALRUS_ROOT}/test/api/${NAME}.c)
+            add_executable(${EXENAME} ${WALRUS_ROOT}/test/api/${NAME}.c)
+            if (NOT COMPILER_IS_MSVC)
+                set_target_properties(${EXENAME} PROPERTIES COMPILE_FLAGS "-std=gnu11")
+            endif ()
+
+            target_link_libraries(${EXENAME} ${WALRUS_TARGET} pthread)
+        else ()
+            add_executable(${EXENAME} ${WALRUS_ROOT}/test/api/${NAME}.cpp)
+            target_compile_definitions(${EXENAME} PRIVATE ${WALRUS_DEFINITIONS})
+            target_compile_options(${EXENAME} PRIVATE ${WALRUS_CXXFLAGS} ${CXXFLAGS_FROM_ENV})
+
+            target_link_libraries(${EXENAME} ${WALRUS_TARGET} ${WALRUS_LIBRARIES} ${WALRUS_LDFLAGS})
+        endif ()
+    endfunction()
+
+    function(api_benchmark NAME)
+        api_program(walrus-benchmark-${NAME} ${NAME})
+    endfunction()
+
+    function(api_test NAME)
+        api_program(walrus-api-test-${NAME} ${NAME})
+    endfunction()
+
+    api_benchmark(atomicWaitNotify)
+    api_benchmark(epochCheck)
+    api_benchmark(funcCall)
+    api_benchmark(gcAlloc)
+    api_benchmark(hostCall)
+    api_benchmark(jitCompile)
+    api_benchmark(throwCatch)
+
+    api_test(epochDeadline)
+    api_test(typedFunction)
 ENDIF()
@@ -335,6 +335,12 @@ if (f.type == Type::B) { puts("failed in msvc."); }
 #define MAY_THREAD_LOCAL __thread
 #endif
 
+// 32 bit memories can reserve their whole address range and rely on
+// guard pages instead of explicit bounds checks in the JIT code.
+#if defined(WALRUS_ENABLE_JIT) && defined(WALRUS_64) && defined(__linux__) && (defined(CPU_X86_64) || defined(CPU_ARM64))
+#define WALRUS_MEMORY_GUARD_PAGES
+#endif
+
 #if defined(COMPILER_GCC) || defined(COMPILER_CLANG)
 #define WALRUS_ENABLE_COMPUTED_GOTO
 // some devices cannot support getting label address from outside well
@@ -405,6 +411,8 @@ if (f.type == Type::B) { puts("failed in msvc."); }
 #include "util/Optional.h"
 namespace Walrus {
 typedef uint16_t ByteCodeStackOffset;
+// Used by the few byte codes which can access values after the 16 bit range.
+typedef uint32_t ByteCodeWideStackOffset;
 }
 
 #endif
@@ -30,9 +30,13 @@
 #include "runtime/Global.h"
 #include "runtime/Instance.h"
 #include "runtime/Trap.h"
+#include "runtime/Profiler.h"
 #include "runtime/TypeStore.h"
 #include "parser/WASMParser.h"
 
+#include "wabt/binary-reader.h"
+#include "wabt/walrus/binary-reader-walrus.h"
+
 using namespace Walrus;
 
 #define own
@@ -89,6 +93,20 @@ struct wasm_exporttype_t {
 };
 
 struct wasm_config_t {
+    wasm_config_t()
+        : memoryGuardPages(false)
+        , epochInterruption(false)
+        , JITThreadCount(1)
+        , JITOptLevel(1)
+        , JITInlineSize(Engine::kDefaultJITInlineSize)
+    {
+    }
+
+    bool memoryGuardPages;
+    bool epochInterruption;
+    uint32_t JITThreadCount;
+    uint32_t JITOptLevel;
+    uint32_t JITInlineSize;
 };
 
 struct wasm_engine_t {
@@ -114,6 +132,8 @@ struct wasm_engine_t {
 struct wasm_store_t {
     wasm_store_t(Store* s)
         : store(s)
+        , epochDeadlineCallback(nullptr)
+        , epochDeadlineEnv(nullptr)
     {
     }
 
@@ -129,6 +149,8 @@ struct wasm_store_t {
     }
 
     Store* store;
+    wasm_epoch_deadline_callback_t epochDeadlineCallback;
+    void* epochDeadlineEnv;
 };
 
 struct wasm_valtype_t {
@@ -313,8 +335,9 @@ struct wasm_extern_t : wasm_ref_t {
 };
 
 struct wasm_module_t : wasm_ref_t {
-    wasm_module_t(own const Module* module)
+    wasm_module_t(own const Module* module, const uint8_t* binary, size_t binarySize)
         : wasm_ref_t(module)
+        , binary(binary, binary + binarySize)
     {
     }
 
@@ -323,6 +346,9 @@ struct wasm_module_t : wasm_ref_t {
         ASSERT(obj && obj->isModule());
         return const_cast<Module*>(static_cast<const Module*>(obj));
     }
+
+    // Kept for wasm_module_serialize
+    std::vector<uint8_t> binary;
 };
 
 struct wasm_func_t : wasm_extern_t {
@@ -637,9 +663,37 @@ const wasm_externtype_t* wasm_exporttype_type(const wasm_exporttype_t* exportTyp
 // Configuration
 own wasm_config_t* wasm_config_new()
 {
-    // TODO
-    RELEASE_ASSERT_NOT_REACHED();
-    return nullptr;
+    return new wasm_config_t();
+}
+
+void wasm_config_set_memory_guard_pages(wasm_config_t* config, bool enable)
+{
+    ASSERT(config);
+    config->memoryGuardPages = enable;
+}
+
+void wasm_config_set_jit_threads(wasm_config_t* config, uint32_t count)
+{
+    ASSERT(config);
+    config->JITThreadCount = count;
+}
+
+void wasm_config_set_jit_opt_level(wasm_config_t* config, uint32_t level)
+{
+    ASSERT(config);
+    config->JITOptLevel = level;
+}
+
+void wasm_config_set_jit_inline_size(wasm_config_t* config, uint32_t size)
+{
+    ASSERT(config);
+    config->JITInlineSize = size;
+}
+
+void wasm_config_set_epoch_interruption(wasm_config_t* config, bool enable)
+{
+    ASSERT(config);
+    config->epochInterruption = enable;
 }
 
 // Engine
@@ -648,11 +702,40 @@ own wasm_engine_t* wasm_engine_new()
     return new wasm_engine_t(new Engine());
 }
 
-own wasm_engine_t* wasm_engine_new_with_config(own wasm_config_t*)
+own wasm_engine_t* wasm_engine_new_with_config(own wasm_config_t* config)
 {
-    // TODO
-    RELEASE_ASSERT_NOT_REACHED();
-    return nullptr;
+    ASSERT(config);
+    Engine* engine = new Engine();
+    engine->setUseMemoryGuardPages(config->memoryGuardPages);
+    engine->setJITThreadCount(config->JITThreadCount);
+    engine->setJITOptLevel(config->JITOptLevel);
+    engine->setJITInlineSize(config->JITInlineSize);
+    engine->setEpochInterruption(config->epochInterruption);
+    delete config;
+    return new wasm_engine_t(engine);
+}
+
+void wasm_engine_increment_epoch(wasm_engine_t* engine)
+{
+    ASSERT(engine);
+    engine->get()->incrementEpoch();
+}
+
+void wasm_thread_release_resources(void)
+{
+    Engine::releaseThreadResources();
+}
+
+// Profiler
+bool wasm_profiler_start(const char* fileName, uint32_t interval)
+{
+    ASSERT(fileName);
+    return Profiler::start(fileName, interval);
+}
+
+void wasm_profiler_stop()
+{
+    Profiler::stop();
 }
 
 // Store
@@ -662,6 +745,27 @@ own wasm_store_t* wasm_store_new(wasm_engine_t* engine)
     return new wasm_store_t(new Store(engine->get()));
 }
 
+static size_t callEpochDeadlineCallback(ExecutionState& state, void* data)
+{
+    wasm_store_t* store = reinterpret_cast<wasm_store_t*>(data);
+    uint64_t ticks = store->epochDeadlineCallback(store->epochDeadlineEnv);
+    return static_cast<size_t>(std::min(ticks, static_cast<uint64_t>(SIZE_MAX)));
+}
+
+void wasm_store_set_epoch_deadline(wasm_store_t* store, uint64_t ticks)
+{
+    ASSERT(store);
+    store->get()->setEpochDeadline(static_cast<size_t>(std::min(ticks, static_cast<uint64_t>(SIZE_MAX))));
+}
+
+void wasm_store_set_epoch_deadline_callback(wasm_store_t* store, wasm_epoch_deadline_callback_t callback, void* env)
+{
+    ASSERT(store);
+    store->epochDeadlineCallback = callback;
+    store->epochDeadlineEnv = env;
+    store->get()->setEpochDeadlineCallback(callback != nullptr ? callEpochDeadlineCallback : nullptr, store);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Type Representations
 
@@ -809,11 +913,17 @@ void wasm_trap_trigger(const char* message, size_t length)
 // Modules
 own wasm_module_t* wasm_module_new(wasm_store_t* store, const wasm_byte_vec_t* binary)
 {
-    auto parseResult = WASMParser::parseBinary(store->get(), std::string(), reinterpret_cast<uint8_t*>(binary->data), binary->size);
+    uint32_t featureFlags = 0;
+
+    if (Profiler::isRunning()) {
+        featureFlags |= wabt::FeatureFlagValue::readFunctionNames | wabt::FeatureFlagValue::recordCodeOffsets;
+    }
+
+    auto parseResult = WASMParser::parseBinary(store->get(), std::string(), reinterpret_cast<uint8_t*>(binary->data), binary->size, 0, featureFlags);
     if (!parseResult.first.hasValue()) {
         return nullptr;
     }
-    return new wasm_module_t(parseResult.first.unwrap());
+    return new wasm_module_t(parseResult.first.unwrap(), reinterpret_cast<uint8_t*>(binary->data), binary->size);
 }
 
 bool wasm_module_validate(wasm_store_t* store, const wasm_byte_vec_t* binary)
@@ -887,17 +997,45 @@ void wasm_module_exports(const wasm_module_t* module, own wasm_exporttype_vec_t*
     }
 }
 
-void wasm_module_serialize(const wasm_module_t*, own wasm_byte_vec_t* out)
+void wasm_module_serialize(const wasm_module_t* module, own wasm_byte_vec_t* out)
 {
-    // TODO
-    RELEASE_ASSERT_NOT_REACHED();
+    std::vector<uint8_t> data;
+
+    if (!WASMParser::serialize(module->get(), module->binary.data(), module->binary.size(), data)) {
+        wasm_byte_vec_new_empty(out);
+        return;
+    }
+
+    wasm_byte_vec_new(out, data.size(), reinterpret_cast<wasm_byte_t*>(data.data()));
 }
 
-own wasm_module_t* wasm_module_deserialize(wasm_store_t*, const wasm_byte_vec_t*)
+own wasm_module_t* wasm_module_deserialize(wasm_store_t* store, const wasm_byte_vec_t* binary)
 {
-    // TODO
-    RELEASE_ASSERT_NOT_REACHED();
-    return nullptr;
+    const uint8_t* data = reinterpret_cast<uint8_t*>(binary->data);
+    const uint8_t* moduleBinary;
+    size_t moduleBinarySize;
+
+    if (!WASMParser::serializedBinary(data, binary->size, &moduleBinary, &moduleBinarySize)) {
+        return nullptr;
+    }
+
+    uint32_t featureFlags = 0;
+
+    if (Profiler::isRunning()) {
+        featureFlags |= wabt::FeatureFlagValue::readFunctionNames | wabt::FeatureFlagValue::recordCodeOffsets;
+    }
+
+    auto parseResult = WASMParser::parseSerialized(store->get(), std::string(), data, binary->size, nullptr, 0, 0, featureFlags);
+    if (!parseResult.first.hasValue()) {
+        // Data created by other builds or with other options is
+        // still usable, since it contains the original binary.
+        parseResult = WASMParser::parseBinary(store->get(), std::string(), moduleBinary, moduleBinarySize, 0, featureFlags);
+        if (!parseResult.first.hasValue()) {
+            return nullptr;
+        }
+    }
+
+    return new wasm_module_t(parseResult.first.unwrap(), moduleBinary, moduleBinarySize);
 }
 
 // Function Instances
@@ -1043,6 +1181,61 @@ own wasm_trap_t* wasm_func_call(
     return nullptr;
 }
 
+struct wasm_func_prepared_t {
+    wasm_func_prepared_t(Function* func)
+        : call(func)
+    {
+    }
+
+    PreparedCall call;
+};
+
+void wasm_func_prepared_delete(own wasm_func_prepared_t* prepared)
+{
+    delete prepared;
+}
+
+own wasm_func_prepared_t* wasm_func_prepare(const wasm_func_t* func)
+{
+    return new wasm_func_prepared_t(func->get());
+}
+
+own wasm_trap_t* wasm_func_prepared_call(
+    const wasm_func_prepared_t* prepared, const wasm_val_t args[], wasm_val_t results[])
+{
+    const PreparedCall& call = prepared->call;
+    const FunctionType* ft = call.function()->functionType();
+    size_t paramNum = ft->param().size();
+    size_t resultNum = ft->result().size();
+
+    ALLOCA(uint8_t, buffer, call.bufferSize());
+    ALLOCA(Value, walrusArgs, paramNum * sizeof(Value));
+    ALLOCA(Value, walrusResults, resultNum * sizeof(Value));
+
+    ToWalrusValues(walrusArgs, args, paramNum);
+
+    struct RunData {
+        const PreparedCall& call;
+        uint8_t* buffer;
+        Value* args;
+        Value* results;
+    } data = { call, buffer, walrusArgs, walrusResults };
+    Trap trap;
+    auto trapResult = trap.run([](ExecutionState& state, void* d) {
+        RunData* data = reinterpret_cast<RunData*>(d);
+
+        data->call.call(state, data->buffer, data->args, data->results);
+    },
+                               &data);
+
+    if (UNLIKELY(trapResult.exception != nullptr)) {
+        return new wasm_trap_t(new Trap(), trapResult.exception->message());
+    }
+
+    FromWalrusValues(results, walrusResults, resultNum);
+    return nullptr;
+}
+
 // Global Instances
 own wasm_global_t* wasm_global_new(
     wasm_store_t* store, const wasm_globaltype_t* gt, const wasm_val_t* val)
@@ -1325,7 +1518,7 @@ uint32_t wasm_instance_func_index(const wasm_instance_t* ins, const wasm_func_t*
     }
 
 //WASM_IMPL_OWN(frame);
-//WASM_IMPL_OWN(config);
+WASM_IMPL_OWN(config);
 WASM_IMPL_OWN(engine);
 WASM_IMPL_OWN(store);
 
@@ -129,6 +129,24 @@ WASM_API_EXTERN own wasm_config_t* wasm_config_new(void);
 
 // Embedders may provide custom functions for manipulating configs.
 
+// Reserve the address space of 32 bit memories and replace the bounds
+// checks of the JIT with guard pages. Ignored on unsupported platforms.
+WASM_API_EXTERN void wasm_config_set_memory_guard_pages(wasm_config_t*, bool);
+
+// Number of threads used for compiling the functions of a module.
+WASM_API_EXTERN void wasm_config_set_jit_threads(wasm_config_t*, uint32_t);
+
+// Optimization level of the JIT compiler from 0 (no optimizations) to 2.
+WASM_API_EXTERN void wasm_config_set_jit_opt_level(wasm_config_t*, uint32_t);
+
+// Maximum number of byte codes of the functions inlined by the JIT compiler,
+// zero disables inlining.
+WASM_API_EXTERN void wasm_config_set_jit_inline_size(wasm_config_t*, uint32_t);
+
+// Check the epoch deadline of the store at the loop headers and function
+// entries of the modules, see wasm_store_set_epoch_deadline.
+WASM_API_EXTERN void wasm_config_set_epoch_interruption(wasm_config_t*, bool);
+
 
 // Engine
 
@@ -137,6 +155,25 @@ WASM_DECLARE_OWN(engine)
 WASM_API_EXTERN own wasm_engine_t* wasm_engine_new(void);
 WASM_API_EXTERN own wasm_engine_t* wasm_engine_new_with_config(own wasm_config_t*);
 
+// Walrus extension: can be called from any thread.
+WASM_API_EXTERN void wasm_engine_increment_epoch(wasm_engine_t*);
+
+// Walrus extension: frees the buffers which the runtime keeps for the
+// calling thread (value stack, allocator, frame buffer of the JIT). Threads
+// which called into wasm should call it before they exit, while no wasm
+// code runs on the thread. Calling into wasm again is allowed.
+WASM_API_EXTERN void wasm_thread_release_resources(void);
+
+// Walrus extension: sampling profiler. The wasm call stacks are sampled
+// every interval microseconds of CPU time (0 selects 1000), and written
+// to the file as folded stacks for flamegraph tools when the profiler is
+// stopped. Modules created while the profiler runs are labelled with the
+// names of their name section. Modules must not be deleted before the
+// profiler is stopped. Returns false when the profiler cannot be started.
+
+WASM_API_EXTERN bool wasm_profiler_start(const char* file_name, uint32_t interval);
+WASM_API_EXTERN void wasm_profiler_stop(void);
+
 
 // Store
 
@@ -144,6 +181,18 @@ WASM_DECLARE_OWN(store)
 
 WASM_API_EXTERN own wasm_store_t* wasm_store_new(wasm_engine_t*);
 
+// Walrus extension: epoch interruption. The running code traps when the
+// epoch of the engine is incremented ticks times after setting the
+// deadline. When a callback is set, it is called instead, and the code
+// continues with a deadline extended by the returned ticks, or traps
+// when zero is returned. The callback must not call into wasm.
+
+typedef uint64_t (*wasm_epoch_deadline_callback_t)(void* env);
+
+WASM_API_EXTERN void wasm_store_set_epoch_deadline(wasm_store_t*, uint64_t ticks);
+WASM_API_EXTERN void wasm_store_set_epoch_deadline_callback(
+  wasm_store_t*, wasm_epoch_deadline_callback_t, void* env);
+
 
 ///////////////////////////////////////////////////////////////////////////////
 // Type Representations
@@ -433,6 +482,18 @@ WASM_API_EXTERN size_t wasm_func_result_arity(const wasm_func_t*);
 WASM_API_EXTERN own wasm_trap_t* wasm_func_call(
   const wasm_func_t*, const wasm_val_vec_t* args, wasm_val_vec_t* results);
 
+// Walrus extension: prepared calls. The call layout of the function is
+// computed once, and the calls take caller provided argument and result
+// arrays with the parameter and result arity of the function, and do not
+// allocate memory unless a trap is returned. The function must outlive
+// the prepared call.
+
+WASM_DECLARE_OWN(func_prepared)
+
+WASM_API_EXTERN own wasm_func_prepared_t* wasm_func_prepare(const wasm_func_t*);
+WASM_API_EXTERN own wasm_trap_t* wasm_func_prepared_call(
+  const wasm_func_prepared_t*, const wasm_val_t args[], wasm_val_t results[]);
+
 
 // Global Instances
 
@@ -41,6 +41,7 @@ class FunctionType;
 #define FOR_EACH_BYTECODE_OP(F) \
     F_NOP(F)                    \
     F(Unreachable)              \
+    F(CheckEpoch)               \
     F(Throw)                    \
     F(End)                      \
     F(BrTable)                  \
@@ -87,6 +88,11 @@ class FunctionType;
     F(MoveI64)                  \
     F(MoveF64)                  \
     F(MoveV128)                 \
+    F(MoveWideI32)              \
+    F(MoveWideF32)              \
+    F(MoveWideI64)              \
+    F(MoveWideF64)              \
+    F(MoveWideV128)             \
     F(Jump)                     \
     F(JumpIfTrue)               \
     F(JumpIfFalse)              \
@@ -107,6 +113,8 @@ class FunctionType;
     F(Load32M64)                \
     F(Load64)                   \
     F(Load64M64)                \
+    F(Load32AddImm)             \
+    F(Load64AddImm)             \
     F(Store32)                  \
     F(Store32M64)               \
     F(Store64)                  \
@@ -437,6 +445,29 @@ class FunctionType;
     F(F64Gt, gt, double, int32_t)                 \
     F(F64Ge, ge, double, int32_t)
 
+// Superinstructions, only generated for the interpreter
+#define FOR_EACH_BYTECODE_BINARY_IMM_OP(F)  \
+    F(I32AddImm, add, int32_t, int32_t)     \
+    F(I32MulImm, mul, int32_t, int32_t)     \
+    F(I32AndImm, intAnd, int32_t, int32_t)  \
+    F(I32OrImm, intOr, int32_t, int32_t)    \
+    F(I32XorImm, intXor, int32_t, int32_t)  \
+    F(I32ShlImm, intShl, int32_t, int32_t)  \
+    F(I32ShrSImm, intShr, int32_t, int32_t) \
+    F(I32ShrUImm, intShr, uint32_t, uint32_t)
+
+#define FOR_EACH_BYTECODE_JUMP_IF_COMPARE_OP(F) \
+    F(JumpIfI32Eq, I32Eq, eq, int32_t)          \
+    F(JumpIfI32Ne, I32Ne, ne, int32_t)          \
+    F(JumpIfI32LtS, I32LtS, lt, int32_t)        \
+    F(JumpIfI32LtU, I32LtU, lt, uint32_t)       \
+    F(JumpIfI32LeS, I32LeS, le, int32_t)        \
+    F(JumpIfI32LeU, I32LeU, le, uint32_t)       \
+    F(JumpIfI32GtS, I32GtS, gt, int32_t)        \
+    F(JumpIfI32GtU, I32GtU, gt, uint32_t)       \
+    F(JumpIfI32GeS, I32GeS, ge, int32_t)        \
+    F(JumpIfI32GeU, I32GeU, ge, uint32_t)
+
 #define FOR_EACH_BYTECODE_UNARY_OP(F)   \
     F(I32Clz, clz, uint32_t)            \
     F(I32Ctz, ctz, uint32_t)            \
@@ -1385,6 +1416,8 @@ class FunctionType;
 #define FOR_EACH_BYTECODE(F)                        \
     FOR_EACH_BYTECODE_OP(F)                         \
     FOR_EACH_BYTECODE_BINARY_OP(F)                  \
+    FOR_EACH_BYTECODE_BINARY_IMM_OP(F)              \
+    FOR_EACH_BYTECODE_JUMP_IF_COMPARE_OP(F)         \
     FOR_EACH_BYTECODE_UNARY_OP(F)                   \
     FOR_EACH_BYTECODE_UNARY_OP_2(F)                 \
     FOR_EACH_BYTECODE_MEMIDX_OP(F)                  \
@@ -1449,6 +1482,7 @@ public:
 protected:
     friend class Interpreter;
     friend class ByteCodeTable;
+    friend class ModuleSerializer;
     ByteCode(Opcode opcode);
 
     ByteCode()
@@ -1909,6 +1943,47 @@ FOR_EACH_BYTECODE_RELAXED_SIMD_TERNARY_OTHER(DEFINE_TERNARY_BYTECODE)
 
 DEFINE_UNARY_BYTECODE(RefI31)
 
+// dummy ByteCode for binary operation with a constant right operand
+class BinaryImmOperation : public ByteCodeOffset2Value {
+public:
+    BinaryImmOperation(Opcode code, ByteCodeStackOffset srcOffset, ByteCodeStackOffset dstOffset, uint32_t value)
+        : ByteCodeOffset2Value(code, srcOffset, dstOffset, value)
+    {
+    }
+
+    ByteCodeStackOffset srcOffset() const { return stackOffset1(); }
+    ByteCodeStackOffset dstOffset() const { return stackOffset2(); }
+    uint32_t value() const { return uintValue(); }
+
+#if !defined(NDEBUG)
+    void dump(size_t pos)
+    {
+    }
+#endif
+};
+
+#if !defined(NDEBUG)
+#define DEFINE_BINARY_IMM_BYTECODE_DUMP(name)                                                                                                                  \
+    void dump(size_t pos)                                                                                                                                      \
+    {                                                                                                                                                          \
+        printf(#name " src: %" PRIu32 " value: %" PRId32 " dst: %" PRIu32, (uint32_t)m_stackOffset1, static_cast<int32_t>(m_value), (uint32_t)m_stackOffset2); \
+    }
+#else
+#define DEFINE_BINARY_IMM_BYTECODE_DUMP(name)
+#endif
+
+#define DEFINE_BINARY_IMM_BYTECODE(name, ...)                                              \
+    class name : public BinaryImmOperation {                                               \
+    public:                                                                                \
+        name(ByteCodeStackOffset srcOffset, ByteCodeStackOffset dstOffset, uint32_t value) \
+            : BinaryImmOperation(Opcode::name##Opcode, srcOffset, dstOffset, value)        \
+        {                                                                                  \
+        }                                                                                  \
+        DEFINE_BINARY_IMM_BYTECODE_DUMP(name)                                              \
+    };
+
+FOR_EACH_BYTECODE_BINARY_IMM_OP(DEFINE_BINARY_IMM_BYTECODE)
+
 #define DEFINE_MOVE_BYTECODE(name)                                         \
     class name : public ByteCodeOffset2 {                                  \
     public:                                                                \
@@ -1967,6 +2042,51 @@ protected:
 DEFINE_MOVE_FLOAT_BYTECODE(MoveF32)
 DEFINE_MOVE_FLOAT_BYTECODE(MoveF64)
 
+// Functions with frames larger than the range of ByteCodeStackOffset
+// keep some of their locals after it, which are only accessed by these moves.
+class MoveWide : public ByteCode {
+public:
+    MoveWide(Opcode code, ByteCodeWideStackOffset srcOffset, ByteCodeWideStackOffset dstOffset)
+        : ByteCode(code)
+        , m_srcOffset(srcOffset)
+        , m_dstOffset(dstOffset)
+    {
+    }
+
+    ByteCodeWideStackOffset srcOffset() const { return m_srcOffset; }
+    ByteCodeWideStackOffset dstOffset() const { return m_dstOffset; }
+
+protected:
+    ByteCodeWideStackOffset m_srcOffset;
+    ByteCodeWideStackOffset m_dstOffset;
+};
+
+#if !defined(NDEBUG)
+#define DEFINE_MOVE_WIDE_DUMP(name)                                                  \
+    void dump(size_t pos)                                                            \
+    {                                                                                \
+        printf(#name " src: %" PRIu32 " dst: %" PRIu32, m_srcOffset, m_dstOffset); \
+    }
+#else
+#define DEFINE_MOVE_WIDE_DUMP(name)
+#endif
+
+#define DEFINE_MOVE_WIDE_BYTECODE(name)                                              \
+    class name : public MoveWide {                                                   \
+    public:                                                                          \
+        name(ByteCodeWideStackOffset srcOffset, ByteCodeWideStackOffset dstOffset) \
+            : MoveWide(Opcode::name##Opcode, srcOffset, dstOffset)                   \
+        {                                                                            \
+        }                                                                            \
+        DEFINE_MOVE_WIDE_DUMP(name)                                                  \
+    };
+
+DEFINE_MOVE_WIDE_BYTECODE(MoveWideI32)
+DEFINE_MOVE_WIDE_BYTECODE(MoveWideF32)
+DEFINE_MOVE_WIDE_BYTECODE(MoveWideI64)
+DEFINE_MOVE_WIDE_BYTECODE(MoveWideF64)
+DEFINE_MOVE_WIDE_BYTECODE(MoveWideV128)
+
 #undef DEFINE_BINARY_BYTECODE_DUMP
 #undef DEFINE_BINARY_BYTECODE
 #undef DEFINE_UNARY_BYTECODE_DUMP
@@ -2331,6 +2451,35 @@ DEFINE_LOAD_OP(Load32M64, Load32M64Opcode, "32M64");
 DEFINE_LOAD_OP(Load64, Load64Opcode, "64");
 DEFINE_LOAD_OP(Load64M64, Load64M64Opcode, "64M64");
 
+// Load from the address computed by a preceding i32.add with a constant.
+#define DEFINE_LOAD_ADD_IMM_OP(className, opcodeType, opStr)                                                     \
+    class className : public ByteCodeOffset2Value {                                                              \
+    public:                                                                                                      \
+        className(ByteCodeStackOffset srcOffset, ByteCodeStackOffset dstOffset, uint32_t value, uint32_t offset) \
+            : ByteCodeOffset2Value(opcodeType, srcOffset, dstOffset, value)                                      \
+            , m_offset(offset)                                                                                   \
+        {                                                                                                        \
+        }                                                                                                        \
+        ByteCodeStackOffset srcOffset() const { return stackOffset1(); }                                         \
+        ByteCodeStackOffset dstOffset() const { return stackOffset2(); }                                         \
+        uint32_t value() const { return uintValue(); }                                                           \
+        uint32_t offset() const { return m_offset; }                                                             \
+        IF_DEBUG_ENABLED(                                                                                        \
+            void dump(size_t pos) {                                                                              \
+                printf("load%s_add_imm ", opStr);                                                                \
+                DUMP_BYTECODE_OFFSET(stackOffset1);                                                              \
+                DUMP_BYTECODE_OFFSET(value);                                                                     \
+                DUMP_BYTECODE_OFFSET(offset);                                                                    \
+                DUMP_BYTECODE_OFFSET(stackOffset2);                                                              \
+            });                                                                                                  \
+                                                                                                                 \
+    protected:                                                                                                   \
+        uint32_t m_offset;                                                                                       \
+    };
+
+DEFINE_LOAD_ADD_IMM_OP(Load32AddImm, Load32AddImmOpcode, "32");
+DEFINE_LOAD_ADD_IMM_OP(Load64AddImm, Load64AddImmOpcode, "64");
+
 #define DEFINE_STORE_OP(className, opcodeType, opStr)                             \
     class className : public ByteCodeOffset2 {                                    \
     public:                                                                       \
@@ -2474,6 +2623,59 @@ public:
 #endif
 };
 
+// dummy ByteCode for i32 comparison fused with a conditional jump
+class JumpIfI32Compare : public ByteCode {
+public:
+    JumpIfI32Compare(Opcode code, ByteCodeStackOffset src0Offset, ByteCodeStackOffset src1Offset, int32_t offset)
+        : ByteCode(code)
+        , m_src0Offset(src0Offset)
+        , m_src1Offset(src1Offset)
+        , m_offset(offset)
+    {
+    }
+
+    ByteCodeStackOffset src0Offset() const { return m_src0Offset; }
+    ByteCodeStackOffset src1Offset() const { return m_src1Offset; }
+    int32_t offset() const { return m_offset; }
+    void setOffset(int32_t offset)
+    {
+        m_offset = offset;
+    }
+
+#if !defined(NDEBUG)
+    void dump(size_t pos)
+    {
+    }
+#endif
+
+protected:
+    ByteCodeStackOffset m_src0Offset;
+    ByteCodeStackOffset m_src1Offset;
+    int32_t m_offset;
+};
+
+#if !defined(NDEBUG)
+#define DEFINE_JUMP_IF_COMPARE_BYTECODE_DUMP(name)                                                                                                   \
+    void dump(size_t pos)                                                                                                                            \
+    {                                                                                                                                                \
+        printf(#name " src1: %" PRIu32 " src2: %" PRIu32 " dst: %" PRId32, (uint32_t)m_src0Offset, (uint32_t)m_src1Offset, (int32_t)pos + m_offset); \
+    }
+#else
+#define DEFINE_JUMP_IF_COMPARE_BYTECODE_DUMP(name)
+#endif
+
+#define DEFINE_JUMP_IF_COMPARE_BYTECODE(name, ...)                                               \
+    class name : public JumpIfI32Compare {                                                       \
+    public:                                                                                      \
+        name(ByteCodeStackOffset src0Offset, ByteCodeStackOffset src1Offset, int32_t offset = 0) \
+            : JumpIfI32Compare(Opcode::name##Opcode, src0Offset, src1Offset, offset)             \
+        {                                                                                        \
+        }                                                                                        \
+        DEFINE_JUMP_IF_COMPARE_BYTECODE_DUMP(name)                                               \
+    };
+
+FOR_EACH_BYTECODE_JUMP_IF_COMPARE_OP(DEFINE_JUMP_IF_COMPARE_BYTECODE)
+
 // The parser requires that conditional jumps must be derieved from ByteCodeOffsetValue.
 class JumpIfCastGeneric : public ByteCodeOffsetValue {
 public:
@@ -5451,6 +5653,24 @@ public:
 protected:
 };
 
+// Function entries and loop headers when epoch interruption is enabled.
+class CheckEpoch : public ByteCode {
+public:
+    CheckEpoch()
+        : ByteCode(Opcode::CheckEpochOpcode)
+    {
+    }
+
+#if !defined(NDEBUG)
+    void dump(size_t pos)
+    {
+        printf("check_epoch");
+    }
+#endif
+
+protected:
+};
+
 class End : public ByteCode {
 public:
     End(uint32_t offsetsSize)
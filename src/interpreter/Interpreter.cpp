@@ -154,8 +154,7 @@ ByteCodeTable::ByteCodeTable()
     b.m_opcodeInAddress = const_cast<void*>(FillByteCodeOpcodeAddress[0]);
 #endif
     size_t pc = reinterpret_cast<size_t>(&b);
-    Interpreter::StackFrame dummyFrame(nullptr, 0);
-    Interpreter::interpret(dummyState, pc, dummyFrame, nullptr);
+    Interpreter::interpret(dummyState, pc, nullptr, nullptr);
 #endif
 }
 
@@ -481,18 +480,78 @@ static void initAddressToOpcodeTable()
 }
 #endif
 
+#if defined(WALRUS_ENABLE_JIT)
+// Backward jumps are the loop iterations of the tiered compilation. When the
+// function is already compiled, returns with the on-stack replacement entry
+// of the loop header, or nullptr otherwise. Modules parsed without tiered
+// compilation only pay for the flag check of their backward jumps.
+static ALWAYS_INLINE void* countLoopIteration(ExecutionState& state, Instance* instance, size_t programCounter, int32_t offset)
+{
+    if (LIKELY(offset >= 0)) {
+        return nullptr;
+    }
+
+    Module* module = instance->module();
+
+    if (LIKELY(module->tieredJITFlags() == 0)) {
+        return nullptr;
+    }
+
+    ModuleFunction* moduleFunction = state.currentFunction().value()->asDefinedFunction()->moduleFunction();
+
+    if (UNLIKELY(moduleFunction->countTierUpEvent())) {
+        module->tierUp(moduleFunction);
+        return nullptr;
+    }
+
+    JITFunction* jitFunction = moduleFunction->jitFunction();
+
+    if (LIKELY(jitFunction == nullptr)) {
+        return nullptr;
+    }
+
+    return jitFunction->osrEntry(programCounter + offset - reinterpret_cast<size_t>(moduleFunction->byteCode()));
+}
+
+ByteCodeStackOffset* Interpreter::onStackReplacement(ExecutionState& state, size_t& programCounter, uint8_t* bp, Instance* instance, void* osrEntry)
+{
+    ModuleFunction* moduleFunction = state.currentFunction().value()->asDefinedFunction()->moduleFunction();
+
+    // The compiled code handles the exceptions thrown inside the function,
+    // so the program counter is moved out of its catch blocks.
+    programCounter = reinterpret_cast<size_t>(moduleFunction->byteCode()) + moduleFunction->byteCodeSize();
+    return moduleFunction->jitFunction()->call(state, instance, bp, osrEntry);
+}
+#endif
+
 ByteCodeStackOffset* Interpreter::interpret(ExecutionState& state,
                                             size_t programCounter,
-                                            StackFrame& frame,
+                                            uint8_t* bp,
                                             Instance* instance)
 {
     Memory** memories = reinterpret_cast<Memory**>(reinterpret_cast<uintptr_t>(instance) + Instance::alignedSize());
-    uint8_t* bp = frame.bp();
 
     state.m_programCounterPointer = &programCounter;
 
 #define ADD_PROGRAM_COUNTER(codeName) programCounter += sizeof(codeName);
 
+#define SWITCH_FRAME(newBp)                                                     \
+    bp = newBp;                                                                 \
+    instance = ValueStack::Frame::fromBP(bp)->function->instance();             \
+    memories = reinterpret_cast<Memory**>(reinterpret_cast<uintptr_t>(instance) \
+                                          + Instance::alignedSize())
+
+// Returns to the calling frame, or leaves the interpreter loop from its first frame.
+#define RETURN_FROM_FUNCTION(offsets)                                          \
+    {                                                                          \
+        ByteCodeStackOffset* resultOffsets = (offsets);                        \
+        if (ValueStack::Frame::fromBP(bp)->parent == nullptr) {                \
+            return resultOffsets;                                              \
+        }                                                                      \
+        SWITCH_FRAME(leaveFunction(state, programCounter, bp, resultOffsets)); \
+        NEXT_INSTRUCTION();                                                    \
+    }
+
 #define BINARY_OPERATION(name, op, paramType, returnType)                   \
     DEFINE_OPCODE(name)                                                     \
         :                                                                   \
@@ -505,6 +564,30 @@ ByteCodeStackOffset* Interpreter::interpret(ExecutionState& state,
         NEXT_INSTRUCTION();                                                 \
     }
 
+#define BINARY_IMM_OPERATION(name, op, paramType, returnType)                                                 \
+    DEFINE_OPCODE(name)                                                                                       \
+        :                                                                                                     \
+    {                                                                                                         \
+        name* code = (name*)programCounter;                                                                   \
+        auto lhs = readValue<paramType>(bp, code->srcOffset());                                               \
+        writeValue<returnType>(bp, code->dstOffset(), op(state, lhs, static_cast<paramType>(code->value()))); \
+        ADD_PROGRAM_COUNTER(name);                                                                            \
+        NEXT_INSTRUCTION();                                                                                   \
+    }
+
+#define JUMP_IF_COMPARE_OPERATION(name, compareName, op, type)                                             \
+    DEFINE_OPCODE(name)                                                                                    \
+        :                                                                                                  \
+    {                                                                                                      \
+        name* code = (name*)programCounter;                                                                \
+        if (op(state, readValue<type>(bp, code->src0Offset()), readValue<type>(bp, code->src1Offset()))) { \
+            programCounter += code->offset();                                                              \
+        } else {                                                                                           \
+            ADD_PROGRAM_COUNTER(name);                                                                     \
+        }                                                                                                  \
+        NEXT_INSTRUCTION();                                                                                \
+    }
+
 #define UNARY_OPERATION(name, op, type)                                                      \
     DEFINE_OPCODE(name)                                                                      \
         :                                                                                    \
@@ -1487,6 +1570,20 @@ NextInstruction:
         NEXT_INSTRUCTION();
     }
 
+    MOVE_OPERATION(MoveWideI32, uint32_t)
+    MOVE_OPERATION(MoveWideF32, float)
+    MOVE_OPERATION(MoveWideI64, uint64_t)
+    MOVE_OPERATION(MoveWideF64, double)
+
+    DEFINE_OPCODE(MoveWideV128)
+        :
+    {
+        MoveWideV128* code = (MoveWideV128*)programCounter;
+        memcpy(bp + code->dstOffset(), bp + code->srcOffset(), 16);
+        ADD_PROGRAM_COUNTER(MoveWideV128);
+        NEXT_INSTRUCTION();
+    }
+
     DEFINE_OPCODE(Load32)
         :
     {
@@ -1517,6 +1614,26 @@ NextInstruction:
         NEXT_INSTRUCTION();
     }
 
+    DEFINE_OPCODE(Load32AddImm)
+        :
+    {
+        Load32AddImm* code = (Load32AddImm*)programCounter;
+        uint32_t offset = readValue<uint32_t>(bp, code->srcOffset()) + code->value();
+        memories[0]->load(state, offset, code->offset(), reinterpret_cast<uint32_t*>(bp + code->dstOffset()));
+        ADD_PROGRAM_COUNTER(Load32AddImm);
+        NEXT_INSTRUCTION();
+    }
+
+    DEFINE_OPCODE(Load64AddImm)
+        :
+    {
+        Load64AddImm* code = (Load64AddImm*)programCounter;
+        uint32_t offset = readValue<uint32_t>(bp, code->srcOffset()) + code->value();
+        memories[0]->load(state, offset, code->offset(), reinterpret_cast<uint64_t*>(bp + code->dstOffset()));
+        ADD_PROGRAM_COUNTER(Load64AddImm);
+        NEXT_INSTRUCTION();
+    }
+
     DEFINE_OPCODE(Load64M64)
         :
     {
@@ -1572,6 +1689,8 @@ NextInstruction:
     }
 
     FOR_EACH_BYTECODE_BINARY_OP(BINARY_OPERATION)
+    FOR_EACH_BYTECODE_BINARY_IMM_OP(BINARY_IMM_OPERATION)
+    FOR_EACH_BYTECODE_JUMP_IF_COMPARE_OP(JUMP_IF_COMPARE_OPERATION)
     FOR_EACH_BYTECODE_UNARY_OP(UNARY_OPERATION)
     FOR_EACH_BYTECODE_UNARY_OP_2(UNARY_OPERATION_2)
     FOR_EACH_BYTECODE_SIMD_BINARY_OP(SIMD_BINARY_OPERATION)
@@ -1590,6 +1709,13 @@ NextInstruction:
         :
     {
         Jump* code = (Jump*)programCounter;
+#if defined(WALRUS_ENABLE_JIT)
+        void* osrEntry = countLoopIteration(state, instance, programCounter, code->offset());
+
+        if (UNLIKELY(osrEntry != nullptr)) {
+            RETURN_FROM_FUNCTION(onStackReplacement(state, programCounter, bp, instance, osrEntry));
+        }
+#endif
         programCounter += code->offset();
         NEXT_INSTRUCTION();
     }
@@ -1599,6 +1725,13 @@ NextInstruction:
     {
         JumpIfTrue* code = (JumpIfTrue*)programCounter;
         if (readValue<int32_t>(bp, code->srcOffset())) {
+#if defined(WALRUS_ENABLE_JIT)
+            void* osrEntry = countLoopIteration(state, instance, programCounter, code->offset());
+
+            if (UNLIKELY(osrEntry != nullptr)) {
+                RETURN_FROM_FUNCTION(onStackReplacement(state, programCounter, bp, instance, osrEntry));
+            }
+#endif
             programCounter += code->offset();
         } else {
             ADD_PROGRAM_COUNTER(JumpIfTrue);
@@ -1613,6 +1746,13 @@ NextInstruction:
         if (readValue<int32_t>(bp, code->srcOffset())) {
             ADD_PROGRAM_COUNTER(JumpIfFalse);
         } else {
+#if defined(WALRUS_ENABLE_JIT)
+            void* osrEntry = countLoopIteration(state, instance, programCounter, code->offset());
+
+            if (UNLIKELY(osrEntry != nullptr)) {
+                RETURN_FROM_FUNCTION(onStackReplacement(state, programCounter, bp, instance, osrEntry));
+            }
+#endif
             programCounter += code->offset();
         }
         NEXT_INSTRUCTION();
@@ -1697,21 +1837,30 @@ NextInstruction:
     DEFINE_OPCODE(Call)
         :
     {
-        callOperation(state, programCounter, bp, instance);
+        uint8_t* nextBp = callOperation(state, programCounter, bp, instance);
+        if (nextBp != bp) {
+            SWITCH_FRAME(nextBp);
+        }
         NEXT_INSTRUCTION();
     }
 
     DEFINE_OPCODE(CallIndirect)
         :
     {
-        callIndirectOperation(state, programCounter, bp, instance);
+        uint8_t* nextBp = callIndirectOperation(state, programCounter, bp, instance);
+        if (nextBp != bp) {
+            SWITCH_FRAME(nextBp);
+        }
         NEXT_INSTRUCTION();
     }
 
     DEFINE_OPCODE(CallRef)
         :
     {
-        callRefOperation(state, programCounter, bp, instance);
+        uint8_t* nextBp = callRefOperation(state, programCounter, bp, instance);
+        if (nextBp != bp) {
+            SWITCH_FRAME(nextBp);
+        }
         NEXT_INSTRUCTION();
     }
 
@@ -1721,13 +1870,12 @@ NextInstruction:
         ReturnCall* code = (ReturnCall*)programCounter;
         Function* target = instance->function(code->index());
 
-        if (tailCallOperation(state, programCounter, frame, instance, target, code->stackOffsets(),
+        if (tailCallOperation(state, programCounter, bp, instance, target, code->stackOffsets(),
                               code->parameterOffsetsSize(), code->resultOffsetsSize())) {
-            bp = frame.bp();
             memories = reinterpret_cast<Memory**>(reinterpret_cast<uintptr_t>(instance) + Instance::alignedSize());
             NEXT_INSTRUCTION();
         }
-        return code->stackOffsets() + code->parameterOffsetsSize();
+        RETURN_FROM_FUNCTION(code->stackOffsets() + code->parameterOffsetsSize());
     }
 
     DEFINE_OPCODE(ReturnCallIndirect)
@@ -1745,17 +1893,16 @@ NextInstruction:
             Trap::throwException(state, "uninitialized element " + std::to_string(idx));
         }
         const FunctionType* ft = target->functionType();
-        if (UNLIKELY(!ft->equals(code->functionType()))) {
+        if (UNLIKELY(!target->hasTypeID(code->functionType()->typeID()) && !ft->equals(code->functionType()))) {
             Trap::throwException(state, "indirect call type mismatch");
         }
 
-        if (tailCallOperation(state, programCounter, frame, instance, target, code->stackOffsets(),
+        if (tailCallOperation(state, programCounter, bp, instance, target, code->stackOffsets(),
                               code->parameterOffsetsSize(), code->resultOffsetsSize())) {
-            bp = frame.bp();
             memories = reinterpret_cast<Memory**>(reinterpret_cast<uintptr_t>(instance) + Instance::alignedSize());
             NEXT_INSTRUCTION();
         }
-        return code->stackOffsets() + code->parameterOffsetsSize();
+        RETURN_FROM_FUNCTION(code->stackOffsets() + code->parameterOffsetsSize());
     }
 
     DEFINE_OPCODE(ReturnCallRef)
@@ -1772,13 +1919,12 @@ NextInstruction:
             Trap::throwException(state, "call by reference type mismatch");
         }
 
-        if (tailCallOperation(state, programCounter, frame, instance, target, code->stackOffsets(),
+        if (tailCallOperation(state, programCounter, bp, instance, target, code->stackOffsets(),
                               code->parameterOffsetsSize(), code->resultOffsetsSize())) {
-            bp = frame.bp();
             memories = reinterpret_cast<Memory**>(reinterpret_cast<uintptr_t>(instance) + Instance::alignedSize());
             NEXT_INSTRUCTION();
         }
-        return code->stackOffsets() + code->parameterOffsetsSize();
+        RETURN_FROM_FUNCTION(code->stackOffsets() + code->parameterOffsetsSize());
     }
 
     DEFINE_OPCODE(Select)
@@ -3210,6 +3356,13 @@ NextInstruction:
     DEFINE_OPCODE(Throw)
         :
     {
+        uint8_t* catchBp = throwOperation(state, programCounter, bp, instance);
+        if (catchBp != nullptr) {
+            SWITCH_FRAME(catchBp);
+            NEXT_INSTRUCTION();
+        }
+
+        // The exception leaves this interpreter loop.
         Throw* code = (Throw*)programCounter;
         Tag* tag = instance->tag(code->tagIndex());
         Vector<uint8_t> userExceptionData;
@@ -3238,6 +3391,17 @@ NextInstruction:
         NEXT_INSTRUCTION();
     }
 
+    DEFINE_OPCODE(CheckEpoch)
+        :
+    {
+        Store* store = instance->module()->store();
+        if (UNLIKELY(store->epochDeadlineReached()) && !store->extendEpochDeadline(state)) {
+            Trap::throwException(state, "epoch deadline reached");
+        }
+        ADD_PROGRAM_COUNTER(CheckEpoch);
+        NEXT_INSTRUCTION();
+    }
+
 #if !defined(NDEBUG)
     DEFINE_OPCODE(Nop)
         :
@@ -3251,7 +3415,7 @@ NextInstruction:
         :
     {
         End* code = (End*)programCounter;
-        return code->resultOffsets();
+        RETURN_FROM_FUNCTION(code->resultOffsets());
     }
 #if defined(WALRUS_ENABLE_COMPUTED_GOTO)
     DEFINE_OPCODE(FillOpcodeTable)
@@ -3277,7 +3441,183 @@ NextInstruction:
     return nullptr;
 }
 
-NEVER_INLINE void Interpreter::callOperation(
+bool Interpreter::findCatchBlock(ExecutionState& state, ValueStack* stack, Exception* exception, size_t& programCounter)
+{
+    if (!exception->isUserException()) {
+        return false;
+    }
+
+    bool hasProgramCounter = false;
+    for (size_t i = exception->m_programCounterInfo.size(); i > 0; i--) {
+        if (exception->m_programCounterInfo[i - 1].first == &state) {
+            programCounter = exception->m_programCounterInfo[i - 1].second;
+            hasProgramCounter = true;
+            break;
+        }
+    }
+
+    if (!hasProgramCounter) {
+        return false;
+    }
+
+    Tag* tag = exception->tag().value();
+    ValueStack::Frame* frame = stack->currentFrame();
+
+    while (true) {
+        DefinedFunction* function = frame->function;
+        ModuleFunction* moduleFunction = function->moduleFunction();
+        size_t offset = programCounter - reinterpret_cast<size_t>(moduleFunction->byteCode());
+
+        for (const auto& item : moduleFunction->catchInfo()) {
+            if (item.m_tryStart <= offset && offset < item.m_tryEnd) {
+                if (item.m_tagIndex == std::numeric_limits<uint32_t>::max() || function->instance()->tag(item.m_tagIndex) == tag) {
+                    programCounter = item.m_catchStartPosition + reinterpret_cast<size_t>(moduleFunction->byteCode());
+                    stack->unwindTo(frame, moduleFunction->requiredStackSize());
+                    state.m_currentFunction = function;
+
+                    uint8_t* sp = frame->bp() + item.m_stackSizeToBe;
+                    if (item.m_tagIndex != std::numeric_limits<uint32_t>::max() && tag->functionType()->paramStackSize()) {
+                        memcpy(sp, exception->userExceptionData().data(), tag->functionType()->paramStackSize());
+                    }
+                    return true;
+                }
+            }
+        }
+
+        if (frame->parent == nullptr) {
+            return false;
+        }
+
+        // The last byte of the call instruction in the calling frame.
+        programCounter = frame->returnProgramCounter - 1;
+        frame = frame->parent;
+    }
+}
+
+// Catches the exception in the frames of this interpreter loop without
+// creating an Exception object. Returns with nullptr when none of the
+// frames catches the exception, and programCounter is unchanged.
+NEVER_INLINE uint8_t* Interpreter::throwOperation(
+    ExecutionState& state,
+    size_t& programCounter,
+    uint8_t* bp,
+    Instance* instance)
+{
+    Throw* code = (Throw*)programCounter;
+    Tag* tag = instance->tag(code->tagIndex());
+    ValueStack::Frame* frame = ValueStack::Frame::fromBP(bp);
+    size_t currentProgramCounter = programCounter;
+
+    while (true) {
+        DefinedFunction* function = frame->function;
+        ModuleFunction* moduleFunction = function->moduleFunction();
+
+        if (moduleFunction->hasTryCatch()) {
+            size_t offset = currentProgramCounter - reinterpret_cast<size_t>(moduleFunction->byteCode());
+
+            for (const auto& item : moduleFunction->catchInfo()) {
+                if (item.m_tryStart <= offset && offset < item.m_tryEnd) {
+                    bool isCatchAll = item.m_tagIndex == std::numeric_limits<uint32_t>::max();
+
+                    if (!isCatchAll && function->instance()->tag(item.m_tagIndex) != tag) {
+                        continue;
+                    }
+
+                    if (!isCatchAll) {
+                        // The arguments may overlap with the values of the catch block.
+                        size_t size = tag->functionType()->paramStackSize();
+                        ALLOCA(uint8_t, data, size);
+                        uint8_t* ptr = data;
+                        const TypeVector::Types& param = tag->functionType()->param().types();
+
+                        for (size_t i = 0; i < param.size(); i++) {
+                            size_t valueSize = valueStackAllocatedSize(param[i]);
+                            memcpy(ptr, bp + code->dataOffsets()[i], valueSize);
+                            ptr += valueSize;
+                        }
+                        memcpy(frame->bp() + item.m_stackSizeToBe, data, size);
+                    }
+
+                    ValueStack::current()->unwindTo(frame, moduleFunction->requiredStackSize());
+                    state.m_currentFunction = function;
+                    programCounter = item.m_catchStartPosition + reinterpret_cast<size_t>(moduleFunction->byteCode());
+                    return frame->bp();
+                }
+            }
+        }
+
+        if (frame->parent == nullptr) {
+            return nullptr;
+        }
+
+        // The last byte of the call instruction in the calling frame.
+        currentProgramCounter = frame->returnProgramCounter - 1;
+        frame = frame->parent;
+    }
+}
+
+ALWAYS_INLINE uint8_t* Interpreter::enterFunction(
+    ExecutionState& state,
+    size_t& programCounter,
+    uint8_t* bp,
+    DefinedFunction* target,
+    ByteCodeStackOffset* offsets,
+    uint16_t parameterOffsetCount,
+    size_t returnProgramCounter)
+{
+    ModuleFunction* moduleFunction = target->moduleFunction();
+
+#if defined(WALRUS_ENABLE_JIT)
+    if (moduleFunction->jitFunction() != nullptr) {
+        return nullptr;
+    }
+
+    if (UNLIKELY(moduleFunction->countTierUpEvent())) {
+        target->instance()->module()->tierUp(moduleFunction);
+    }
+#endif
+
+    ValueStack::Frame* frame = ValueStack::current()->pushFrame(ValueStack::Frame::fromBP(bp), target, moduleFunction->requiredStackSize());
+
+    if (UNLIKELY(frame == nullptr)) {
+        Trap::throwException(state, "call stack exhausted");
+    }
+
+    frame->returnProgramCounter = returnProgramCounter;
+    frame->resultOffsets = offsets + parameterOffsetCount;
+
+    uint8_t* calleeBp = frame->bp();
+    for (size_t i = 0; i < parameterOffsetCount; i++) {
+        ((size_t*)calleeBp)[i] = *((size_t*)(bp + offsets[i]));
+    }
+
+    state.m_currentFunction = target;
+    programCounter = reinterpret_cast<size_t>(moduleFunction->byteCode());
+    return calleeBp;
+}
+
+NEVER_INLINE uint8_t* Interpreter::leaveFunction(
+    ExecutionState& state,
+    size_t& programCounter,
+    uint8_t* bp,
+    ByteCodeStackOffset* resultOffsets)
+{
+    ValueStack::Frame* frame = ValueStack::Frame::fromBP(bp);
+    ValueStack::Frame* parent = frame->parent;
+    uint8_t* parentBp = parent->bp();
+    size_t resultOffsetCount = frame->function->functionType()->resultStackSize() / sizeof(size_t);
+
+    for (size_t i = 0; i < resultOffsetCount; i++) {
+        *((size_t*)(parentBp + frame->resultOffsets[i])) = *((size_t*)(bp + resultOffsets[i]));
+    }
+
+    ValueStack::current()->popFrame(frame);
+    state.m_currentFunction = parent->function;
+    programCounter = frame->returnProgramCounter;
+    return parentBp;
+}
+
+NEVER_INLINE uint8_t* Interpreter::callOperation(
     ExecutionState& state,
     size_t& programCounter,
     uint8_t* bp,
@@ -3285,13 +3625,23 @@ NEVER_INLINE void Interpreter::callOperation(
 {
     Call* code = (Call*)programCounter;
     Function* target = instance->function(code->index());
-    target->interpreterCall(state, bp, code->stackOffsets(), code->parameterOffsetsSize(), code->resultOffsetsSize());
+    size_t nextProgramCounter = programCounter + ByteCode::pointerAlignedSize(sizeof(Call) + sizeof(ByteCodeStackOffset) * code->parameterOffsetsSize()
+                                                                              + sizeof(ByteCodeStackOffset) * code->resultOffsetsSize());
+
+    if (target->kind() == Function::DefinedFunctionKind) {
+        uint8_t* calleeBp = enterFunction(state, programCounter, bp, target->asDefinedFunction(), code->stackOffsets(),
+                                          code->parameterOffsetsSize(), nextProgramCounter);
+        if (calleeBp != nullptr) {
+            return calleeBp;
+        }
+    }
 
-    programCounter += ByteCode::pointerAlignedSize(sizeof(Call) + sizeof(ByteCodeStackOffset) * code->parameterOffsetsSize()
-                                                   + sizeof(ByteCodeStackOffset) * code->resultOffsetsSize());
+    target->interpreterCall(state, bp, code->stackOffsets(), code->parameterOffsetsSize(), code->resultOffsetsSize());
+    programCounter = nextProgramCounter;
+    return bp;
 }
 
-NEVER_INLINE void Interpreter::callIndirectOperation(
+NEVER_INLINE uint8_t* Interpreter::callIndirectOperation(
     ExecutionState& state,
     size_t& programCounter,
     uint8_t* bp,
@@ -3309,17 +3659,27 @@ NEVER_INLINE void Interpreter::callIndirectOperation(
         Trap::throwException(state, "uninitialized element " + std::to_string(idx));
     }
     const FunctionType* ft = target->functionType();
-    if (!ft->equals(code->functionType())) {
+    if (!target->hasTypeID(code->functionType()->typeID()) && !ft->equals(code->functionType())) {
         Trap::throwException(state, "indirect call type mismatch");
     }
 
-    target->interpreterCall(state, bp, code->stackOffsets(), code->parameterOffsetsSize(), code->resultOffsetsSize());
+    size_t nextProgramCounter = programCounter + ByteCode::pointerAlignedSize(sizeof(CallIndirect) + sizeof(ByteCodeStackOffset) * code->parameterOffsetsSize()
+                                                                              + sizeof(ByteCodeStackOffset) * code->resultOffsetsSize());
+
+    if (target->kind() == Function::DefinedFunctionKind) {
+        uint8_t* calleeBp = enterFunction(state, programCounter, bp, target->asDefinedFunction(), code->stackOffsets(),
+                                          code->parameterOffsetsSize(), nextProgramCounter);
+        if (calleeBp != nullptr) {
+            return calleeBp;
+        }
+    }
 
-    programCounter += ByteCode::pointerAlignedSize(sizeof(CallIndirect) + sizeof(ByteCodeStackOffset) * code->parameterOffsetsSize()
-                                                   + sizeof(ByteCodeStackOffset) * code->resultOffsetsSize());
+    target->interpreterCall(state, bp, code->stackOffsets(), code->parameterOffsetsSize(), code->resultOffsetsSize());
+    programCounter = nextProgramCounter;
+    return bp;
 }
 
-NEVER_INLINE void Interpreter::callRefOperation(
+NEVER_INLINE uint8_t* Interpreter::callRefOperation(
     ExecutionState& state,
     size_t& programCounter,
     uint8_t* bp,
@@ -3336,22 +3696,34 @@ NEVER_INLINE void Interpreter::callRefOperation(
         Trap::throwException(state, "call by reference type mismatch");
     }
 
-    target->interpreterCall(state, bp, code->stackOffsets(), code->parameterOffsetsSize(), code->resultOffsetsSize());
+    size_t nextProgramCounter = programCounter + ByteCode::pointerAlignedSize(sizeof(CallRef) + sizeof(ByteCodeStackOffset) * code->parameterOffsetsSize()
+                                                                              + sizeof(ByteCodeStackOffset) * code->resultOffsetsSize());
+
+    if (target->kind() == Function::DefinedFunctionKind) {
+        uint8_t* calleeBp = enterFunction(state, programCounter, bp, target->asDefinedFunction(), code->stackOffsets(),
+                                          code->parameterOffsetsSize(), nextProgramCounter);
+        if (calleeBp != nullptr) {
+            return calleeBp;
+        }
+    }
 
-    programCounter += ByteCode::pointerAlignedSize(sizeof(CallRef) + sizeof(ByteCodeStackOffset) * code->parameterOffsetsSize()
-                                                   + sizeof(ByteCodeStackOffset) * code->resultOffsetsSize());
+    target->interpreterCall(state, bp, code->stackOffsets(), code->parameterOffsetsSize(), code->resultOffsetsSize());
+    programCounter = nextProgramCounter;
+    return bp;
 }
 
 NEVER_INLINE bool Interpreter::tailCallOperation(
     ExecutionState& state,
     size_t& programCounter,
-    StackFrame& frame,
+    uint8_t* bp,
     Instance*& instance,
     Function* target,
     ByteCodeStackOffset* offsets,
     uint16_t parameterOffsetCount,
     uint16_t resultOffsetCount)
 {
+    ValueStack::Frame* frame = ValueStack::Frame::fromBP(bp);
+
     if (LIKELY(target->kind() == Function::DefinedFunctionKind)) {
         DefinedFunction* definedTarget = target->asDefinedFunction();
         ModuleFunction* targetModuleFunction = definedTarget->moduleFunction();
@@ -3359,21 +3731,23 @@ NEVER_INLINE bool Interpreter::tailCallOperation(
         if (LIKELY(targetModuleFunction->jitFunction() == nullptr))
 #endif
         {
-            size_t requiredStackSize = targetModuleFunction->requiredStackSize();
-            if (UNLIKELY(requiredStackSize > frame.capacity())) {
-                uint8_t* newBuffer = StackFrame::allocateBuffer(requiredStackSize);
-                for (size_t i = 0; i < parameterOffsetCount; i++) {
-                    ((size_t*)newBuffer)[i] = *((size_t*)(frame.bp() + offsets[i]));
-                }
-                frame.replaceBuffer(newBuffer, requiredStackSize);
-            } else {
-                ALLOCA(size_t, paramBuffer, parameterOffsetCount * sizeof(size_t));
-                for (size_t i = 0; i < parameterOffsetCount; i++) {
-                    paramBuffer[i] = *((size_t*)(frame.bp() + offsets[i]));
-                }
-                VectorCopier<size_t>::copy((size_t*)frame.bp(), paramBuffer, parameterOffsetCount);
+#if defined(WALRUS_ENABLE_JIT)
+            if (UNLIKELY(targetModuleFunction->countTierUpEvent())) {
+                definedTarget->instance()->module()->tierUp(targetModuleFunction);
+            }
+#endif
+            ALLOCA(size_t, paramBuffer, parameterOffsetCount * sizeof(size_t));
+            for (size_t i = 0; i < parameterOffsetCount; i++) {
+                paramBuffer[i] = *((size_t*)(bp + offsets[i]));
+            }
+
+            // The frame is always on the top of the stack, so it can grow in place.
+            if (UNLIKELY(!ValueStack::current()->resizeFrame(frame, targetModuleFunction->requiredStackSize()))) {
+                Trap::throwException(state, "call stack exhausted");
             }
+            VectorCopier<size_t>::copy((size_t*)bp, paramBuffer, parameterOffsetCount);
 
+            frame->function = definedTarget;
             state.m_currentFunction = definedTarget;
             instance = definedTarget->instance();
             programCounter = reinterpret_cast<size_t>(targetModuleFunction->byteCode());
@@ -3381,8 +3755,11 @@ NEVER_INLINE bool Interpreter::tailCallOperation(
         }
     }
 
-    state.m_currentFunction = nullptr;
-    target->interpreterCall(state, frame.bp(), offsets, parameterOffsetCount, resultOffsetCount);
+    // The catch blocks of the returning function must not handle
+    // the exceptions of the target, so the program counter is moved out.
+    ModuleFunction* moduleFunction = frame->function->moduleFunction();
+    programCounter = reinterpret_cast<size_t>(moduleFunction->byteCode()) + moduleFunction->byteCodeSize();
+    target->interpreterCall(state, bp, offsets, parameterOffsetCount, resultOffsetCount);
     return false;
 }
 
@@ -25,6 +25,7 @@
 #include "runtime/Store.h"
 #include "runtime/Tag.h"
 #include "interpreter/ByteCode.h"
+#include "interpreter/ValueStack.h"
 
 #ifdef ENABLE_GC
 #include "GCUtil.h"
@@ -42,61 +43,6 @@ private:
     friend class ByteCodeTable;
     friend class DefinedFunction;
 
-    class StackFrame {
-        MAKE_STACK_ALLOCATED();
-
-    public:
-        StackFrame(uint8_t* bp, size_t capacity)
-            : m_bp(bp)
-            , m_capacity(capacity)
-            , m_owned(nullptr)
-        {
-        }
-
-        ~StackFrame()
-        {
-            if (m_owned != nullptr) {
-                deallocateBuffer(m_owned);
-            }
-        }
-
-        uint8_t* bp() const { return m_bp; }
-        size_t capacity() const { return m_capacity; }
-
-        static uint8_t* allocateBuffer(size_t size)
-        {
-#ifdef ENABLE_GC
-            return reinterpret_cast<uint8_t*>(GC_MALLOC_UNCOLLECTABLE(size));
-#else
-            return reinterpret_cast<uint8_t*>(malloc(size));
-#endif
-        }
-
-        void replaceBuffer(uint8_t* buffer, size_t capacity)
-        {
-            if (m_owned != nullptr) {
-                deallocateBuffer(m_owned);
-            }
-            m_owned = buffer;
-            m_bp = buffer;
-            m_capacity = capacity;
-        }
-
-    private:
-        static void deallocateBuffer(uint8_t* buffer)
-        {
-#ifdef ENABLE_GC
-            GC_FREE(buffer);
-#else
-            free(buffer);
-#endif
-        }
-
-        uint8_t* m_bp;
-        size_t m_capacity;
-        uint8_t* m_owned;
-    };
-
     ALWAYS_INLINE static void callInterpreter(ExecutionState& state, DefinedFunction* function, uint8_t* bp, ByteCodeStackOffset* offsets,
                                               uint16_t parameterOffsetCount, uint16_t resultOffsetCount)
     {
@@ -104,93 +50,113 @@ private:
         CHECK_STACK_LIMIT(newState);
 
         auto moduleFunction = function->moduleFunction();
-        ALLOCA(uint8_t, functionStackBase, moduleFunction->requiredStackSize());
+        ValueStack* stack = ValueStack::current();
+        ValueStack::Scope scope(stack);
+        newState.m_callerFrame = stack->currentFrame();
+        ValueStack::Frame* frame = stack->pushFrame(nullptr, function, moduleFunction->requiredStackSize());
+
+        if (UNLIKELY(frame == nullptr)) {
+            Trap::throwException(newState, "call stack exhausted");
+        }
+
+        uint8_t* functionStackBase = frame->bp();
 
         for (size_t i = 0; i < parameterOffsetCount; i++) {
             ((size_t*)functionStackBase)[i] = *((size_t*)(bp + offsets[i]));
         }
 
         size_t programCounter = reinterpret_cast<size_t>(moduleFunction->byteCode());
-        StackFrame frame(functionStackBase, moduleFunction->requiredStackSize());
         ByteCodeStackOffset* resultOffsets;
 
 #if defined(WALRUS_ENABLE_JIT)
-        if (moduleFunction->jitFunction() != nullptr) {
-            resultOffsets = moduleFunction->jitFunction()->call(newState, function->instance(), functionStackBase);
+        JITFunction* jitFunction = moduleFunction->jitFunction();
+
+        if (jitFunction != nullptr) {
+            resultOffsets = jitFunction->call(newState, function->instance(), functionStackBase);
         } else
 #endif
         {
+#if defined(WALRUS_ENABLE_JIT)
+            if (UNLIKELY(moduleFunction->countTierUpEvent())) {
+                function->instance()->module()->tierUp(moduleFunction);
+            }
+#endif
+            uint8_t* frameBp = functionStackBase;
+
             while (true) {
                 try {
-                    resultOffsets = interpret(newState, programCounter, frame, function->instance());
+                    resultOffsets = interpret(newState, programCounter, frameBp, function->instance());
                     break;
                 } catch (std::unique_ptr<Exception>& e) {
-                    if (UNLIKELY(!newState.m_currentFunction.hasValue())) {
+                    if (!findCatchBlock(newState, stack, e.get(), programCounter)) {
                         throw std::unique_ptr<Exception>(std::move(e));
                     }
-                    function = newState.m_currentFunction.value()->asDefinedFunction();
-                    moduleFunction = function->moduleFunction();
-                    for (size_t i = e->m_programCounterInfo.size(); i > 0; i--) {
-                        if (e->m_programCounterInfo[i - 1].first == &newState) {
-                            programCounter = e->m_programCounterInfo[i - 1].second;
-                            break;
-                        }
-                    }
-                    if (e->isUserException()) {
-                        bool isCatchSucessful = false;
-                        Tag* tag = e->tag().value();
-                        size_t offset = programCounter - reinterpret_cast<size_t>(moduleFunction->byteCode());
-                        for (const auto& item : moduleFunction->catchInfo()) {
-                            if (item.m_tryStart <= offset && offset < item.m_tryEnd) {
-                                if (item.m_tagIndex == std::numeric_limits<uint32_t>::max() || function->instance()->tag(item.m_tagIndex) == tag) {
-                                    programCounter = item.m_catchStartPosition + reinterpret_cast<size_t>(moduleFunction->byteCode());
-                                    uint8_t* sp = frame.bp() + item.m_stackSizeToBe;
-                                    if (item.m_tagIndex != std::numeric_limits<uint32_t>::max() && tag->functionType()->paramStackSize()) {
-                                        memcpy(sp, e->userExceptionData().data(), tag->functionType()->paramStackSize());
-                                    }
-                                    isCatchSucessful = true;
-                                    break;
-                                }
-                            }
-                        }
-                        if (isCatchSucessful) {
-                            continue;
-                        }
-                    }
-                    throw std::unique_ptr<Exception>(std::move(e));
+                    frameBp = stack->currentFrame()->bp();
+                    function = stack->currentFrame()->function;
                 }
             }
         }
 
         offsets += parameterOffsetCount;
         for (size_t i = 0; i < resultOffsetCount; i++) {
-            *((size_t*)(bp + offsets[i])) = *((size_t*)(frame.bp() + resultOffsets[i]));
+            *((size_t*)(bp + offsets[i])) = *((size_t*)(functionStackBase + resultOffsets[i]));
         }
     }
 
     static ByteCodeStackOffset* interpret(ExecutionState& state,
                                           size_t programCounter,
-                                          StackFrame& frame,
+                                          uint8_t* bp,
                                           Instance* instance);
 
-    static void callOperation(ExecutionState& state,
-                              size_t& programCounter,
-                              uint8_t* bp,
-                              Instance* instance);
+    static bool findCatchBlock(ExecutionState& state,
+                               ValueStack* stack,
+                               Exception* exception,
+                               size_t& programCounter);
+
+    static uint8_t* throwOperation(ExecutionState& state,
+                                   size_t& programCounter,
+                                   uint8_t* bp,
+                                   Instance* instance);
 
-    static void callIndirectOperation(ExecutionState& state,
-                                      size_t& programCounter,
-                                      uint8_t* bp,
-                                      Instance* instance);
+#if defined(WALRUS_ENABLE_JIT)
+    static ByteCodeStackOffset* onStackReplacement(ExecutionState& state,
+                                                   size_t& programCounter,
+                                                   uint8_t* bp,
+                                                   Instance* instance,
+                                                   void* osrEntry);
+#endif
+
+    static uint8_t* enterFunction(ExecutionState& state,
+                                  size_t& programCounter,
+                                  uint8_t* bp,
+                                  DefinedFunction* target,
+                                  ByteCodeStackOffset* offsets,
+                                  uint16_t parameterOffsetCount,
+                                  size_t returnProgramCounter);
+
+    static uint8_t* leaveFunction(ExecutionState& state,
+                                  size_t& programCounter,
+                                  uint8_t* bp,
+                                  ByteCodeStackOffset* resultOffsets);
+
+    static uint8_t* callOperation(ExecutionState& state,
+                                  size_t& programCounter,
+                                  uint8_t* bp,
+                                  Instance* instance);
+
+    static uint8_t* callIndirectOperation(ExecutionState& state,
+                                          size_t& programCounter,
+                                          uint8_t* bp,
+                                          Instance* instance);
 
-    static void callRefOperation(ExecutionState& state,
-                                 size_t& programCounter,
-                                 uint8_t* bp,
-                                 Instance* instance);
+    static uint8_t* callRefOperation(ExecutionState& state,
+                                     size_t& programCounter,
+                                     uint8_t* bp,
+                                     Instance* instance);
 
     static bool tailCallOperation(ExecutionState& state,
                                   size_t& programCounter,
-                                  StackFrame& frame,
+                                  uint8_t* bp,
                                   Instance*& instance,
                                   Function* target,
                                   ByteCodeStackOffset* offsets,
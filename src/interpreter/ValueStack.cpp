@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Walrus.h"
+
+#include "interpreter/ValueStack.h"
+#include "runtime/Function.h"
+#include "runtime/Module.h"
+
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#endif
+
+#ifdef ENABLE_GC
+#include "GCUtil.h"
+#endif /* ENABLE_GC */
+
+namespace Walrus {
+
+MAY_THREAD_LOCAL ValueStack* ValueStack::s_current;
+
+#ifdef ENABLE_GC
+// Protected by the allocation lock of the collector.
+static ValueStack* s_firstStack;
+static GC_push_other_roots_proc s_previousPushOtherRoots;
+static bool s_pushOtherRootsInstalled;
+#endif /* ENABLE_GC */
+
+ValueStack::ValueStack(uint8_t* start)
+    : m_start(start)
+    , m_top(start)
+    , m_committedEnd(start)
+    , m_currentFrame(nullptr)
+#ifdef ENABLE_GC
+    , m_next(nullptr)
+#endif /* ENABLE_GC */
+{
+}
+
+ValueStack* ValueStack::create()
+{
+    // The stack is reused for the lifetime of the thread.
+#if defined(OS_POSIX)
+    // The guard area after the reserved range is never committed.
+    void* start = mmap(NULL, kReservedSize + kGuardSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    RELEASE_ASSERT(start != MAP_FAILED);
+#elif defined(ENABLE_GC)
+    // The frames are scanned by pushRoots.
+    void* start = GC_MALLOC_ATOMIC_UNCOLLECTABLE(kReservedSize);
+    RELEASE_ASSERT(start != nullptr);
+#else
+    void* start = malloc(kReservedSize);
+    RELEASE_ASSERT(start != nullptr);
+#endif
+
+    ValueStack* stack = new ValueStack(reinterpret_cast<uint8_t*>(start));
+#ifdef ENABLE_GC
+    GC_call_with_alloc_lock(registerStack, stack);
+#endif /* ENABLE_GC */
+    return stack;
+}
+
+void ValueStack::releaseCurrent()
+{
+    ValueStack* stack = s_current;
+
+    if (stack == nullptr) {
+        return;
+    }
+
+    ASSERT(stack->m_top == stack->m_start);
+    s_current = nullptr;
+
+#ifdef ENABLE_GC
+    GC_call_with_alloc_lock(unregisterStack, stack);
+#endif /* ENABLE_GC */
+
+#if defined(OS_POSIX)
+    munmap(stack->m_start, kReservedSize + kGuardSize);
+#elif defined(ENABLE_GC)
+    GC_FREE(stack->m_start);
+#else
+    free(stack->m_start);
+#endif
+
+    delete stack;
+}
+
+bool ValueStack::commit(uint8_t* end)
+{
+    uint8_t* reservedEnd = m_start + kReservedSize;
+
+    if (end > reservedEnd) {
+        return false;
+    }
+
+#if defined(OS_POSIX)
+    size_t size = (static_cast<size_t>(end - m_committedEnd) + kCommitSize - 1) & ~(kCommitSize - 1);
+
+    if (size > static_cast<size_t>(reservedEnd - m_committedEnd)) {
+        size = reservedEnd - m_committedEnd;
+    }
+
+    if (mprotect(m_committedEnd, size, (PROT_READ | PROT_WRITE)) != 0) {
+        return false;
+    }
+
+    m_committedEnd += size;
+#else
+    m_committedEnd = reservedEnd;
+#endif
+    return true;
+}
+
+#ifdef ENABLE_GC
+void* ValueStack::registerStack(void* stack)
+{
+    // The callback is installed once, since the list may become
+    // empty when the threads release their stacks.
+    if (!s_pushOtherRootsInstalled) {
+        s_previousPushOtherRoots = GC_get_push_other_roots();
+        GC_set_push_other_roots(pushRoots);
+        s_pushOtherRootsInstalled = true;
+    }
+
+    reinterpret_cast<ValueStack*>(stack)->m_next = s_firstStack;
+    s_firstStack = reinterpret_cast<ValueStack*>(stack);
+    return nullptr;
+}
+
+void* ValueStack::unregisterStack(void* stack)
+{
+    ValueStack** link = &s_firstStack;
+
+    while (*link != stack) {
+        ASSERT(*link != nullptr);
+        link = &(*link)->m_next;
+    }
+
+    *link = reinterpret_cast<ValueStack*>(stack)->m_next;
+    return nullptr;
+}
+
+void ValueStack::pushRoots()
+{
+    for (ValueStack* stack = s_firstStack; stack != nullptr; stack = stack->m_next) {
+        stack->pushFrames();
+    }
+
+    if (s_previousPushOtherRoots != nullptr) {
+        s_previousPushOtherRoots();
+    }
+}
+
+void ValueStack::pushFrames()
+{
+    uint8_t* current = m_start;
+
+    // The frames are contiguous, and the size of a
+    // frame is computed from the size of its function.
+    while (current < m_top) {
+        Frame* frame = reinterpret_cast<Frame*>(current);
+
+        if (frame == m_currentFrame) {
+            break;
+        }
+
+        ModuleFunction* moduleFunction = frame->function->moduleFunction();
+        uint8_t* bp = frame->bp();
+
+        for (const auto& range : moduleFunction->referenceRanges()) {
+            GC_push_all_eager(bp + range.first, bp + range.second);
+        }
+
+        current = bp + alignedSize(moduleFunction->requiredStackSize());
+    }
+
+    // The current frame is scanned conservatively, since it may be
+    // partially initialized, or resized by a tail call.
+    if (current < m_top) {
+        GC_push_all_eager(current, m_top);
+    }
+}
+#endif /* ENABLE_GC */
+
+} // namespace Walrus
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WalrusValueStack__
+#define __WalrusValueStack__
+
+#include "interpreter/ByteCode.h"
+
+#include <atomic>
+
+namespace Walrus {
+
+class DefinedFunction;
+
+// Contiguous per-thread stack of the interpreter frames. Calls between
+// interpreted functions push their frames here instead of recursing on
+// the native stack. The memory is reserved once and committed on demand.
+// When the garbage collector is enabled, the frames are scanned precisely
+// using the reference ranges of their functions, except the current frame
+// which may be partially initialized.
+class ValueStack {
+public:
+    static const size_t kReservedSize = 16 * 1024 * 1024;
+    static const size_t kCommitSize = 64 * 1024;
+    static const size_t kGuardSize = 64 * 1024;
+
+    struct Frame {
+        // Calling frame in the same interpreter loop, nullptr for the first frame.
+        Frame* parent;
+        DefinedFunction* function;
+        // Only valid when parent is not nullptr.
+        size_t returnProgramCounter;
+        ByteCodeStackOffset* resultOffsets;
+
+        uint8_t* bp()
+        {
+            return reinterpret_cast<uint8_t*>(this) + sizeof(Frame);
+        }
+
+        static Frame* fromBP(uint8_t* bp)
+        {
+            return reinterpret_cast<Frame*>(bp - sizeof(Frame));
+        }
+    };
+
+    static_assert(sizeof(Frame) % 16 == 0, "Frame must keep the values aligned");
+
+    // Saves the stack state, and restores it when a call of the
+    // interpreter returns or is unwound by an exception.
+    class Scope {
+        MAKE_STACK_ALLOCATED();
+
+    public:
+        Scope(ValueStack* stack)
+            : m_stack(stack)
+            , m_top(stack->m_top)
+            , m_currentFrame(stack->m_currentFrame)
+        {
+        }
+
+        ~Scope()
+        {
+            m_stack->m_top = m_top;
+            m_stack->m_currentFrame = m_currentFrame;
+        }
+
+    private:
+        ValueStack* m_stack;
+        uint8_t* m_top;
+        Frame* m_currentFrame;
+    };
+
+    static ValueStack* current()
+    {
+        if (UNLIKELY(s_current == nullptr)) {
+            s_current = create();
+        }
+        return s_current;
+    }
+
+    // Frees the stack of the current thread before the thread exits.
+    // The thread must not have frames on the stack.
+    static void releaseCurrent();
+
+    // Does not create the stack, so it can be used by signal handlers.
+    static ValueStack* currentIfExists()
+    {
+        return s_current;
+    }
+
+    static size_t alignedSize(size_t size)
+    {
+        return (size + 15) & ~static_cast<size_t>(15);
+    }
+
+    Frame* currentFrame() const { return m_currentFrame; }
+
+    // Returns with nullptr when the stack is exhausted.
+    ALWAYS_INLINE Frame* pushFrame(Frame* parent, DefinedFunction* function, size_t stackSize)
+    {
+        size_t frameSize = sizeof(Frame) + alignedSize(stackSize);
+
+        if (UNLIKELY(frameSize > static_cast<size_t>(m_committedEnd - m_top)) && !commit(m_top + frameSize)) {
+            return nullptr;
+        }
+
+        Frame* frame = reinterpret_cast<Frame*>(m_top);
+        frame->parent = parent;
+        frame->function = function;
+        m_top += frameSize;
+        // The profiler may walk the frames from a signal handler.
+        std::atomic_signal_fence(std::memory_order_release);
+        m_currentFrame = frame;
+        return frame;
+    }
+
+    ALWAYS_INLINE void popFrame(Frame* frame)
+    {
+        ASSERT(frame == m_currentFrame && frame->parent != nullptr);
+        m_top = reinterpret_cast<uint8_t*>(frame);
+        m_currentFrame = frame->parent;
+    }
+
+    // Changes the size of the current frame, used by tail calls.
+    bool resizeFrame(Frame* frame, size_t stackSize)
+    {
+        ASSERT(frame == m_currentFrame);
+        uint8_t* end = frame->bp() + alignedSize(stackSize);
+
+        if (UNLIKELY(end > m_committedEnd) && !commit(end)) {
+            return false;
+        }
+
+        m_top = end;
+        return true;
+    }
+
+    // Drops the frames above the frame, used by exception handling.
+    void unwindTo(Frame* frame, size_t stackSize)
+    {
+        m_top = frame->bp() + alignedSize(stackSize);
+        m_currentFrame = frame;
+    }
+
+private:
+    ValueStack(uint8_t* start);
+
+    static ValueStack* create();
+    bool commit(uint8_t* end);
+
+#ifdef ENABLE_GC
+    static void* registerStack(void* stack);
+    static void* unregisterStack(void* stack);
+    static void pushRoots();
+    void pushFrames();
+#endif
+
+    static MAY_THREAD_LOCAL ValueStack* s_current;
+
+    uint8_t* m_start;
+    uint8_t* m_top;
+    uint8_t* m_committedEnd;
+    Frame* m_currentFrame;
+#ifdef ENABLE_GC
+    // All stacks are linked, since the collector scans the frames of every thread.
+    ValueStack* m_next;
+#endif
+};
+
+} // namespace Walrus
+
+#endif // __WalrusValueStack__
@@ -20,107 +20,221 @@
 #include "jit/Compiler.h"
 #include "runtime/GCArray.h"
 
-#include <set>
+#include <algorithm>
 
 namespace Walrus {
 
+// The instruction list is split into blocks: the first block starts at the
+// beginning of the function, and every label starts a new block. Instead of
+// tracking the dependencies of all stack slots for every label, only the
+// assignments of the blocks and the edges between the blocks are recorded.
+// The values of the labels are computed later, and only for those slots
+// which are read before they are assigned in a block. Hence the memory
+// consumption and the compilation time do not depend on the number of
+// labels multiplied by the frame size.
 struct DependencyGenContext {
     enum Type : VariableRef {
-        // Label must be 0, since labels are pointers.
+        // Operand refers to a Reference.
         Label = Instruction::ConstPtr,
         Variable = Instruction::Register,
     };
 
-    // Also uses: VariableList::kConstraints.
-    static const uint8_t kOptReferenced = 1 << 0;
-    static const uint8_t kOptDependencyComputed = 1 << 1;
-
     static const VariableRef kNoRef = ~(VariableRef)0;
 
-    typedef std::set<VariableRef> DependencyList;
+    struct Assignment {
+        Assignment(uint32_t slot, VariableRef ref)
+            : slot(slot)
+            , ref(ref)
+        {
+        }
 
-    DependencyGenContext(size_t dependencySize, size_t requiredStackSize)
-    {
-        currentDependencies.resize(requiredStackSize);
-        currentOptions.resize(requiredStackSize);
+        uint32_t slot;
+        // Zero for the upper parts of 64 and 128 bit values.
+        VariableRef ref;
+    };
+
+    struct Edge {
+        Edge(uint32_t target, uint32_t source, uint32_t assignmentEnd, uint32_t callbackStamp,
+             uint32_t destroysR0R1Stamp, uint32_t excludeStart, uint32_t excludeEnd)
+            : target(target)
+            , source(source)
+            , assignmentEnd(assignmentEnd)
+            , callbackStamp(callbackStamp)
+            , destroysR0R1Stamp(destroysR0R1Stamp)
+            , excludeStart(excludeStart)
+            , excludeEnd(excludeEnd)
+        {
+        }
+
+        uint32_t target;
+        uint32_t source;
+        // Assignments of the source block before the jump.
+        uint32_t assignmentEnd;
+        uint32_t callbackStamp;
+        uint32_t destroysR0R1Stamp;
+        // Slots defined by the catch block.
+        uint32_t excludeStart;
+        uint32_t excludeEnd;
+    };
 
-        if (dependencySize == 0) {
-            // No labels in the code.
-            return;
+    struct CatchParam {
+        CatchParam(uint32_t block, uint32_t slot, VariableRef ref)
+            : block(block)
+            , slot(slot)
+            , ref(ref)
+        {
         }
 
-        ASSERT((dependencySize % requiredStackSize) == 0);
+        uint32_t block;
+        uint32_t slot;
+        VariableRef ref;
+    };
+
+    // A slot of a label read by an instruction.
+    struct Reference {
+        Reference(uint32_t block, uint32_t slot)
+            : block(block)
+            , slot(slot)
+            , options(0)
+            , result(0)
+        {
+        }
+
+        uint32_t block;
+        uint32_t slot;
+        uint8_t options;
+        // Component index during the computation, variable index afterwards.
+        VariableRef result;
+    };
+
+    struct Component {
+        Component(uint32_t parent)
+            : parent(parent)
+            , options(0)
+            , rangeStart(VariableList::kRangeMax)
+            , rangeEnd(0)
+            , result(kNoRef)
+        {
+        }
+
+        uint32_t parent;
+        uint8_t options;
+        size_t rangeStart;
+        size_t rangeEnd;
+        VariableRef result;
+    };
+
+    DependencyGenContext(size_t blockCount, size_t requiredStackSize)
+        : currentBlock(0)
+        , callbackStamp(0)
+        , destroysR0R1Stamp(0)
+    {
+        labels.resize(blockCount);
+        maxDistance.resize(blockCount);
+        assignmentStart.resize(blockCount + 1);
+        currentRefs.resize(requiredStackSize);
+        currentStamps.resize(requiredStackSize);
+        currentReferences.resize(requiredStackSize);
+    }
+
+    static uint8_t options(uint32_t base, uint32_t callbackStamp, uint32_t destroysR0R1Stamp)
+    {
+        return ((callbackStamp > base) ? VariableList::kIsCallback : 0)
+            | ((destroysR0R1Stamp > base) ? VariableList::kDestroysR0R1 : 0);
+    }
+
+    bool isAssigned(size_t slot)
+    {
+        return currentBlock == 0 || currentStamps[slot] > assignmentStart[currentBlock];
+    }
+
+    uint8_t currentOptions(size_t slot)
+    {
+        return options(std::max(currentStamps[slot], assignmentStart[currentBlock]), callbackStamp, destroysR0R1Stamp);
+    }
+
+    void startBlock(uint32_t block)
+    {
+        currentBlock = block;
+        assignmentStart[block] = static_cast<uint32_t>(assignments.size());
+        callbackStamp = 0;
+        destroysR0R1Stamp = 0;
+    }
 
-        dependencies.resize(dependencySize);
-        options.resize(dependencySize);
-        maxDistance.resize(dependencySize / requiredStackSize);
+    void addEdge(uint32_t target, uint32_t excludeStart = 0, uint32_t excludeEnd = 0)
+    {
+        edges.push_back(Edge(target, currentBlock, static_cast<uint32_t>(assignments.size()),
+                             callbackStamp, destroysR0R1Stamp, excludeStart, excludeEnd));
     }
 
-    void update(size_t dependencyStart, size_t id);
-    void update(size_t dependencyStart, size_t id, size_t excludeStart, const TypeVector& param, VariableList* variableList);
+    void update(uint32_t block, size_t id);
+    void update(uint32_t block, size_t id, size_t excludeStart, const TypeVector& param, VariableList* variableList);
     void updateWithGetter(VariableList* variableList, VariableRef ref, Instruction* getter);
     void assignReference(VariableRef ref, size_t offset, uint32_t typeInfo);
+    size_t reference(size_t slot);
 
-    std::vector<DependencyList> dependencies;
-    std::vector<uint8_t> options;
+    void buildEdges();
+    VariableRef findAssignment(uint32_t block, uint32_t slot, uint32_t end, uint32_t& stamp);
+    uint32_t findComponent(uint32_t component);
+    void visitBlock(uint32_t block, uint32_t component, uint32_t slot);
+    void computeReferences(VariableList* variableList);
+
+    // Per block data.
+    std::vector<Walrus::Label*> labels;
     std::vector<size_t> maxDistance;
-    std::vector<VariableRef> currentDependencies;
-    std::vector<uint8_t> currentOptions;
+    std::vector<uint32_t> assignmentStart;
+    std::vector<uint32_t> edgeStart;
+    std::vector<uint32_t> catchParamStart;
+    std::vector<uint32_t> visited;
+    std::vector<uint32_t> blockComponents;
+
+    std::vector<Assignment> assignments;
+    std::vector<uint32_t> sortedAssignments;
+    std::vector<Edge> edges;
+    std::vector<CatchParam> catchParams;
+    std::vector<Reference> references;
+    std::vector<Component> components;
+    std::vector<std::pair<uint32_t, VariableRef>> componentVariables;
+    std::vector<uint32_t> unprocessedBlocks;
+
+    // State of the current block. The stamps are the number
+    // of assignments plus one when the slot / constraint is
+    // updated, so they can be compared to assignmentStart.
+    uint32_t currentBlock;
+    uint32_t callbackStamp;
+    uint32_t destroysR0R1Stamp;
+    std::vector<VariableRef> currentRefs;
+    std::vector<uint32_t> currentStamps;
+    std::vector<uint32_t> currentReferences;
 };
 
-void DependencyGenContext::update(size_t dependencyStart, size_t id)
+void DependencyGenContext::update(uint32_t block, size_t id)
 {
-    size_t size = currentDependencies.size();
-
-    ASSERT(dependencyStart + size <= dependencies.size()
-           && (dependencyStart % size) == 0
-           && maxDistance[dependencyStart / size] <= id);
-
-    maxDistance[dependencyStart / size] = id;
-
-    for (size_t i = 0; i < size; i++) {
-        VariableRef ref = currentDependencies[i];
+    ASSERT(maxDistance[block] <= id);
 
-        if (ref != 0) {
-            dependencies[dependencyStart + i].insert(currentDependencies[i]);
-            options[dependencyStart + i] |= currentOptions[i] & VariableList::kConstraints;
-        }
-    }
+    maxDistance[block] = id;
+    addEdge(block);
 }
 
-void DependencyGenContext::update(size_t dependencyStart, size_t id, size_t excludeStart, const TypeVector& param, VariableList* variableList)
+void DependencyGenContext::update(uint32_t block, size_t id, size_t excludeStart, const TypeVector& param, VariableList* variableList)
 {
-    size_t size = currentDependencies.size();
     size_t offset = excludeStart;
 
-    ASSERT(dependencyStart + size <= dependencies.size()
-           && (dependencyStart % size) == 0
-           && maxDistance[dependencyStart / size] <= id);
+    ASSERT(maxDistance[block] <= id);
 
     for (auto it : param.types()) {
         if (variableList != nullptr) {
             // Construct new variables.
             VariableRef ref = variableList->variables.size();
 
-            dependencies[dependencyStart + offset].insert(VARIABLE_SET(ref, Variable));
+            catchParams.push_back(CatchParam(block, static_cast<uint32_t>(offset), ref));
             variableList->variables.push_back(VariableList::Variable(VARIABLE_SET(offset, Instruction::Offset), 0, id));
         }
 
         offset += STACK_OFFSET(valueStackAllocatedSize(it));
     }
 
-    for (size_t i = 0; i < size; i++) {
-        if (i >= excludeStart && i < offset) {
-            continue;
-        }
-
-        VariableRef ref = currentDependencies[i];
-
-        if (ref != 0) {
-            dependencies[dependencyStart + i].insert(currentDependencies[i]);
-            options[dependencyStart + i] |= currentOptions[i] & VariableList::kConstraints;
-        }
-    }
+    addEdge(block, static_cast<uint32_t>(excludeStart), static_cast<uint32_t>(offset));
 }
 
 void DependencyGenContext::updateWithGetter(VariableList* variableList, VariableRef ref, Instruction* getter)
@@ -131,7 +245,7 @@ void DependencyGenContext::updateWithGetter(VariableList* variableList, Variable
         return;
     }
 
-    variable.info |= currentOptions[VARIABLE_GET_REF(variable.value)] & VariableList::kConstraints;
+    variable.info |= currentOptions(VARIABLE_GET_REF(variable.value)) & VariableList::kConstraints;
 
     if (getter->id() < variable.u.rangeStart) {
         variable.u.rangeStart = getter->id();
@@ -142,52 +256,220 @@ void DependencyGenContext::updateWithGetter(VariableList* variableList, Variable
 
 void DependencyGenContext::assignReference(VariableRef ref, size_t offset, uint32_t typeInfo)
 {
+    size_t count = 1;
+
     switch (typeInfo) {
     case Instruction::Int64Operand:
     case Instruction::Float64Operand:
-        currentDependencies[offset + 1] = 0;
-        currentOptions[offset + 1] = 0;
+        count = 2;
         break;
 
     case Instruction::V128Operand:
-        currentDependencies[offset + 1] = 0;
-        currentOptions[offset + 1] = 0;
-        currentDependencies[offset + 2] = 0;
-        currentOptions[offset + 2] = 0;
-        currentDependencies[offset + 3] = 0;
-        currentOptions[offset + 3] = 0;
+        count = 4;
         break;
     }
 
-    currentDependencies[offset] = ref;
-    currentOptions[offset] = 0;
+    for (size_t i = 0; i < count; i++) {
+        currentRefs[offset + i] = (i == 0) ? ref : 0;
+        assignments.push_back(Assignment(static_cast<uint32_t>(offset + i), currentRefs[offset + i]));
+        currentStamps[offset + i] = static_cast<uint32_t>(assignments.size());
+    }
+}
+
+size_t DependencyGenContext::reference(size_t slot)
+{
+    uint32_t index = currentReferences[slot];
+
+    if (index == 0 || references[index - 1].block != currentBlock) {
+        references.push_back(Reference(currentBlock, static_cast<uint32_t>(slot)));
+        index = static_cast<uint32_t>(references.size());
+        currentReferences[slot] = index;
+    }
+
+    references[index - 1].options |= currentOptions(slot);
+    return index - 1;
+}
+
+void DependencyGenContext::buildEdges()
+{
+    size_t blockCount = labels.size();
+
+    assignmentStart[blockCount] = static_cast<uint32_t>(assignments.size());
+
+    // Sort the assignments of each block by slots, so the
+    // last assignment of a slot can be found by binary search.
+    sortedAssignments.resize(assignments.size());
+
+    for (size_t i = 0; i < assignments.size(); i++) {
+        sortedAssignments[i] = static_cast<uint32_t>(i);
+    }
+
+    for (size_t i = 0; i < blockCount; i++) {
+        std::sort(sortedAssignments.begin() + assignmentStart[i], sortedAssignments.begin() + assignmentStart[i + 1],
+                  [this](uint32_t a, uint32_t b) {
+                      return assignments[a].slot < assignments[b].slot || (assignments[a].slot == assignments[b].slot && a < b);
+                  });
+    }
+
+    // Group the edges and catch parameters by their target blocks.
+    edgeStart.assign(blockCount + 1, 0);
+    catchParamStart.assign(blockCount + 1, 0);
+
+    for (auto& it : edges) {
+        edgeStart[it.target + 1]++;
+    }
+
+    for (auto& it : catchParams) {
+        catchParamStart[it.block + 1]++;
+    }
+
+    for (size_t i = 0; i < blockCount; i++) {
+        edgeStart[i + 1] += edgeStart[i];
+        catchParamStart[i + 1] += catchParamStart[i];
+    }
+
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.target < b.target; });
+    std::stable_sort(catchParams.begin(), catchParams.end(), [](const CatchParam& a, const CatchParam& b) { return a.block < b.block; });
+
+    visited.assign(blockCount, 0);
+    blockComponents.resize(blockCount);
 }
 
-static bool checkSameConst(VariableList* variableList, std::set<VariableRef>& dependencies)
+VariableRef DependencyGenContext::findAssignment(uint32_t block, uint32_t slot, uint32_t end, uint32_t& stamp)
 {
-    VariableRef constRef = 0;
+    auto begin = sortedAssignments.begin() + assignmentStart[block];
+    auto it = std::lower_bound(begin, sortedAssignments.begin() + assignmentStart[block + 1], end,
+                               [this, slot](uint32_t index, uint32_t end) {
+                                   return assignments[index].slot < slot || (assignments[index].slot == slot && index < end);
+                               });
+
+    if (it == begin || assignments[*(it - 1)].slot != slot) {
+        stamp = assignmentStart[block];
+        return kNoRef;
+    }
+
+    stamp = *(it - 1) + 1;
+    return assignments[*(it - 1)].ref;
+}
+
+uint32_t DependencyGenContext::findComponent(uint32_t component)
+{
+    while (components[component].parent != component) {
+        uint32_t parent = components[component].parent;
+
+        components[component].parent = components[parent].parent;
+        component = parent;
+    }
+
+    return component;
+}
+
+void DependencyGenContext::visitBlock(uint32_t block, uint32_t component, uint32_t slot)
+{
+    // The component must be a root during the visit.
+    ASSERT(components[component].parent == component && visited[block] != slot + 1);
+
+    visited[block] = slot + 1;
+    blockComponents[block] = component;
+    unprocessedBlocks.push_back(block);
+
+    while (!unprocessedBlocks.empty()) {
+        block = unprocessedBlocks.back();
+        unprocessedBlocks.pop_back();
+
+        Component& current = components[component];
+
+        if (current.rangeStart > labels[block]->id()) {
+            current.rangeStart = labels[block]->id();
+        }
+
+        if (current.rangeEnd < maxDistance[block]) {
+            current.rangeEnd = maxDistance[block];
+        }
+
+        for (uint32_t i = catchParamStart[block]; i < catchParamStart[block + 1]; i++) {
+            if (catchParams[i].slot == slot) {
+                componentVariables.push_back(std::make_pair(component, catchParams[i].ref));
+            }
+        }
+
+        for (uint32_t i = edgeStart[block]; i < edgeStart[block + 1]; i++) {
+            Edge& edge = edges[i];
+
+            if (slot >= edge.excludeStart && slot < edge.excludeEnd) {
+                continue;
+            }
+
+            uint32_t stamp;
+            VariableRef ref = findAssignment(edge.source, slot, edge.assignmentEnd, stamp);
+
+            if (ref == 0) {
+                continue;
+            }
+
+            components[component].options |= options(stamp, edge.callbackStamp, edge.destroysR0R1Stamp);
+
+            if (ref != kNoRef) {
+                ASSERT(VARIABLE_TYPE(ref) == Variable);
+                componentVariables.push_back(std::make_pair(component, VARIABLE_GET_REF(ref)));
+                continue;
+            }
+
+            if (edge.source == 0) {
+                // Initial value of the slot.
+                componentVariables.push_back(std::make_pair(component, static_cast<VariableRef>(slot)));
+                continue;
+            }
+
+            if (visited[edge.source] != slot + 1) {
+                visited[edge.source] = slot + 1;
+                blockComponents[edge.source] = component;
+                unprocessedBlocks.push_back(edge.source);
+                continue;
+            }
+
+            // Values flowing into the same label are merged.
+            uint32_t other = findComponent(blockComponents[edge.source]);
+
+            if (other != component) {
+                Component& head = components[component];
+                Component& otherComponent = components[other];
+
+                otherComponent.parent = component;
+                head.options |= otherComponent.options;
+
+                if (head.rangeStart > otherComponent.rangeStart) {
+                    head.rangeStart = otherComponent.rangeStart;
+                }
+
+                if (head.rangeEnd < otherComponent.rangeEnd) {
+                    head.rangeEnd = otherComponent.rangeEnd;
+                }
+            }
+        }
+    }
+}
+
+static VariableRef checkSameConst(VariableList* variableList, const std::pair<uint32_t, VariableRef>* begin,
+                                  const std::pair<uint32_t, VariableRef>* end)
+{
+    VariableRef constRef = DependencyGenContext::kNoRef;
     Instruction* constInstr = nullptr;
     uint32_t value32 = 0;
     uint32_t value64 = 0;
     const uint8_t* value128 = nullptr;
 
-    for (auto it : dependencies) {
-        if (VARIABLE_TYPE(it) == DependencyGenContext::Label) {
-            continue;
-        }
-
-        ASSERT(VARIABLE_TYPE(it) == DependencyGenContext::Variable);
-
-        VariableList::Variable& variable = variableList->variables[VARIABLE_GET_REF(it)];
+    for (const std::pair<uint32_t, VariableRef>* it = begin; it < end; it++) {
+        VariableList::Variable& variable = variableList->variables[it->second];
 
         if (!(variable.info & VariableList::kIsImmediate)) {
-            return false;
+            return DependencyGenContext::kNoRef;
         }
 
         Instruction* instr = variable.u.immediate;
 
         if (constInstr == nullptr) {
-            constRef = it;
+            constRef = it->second;
             constInstr = instr;
 
             switch (constInstr->opcode()) {
@@ -210,26 +492,24 @@ static bool checkSameConst(VariableList* variableList, std::set<VariableRef>& de
         switch (constInstr->opcode()) {
         case ByteCode::Const32Opcode:
             if (reinterpret_cast<Const32*>(instr->byteCode())->value() != value32) {
-                return false;
+                return DependencyGenContext::kNoRef;
             }
             break;
         case ByteCode::Const64Opcode:
             if (reinterpret_cast<Const64*>(instr->byteCode())->value() != value64) {
-                return false;
+                return DependencyGenContext::kNoRef;
             }
             break;
         default:
             ASSERT(constInstr->opcode() == ByteCode::Const128Opcode);
             if (memcmp(reinterpret_cast<Const128*>(instr->byteCode())->value(), value128, 16) != 0) {
-                return false;
+                return DependencyGenContext::kNoRef;
             }
             break;
         }
     }
 
-    dependencies.clear();
-    dependencies.insert(constRef);
-    return true;
+    return constRef;
 }
 
 static VariableRef mergeVariables(VariableList* variableList, VariableRef head, VariableRef other)
@@ -276,7 +556,97 @@ static VariableRef mergeVariables(VariableList* variableList, VariableRef head,
     return head;
 }
 
-#define VARIABLE_GET_LABEL(v) (reinterpret_cast<InstructionListItem*>(v)->asLabel())
+void DependencyGenContext::computeReferences(VariableList* variableList)
+{
+    std::vector<uint32_t> order(references.size());
+
+    for (size_t i = 0; i < references.size(); i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return references[a].slot < references[b].slot || (references[a].slot == references[b].slot && a < b);
+    });
+
+    size_t next = 0;
+
+    while (next < order.size()) {
+        uint32_t slot = references[order[next]].slot;
+        size_t groupStart = next;
+
+        components.clear();
+        componentVariables.clear();
+
+        // Each slot is processed separately: the labels which are reachable
+        // backwards from the referenced labels without passing through an
+        // assignment of the slot form connected components. All variables
+        // of a component are merged into a single variable.
+        for (; next < order.size() && references[order[next]].slot == slot; next++) {
+            Reference& reference = references[order[next]];
+
+            if (visited[reference.block] != slot + 1) {
+                uint32_t component = static_cast<uint32_t>(components.size());
+
+                components.push_back(Component(component));
+                visitBlock(reference.block, component, slot);
+            }
+
+            uint32_t component = findComponent(blockComponents[reference.block]);
+            components[component].options |= reference.options;
+            reference.result = component;
+        }
+
+        for (auto& it : componentVariables) {
+            it.first = findComponent(it.first);
+        }
+
+        std::sort(componentVariables.begin(), componentVariables.end());
+
+        const std::pair<uint32_t, VariableRef>* variables = componentVariables.data();
+        const std::pair<uint32_t, VariableRef>* variablesEnd = variables + componentVariables.size();
+
+        while (variables < variablesEnd) {
+            const std::pair<uint32_t, VariableRef>* end = variables + 1;
+
+            while (end < variablesEnd && end->first == variables->first) {
+                end++;
+            }
+
+            Component& component = components[variables->first];
+            component.result = checkSameConst(variableList, variables, end);
+
+            if (component.result == kNoRef) {
+                VariableRef headRef = variableList->getMergeHead(variables->second);
+
+                for (const std::pair<uint32_t, VariableRef>* it = variables + 1; it < end; it++) {
+                    headRef = mergeVariables(variableList, headRef, it->second);
+                }
+
+                VariableList::Variable& variable = variableList->variables[headRef];
+                variable.info |= component.options & VariableList::kConstraints;
+
+                if (variable.u.rangeStart > component.rangeStart) {
+                    variable.u.rangeStart = component.rangeStart;
+                }
+
+                if (variable.rangeEnd < component.rangeEnd) {
+                    variable.rangeEnd = component.rangeEnd;
+                }
+
+                component.result = headRef;
+            }
+
+            variables = end;
+        }
+
+        for (size_t i = groupStart; i < next; i++) {
+            Reference& reference = references[order[i]];
+            reference.result = components[findComponent(static_cast<uint32_t>(reference.result))].result;
+
+            ASSERT(reference.result != kNoRef);
+        }
+    }
+}
 
 void JITCompiler::buildVariables(uint32_t requiredStackSize)
 {
@@ -288,7 +658,7 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
                   "Coverting Int64Operand to Float64Operand should be possible");
 
     size_t variableCount = requiredStackSize;
-    size_t dependencySize = 0;
+    size_t blockCount = 1;
     size_t nextId = 0;
     size_t nextTryBlock = m_tryBlockStart;
 
@@ -299,8 +669,7 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
         if (item->isLabel()) {
             Label* label = item->asLabel();
 
-            label->m_dependencyStart = dependencySize;
-            dependencySize += requiredStackSize;
+            label->m_blockIndex = blockCount++;
 
             if (label->info() & Label::kHasTryInfo) {
                 ASSERT(tryBlocks()[nextTryBlock].start == label);
@@ -326,17 +695,17 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
         return;
     }
 
-    DependencyGenContext dependencyCtx(dependencySize, requiredStackSize);
+    DependencyGenContext dependencyCtx(blockCount, requiredStackSize);
     bool updateDeps = true;
     std::vector<size_t> activeTryBlocks;
+    std::vector<size_t> lastBranches(blockCount, 0);
 
     m_variableList = new VariableList(variableCount, requiredStackSize);
     nextTryBlock = m_tryBlockStart;
 
     for (uint32_t i = 0; i < requiredStackSize; i++) {
         m_variableList->variables.push_back(VariableList::Variable(VARIABLE_SET(i, Instruction::Offset), 0, static_cast<size_t>(0)));
-        dependencyCtx.currentDependencies[i] = VARIABLE_SET(i, DependencyGenContext::Variable);
-        dependencyCtx.currentOptions[i] = 0;
+        dependencyCtx.currentRefs[i] = VARIABLE_SET(i, DependencyGenContext::Variable);
     }
 
     const TypeVector::Types& paramTypeInfo = moduleFunction()->functionType()->param().types();
@@ -347,17 +716,20 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
         offsetIndex += STACK_OFFSET(valueStackAllocatedSize(paramTypeInfo[i]));
     }
 
-    // Phase 1: the direct dependencies are computed for instructions
-    // and labels (only labels can have multiple dependencies).
+    // Phase 1: the assignments of the blocks and the edges
+    // between the blocks are recorded. Operands which read
+    // a value of a label are converted to References.
     for (InstructionListItem* item = m_first; item != nullptr; item = item->next()) {
         if (item->isLabel()) {
-            // Build a dependency list which refers to the last label.
             Label* label = item->asLabel();
+            uint32_t block = static_cast<uint32_t>(label->m_blockIndex);
+
+            dependencyCtx.labels[block] = label;
 
             if (updateDeps) {
-                dependencyCtx.update(label->m_dependencyStart, label->id());
+                dependencyCtx.update(block, label->id());
             } else {
-                dependencyCtx.maxDistance[label->m_dependencyStart / requiredStackSize] = label->id();
+                dependencyCtx.maxDistance[block] = label->id();
             }
 
             if (label->info() & Label::kHasTryInfo) {
@@ -367,7 +739,7 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
                     for (auto it : tryBlocks()[nextTryBlock].catchBlocks) {
                         // Forward jump.
                         if (it.tagIndex == std::numeric_limits<uint32_t>::max()) {
-                            dependencyCtx.update(it.u.handler->m_dependencyStart, label->id());
+                            dependencyCtx.update(it.u.handler->m_blockIndex, label->id());
                         } else {
                             TagType* tagType = module()->tagType(it.tagIndex);
                             const TypeVector& param = tagType->functionType()->param();
@@ -375,7 +747,7 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
 
                             m_variableList->pushCatchUpdate(catchLabel, param.size());
 
-                            dependencyCtx.update(catchLabel->m_dependencyStart, catchLabel->id(),
+                            dependencyCtx.update(catchLabel->m_blockIndex, catchLabel->id(),
                                                  STACK_OFFSET(it.stackSizeToBe), param, m_variableList);
                         }
                     }
@@ -390,11 +762,7 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
                 activeTryBlocks.pop_back();
             }
 
-            for (size_t i = 0; i < requiredStackSize; ++i) {
-                dependencyCtx.currentDependencies[i] = VARIABLE_SET_PTR(label);
-                dependencyCtx.currentOptions[i] = 0;
-            }
-
+            dependencyCtx.startBlock(block);
             updateDeps = true;
             continue;
         }
@@ -404,16 +772,15 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
         Operand* end = operand + instr->paramCount();
 
         while (operand < end) {
-            VariableRef ref = dependencyCtx.currentDependencies[*operand];
+            VariableRef ref;
 
-            if (VARIABLE_TYPE(ref) == DependencyGenContext::Label) {
-                size_t offset = VARIABLE_GET_LABEL(ref)->m_dependencyStart + *operand;
-                dependencyCtx.options[offset] |= DependencyGenContext::kOptReferenced | (dependencyCtx.currentOptions[*operand] & VariableList::kConstraints);
+            if (dependencyCtx.isAssigned(*operand)) {
+                ref = dependencyCtx.currentRefs[*operand];
 
-                ref = VARIABLE_SET(*operand, DependencyGenContext::Label);
-            } else {
                 ASSERT(VARIABLE_TYPE(ref) == DependencyGenContext::Variable);
                 dependencyCtx.updateWithGetter(m_variableList, VARIABLE_GET_REF(ref), instr);
+            } else {
+                ref = VARIABLE_SET(dependencyCtx.reference(*operand), DependencyGenContext::Label);
             }
 
             *operand++ = ref;
@@ -421,7 +788,7 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
 
         if (instr->group() == Instruction::DirectBranch) {
             Label* label = instr->asExtended()->value().targetLabel;
-            dependencyCtx.update(label->m_dependencyStart, instr->id());
+            dependencyCtx.update(label->m_blockIndex, instr->id());
 
             if (instr->opcode() == ByteCode::JumpOpcode) {
                 updateDeps = false;
@@ -432,11 +799,11 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
         if (instr->group() == Instruction::BrTable) {
             Label** label = instr->asBrTable()->targetLabels();
             Label** end = label + instr->asBrTable()->targetLabelCount();
-            std::set<Label*> updatedLabels;
 
             while (label < end) {
-                if (updatedLabels.insert(*label).second) {
-                    dependencyCtx.update((*label)->m_dependencyStart, instr->id());
+                if (lastBranches[(*label)->m_blockIndex] != instr->id()) {
+                    lastBranches[(*label)->m_blockIndex] = instr->id();
+                    dependencyCtx.update((*label)->m_blockIndex, instr->id());
                 }
                 label++;
             }
@@ -451,13 +818,13 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
             for (auto blockIt : activeTryBlocks) {
                 for (auto it : tryBlocks()[blockIt].catchBlocks) {
                     if (it.tagIndex == std::numeric_limits<uint32_t>::max()) {
-                        dependencyCtx.update(it.u.handler->m_dependencyStart, instr->id());
+                        dependencyCtx.update(it.u.handler->m_blockIndex, instr->id());
                     } else {
                         TagType* tagType = module()->tagType(it.tagIndex);
                         const TypeVector& param = tagType->functionType()->param();
                         Label* catchLabel = it.u.handler;
 
-                        dependencyCtx.update(catchLabel->m_dependencyStart, catchLabel->id(),
+                        dependencyCtx.update(catchLabel->m_blockIndex, catchLabel->id(),
                                              STACK_OFFSET(it.stackSizeToBe), param, nullptr);
                     }
                 }
@@ -471,15 +838,11 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
         }
 
         if (instr->info() & Instruction::kIsCallback) {
-            for (size_t i = 0; i < requiredStackSize; i++) {
-                dependencyCtx.currentOptions[i] |= VariableList::kIsCallback;
-            }
+            dependencyCtx.callbackStamp = static_cast<uint32_t>(dependencyCtx.assignments.size() + 1);
         }
 
         if (instr->info() & Instruction::kDestroysR0R1) {
-            for (size_t i = 0; i < requiredStackSize; i++) {
-                dependencyCtx.currentOptions[i] |= VariableList::kDestroysR0R1;
-            }
+            dependencyCtx.destroysR0R1Stamp = static_cast<uint32_t>(dependencyCtx.assignments.size() + 1);
         }
 
         uint32_t resultCount = instr->resultCount();
@@ -551,117 +914,13 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
     ASSERT(variableCount == m_variableList->variables.size());
     ASSERT(activeTryBlocks.size() == 0);
 
-    // Phase 2: the indirect instruction
-    // references are computed for labels.
-
-    for (InstructionListItem* item = m_first; item != nullptr; item = item->next()) {
-        if (!item->isLabel()) {
-            continue;
-        }
-
-        Label* currentLabel = item->asLabel();
-        size_t dependencyStart = currentLabel->m_dependencyStart;
-
-        // Compute the required size first
-        size_t end = dependencyStart + requiredStackSize;
-
-        for (uint32_t i = dependencyStart; i < end; ++i) {
-            ASSERT(!(dependencyCtx.options[i] & DependencyGenContext::kOptDependencyComputed));
-
-            if (!(dependencyCtx.options[i] & DependencyGenContext::kOptReferenced)) {
-                continue;
-            }
-
-            std::vector<Label*> unprocessedLabels;
-            std::set<VariableRef>& dependencies = dependencyCtx.dependencies[i];
-
-            for (auto it : dependencies) {
-                if (VARIABLE_TYPE(it) == DependencyGenContext::Label) {
-                    unprocessedLabels.push_back(VARIABLE_GET_LABEL(it));
-                }
-            }
-
-            while (!unprocessedLabels.empty()) {
-                Label* label = unprocessedLabels.back();
-                std::set<VariableRef>& list = dependencyCtx.dependencies[i - dependencyStart + label->m_dependencyStart];
-
-                unprocessedLabels.pop_back();
-
-                for (auto it : list) {
-                    if (dependencies.insert(it).second) {
-                        if (VARIABLE_TYPE(it) == DependencyGenContext::Label) {
-                            unprocessedLabels.push_back(VARIABLE_GET_LABEL(it));
-                        }
-                    }
-                }
-            }
-
-            dependencyCtx.options[i] |= DependencyGenContext::kOptDependencyComputed;
-
-            // Compute variable dependencies.
-            if (checkSameConst(m_variableList, dependencies)) {
-                continue;
-            }
-
-            VariableRef headRef = DependencyGenContext::kNoRef;
-            uint8_t options = 0;
-            size_t rangeStart = VariableList::kRangeMax;
-            size_t rangeEnd = dependencyCtx.maxDistance[currentLabel->m_dependencyStart / requiredStackSize];
-
-            for (auto it : dependencies) {
-                if (VARIABLE_TYPE(it) == DependencyGenContext::Label) {
-                    Label* label = VARIABLE_GET_LABEL(it);
-
-                    if (label == currentLabel) {
-                        continue;
-                    }
-
-                    options |= dependencyCtx.options[label->m_dependencyStart + (i - dependencyStart)] & VariableList::kConstraints;
-
-                    if (rangeStart > label->id()) {
-                        rangeStart = label->id();
-                    }
-
-                    size_t end = dependencyCtx.maxDistance[label->m_dependencyStart / requiredStackSize];
-                    if (rangeEnd < end) {
-                        rangeEnd = end;
-                    }
-                    continue;
-                }
-
-                VariableRef ref = VARIABLE_GET_REF(it);
-
-                if (headRef == DependencyGenContext::kNoRef) {
-                    headRef = m_variableList->getMergeHead(ref);
-                } else {
-                    headRef = mergeVariables(m_variableList, headRef, ref);
-                }
-            }
-
-            ASSERT(headRef != DependencyGenContext::kNoRef);
-
-            VariableList::Variable& variable = m_variableList->variables[headRef];
-            variable.info |= (options | dependencyCtx.options[i]) & VariableList::kConstraints;
-
-            if (variable.u.rangeStart > rangeStart) {
-                variable.u.rangeStart = rangeStart;
-            }
-
-            if (variable.rangeEnd < rangeEnd) {
-                variable.rangeEnd = rangeEnd;
-            }
-
-            dependencies.clear();
-            dependencies.insert(VARIABLE_SET(headRef, DependencyGenContext::Variable));
-        }
-    }
+    // Phase 2: the values of the referenced label slots are computed.
+    dependencyCtx.buildEdges();
+    dependencyCtx.computeReferences(m_variableList);
 
     // Cleanup
-    size_t lastDependencyStart = 0;
-
     for (InstructionListItem* item = m_first; item != nullptr; item = item->next()) {
         if (item->isLabel()) {
-            lastDependencyStart = item->asLabel()->m_dependencyStart;
             continue;
         }
 
@@ -673,16 +932,8 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
             VariableRef ref = *param;
 
             if (VARIABLE_TYPE(ref) == DependencyGenContext::Label) {
-                size_t offset = lastDependencyStart + VARIABLE_GET_REF(ref);
-                DependencyGenContext::DependencyList& list = dependencyCtx.dependencies[offset];
-
-                ASSERT((dependencyCtx.options[offset] & DependencyGenContext::kOptDependencyComputed) && list.size() == 1);
-
-                ref = *list.begin();
-
-                ASSERT(VARIABLE_TYPE(ref) == DependencyGenContext::Variable);
-
-                ref = m_variableList->getMergeHead(VARIABLE_GET_REF(ref));
+                ref = dependencyCtx.references[VARIABLE_GET_REF(ref)].result;
+                ref = m_variableList->getMergeHead(ref);
                 VariableList::Variable& variable = m_variableList->variables[ref];
 
                 if (!(variable.info & VariableList::kIsImmediate)) {
@@ -735,6 +986,15 @@ void JITCompiler::buildVariables(uint32_t requiredStackSize)
                     }
                     break;
                 }
+                case kLoopBoundsCheckOpcode: {
+                    ASSERT(instr->group() == Instruction::DirectBranch);
+                    uint8_t info = instr->asLoopBoundsCheck()->boundsCheck()->is64Bit ? Instruction::Int64Operand : Instruction::Int32Operand;
+
+                    for (uint32_t i = 0; i < instr->paramCount(); i++) {
+                        m_variableList->variables[param[i]].info |= info;
+                    }
+                    break;
+                }
                 case ByteCode::ArrayCopyOpcode: {
                     ASSERT(instr->paramCount() == 5);
 #if (defined SLJIT_32BIT_ARCHITECTURE && SLJIT_32BIT_ARCHITECTURE)
@@ -18,6 +18,7 @@
 
 #include "Walrus.h"
 
+#include "runtime/GCAllocator.h"
 #include "runtime/GCArray.h"
 #include "runtime/GCStruct.h"
 #include "runtime/Global.h"
@@ -25,16 +26,19 @@
 #include "runtime/Instance.h"
 #include "runtime/JITExec.h"
 #include "runtime/Memory.h"
+#include "runtime/Module.h"
+#include "runtime/Store.h"
 #include "runtime/Table.h"
 #include "runtime/Tag.h"
 #include "jit/Compiler.h"
-#ifdef WALRUS_JITPERF
 #include "jit/PerfDump.h"
-#endif
 #include "util/MathOperation.h"
 
 #include <math.h>
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <thread>
 
 // Inlined platform independent assembler backend.
 extern "C" {
@@ -62,6 +66,9 @@ namespace Walrus {
 static const uint8_t kFrameReg = SLJIT_S0;
 static const uint8_t kInstanceReg = SLJIT_S1;
 static const sljit_sw kContextOffset = 0;
+// These two are only initialized by functions which contain direct calls.
+static const sljit_sw kSavedFrameOffset = sizeof(sljit_sw);
+static const sljit_sw kDirectCallFrameOffset = 2 * sizeof(sljit_sw);
 
 struct JITArg {
     JITArg(Operand* operand)
@@ -145,37 +152,73 @@ public:
         uint32_t tagIndex;
     };
 
-    InstanceConstData(std::vector<TrapBlock>& trapBlocks, std::vector<Walrus::TryBlock>& tryBlocks);
-    void append(std::vector<TrapBlock>& trapBlocks, std::vector<Walrus::TryBlock>& tryBlocks);
+    struct Tables {
+        sljit_uw find(sljit_uw return_addr)
+        {
+            size_t begin = 0;
+            size_t end = trapList.size();
 
-    std::vector<TryBlock>& tryBlocks() { return m_tryBlocks; }
-    std::vector<CatchBlock>& catchBlocks() { return m_catchBlocks; }
+            while (true) {
+                size_t mid = ((begin + end) >> 2) << 1;
 
-    sljit_uw find(sljit_uw return_addr)
-    {
-        size_t begin = 0;
-        size_t end = m_trapList.size();
+                if (trapList[mid] < return_addr) {
+                    begin = mid + 2;
+                    continue;
+                }
 
-        while (true) {
-            size_t mid = ((begin + end) >> 2) << 1;
+                if (mid == 0 || trapList[mid - 2] < return_addr) {
+                    return trapList[mid + 1];
+                }
 
-            if (m_trapList[mid] < return_addr) {
-                begin = mid + 2;
-                continue;
+                end = mid - 2;
             }
+        }
 
-            if (mid == 0 || m_trapList[mid - 2] < return_addr) {
-                return m_trapList[mid + 1];
-            }
+        std::vector<sljit_uw> trapList;
+        std::vector<TryBlock> tryBlocks;
+        std::vector<CatchBlock> catchBlocks;
+    };
 
-            end = mid - 2;
+    // The tables are never modified after they are published. The tiered
+    // compiler publishes an extended copy while other threads may run the
+    // code of the module, and frees the old copy when no readers are left.
+    class Reader {
+    public:
+        explicit Reader(InstanceConstData* data)
+            : m_data(data)
+        {
+            data->m_readers.fetch_add(1);
+            m_tables = data->m_tables.load();
+        }
+
+        ~Reader()
+        {
+            m_data->m_readers.fetch_sub(1);
         }
+
+        Tables* operator->() { return m_tables; }
+
+    private:
+        InstanceConstData* m_data;
+        Tables* m_tables;
+    };
+
+    InstanceConstData(std::vector<TrapBlock>& trapBlocks, std::vector<Walrus::TryBlock>& tryBlocks);
+    ~InstanceConstData()
+    {
+        delete m_tables.load();
     }
 
+    void append(std::vector<TrapBlock>& trapBlocks, std::vector<Walrus::TryBlock>& tryBlocks);
+
+    // Only used by the compiler thread, which is the only writer.
+    size_t tryBlockCount() { return m_tables.load()->tryBlocks.size(); }
+
 private:
-    std::vector<sljit_uw> m_trapList;
-    std::vector<TryBlock> m_tryBlocks;
-    std::vector<CatchBlock> m_catchBlocks;
+    std::atomic<Tables*> m_tables;
+    std::atomic<size_t> m_readers;
+    // Serializes the writers.
+    std::mutex m_lock;
 };
 
 class JITFieldAccessor {
@@ -204,6 +247,48 @@ public:
     {
         return offsetof(GCArray, m_length);
     }
+
+#ifdef ENABLE_GC
+    static sljit_sw gcRefIndex()
+    {
+        return offsetof(GCBase, m_refIndex);
+    }
+#endif
+
+    static sljit_sw functionTypedEntry()
+    {
+        return offsetof(Function, m_typedEntry);
+    }
+
+    static sljit_sw functionTypeID()
+    {
+        return offsetof(Function, m_typeID);
+    }
+
+    static sljit_sw definedFunctionInstance()
+    {
+        return offsetof(DefinedFunction, m_instance);
+    }
+
+    static sljit_sw definedFunctionModuleFunction()
+    {
+        return offsetof(DefinedFunction, m_moduleFunction);
+    }
+
+    static sljit_sw moduleFunctionRequiredStackSize()
+    {
+        return offsetof(ModuleFunction, m_requiredStackSize);
+    }
+
+    static sljit_sw moduleFunctionJITFunction()
+    {
+        return offsetof(ModuleFunction, m_jitFunction);
+    }
+
+    static sljit_sw jitFunctionExportEntry()
+    {
+        return offsetof(JITFunction, m_exportEntry);
+    }
 };
 
 class SlowCase {
@@ -215,6 +300,7 @@ public:
         SignedModulo32,
         ConvertIntFromFloat,
         ConvertUnsignedIntFromFloat,
+        CheckEpoch,
     };
 
     SlowCase(Type type, sljit_jump* jump_from, sljit_label* resume_label, Instruction* instr)
@@ -236,16 +322,27 @@ protected:
     Instruction* m_instr;
 };
 
+class CheckEpochSlowCase : public SlowCase {
+public:
+    CheckEpochSlowCase(sljit_jump* jumpFrom, sljit_label* resumeLabel, Instruction* instr)
+        : SlowCase(Type::CheckEpoch, jumpFrom, resumeLabel, instr)
+    {
+    }
+
+    void emitSlowCase(sljit_compiler* compiler);
+};
+
 CompileContext::CompileContext(Module* module, JITCompiler* compiler)
     : compiler(compiler)
     , branchTableOffset(0)
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
     , shuffleOffset(0)
 #endif /* SLJIT_CONFIG_X86 */
-    , stackTmpStart(sizeof(sljit_sw))
+    , stackTmpStart(3 * sizeof(sljit_sw))
     , nextTryBlock(0)
     , currentTryBlock(InstanceConstData::globalTryBlock)
     , trapBlocksStart(0)
+    , hasGuardPageAccess(false)
     , module(module)
 {
     // Compiler is not initialized yet.
@@ -546,6 +643,10 @@ void SlowCase::emit(sljit_compiler* compiler)
         return;
     }
 #endif /* SLJIT_64BIT_ARCHITECTURE */
+    case Type::CheckEpoch: {
+        reinterpret_cast<CheckEpochSlowCase*>(this)->emitSlowCase(compiler);
+        return;
+    }
     default: {
         RELEASE_ASSERT_NOT_REACHED();
         break;
@@ -763,6 +864,11 @@ static void emitDirectBranch(sljit_compiler* compiler, Instruction* instr)
     case ByteCode::JumpIfCastDefinedOpcode:
         emitGCCastDefined(compiler, instr);
         return;
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+    case kLoopBoundsCheckOpcode:
+        emitLoopBoundsCheck(compiler, instr->asLoopBoundsCheck());
+        return;
+#endif /* SLJIT_64BIT_ARCHITECTURE */
     default: {
         JITArg src(instr->operands());
 
@@ -970,6 +1076,129 @@ static void emitRefAsNonNull(sljit_compiler* compiler, Instruction* instr)
     context->appendTrapJump(ExecutionContext::NullReferenceError, sljit_emit_cmp(compiler, SLJIT_EQUAL, srcArg.arg, srcArg.argw, SLJIT_IMM, 0));
 }
 
+static sljit_sw extendEpochDeadline(ExecutionContext* context)
+{
+    if (context->instance->module()->store()->extendEpochDeadline(context->state)) {
+        return ExecutionContext::NoError;
+    }
+    return ExecutionContext::EpochDeadlineError;
+}
+
+static_assert(sizeof(std::atomic<size_t>) == sizeof(sljit_uw), "The epoch is read by plain loads");
+static_assert(SLJIT_NUMBER_OF_SCRATCH_REGISTERS * sizeof(sljit_sw)
+                      + (SLJIT_NUMBER_OF_SCRATCH_FLOAT_REGISTERS + SLJIT_NUMBER_OF_SCRATCH_VECTOR_REGISTERS) * 16
+                  <= ExecutionContext::kEpochSaveAreaSize,
+              "The scratch registers must fit into the epoch save area");
+
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+// SLJIT_R0 is saved by the fast path.
+#define EPOCH_FIRST_SAVED_REG 1
+#else /* !SLJIT_CONFIG_X86_32 */
+#define EPOCH_FIRST_SAVED_REG 0
+#endif /* SLJIT_CONFIG_X86_32 */
+
+// Stores (or loads) the scratch registers into the epoch save
+// area of the context. SLJIT_TMP_DEST_REG is overwritten.
+static void emitEpochSaveArea(sljit_compiler* compiler, sljit_s32 firstReg, bool load)
+{
+    sljit_sw offset = firstReg * static_cast<sljit_sw>(sizeof(sljit_sw));
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochSaveArea));
+
+    for (sljit_s32 i = firstReg; i < SLJIT_NUMBER_OF_SCRATCH_REGISTERS; i++) {
+        if (load) {
+            sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R(i), 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), offset);
+        } else {
+            sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_TMP_DEST_REG), offset, SLJIT_R(i), 0);
+        }
+        offset += sizeof(sljit_sw);
+    }
+
+#if defined(HAS_SIMD) && !(defined SLJIT_SEPARATE_VECTOR_REGISTERS && SLJIT_SEPARATE_VECTOR_REGISTERS) && !(defined SLJIT_CONFIG_ARM_32 && SLJIT_CONFIG_ARM_32)
+    // The float registers hold v128 values as well.
+    sljit_s32 type = (load ? SLJIT_SIMD_LOAD : SLJIT_SIMD_STORE) | SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_128;
+
+    for (sljit_s32 i = 0; i < SLJIT_NUMBER_OF_SCRATCH_FLOAT_REGISTERS; i++) {
+        sljit_emit_simd_mov(compiler, type, SLJIT_FR(i), SLJIT_MEM1(SLJIT_TMP_DEST_REG), offset);
+        offset += 16;
+    }
+#else /* !HAS_SIMD || SLJIT_SEPARATE_VECTOR_REGISTERS || SLJIT_CONFIG_ARM_32 */
+    // On ARM32 a v128 value is held by two float registers.
+    for (sljit_s32 i = 0; i < SLJIT_NUMBER_OF_SCRATCH_FLOAT_REGISTERS; i++) {
+        if (load) {
+            sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_FR(i), 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), offset);
+        } else {
+            sljit_emit_fop1(compiler, SLJIT_MOV_F64, SLJIT_MEM1(SLJIT_TMP_DEST_REG), offset, SLJIT_FR(i), 0);
+        }
+        offset += sizeof(sljit_f64);
+    }
+#endif /* HAS_SIMD && !SLJIT_SEPARATE_VECTOR_REGISTERS && !SLJIT_CONFIG_ARM_32 */
+
+#if (defined SLJIT_SEPARATE_VECTOR_REGISTERS && SLJIT_SEPARATE_VECTOR_REGISTERS)
+    sljit_s32 vectorType = (load ? SLJIT_SIMD_LOAD : SLJIT_SIMD_STORE) | SLJIT_SIMD_REG_128 | SLJIT_SIMD_ELEM_128;
+
+    for (sljit_s32 i = 0; i < SLJIT_NUMBER_OF_SCRATCH_VECTOR_REGISTERS; i++) {
+        sljit_emit_simd_mov(compiler, vectorType, SLJIT_VR(i), SLJIT_MEM1(SLJIT_TMP_DEST_REG), offset);
+        offset += 16;
+    }
+#endif /* SLJIT_SEPARATE_VECTOR_REGISTERS */
+}
+
+void CheckEpochSlowCase::emitSlowCase(sljit_compiler* compiler)
+{
+    CompileContext* context = CompileContext::get(compiler);
+
+    // The check is not a call for the register allocator, so
+    // the scratch registers are preserved by the slow case.
+    emitEpochSaveArea(compiler, EPOCH_FIRST_SAVED_REG, false);
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS1(W, P), SLJIT_IMM, GET_FUNC_ADDR(sljit_sw, extendEpochDeadline));
+    sljit_jump* cmp = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, ExecutionContext::NoError);
+    context->appendTrapJump(ExecutionContext::GenericTrap, cmp);
+
+    emitEpochSaveArea(compiler, 0, true);
+    sljit_set_label(sljit_emit_jump(compiler, SLJIT_JUMP), m_resumeLabel);
+}
+
+static void emitCheckEpoch(sljit_compiler* compiler, Instruction* instr)
+{
+    CompileContext* context = CompileContext::get(compiler);
+
+    ASSERT(!(instr->info() & Instruction::kIsCallback));
+
+#if (defined SLJIT_CONFIG_X86_32 && SLJIT_CONFIG_X86_32)
+    // Only one temporary register is available.
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochSaveArea));
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_TMP_DEST_REG), 0, SLJIT_R0, 0);
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochCounter));
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochDeadline));
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_R0), 0);
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), 0);
+    sljit_jump* reached = sljit_emit_cmp(compiler, SLJIT_GREATER_EQUAL, SLJIT_R0, 0, SLJIT_TMP_DEST_REG, 0);
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochSaveArea));
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), 0);
+#else /* !SLJIT_CONFIG_X86_32 */
+#ifndef SLJIT_TMP_OPT_REG
+#error "Missing implementation"
+#endif
+    // Only temporary registers are used, so no live values are destroyed.
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_TMP_OPT_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochDeadline));
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), OffsetOfContextField(epochCounter));
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_OPT_REG, 0, SLJIT_MEM1(SLJIT_TMP_OPT_REG), 0);
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(SLJIT_TMP_DEST_REG), 0);
+    sljit_jump* reached = sljit_emit_cmp(compiler, SLJIT_GREATER_EQUAL, SLJIT_TMP_DEST_REG, 0, SLJIT_TMP_OPT_REG, 0);
+#endif /* SLJIT_CONFIG_X86_32 */
+
+    context->add(new CheckEpochSlowCase(reached, sljit_emit_label(compiler), instr));
+}
+
 static void emitStackInit(sljit_compiler* compiler, Instruction* instr)
 {
     uint32_t type;
@@ -999,6 +1228,9 @@ static void emitStackInit(sljit_compiler* compiler, Instruction* instr)
 
 JITModule::~JITModule()
 {
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    removeGuardPageTraps();
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
     delete m_instanceConstData;
     sljit_free_code(m_moduleStart, nullptr);
 
@@ -1066,29 +1298,53 @@ JITCompiler::JITCompiler(Module* module, uint32_t JITFlags)
     , m_savedVectorRegCount(0)
 #endif /* SLJIT_SEPARATE_VECTOR_REGISTERS */
     , m_stackTmpSize(0)
+    , m_hasDirectCall(false)
+    , m_emitEntryCode(module->m_jitModule == nullptr)
+    , m_code(nullptr)
+    , m_executableOffset(0)
+    , m_remoteDirectCallTargets(nullptr)
 {
     if (module->m_jitModule != nullptr) {
         ASSERT(module->m_jitModule->m_instanceConstData != nullptr);
-        m_tryBlockOffset = module->m_jitModule->m_instanceConstData->tryBlocks().size();
+        m_tryBlockOffset = module->m_jitModule->m_instanceConstData->tryBlockCount();
     }
 
     if (sljit_has_cpu_feature(SLJIT_HAS_CMOV)) {
         m_options |= JITCompiler::kHasCondMov;
     }
+
+    if (module->store()->useMemoryGuardPages()) {
+        m_options |= JITCompiler::kMemoryGuardPages;
+    }
+}
+
+bool JITCompiler::isDirectCallTarget(ModuleFunction* moduleFunction)
+{
+    if (moduleFunction->byteCodeSize() == 0) {
+        // Imported functions are called through the C helper.
+        return false;
+    }
+
+    if (isLocalDirectCallTarget(moduleFunction) || isRemoteDirectCallTarget(moduleFunction)) {
+        return true;
+    }
+
+    JITFunction* jitFunc = moduleFunction->jitFunction();
+    return jitFunc != nullptr && jitFunc->isCompiled();
 }
 
 void JITCompiler::compileFunction(JITFunction* jitFunc, bool isExternal)
 {
     ASSERT(m_first != nullptr && m_last != nullptr);
 
-    m_functionList.push_back(FunctionList(jitFunc, isExternal, m_branchTableSize));
+    m_functionList.push_back(FunctionList(m_moduleFunction, jitFunc, isExternal, m_branchTableSize));
 
     if (m_compiler == nullptr) {
         // First compiled function.
         m_compiler = sljit_create_compiler(nullptr);
         sljit_compiler_set_user_data(m_compiler, reinterpret_cast<void*>(&m_context));
 
-        if (module()->m_jitModule == nullptr) {
+        if (m_emitEntryCode) {
             // Follows the declaration of FunctionDescriptor::ExternalDecl().
             // Frame stored in SLJIT_S0 (kFrameReg)
             // Instance stored in SLJIT_S1 (kInstanceReg)
@@ -1108,38 +1364,15 @@ void JITCompiler::compileFunction(JITFunction* jitFunc, bool isExternal)
         }
     }
 
-#ifdef WALRUS_JITPERF
-    const bool perfEnabled = PerfDump::instance().perfEnabled();
-#if !defined(NDEBUG)
-    if (perfEnabled) {
-        uint32_t line = PerfDump::instance().dumpProlog(module(), moduleFunction());
-        m_debugEntries.push_back(DebugEntry(sljit_emit_label(m_compiler), line));
-    }
-#endif /* !NDEBUG */
-#endif /* WALRUS_JITPERF */
+    const bool perfDebugInfo = (m_JITFlags & JITFlagValue::perfJITDump) != 0;
 
     emitProlog();
     m_context.tailCallLabel = sljit_emit_label(m_compiler);
 
     for (InstructionListItem* item = m_first; item != nullptr; item = item->next()) {
-#if defined(WALRUS_JITPERF) && !defined(NDEBUG)
-        if (perfEnabled) {
-            uint32_t line = PerfDump::instance().dumpByteCode(item);
-            if (item->info() & Instruction::kIsMergeCompare) {
-                line = PerfDump::instance().dumpByteCode(item->next());
-            }
-
-            ASSERT(!m_debugEntries.empty());
-            sljit_label* label = sljit_emit_label(m_compiler);
-
-            // Label is the same, if no instructions are emitted.
-            if (m_debugEntries.back().u.label == label) {
-                m_debugEntries.back().line = line;
-            } else {
-                m_debugEntries.push_back(DebugEntry(label, line));
-            }
+        if (perfDebugInfo && item->isInstruction()) {
+            addDebugEntry(item->asInstruction());
         }
-#endif /* WALRUS_JITPERF && !NDEBUG */
 
         if (item->isLabel()) {
             Label* label = item->asLabel();
@@ -1424,6 +1657,10 @@ void JITCompiler::compileFunction(JITFunction* jitFunc, bool isExternal)
                 m_context.appendTrapJump(ExecutionContext::GenericTrap, sljit_emit_jump(m_compiler, SLJIT_JUMP));
                 break;
             }
+            case ByteCode::CheckEpochOpcode: {
+                emitCheckEpoch(m_compiler, item->asInstruction());
+                break;
+            }
 #if !defined(NDEBUG)
             case ByteCode::NopOpcode: {
                 sljit_emit_op0(m_compiler, SLJIT_NOP);
@@ -1444,15 +1681,16 @@ void JITCompiler::compileFunction(JITFunction* jitFunc, bool isExternal)
         }
     }
 
-#if defined(WALRUS_JITPERF) && !defined(NDEBUG)
-    if (perfEnabled) {
-        uint32_t line = PerfDump::instance().dumpEpilog();
-        m_debugEntries.push_back(DebugEntry(sljit_emit_label(m_compiler), line));
+    if (perfDebugInfo) {
         m_debugEntries.push_back(DebugEntry());
     }
-#endif /* WALRUS_JITPERF && !NDEBUG */
 
     emitEpilog();
+
+    if (!m_osrEntries.empty()) {
+        emitOSREntries(jitFunc);
+    }
+
     clear();
 }
 
@@ -1489,21 +1727,40 @@ void JITCompiler::generateCode()
         } while (brTable != nullptr);
     }
 
-    void* code = sljit_generate_code(m_compiler, 0, nullptr);
+    if (!m_directCalls.empty()) {
+        std::unordered_map<ModuleFunction*, sljit_label*> entryLabels;
 
-#ifdef WALRUS_JITPERF
-    const bool perfEnabled = PerfDump::instance().perfEnabled();
-    if (perfEnabled) {
-        sljit_uw funcStart = SLJIT_FUNC_UADDR(code);
-        sljit_uw funcEnd = sljit_get_label_addr(m_functionList[0].exportEntryLabel);
-        PerfDump::instance().dumpCodeLoad(funcStart, funcStart, (funcEnd - funcStart), "*entrypoint*", (uint8_t*)funcStart);
+        for (auto it : m_functionList) {
+            entryLabels[it.moduleFunction] = it.exportEntryLabel;
+        }
+
+        for (auto it : m_directCalls) {
+            if (!isLocalDirectCallTarget(it.target)) {
+                // The target address is patched by linkCode().
+                sljit_set_target(it.jump, 0);
+                continue;
+            }
+
+            ASSERT(entryLabels.find(it.target) != entryLabels.end());
+            sljit_set_label(it.jump, entryLabels[it.target]);
+        }
     }
-#endif
+
+    void* code = sljit_generate_code(m_compiler, 0, nullptr);
+    m_code = code;
 
     if (code != nullptr) {
+        m_executableOffset = sljit_get_executable_offset(m_compiler);
+
+        for (auto it : m_directCalls) {
+            if (!isLocalDirectCallTarget(it.target)) {
+                m_remoteDirectCalls.push_back(RemoteDirectCall(sljit_get_jump_addr(it.jump), it.target));
+            }
+        }
+
         if (m_brTableLabels != nullptr) {
             BranchTableLabels* brTable = m_brTableLabels;
-            sljit_sw executable_offset = sljit_get_executable_offset(m_compiler);
+            sljit_sw executable_offset = m_executableOffset;
 
             do {
                 sljit_uw addr = sljit_get_label_abs_addr(brTable->header.u.label);
@@ -1520,18 +1777,62 @@ void JITCompiler::generateCode()
                 brTable = reinterpret_cast<BranchTableLabels*>(brTable->header.next);
             } while (brTable != nullptr);
         }
+    }
 
+    m_directCalls.clear();
+}
+
+void JITCompiler::registerCode()
+{
+    if (m_compiler == nullptr) {
+        return;
+    }
+
+    void* code = m_code;
+
+    if (code != nullptr) {
         JITModule* moduleDescriptor = module()->m_jitModule;
 
         if (moduleDescriptor == nullptr) {
+            ASSERT(m_emitEntryCode);
             InstanceConstData* instanceConstData = new InstanceConstData(m_context.trapBlocks, tryBlocks());
             moduleDescriptor = new JITModule(instanceConstData, code);
             module()->m_jitModule = moduleDescriptor;
         } else {
-            moduleDescriptor->m_instanceConstData->append(m_context.trapBlocks, tryBlocks());
+            ASSERT(!m_emitEntryCode && moduleDescriptor->m_instanceConstData->tryBlockCount() == m_tryBlockOffset);
+
+            if (!m_context.trapBlocks.empty()) {
+                moduleDescriptor->m_instanceConstData->append(m_context.trapBlocks, tryBlocks());
+            }
             moduleDescriptor->m_codeBlocks.push_back(code);
         }
 
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+        std::vector<JITModule::GuardPageTrap> guardPageTraps;
+        size_t functionCount = m_functionList.size();
+
+        for (size_t i = 0; i < functionCount; i++) {
+            if (m_functionList[i].guardPageTrapLabel == nullptr) {
+                continue;
+            }
+
+            uintptr_t start = sljit_get_label_addr(m_functionList[i].exportEntryLabel);
+            uintptr_t end;
+
+            if (i + 1 < functionCount) {
+                end = sljit_get_label_addr(m_functionList[i + 1].exportEntryLabel);
+            } else {
+                end = SLJIT_FUNC_UADDR(code) + sljit_get_generated_code_size(m_compiler);
+            }
+
+            guardPageTraps.push_back(JITModule::GuardPageTrap(start, end, sljit_get_label_addr(m_functionList[i].guardPageTrapLabel)));
+        }
+
+        if (!guardPageTraps.empty()) {
+            moduleDescriptor->appendGuardPageTraps(guardPageTraps);
+        }
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
+
         for (auto it : m_functionList) {
             it.jitFunc->m_module = moduleDescriptor;
 
@@ -1542,6 +1843,10 @@ void JITCompiler::generateCode()
 
             it.jitFunc->m_exportEntry = reinterpret_cast<void*>(sljit_get_label_addr(it.exportEntryLabel));
 
+            for (auto& entry : it.jitFunc->m_osrEntries) {
+                entry.u.address = reinterpret_cast<void*>(sljit_get_label_addr(entry.u.label));
+            }
+
             if (it.branchTableSize > 0) {
                 sljit_up* branchList = reinterpret_cast<sljit_up*>(it.jitFunc->m_constData);
                 ASSERT(branchList != nullptr);
@@ -1556,62 +1861,117 @@ void JITCompiler::generateCode()
         }
     }
 
-#ifdef WALRUS_JITPERF
-    if (perfEnabled) {
-#if !defined(NDEBUG)
-        size_t size = m_debugEntries.size();
+    if (code != nullptr && (m_JITFlags & (JITFlagValue::perfMap | JITFlagValue::perfJITDump))) {
+        dumpPerfInfo(code);
+    }
 
-        for (size_t i = 0; i < size; i++) {
-            if (m_debugEntries[i].line != 0) {
-                m_debugEntries[i].u.address = sljit_get_label_addr(m_debugEntries[i].u.label);
-            } else {
-                m_debugEntries[i].u.address = 0;
-            }
+    sljit_free_compiler(m_compiler);
+    m_compiler = nullptr;
+}
+
+void JITCompiler::addDebugEntry(Instruction* instr)
+{
+    const uint8_t* byteCode = reinterpret_cast<const uint8_t*>(instr->byteCode());
+    const uint8_t* byteCodeStart = moduleFunction()->byteCode();
+
+    // Some instructions are not generated from the byte code of the function.
+    if (byteCode < byteCodeStart || byteCode >= byteCodeStart + moduleFunction()->byteCodeSize()) {
+        return;
+    }
+
+    uint32_t offset = moduleFunction()->codeOffset(static_cast<size_t>(byteCode - byteCodeStart));
+
+    if (offset == 0) {
+        return;
+    }
+
+    sljit_label* label = sljit_emit_label(m_compiler);
+
+    if (!m_debugEntries.empty() && m_debugEntries.back().line != 0) {
+        // Label is the same, if no instructions are emitted.
+        if (m_debugEntries.back().u.label == label) {
+            m_debugEntries.back().line = offset;
+            return;
         }
 
-        size_t debugEntryStart = 0;
-#endif /* !NDEBUG */
+        if (m_debugEntries.back().line == offset) {
+            return;
+        }
+    }
 
-        for (size_t i = 0; i < m_functionList.size(); i++) {
-            size_t size = module()->numberOfFunctions();
-            int functionIndex = 0;
+    m_debugEntries.push_back(DebugEntry(label, offset));
+}
 
-            for (size_t i = 0; i < size; i++) {
-                if (module()->function(i)->jitFunction() == m_functionList[i].jitFunc) {
-                    functionIndex = static_cast<int>(i);
-                    break;
-                }
-            }
+void JITCompiler::dumpPerfInfo(void* code)
+{
+    PerfDump& perfDump = PerfDump::instance();
+    std::lock_guard<std::mutex> guard(perfDump.lock());
 
-            std::string name = "function" + std::to_string(functionIndex);
-            for (auto exp : module()->exports()) {
-                if (exp->exportType() != Walrus::ExportType::Function) {
-                    continue;
-                }
-                if (module()->function(exp->itemIndex())->jitFunction() == m_functionList[i].jitFunc) {
-                    name += "_" + exp->name();
-                    break;
-                }
-            }
+    if (m_emitEntryCode) {
+        sljit_uw funcStart = SLJIT_FUNC_UADDR(code);
+        sljit_uw funcEnd = sljit_get_label_addr(m_functionList[0].exportEntryLabel);
+        perfDump.dumpFunction(m_JITFlags, funcStart, funcEnd - funcStart, "*entrypoint*");
+    }
 
-            sljit_uw funcStart = sljit_get_label_addr(m_functionList[i].exportEntryLabel);
-            sljit_uw funcEnd;
+    for (auto& entry : m_debugEntries) {
+        entry.u.address = entry.line != 0 ? sljit_get_label_addr(entry.u.label) : 0;
+    }
 
-#if !defined(NDEBUG)
-            debugEntryStart = PerfDump::instance().dumpDebugInfo(m_debugEntries, debugEntryStart, funcStart);
-#endif /* !NDEBUG */
+    size_t debugEntryStart = 0;
+    size_t functionCount = m_functionList.size();
 
-            if (i < m_functionList.size() - 1) {
-                funcEnd = sljit_get_label_addr(m_functionList[i + 1].exportEntryLabel);
-            } else {
-                funcEnd = SLJIT_FUNC_UADDR(code) + sljit_get_generated_code_size(m_compiler);
+    for (size_t i = 0; i < functionCount; i++) {
+        ModuleFunction* function = m_functionList[i].moduleFunction;
+        std::string name = module()->symbolName(function);
+
+        sljit_uw funcStart = sljit_get_label_addr(m_functionList[i].exportEntryLabel);
+        sljit_uw funcEnd;
+
+        if (i + 1 < functionCount) {
+            funcEnd = sljit_get_label_addr(m_functionList[i + 1].exportEntryLabel);
+        } else {
+            funcEnd = SLJIT_FUNC_UADDR(code) + sljit_get_generated_code_size(m_compiler);
+        }
+
+        if (m_JITFlags & JITFlagValue::perfJITDump) {
+            size_t debugEntryEnd = debugEntryStart;
+
+            while (m_debugEntries[debugEntryEnd].line != 0) {
+                debugEntryEnd++;
             }
 
-            PerfDump::instance().dumpCodeLoad(funcStart, funcStart, (funcEnd - funcStart), name, (uint8_t*)funcStart);
+            perfDump.dumpDebugInfo(m_debugEntries.data() + debugEntryStart, debugEntryEnd - debugEntryStart, funcStart);
+            debugEntryStart = debugEntryEnd + 1;
         }
+
+        perfDump.dumpFunction(m_JITFlags, funcStart, funcEnd - funcStart, name);
     }
-#endif
-    sljit_free_compiler(m_compiler);
+
+    m_debugEntries.clear();
+}
+
+void JITCompiler::linkCode()
+{
+    for (auto it : m_remoteDirectCalls) {
+        JITFunction* jitFunc = it.target->jitFunction();
+
+        ASSERT(jitFunc != nullptr && jitFunc->isCompiled());
+        sljit_set_jump_addr(it.address, reinterpret_cast<sljit_uw>(jitFunc->exportEntry()), m_executableOffset);
+    }
+
+    m_remoteDirectCalls.clear();
+
+    // The functions become visible to other threads after they are fully linked.
+    for (auto it : m_functionList) {
+        if (m_code == nullptr) {
+            delete it.jitFunc;
+            continue;
+        }
+
+        it.moduleFunction->setJITFunction(it.jitFunc);
+    }
+
+    m_functionList.clear();
 }
 
 void JITCompiler::clear()
@@ -1622,6 +1982,7 @@ void JITCompiler::clear()
     m_last = nullptr;
     m_branchTableSize = 0;
     m_stackTmpSize = 0;
+    m_hasDirectCall = false;
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
     m_context.shuffleOffset = 0;
 #endif /* SLJIT_CONFIG_X86 */
@@ -1643,16 +2004,25 @@ void JITCompiler::clear()
     }
 
     m_context.trapJumps.clear();
-}
+    m_optimizerConst32.clear();
+    m_optimizerConst64.clear();
+    m_loopBoundsChecks.clear();
 
-void JITCompiler::emitProlog()
-{
-    FunctionList& func = m_functionList.back();
+    for (auto& it : m_osrEntries) {
+        item = it.stackInitList;
 
-    if (func.isExported) {
-        func.exportEntryLabel = sljit_emit_label(m_compiler);
+        while (item != nullptr) {
+            InstructionListItem* next = item->next();
+            item->deleteObject();
+            item = next;
+        }
     }
 
+    m_osrEntries.clear();
+}
+
+void JITCompiler::emitEnter()
+{
     sljit_s32 options = SLJIT_ENTER_REG_ARG | SLJIT_ENTER_KEEP(2);
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
     options |= SLJIT_ENTER_USE_VEX;
@@ -1674,6 +2044,25 @@ void JITCompiler::emitProlog()
 
     sljit_emit_op1(m_compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), kContextOffset, SLJIT_R0, 0);
 
+    if (m_hasDirectCall) {
+        // The frames of the callees start at the current top of the frame stack,
+        // which does not change while this function is running.
+        sljit_emit_op1(m_compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), kSavedFrameOffset, kFrameReg, 0);
+        sljit_emit_op1(m_compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(frameStackTop));
+        sljit_emit_op1(m_compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_SP), kDirectCallFrameOffset, SLJIT_R1, 0);
+    }
+}
+
+void JITCompiler::emitProlog()
+{
+    FunctionList& func = m_functionList.back();
+
+    if (func.isExported) {
+        func.exportEntryLabel = sljit_emit_label(m_compiler);
+    }
+
+    emitEnter();
+
     m_context.branchTableOffset = 0;
     size_t size = func.branchTableSize * sizeof(sljit_up);
 #if (defined SLJIT_CONFIG_X86 && SLJIT_CONFIG_X86)
@@ -1716,6 +2105,12 @@ void JITCompiler::emitEpilog()
 
     m_context.emitSlowCases(m_compiler);
 
+    if (m_context.hasGuardPageAccess) {
+        func.guardPageTrapLabel = sljit_emit_label(m_compiler);
+        m_context.appendTrapJump(ExecutionContext::OutOfBoundsMemAccessError, sljit_emit_jump(m_compiler, SLJIT_JUMP));
+        m_context.hasGuardPageAccess = false;
+    }
+
     std::vector<TrapJump>& trapJumps = m_context.trapJumps;
     // The actual maximum is smaller, but the extra stack consumption is small.
     sljit_jump* jumps[ExecutionContext::GenericTrap];
@@ -1831,7 +2226,8 @@ void JITCompiler::emitEpilog()
         size_t tryBlockId = trapBlocks[i].u.tryBlockId;
 
         if (tryBlockId == InstanceConstData::globalTryBlock) {
-            trapBlocks[i].u.handlerLabel = endLabel;
+            // Errors returned by direct calls are propagated to the caller.
+            trapBlocks[i].u.handlerLabel = lastLabel;
         } else {
             trapBlocks[i].u.handlerLabel = tryBlocks()[tryBlockId].findHandlerLabel;
         }
@@ -1853,6 +2249,26 @@ void JITCompiler::emitEpilog()
     }
 }
 
+void JITCompiler::emitOSREntries(JITFunction* jitFunc)
+{
+    ASSERT(jitFunc->m_osrEntries.empty());
+
+    // Each entry creates the same frame as the prolog of the function, and
+    // continues the execution at the loop header using the frame of the
+    // interpreter. The label addresses are resolved by registerCode().
+    for (auto& it : m_osrEntries) {
+        jitFunc->m_osrEntries.push_back(JITFunction::OSREntry(it.byteCodeOffset, sljit_emit_label(m_compiler)));
+
+        emitEnter();
+
+        for (InstructionListItem* item = it.stackInitList; item != nullptr; item = item->next()) {
+            emitStackInit(m_compiler, item->asInstruction());
+        }
+
+        sljit_set_label(sljit_emit_jump(m_compiler, SLJIT_JUMP), it.label->label());
+    }
+}
+
 } // namespace Walrus
 
 #endif // WALRUS_ENABLE_JIT
@@ -21,8 +21,14 @@
 #include "jit/Compiler.h"
 #include "runtime/JITExec.h"
 #include "runtime/Module.h"
+#include "runtime/Store.h"
+#include "runtime/TieredCompiler.h"
 
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <set>
+#include <thread>
 
 #if defined(COMPILER_MSVC)
 #include <BaseTsd.h>
@@ -55,13 +61,19 @@ private:
     size_t m_end;
 };
 
-static void buildCatchInfo(JITCompiler* compiler, ModuleFunction* function, std::map<size_t, Label*>& labels)
+// Each try range is a try block, and the value is the number of its catch blocks.
+static void collectTryRanges(ModuleFunction* function, std::map<TryRange, size_t>& ranges)
 {
-    std::map<TryRange, size_t> ranges;
-
     for (auto it : function->catchInfo()) {
         ranges[TryRange(it.m_tryStart, it.m_tryEnd)]++;
     }
+}
+
+static void buildCatchInfo(JITCompiler* compiler, ModuleFunction* function, std::map<size_t, Label*>& labels)
+{
+    std::map<TryRange, size_t> ranges;
+
+    collectTryRanges(function, ranges);
 
     std::vector<TryBlock>& tryBlocks = compiler->tryBlocks();
     size_t counter = tryBlocks.size();
@@ -594,6 +606,183 @@ static uint32_t typeToStructRequiredInit(Value::Type type, bool isGet)
     }
 }
 
+static void compileByteCodes(JITCompiler* compiler, ModuleFunction* function, std::map<size_t, Label*>& labels, End** inlineEnd);
+
+// Inlined functions are stored in the frame of the caller, so their frame must be small.
+static const uint32_t kMaxInlineStackSize = 256;
+
+// Returns with the reason when the calls of the function cannot be inlined,
+// or nullptr otherwise. Only short functions without branches and calls are inlined.
+static const char* inlineRejectReason(ModuleFunction* function, uint32_t maxByteCodes)
+{
+    size_t idx = 0;
+    size_t endIdx = function->byteCodeSize();
+    uint32_t byteCodeCount = 0;
+
+    if (endIdx == 0) {
+        return "imported function";
+    }
+
+    if (function->hasTryCatch() || !function->catchInfo().empty()) {
+        return "has try blocks";
+    }
+
+    if (function->requiredStackSize() > kMaxInlineStackSize) {
+        return "frame is too large";
+    }
+
+#ifdef ENABLE_GC
+    // The inlined frame is not scanned by the garbage collector.
+    if (!function->referenceRanges().empty()) {
+        return "holds references";
+    }
+#endif
+
+    while (idx < endIdx) {
+        ByteCode* byteCode = function->getByteCode<ByteCode>(idx);
+
+        switch (byteCode->opcode()) {
+        case ByteCode::JumpOpcode:
+        case ByteCode::JumpIfTrueOpcode:
+        case ByteCode::JumpIfFalseOpcode:
+        case ByteCode::JumpIfNullOpcode:
+        case ByteCode::JumpIfNonNullOpcode:
+        case ByteCode::JumpIfCastGenericOpcode:
+        case ByteCode::JumpIfCastDefinedOpcode:
+        case ByteCode::BrTableOpcode:
+            return "has branches";
+        case ByteCode::CallOpcode:
+        case ByteCode::CallIndirectOpcode:
+        case ByteCode::CallRefOpcode:
+        case ByteCode::ReturnCallOpcode:
+        case ByteCode::ReturnCallIndirectOpcode:
+        case ByteCode::ReturnCallRefOpcode:
+            return "has calls";
+        // These instructions read their stack offsets from the byte code.
+        case ByteCode::ThrowOpcode:
+        case ByteCode::ArrayNewOpcode:
+        case ByteCode::ArrayNewFixedOpcode:
+        case ByteCode::StructNewOpcode:
+            return "unsupported instruction";
+        case ByteCode::EndOpcode:
+            if (idx + byteCode->getSize() != endIdx) {
+                return "has early returns";
+            }
+            break;
+        default:
+            if (++byteCodeCount > maxByteCodes) {
+                return "too many byte codes";
+            }
+            break;
+        }
+
+        idx += byteCode->getSize();
+    }
+
+    return nullptr;
+}
+
+static void appendInlineMove(JITCompiler* compiler, ByteCode* byteCode, Value::Type type, Operand src, Operand dst)
+{
+    ByteCode::Opcode opcode = ByteCode::MoveI32Opcode;
+    uint32_t requiredInit = OTOp1I32;
+
+    if (valueSize(type) == 8) {
+        opcode = ByteCode::MoveI64Opcode;
+        requiredInit = OTOp1I64;
+    } else if (valueSize(type) == 16) {
+        opcode = ByteCode::MoveV128Opcode;
+        requiredInit = OTMoveV128;
+    }
+
+    Instruction* instr = compiler->append(byteCode, Instruction::Move, opcode, 1, 1);
+    instr->setRequiredRegsDescriptor(requiredInit);
+
+    Operand* operands = instr->operands();
+    operands[0] = src;
+    operands[1] = dst;
+}
+
+// The body of the callee is compiled into the caller, and its frame
+// is placed into the inline stack area of the frame of the caller.
+static bool inlineCall(JITCompiler* compiler, ModuleFunction* function, Call* call)
+{
+    uint32_t maxByteCodes = compiler->module()->store()->JITInlineSize();
+
+    if (maxByteCodes == 0) {
+        return false;
+    }
+
+    ModuleFunction* callee = compiler->module()->function(call->index());
+    const char* reason = inlineRejectReason(callee, maxByteCodes);
+
+    if (reason == nullptr && callee->requiredStackSize() > function->inlineStackSize()) {
+        reason = "no inline stack";
+    }
+
+    if (compiler->JITFlags() & JITFlagValue::JITVerbose) {
+        if (reason == nullptr) {
+            printf("Inline: call of function %d is inlined\n", static_cast<int>(call->index()));
+        } else {
+            printf("Inline: call of function %d is not inlined: %s\n", static_cast<int>(call->index()), reason);
+        }
+    }
+
+    if (reason != nullptr) {
+        return false;
+    }
+
+    FunctionType* functionType = callee->functionType();
+    ByteCodeStackOffset* stackOffset = call->stackOffsets();
+    uint32_t inlineStackStart = function->inlineStackStart();
+    uint32_t paramOffset = inlineStackStart;
+
+    for (auto it : functionType->param().types()) {
+        size_t count = (valueSize(it) + (sizeof(size_t) - 1)) / sizeof(size_t);
+
+        appendInlineMove(compiler, call, it, STACK_OFFSET(*stackOffset), STACK_OFFSET(paramOffset));
+        stackOffset += count;
+        paramOffset += static_cast<uint32_t>(count * sizeof(size_t));
+    }
+
+    InstructionListItem* last = compiler->last();
+    std::map<size_t, Label*> labels;
+    End* end = nullptr;
+
+    compileByteCodes(compiler, callee, labels, &end);
+    ASSERT(end != nullptr);
+
+    // Operands of the callee are relative to the start of its frame.
+    InstructionListItem* item = (last != nullptr) ? last->next() : compiler->first();
+    Operand frameStart = STACK_OFFSET(inlineStackStart);
+
+    for (; item != nullptr; item = item->next()) {
+        if (!item->isInstruction()) {
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+        Operand* operand = instr->operands();
+        Operand* operandEnd = operand + instr->paramCount() + instr->resultCount();
+
+        while (operand < operandEnd) {
+            *operand++ += frameStart;
+        }
+    }
+
+    ByteCodeStackOffset* resultOffset = end->resultOffsets();
+
+    for (auto it : functionType->result().types()) {
+        size_t count = (valueSize(it) + (sizeof(size_t) - 1)) / sizeof(size_t);
+
+        appendInlineMove(compiler, call, it, STACK_OFFSET(inlineStackStart + *resultOffset), STACK_OFFSET(*stackOffset));
+        resultOffset += count;
+        stackOffset += count;
+    }
+
+    return true;
+}
+
 static void compileFunction(JITCompiler* compiler)
 {
     size_t idx = 0;
@@ -606,6 +795,9 @@ static void compileFunction(JITCompiler* compiler)
     }
 
     std::map<size_t, Label*> labels;
+    // Targets of backward jumps, which are counted by the interpreter.
+    std::set<size_t> loopHeaders;
+    bool hasOSREntries = (compiler->JITFlags() & JITFlagValue::tieredJIT) != 0;
 
     // Construct labels first
     while (idx < endIdx) {
@@ -616,10 +808,22 @@ static void compileFunction(JITCompiler* compiler)
         case ByteCode::JumpOpcode: {
             Jump* jump = reinterpret_cast<Jump*>(byteCode);
             labels[COMPUTE_OFFSET(idx, jump->offset())] = nullptr;
+
+            if (hasOSREntries && jump->offset() < 0) {
+                loopHeaders.insert(COMPUTE_OFFSET(idx, jump->offset()));
+            }
             break;
         }
         case ByteCode::JumpIfTrueOpcode:
-        case ByteCode::JumpIfFalseOpcode:
+        case ByteCode::JumpIfFalseOpcode: {
+            ByteCodeOffsetValue* offsetValue = reinterpret_cast<ByteCodeOffsetValue*>(byteCode);
+            labels[COMPUTE_OFFSET(idx, offsetValue->int32Value())] = nullptr;
+
+            if (hasOSREntries && offsetValue->int32Value() < 0) {
+                loopHeaders.insert(COMPUTE_OFFSET(idx, offsetValue->int32Value()));
+            }
+            break;
+        }
         case ByteCode::JumpIfNullOpcode:
         case ByteCode::JumpIfNonNullOpcode:
         case ByteCode::JumpIfCastGenericOpcode:
@@ -661,17 +865,52 @@ static void compileFunction(JITCompiler* compiler)
         it->second = new Label();
     }
 
+    for (auto it : loopHeaders) {
+        compiler->appendOSREntry(labels[it], it);
+    }
+
     compiler->initTryBlockStart();
     buildCatchInfo(compiler, function, labels);
 
-    it = labels.begin();
+    compileByteCodes(compiler, function, labels, nullptr);
+
+    uint32_t optLevel = compiler->module()->store()->JITOptLevel();
+
+    if (optLevel > 0) {
+        compiler->optimize(optLevel);
+    }
+
+    compiler->buildVariables(STACK_OFFSET(function->requiredStackSize()));
+
+    if (compiler->JITFlags() & JITFlagValue::disableRegAlloc) {
+        compiler->allocateRegistersSimple();
+    } else {
+        compiler->allocateRegisters();
+    }
+
+#if !defined(NDEBUG)
+    if (compiler->JITFlags() & JITFlagValue::JITVerbose) {
+        compiler->dump();
+    }
+#endif /* !NDEBUG */
+
+    compiler->freeVariables();
+
+    compiler->compileFunction(new JITFunction(), true);
+}
+
+// The End byte code of inlined functions is not compiled, it is stored in inlineEnd instead.
+static void compileByteCodes(JITCompiler* compiler, ModuleFunction* function, std::map<size_t, Label*>& labels, End** inlineEnd)
+{
+    size_t idx = 0;
+    size_t endIdx = function->byteCodeSize();
+    std::map<size_t, Label*>::iterator it = labels.begin();
     size_t nextLabelIndex = ~static_cast<size_t>(0);
 
     if (it != labels.end()) {
         nextLabelIndex = it->first;
     }
 
-    idx = 0;
     while (idx < endIdx) {
         if (idx == nextLabelIndex) {
             compiler->appendLabel(it->second);
@@ -1199,11 +1438,25 @@ static void compileFunction(JITCompiler* compiler)
                 callerCount = 1;
             }
 
+            if (opcode == ByteCode::CallOpcode && inlineCall(compiler, function, reinterpret_cast<Call*>(byteCode))) {
+                break;
+            }
+
             Instruction* instr = compiler->appendExtended(byteCode, Instruction::Call, opcode,
                                                           functionType->param().size() + callerCount, functionType->result().size());
+
             Operand* operand = instr->operands();
             instr->addInfo(Instruction::kIsCallback | Instruction::kFreeUnusedEarly);
 
+            if (opcode == ByteCode::CallOpcode && compiler->isDirectCallTarget(compiler->module()->function(reinterpret_cast<Call*>(byteCode)->index()))) {
+                instr->addInfo(Instruction::kDirectCall);
+                compiler->setHasDirectCall();
+            } else if (opcode == ByteCode::CallIndirectOpcode && functionType->typeID() != 0) {
+                // Targets with the same type ID are called directly.
+                instr->addInfo(Instruction::kDirectCall);
+                compiler->setHasDirectCall();
+            }
+
             for (auto it : functionType->param().types()) {
                 *operand++ = STACK_OFFSET(*stackOffset);
                 stackOffset += (valueSize(it) + (sizeof(size_t) - 1)) / sizeof(size_t);
@@ -2026,6 +2279,11 @@ static void compileFunction(JITCompiler* compiler)
             instr->addInfo(Instruction::kIsCallback);
             break;
         }
+        case ByteCode::CheckEpochOpcode: {
+            // The registers are only saved when the deadline is reached.
+            compiler->append(byteCode, group, opcode, 0, 0);
+            break;
+        }
         case ByteCode::AtomicFenceOpcode: {
             group = Instruction::AtomicFence;
             FALLTHROUGH;
@@ -2148,6 +2406,47 @@ static void compileFunction(JITCompiler* compiler)
             operands[1] = STACK_OFFSET(moveFloat->dstOffset());
             break;
         }
+        case ByteCode::MoveWideI32Opcode:
+        case ByteCode::MoveWideF32Opcode:
+        case ByteCode::MoveWideI64Opcode:
+        case ByteCode::MoveWideF64Opcode:
+        case ByteCode::MoveWideV128Opcode: {
+            // Wide offsets are only a byte code encoding, the
+            // compiler handles them the same way as other moves.
+            MoveWide* moveWide = reinterpret_cast<MoveWide*>(byteCode);
+            ByteCode::Opcode moveOpcode;
+
+            switch (opcode) {
+            case ByteCode::MoveWideI32Opcode:
+                moveOpcode = ByteCode::MoveI32Opcode;
+                requiredInit = OTOp1I32;
+                break;
+            case ByteCode::MoveWideF32Opcode:
+                moveOpcode = ByteCode::MoveF32Opcode;
+                requiredInit = OTF32ReinterpretI32;
+                break;
+            case ByteCode::MoveWideI64Opcode:
+                moveOpcode = ByteCode::MoveI64Opcode;
+                requiredInit = OTOp1I64;
+                break;
+            case ByteCode::MoveWideF64Opcode:
+                moveOpcode = ByteCode::MoveF64Opcode;
+                requiredInit = OTF64ReinterpretI64;
+                break;
+            default:
+                moveOpcode = ByteCode::MoveV128Opcode;
+                requiredInit = OTMoveV128;
+                break;
+            }
+
+            Instruction* instr = compiler->append(byteCode, Instruction::Move, moveOpcode, 1, 1);
+            instr->setRequiredRegsDescriptor(requiredInit);
+
+            Operand* operands = instr->operands();
+            operands[0] = STACK_OFFSET(moveWide->srcOffset());
+            operands[1] = STACK_OFFSET(moveWide->dstOffset());
+            break;
+        }
         case ByteCode::GlobalGet32Opcode: {
             GlobalGet32* globalGet32 = reinterpret_cast<GlobalGet32*>(byteCode);
             group = Instruction::Any;
@@ -2458,6 +2757,13 @@ static void compileFunction(JITCompiler* compiler)
             break;
         }
         case ByteCode::EndOpcode: {
+            if (inlineEnd != nullptr) {
+                ASSERT(idx + byteCode->getSize() == endIdx);
+                *inlineEnd = reinterpret_cast<End*>(byteCode);
+                idx += byteCode->getSize();
+                continue;
+            }
+
             const TypeVector& result = function->functionType()->result();
 
             Instruction* instr = compiler->append(byteCode, Instruction::Any, opcode, result.size(), 0);
@@ -3623,27 +3929,6 @@ static void compileFunction(JITCompiler* compiler)
 
         idx += byteCode->getSize();
     }
-
-    compiler->buildVariables(STACK_OFFSET(function->requiredStackSize()));
-
-    if (compiler->JITFlags() & JITFlagValue::disableRegAlloc) {
-        compiler->allocateRegistersSimple();
-    } else {
-        compiler->allocateRegisters();
-    }
-
-#if !defined(NDEBUG)
-    if (compiler->JITFlags() & JITFlagValue::JITVerbose) {
-        compiler->dump();
-    }
-#endif /* !NDEBUG */
-
-    compiler->freeVariables();
-
-    Walrus::JITFunction* jitFunc = new JITFunction();
-
-    function->setJITFunction(jitFunc);
-    compiler->compileFunction(jitFunc, true);
 }
 
 const uint8_t* VariableList::getOperandDescriptor(Instruction* instr)
@@ -3730,13 +4015,294 @@ const uint8_t* VariableList::getOperandDescriptor(Instruction* instr)
     return instr->getOperandDescriptor();
 }
 
+// The optimizer helpers below are defined here, since
+// the operand descriptors are only available in this file.
+
+void JITCompiler::convertToConst(Instruction* instr, uint64_t value, bool is64Bit)
+{
+    ASSERT(!(instr->info() & Instruction::kIsExtended) && instr->internalResultCount() == 1);
+
+    Operand result = *instr->getResult(0);
+
+    instr->m_group = Instruction::Immediate;
+    instr->m_paramCount = 0;
+    instr->setInfo(0);
+
+    if (is64Bit) {
+        m_optimizerConst64.emplace_back(0, value);
+        instr->m_byteCode = &m_optimizerConst64.back();
+        instr->m_opcode = ByteCode::Const64Opcode;
+        instr->setRequiredRegsDescriptor(OTPutI64);
+    } else {
+        m_optimizerConst32.emplace_back(0, static_cast<uint32_t>(value));
+        instr->m_byteCode = &m_optimizerConst32.back();
+        instr->m_opcode = ByteCode::Const32Opcode;
+        instr->setRequiredRegsDescriptor(OTPutI32);
+    }
+
+    *instr->operands() = result;
+}
+
+void JITCompiler::convertToMove(Instruction* instr, Operand src, bool is64Bit)
+{
+    ASSERT(!(instr->info() & Instruction::kIsExtended) && instr->internalResultCount() == 1);
+
+    Operand result = *instr->getResult(0);
+
+    // The byte code is kept for the debug entries.
+    instr->m_group = Instruction::Move;
+    instr->m_opcode = is64Bit ? ByteCode::MoveI64Opcode : ByteCode::MoveI32Opcode;
+    instr->m_paramCount = 1;
+    instr->setInfo(0);
+    instr->setRequiredRegsDescriptor(is64Bit ? OTOp1I64 : OTOp1I32);
+
+    Operand* operands = instr->operands();
+    operands[0] = src;
+    operands[1] = result;
+}
+
+static size_t countTryBlocks(ModuleFunction* function)
+{
+    std::map<TryRange, size_t> ranges;
+
+    collectTryRanges(function, ranges);
+    return ranges.size();
+}
+
+struct JITCompileBatch {
+    JITCompileBatch(size_t start, size_t end, JITCompiler* compiler)
+        : start(start)
+        , end(end)
+        , compiler(compiler)
+    {
+    }
+
+    size_t start;
+    size_t end;
+    JITCompiler* compiler;
+};
+
+static void jitCompileInParallel(Module* module, std::vector<ModuleFunction*>& functions, size_t threadCount, uint32_t JITFlags)
+{
+    // Several batches per thread balance the work between the threads.
+    const size_t batchesPerThread = 4;
+
+    size_t functionCount = functions.size();
+    size_t byteCodeSize = 0;
+
+    for (auto it : functions) {
+        byteCodeSize += it->byteCodeSize();
+    }
+
+    // The functions are split into batches of consecutive functions with similar
+    // byte code size, so the layout of the generated code is always the same.
+    size_t batchSize = byteCodeSize / (threadCount * batchesPerThread) + 1;
+    std::vector<JITCompileBatch> batches;
+    std::unordered_set<ModuleFunction*> directCallTargets(functions.begin(), functions.end());
+    size_t start = 0;
+    size_t currentSize = 0;
+    size_t tryBlockCount = 0;
+
+    for (size_t i = 0; i < functionCount; i++) {
+        currentSize += functions[i]->byteCodeSize();
+
+        if (currentSize < batchSize && i + 1 < functionCount) {
+            continue;
+        }
+
+        JITCompiler* compiler = new JITCompiler(module, JITFlags);
+
+        // Try block indices are encoded in the machine code, so they
+        // are assigned before the batches are compiled.
+        compiler->setTryBlockOffset(compiler->tryBlockOffset() + tryBlockCount);
+        compiler->setRemoteDirectCallTargets(&directCallTargets);
+
+        if (!batches.empty()) {
+            compiler->disableEntryCode();
+        }
+
+        for (size_t j = start; j <= i; j++) {
+            compiler->addDirectCallTarget(functions[j]);
+            tryBlockCount += countTryBlocks(functions[j]);
+        }
+
+        batches.push_back(JITCompileBatch(start, i + 1, compiler));
+        start = i + 1;
+        currentSize = 0;
+    }
+
+    std::atomic<size_t> nextBatch(0);
+
+    auto worker = [&]() {
+        while (true) {
+            size_t index = nextBatch.fetch_add(1);
+
+            if (index >= batches.size()) {
+                return;
+            }
+
+            JITCompileBatch& batch = batches[index];
+
+            for (size_t i = batch.start; i < batch.end; i++) {
+                batch.compiler->setModuleFunction(functions[i]);
+                compileFunction(batch.compiler);
+            }
+
+            batch.compiler->generateCode();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    size_t workerCount = std::min(threadCount, batches.size());
+
+    for (size_t i = 1; i < workerCount; i++) {
+        threads.push_back(std::thread(worker));
+    }
+
+    worker();
+
+    for (auto& it : threads) {
+        it.join();
+    }
+
+    // Registered in creation order, so the result does not depend on thread scheduling.
+    for (auto& it : batches) {
+        it.compiler->registerCode();
+    }
+
+    for (auto& it : batches) {
+        it.compiler->linkCode();
+        delete it.compiler;
+    }
+}
+
+// The frames of the functions are enlarged by the frames of their inlined
+// callees, so this must be done before any function is executed or compiled.
+void Module::reserveInlineStacks()
+{
+    uint32_t maxByteCodes = store()->JITInlineSize();
+
+    if (maxByteCodes == 0) {
+        return;
+    }
+
+    size_t functionCount = m_functions.size();
+
+    for (size_t i = 0; i < functionCount; i++) {
+        ModuleFunction* caller = m_functions[i];
+        size_t idx = 0;
+        size_t endIdx = caller->byteCodeSize();
+        uint32_t inlineStackSize = 0;
+
+        if (caller->inlineStackSize() > 0) {
+            continue;
+        }
+
+        while (idx < endIdx) {
+            ByteCode* byteCode = caller->getByteCode<ByteCode>(idx);
+
+            if (byteCode->opcode() == ByteCode::CallOpcode) {
+                ModuleFunction* callee = function(reinterpret_cast<Call*>(byteCode)->index());
+
+                if (callee->requiredStackSize() > inlineStackSize && inlineRejectReason(callee, maxByteCodes) == nullptr) {
+                    inlineStackSize = callee->requiredStackSize();
+                }
+            }
+
+            idx += byteCode->getSize();
+        }
+
+        if (inlineStackSize > 0) {
+            caller->reserveInlineStack(inlineStackSize);
+        }
+    }
+}
+
 void Module::jitCompile(ModuleFunction** functions, size_t functionsLength, uint32_t JITFlags)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    size_t threadCount = store()->JITThreadCount();
+
+    if (functionsLength == 0) {
+        // All functions are compiled after the module is parsed.
+        reserveInlineStacks();
+    }
+
+#if !defined(NDEBUG)
+    if (JITFlags & JITFlagValue::JITVerbose) {
+        // The dumps of different threads would be mixed.
+        threadCount = 1;
+    }
+#endif /* !NDEBUG */
+
+    if (threadCount > 1) {
+        std::vector<ModuleFunction*> functionList;
+
+        if (functionsLength == 0) {
+            functions = m_functions.data();
+            functionsLength = m_functions.size();
+        }
+
+        for (size_t i = 0; i < functionsLength; i++) {
+            if (functions[i]->jitFunction() == nullptr && functions[i]->byteCodeSize() > 0) {
+                functionList.push_back(functions[i]);
+            }
+        }
+
+        jitCompileInParallel(this, functionList, threadCount, JITFlags);
+    } else {
+        jitCompileFunctions(functions, functionsLength, JITFlags);
+    }
+
+    if (JITFlags & JITFlagValue::JITVerbose) {
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+        printf("[[[[[[[  Compile time: %.3f ms, threads: %d  ]]]]]]]\n", elapsed.count(), static_cast<int>(threadCount));
+    }
+}
+
+void Module::enableTieredCompilation(uint32_t JITFlags)
+{
+    ASSERT(JITFlags & JITFlagValue::tieredJIT);
+    m_tieredJITFlags = JITFlags;
+    reserveInlineStacks();
+
+    // Created here, since modules are parsed before they are executed by any thread.
+    store()->tieredCompiler();
+
+    size_t functionCount = m_functions.size();
+    uint32_t threshold = store()->JITTierUpThreshold();
+
+    for (size_t i = 0; i < functionCount; i++) {
+        if (m_functions[i]->byteCodeSize() > 0) {
+            m_functions[i]->enableTierUpCounter(threshold);
+        }
+    }
+}
+
+void Module::tierUp(ModuleFunction* function)
+{
+    ASSERT(m_tieredJITFlags & JITFlagValue::tieredJIT);
+
+    if (m_tieredJITFlags & JITFlagValue::JITVerbose) {
+        printf("[[[[[[[  Tier up function %p  ]]]]]]]\n", function);
+    }
+
+    store()->tieredCompiler()->enqueue(this, function);
+}
+
+void Module::jitCompileFunctions(ModuleFunction** functions, size_t functionsLength, uint32_t JITFlags)
 {
     JITCompiler compiler(this, JITFlags);
 
     if (functionsLength == 0) {
         size_t functionCount = m_functions.size();
 
+        for (size_t i = 0; i < functionCount; i++) {
+            if (m_functions[i]->jitFunction() == nullptr) {
+                compiler.addDirectCallTarget(m_functions[i]);
+            }
+        }
+
         for (size_t i = 0; i < functionCount; i++) {
             if (m_functions[i]->jitFunction() == nullptr) {
                 if (JITFlags & JITFlagValue::JITVerbose) {
@@ -3748,6 +4314,12 @@ void Module::jitCompile(ModuleFunction** functions, size_t functionsLength, uint
             }
         }
     } else {
+        for (size_t i = 0; i < functionsLength; i++) {
+            if (functions[i]->jitFunction() == nullptr) {
+                compiler.addDirectCallTarget(functions[i]);
+            }
+        }
+
         do {
             if ((*functions)->jitFunction() == nullptr) {
                 if (JITFlags & JITFlagValue::JITVerbose) {
@@ -3763,6 +4335,8 @@ void Module::jitCompile(ModuleFunction** functions, size_t functionsLength, uint
     }
 
     compiler.generateCode();
+    compiler.registerCode();
+    compiler.linkCode();
 }
 
 } // namespace Walrus
@@ -57,7 +57,7 @@ static sljit_sw callFunctionIndirect(
     }
 
     const FunctionType* ft = target->functionType();
-    if (!ft->equals(code->functionType())) {
+    if (!target->hasTypeID(code->functionType()->typeID()) && !ft->equals(code->functionType())) {
         context->error = ExecutionContext::IndirectCallTypeMismatchError;
         return ExecutionContext::IndirectCallTypeMismatchError;
     }
@@ -121,6 +121,168 @@ static sljit_sw shuffleTailCallSelfArguments(uint8_t* bp, ByteCodeStackOffset* o
     return ExecutionContext::NoError;
 }
 
+// SLJIT_R0 contains the result offsets of the callee. Returns with the
+// jump taken after the results are copied into the frame of the caller.
+static sljit_jump* emitDirectCallReturn(sljit_compiler* compiler, ByteCodeStackOffset* stackOffset, uint16_t resultOffsetsSize)
+{
+    sljit_emit_op1(compiler, SLJIT_MOV, kFrameReg, 0, SLJIT_MEM1(SLJIT_SP), kSavedFrameOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), kDirectCallFrameOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R2), OffsetOfContextField(frameStackTop), SLJIT_R1, 0);
+
+    for (uint16_t i = 0; i < resultOffsetsSize; i++) {
+        sljit_emit_op1(compiler, SLJIT_MOV_U16, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R0), static_cast<sljit_sw>(i * sizeof(ByteCodeStackOffset)));
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM2(SLJIT_R1, SLJIT_R2), 0);
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(kFrameReg), static_cast<sljit_sw>(stackOffset[i]), SLJIT_R2, 0);
+    }
+
+    return sljit_emit_jump(compiler, SLJIT_JUMP);
+}
+
+// Directly called functions run without an ExecutionState and their frames
+// have no function header. Traps, exceptions and host calls of the callee
+// are therefore attributed to the function which entered compiled code, and
+// the sampling profiler does not see the callee. Walrus reports no trap
+// backtraces, so only the profiler output is affected.
+static sljit_jump* emitDirectCall(sljit_compiler* compiler, Call* call)
+{
+    CompileContext* context = CompileContext::get(compiler);
+    ModuleFunction* target = context->module->function(call->index());
+    ByteCodeStackOffset* stackOffset = call->stackOffsets();
+    uint16_t parameterOffsetsSize = call->parameterOffsetsSize();
+    uint16_t resultOffsetsSize = call->resultOffsetsSize();
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_get_local_base(compiler, SLJIT_R1, 0, 0);
+    context->appendTrapJump(ExecutionContext::OutOfStackError,
+                            sljit_emit_cmp(compiler, SLJIT_LESS, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(stackLimit)));
+
+    // Allocate the frame of the callee. The generic path is used when the frame stack is exhausted.
+    sljit_sw frameSize = static_cast<sljit_sw>((target->requiredStackSize() + 0xf) & ~0xf);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), kDirectCallFrameOffset);
+    sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R2, 0, SLJIT_R1, 0, SLJIT_IMM, frameSize);
+    sljit_jump* slowPath = sljit_emit_cmp(compiler, SLJIT_GREATER, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(frameStackEnd));
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(frameStackTop), SLJIT_R2, 0);
+
+    for (uint16_t i = 0; i < parameterOffsetsSize; i++) {
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(kFrameReg), static_cast<sljit_sw>(stackOffset[i]));
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_R1), static_cast<sljit_sw>(i * sizeof(sljit_sw)), SLJIT_R2, 0);
+    }
+
+    // The callee shares the context and the instance register,
+    // and errors are returned to the trap handler of this function.
+    sljit_emit_op1(compiler, SLJIT_MOV, kFrameReg, 0, SLJIT_R1, 0);
+
+    // The targets compiled by other threads must be checked
+    // before their jitFunction() is accessed.
+    if (context->compiler->isLocalDirectCallTarget(target)) {
+        context->compiler->appendDirectCall(sljit_emit_call(compiler, SLJIT_CALL_REG_ARG, SLJIT_ARGS1(P, P)), target);
+    } else if (context->compiler->isRemoteDirectCallTarget(target)) {
+        context->compiler->appendDirectCall(sljit_emit_call(compiler, SLJIT_CALL_REG_ARG | SLJIT_REWRITABLE_JUMP, SLJIT_ARGS1(P, P)), target);
+    } else {
+        JITFunction* jitFunc = target->jitFunction();
+
+        ASSERT(jitFunc != nullptr && jitFunc->isCompiled());
+        sljit_emit_icall(compiler, SLJIT_CALL_REG_ARG, SLJIT_ARGS1(P, P), SLJIT_IMM, reinterpret_cast<sljit_sw>(jitFunc->exportEntry()));
+    }
+
+    sljit_jump* directCallEnd = emitDirectCallReturn(compiler, stackOffset + parameterOffsetsSize, resultOffsetsSize);
+    sljit_set_label(slowPath, sljit_emit_label(compiler));
+    return directCallEnd;
+}
+
+// Indirect calls of compiled functions of the same instance with the expected
+// type ID are direct calls. The generic call is used for any other targets.
+static sljit_jump* emitIndirectDirectCall(sljit_compiler* compiler, CallIndirect* callIndirect)
+{
+    CompileContext* context = CompileContext::get(compiler);
+    ByteCodeStackOffset* stackOffset = callIndirect->stackOffsets();
+    uint16_t parameterOffsetsSize = callIndirect->parameterOffsetsSize();
+    sljit_jump* slowPaths[7];
+
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(kInstanceReg), context->tableStart + callIndirect->tableIndex() * sizeof(void*));
+    sljit_emit_op1(compiler, SLJIT_MOV_U32, SLJIT_R2, 0, SLJIT_MEM1(kFrameReg), static_cast<sljit_sw>(callIndirect->calleeOffset()));
+    slowPaths[0] = sljit_emit_cmp(compiler, SLJIT_GREATER_EQUAL | SLJIT_32, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::tableSizeOffset());
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::tableElements());
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM2(SLJIT_R1, SLJIT_R2), SLJIT_WORD_SHIFT);
+    slowPaths[1] = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R1, 0, SLJIT_IMM, static_cast<sljit_sw>(Value::NullBits));
+
+    // Only defined functions have non-zero type IDs.
+    slowPaths[2] = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL | SLJIT_32, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::functionTypeID(),
+                                  SLJIT_IMM, static_cast<sljit_s32>(callIndirect->functionType()->typeID()));
+    slowPaths[3] = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::definedFunctionInstance(), kInstanceReg, 0);
+
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::definedFunctionModuleFunction());
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R3, 0, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::moduleFunctionJITFunction());
+    slowPaths[4] = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R3, 0, SLJIT_IMM, 0);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R3, 0, SLJIT_MEM1(SLJIT_R3), JITFieldAccessor::jitFunctionExportEntry());
+    slowPaths[5] = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R3, 0, SLJIT_IMM, 0);
+
+    sljit_emit_op1(compiler, SLJIT_MOV_U32, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R1), JITFieldAccessor::moduleFunctionRequiredStackSize());
+    sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, 0xf);
+    sljit_emit_op2(compiler, SLJIT_AND, SLJIT_R2, 0, SLJIT_R2, 0, SLJIT_IMM, ~static_cast<sljit_sw>(0xf));
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_get_local_base(compiler, SLJIT_R1, 0, 0);
+    context->appendTrapJump(ExecutionContext::OutOfStackError,
+                            sljit_emit_cmp(compiler, SLJIT_LESS, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(stackLimit)));
+
+    // Allocate the frame of the callee. The generic path is used when the frame stack is exhausted.
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), kDirectCallFrameOffset);
+    sljit_emit_op2(compiler, SLJIT_ADD, SLJIT_R2, 0, SLJIT_R1, 0, SLJIT_R2, 0);
+    slowPaths[6] = sljit_emit_cmp(compiler, SLJIT_GREATER, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(frameStackEnd));
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(frameStackTop), SLJIT_R2, 0);
+
+    for (uint16_t i = 0; i < parameterOffsetsSize; i++) {
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(kFrameReg), static_cast<sljit_sw>(stackOffset[i]));
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_R1), static_cast<sljit_sw>(i * sizeof(sljit_sw)), SLJIT_R2, 0);
+    }
+
+    sljit_emit_op1(compiler, SLJIT_MOV, kFrameReg, 0, SLJIT_R1, 0);
+    sljit_emit_icall(compiler, SLJIT_CALL_REG_ARG, SLJIT_ARGS1(P, P), SLJIT_R3, 0);
+
+    sljit_jump* directCallEnd = emitDirectCallReturn(compiler, stackOffset + parameterOffsetsSize, callIndirect->resultOffsetsSize());
+    sljit_label* slowPath = sljit_emit_label(compiler);
+
+    for (size_t i = 0; i < sizeof(slowPaths) / sizeof(slowPaths[0]); i++) {
+        sljit_set_label(slowPaths[i], slowPath);
+    }
+
+    return directCallEnd;
+}
+
+#if !(defined SLJIT_INDIRECT_CALL && SLJIT_INDIRECT_CALL)
+// Imports are resolved when the module is instantiated, so the entry of
+// typed functions is checked at runtime. Returns with the jump taken after
+// a successful call, and errorJump is set to the jump taken after a trap.
+static sljit_jump* emitTypedCall(sljit_compiler* compiler, Call* call, sljit_jump** errorJump)
+{
+    CompileContext* context = CompileContext::get(compiler);
+    sljit_sw entryOffset = JITFieldAccessor::functionTypedEntry();
+
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(kInstanceReg), static_cast<sljit_sw>(context->functionsStart + call->index() * sizeof(void*)));
+    sljit_jump* genericCall = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_MEM1(SLJIT_R1), entryOffset, SLJIT_IMM, 0);
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_R0), OffsetOfContextField(state));
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, kFrameReg, 0);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R3, 0, SLJIT_IMM, reinterpret_cast<sljit_sw>(call->stackOffsets()));
+    sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS4(P, P, P, P, P), SLJIT_MEM1(SLJIT_R1), entryOffset);
+
+    sljit_jump* callEnd = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 0);
+
+    // SLJIT_R0 contains the exception thrown by the function.
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R1), OffsetOfContextField(capturedException), SLJIT_R0, 0);
+    sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_MEM1(SLJIT_R1), OffsetOfContextField(error), SLJIT_IMM, ExecutionContext::CapturedException);
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, ExecutionContext::CapturedException);
+    *errorJump = sljit_emit_jump(compiler, SLJIT_JUMP);
+
+    sljit_set_label(genericCall, sljit_emit_label(compiler));
+    return callEnd;
+}
+#endif /* !SLJIT_INDIRECT_CALL */
+
 static void emitCall(sljit_compiler* compiler, Instruction* instr)
 {
     FunctionType* functionType;
@@ -255,13 +417,42 @@ static void emitCall(sljit_compiler* compiler, Instruction* instr)
         operand++;
     }
 
+    sljit_jump* directCallEnd = nullptr;
+    sljit_jump* typedCallError = nullptr;
+
+    if (instr->info() & Instruction::kDirectCall) {
+        if (callOpcode == ByteCode::CallOpcode) {
+            directCallEnd = emitDirectCall(compiler, reinterpret_cast<Call*>(instr->byteCode()));
+        } else {
+            ASSERT(callOpcode == ByteCode::CallIndirectOpcode);
+            directCallEnd = emitIndirectDirectCall(compiler, reinterpret_cast<CallIndirect*>(instr->byteCode()));
+        }
+    }
+#if !(defined SLJIT_INDIRECT_CALL && SLJIT_INDIRECT_CALL)
+    else if (callOpcode == ByteCode::CallOpcode) {
+        Call* call = reinterpret_cast<Call*>(instr->byteCode());
+
+        if (context->compiler->module()->function(call->index())->byteCodeSize() == 0) {
+            directCallEnd = emitTypedCall(compiler, call, &typedCallError);
+        }
+    }
+#endif /* !SLJIT_INDIRECT_CALL */
+
     sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R0, 0, SLJIT_IMM, reinterpret_cast<sljit_sw>(instr->byteCode()));
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, kFrameReg, 0);
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
     sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS3(W, W, W, W), SLJIT_IMM, addr);
 
+    if (typedCallError != nullptr) {
+        sljit_set_label(typedCallError, sljit_emit_label(compiler));
+    }
+
     sljit_jump* jump = sljit_emit_cmp(compiler, SLJIT_NOT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, ExecutionContext::NoError);
 
+    if (directCallEnd != nullptr) {
+        sljit_set_label(directCallEnd, sljit_emit_label(compiler));
+    }
+
     for (auto it : functionType->result().types()) {
         ASSERT(VARIABLE_TYPE(*operand) != Instruction::ConstPtr);
 
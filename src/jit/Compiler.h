@@ -36,6 +36,7 @@ class JITFunction;
 class Instruction;
 class ExtendedInstruction;
 class BrTableInstruction;
+class LoopBoundsCheckInstruction;
 class Label;
 class JITModule;
 class DataSegment;
@@ -46,6 +47,10 @@ struct ExecutionContext;
 // Defined in ObjectType.h.
 class FunctionType;
 
+// Opcode of the LoopBoundsCheckInstruction, which is created by
+// the optimizer and has no corresponding byte code.
+static const ByteCode::Opcode kLoopBoundsCheckOpcode = ByteCode::OpcodeKindEnd;
+
 class InstructionListItem {
     friend class JITCompiler;
 
@@ -261,6 +266,13 @@ public:
     // These two are only used by memory load/store instructions
     static const uint16_t kMultiMemory = 1 << 9;
     static const uint16_t kMemory64 = 1 << 10;
+    // Only used by call instructions: the target is a compiled function
+    // of the same module, which is called without the C helper. Indirect
+    // calls check the target at runtime, and use the C helper on mismatch.
+    static const uint16_t kDirectCall = 1 << 9;
+    // Only used by memory load/store instructions: the address
+    // range is checked before the loop containing the instruction.
+    static const uint16_t kBoundsChecked = 1 << 11;
 
     ByteCode::Opcode opcode() { return m_opcode; }
 
@@ -296,6 +308,12 @@ public:
         return reinterpret_cast<BrTableInstruction*>(this);
     }
 
+    LoopBoundsCheckInstruction* asLoopBoundsCheck()
+    {
+        ASSERT(group() == Instruction::DirectBranch && opcode() == kLoopBoundsCheckOpcode);
+        return reinterpret_cast<LoopBoundsCheckInstruction*>(this);
+    }
+
     void setRequiredRegsDescriptor(uint32_t requiredRegsDescriptor)
     {
         u.m_requiredRegsDescriptor = requiredRegsDescriptor;
@@ -400,6 +418,45 @@ private:
     Label** m_targetLabels;
 };
 
+// Checks the address ranges of the memory accesses of a loop before the loop
+// is entered. The memory accesses are affine functions of the loop variable,
+// which is increased by a constant step until it reaches the loop limit.
+struct LoopBoundsCheck {
+    static const uint32_t kMaxTerms = 4;
+    // The loop variable, the limit and the 64 bit terms are checked against these
+    // values before the loop is entered, so their sums cannot overflow.
+    static const uint64_t kMaxInput32 = 0x7ffe0000;
+    static const uint64_t kMaxInput64 = static_cast<uint64_t>(1) << 40;
+
+    struct Access {
+        uint16_t memIndex;
+        // Factor of the loop variable.
+        uint64_t factor;
+        // Factors of the loop invariant terms.
+        uint64_t termFactors[kMaxTerms];
+        // The end of the address range is computed by adding these constants
+        // to the sum of the terms, when the loop variable is replaced by its
+        // initial value or by the loop limit.
+        uint64_t firstEnd;
+        uint64_t lastEnd;
+    };
+
+    bool is64Bit;
+    // The loop limit is a param when it is not constant.
+    bool hasLimitParam;
+    std::vector<Access> accesses;
+};
+
+// Jumps to its target label, when any of the checks fails. The params are
+// the loop variable, the loop limit if it is not constant, and the terms.
+class LoopBoundsCheckInstruction : public ExtendedInstruction {
+    friend class JITCompiler;
+
+public:
+    LoopBoundsCheck* boundsCheck() { return reinterpret_cast<LoopBoundsCheck*>(operands()[paramCount()]); }
+    uint32_t termStart() { return boundsCheck()->hasLimitParam ? 2 : 1; }
+};
+
 struct LabelJumpList;
 struct LabelData;
 
@@ -412,6 +469,7 @@ public:
     static const uint16_t kHasLabelData = 1 << 1;
     static const uint16_t kHasTryInfo = 1 << 2;
     static const uint16_t kHasCatchInfo = 1 << 3;
+    static const uint16_t kIsOSREntry = 1 << 4;
 
     explicit Label()
         : InstructionListItem(CodeLabel)
@@ -438,7 +496,7 @@ private:
 
     // Contexts used by different compiling stages.
     union {
-        size_t m_dependencyStart;
+        size_t m_blockIndex;
         LabelJumpList* m_jumpList;
         sljit_label* m_label;
     };
@@ -582,6 +640,7 @@ struct CompileContext {
     size_t nextTryBlock;
     size_t currentTryBlock;
     size_t trapBlocksStart;
+    bool hasGuardPageAccess;
     Module* module;
     std::vector<TrapBlock> trapBlocks;
     std::vector<size_t> tryBlockStack;
@@ -683,7 +742,7 @@ struct VariableList {
 
 class JITCompiler {
 public:
-#ifdef WALRUS_JITPERF
+    // Maps the machine code to wasm code offsets in the jitdump output.
     struct DebugEntry {
         DebugEntry()
             : line(0)
@@ -701,9 +760,9 @@ public:
             sljit_label* label;
             uintptr_t address;
         } u;
+        // Wasm code offset, 0 terminates the entries of a function.
         uint32_t line;
     };
-#endif
 
     struct BranchTableLabels {
         BranchTableLabels(JITCompiler* compiler, size_t labelCount)
@@ -736,6 +795,7 @@ public:
 
     static const uint32_t kHasCondMov = 1 << 0;
     static const uint32_t kHasShortAtomic = 1 << 1;
+    static const uint32_t kMemoryGuardPages = 1 << 2;
 
     static const uint32_t kMaxInlinedBranchTable = 1024;
 
@@ -772,6 +832,15 @@ public:
     BrTableInstruction* appendBrTable(ByteCode* byteCode, uint32_t numTargets, uint32_t offset);
     InstructionListItem* insertStackInit(InstructionListItem* prev, VariableList::Variable& variable, VariableRef ref);
     void insertStackInitList(InstructionListItem* prev, size_t variableListStart, size_t variableListSize);
+    void buildOSRStackInitLists();
+
+    // Loop headers, where the interpreter can continue
+    // the execution in the compiled code of the function.
+    void appendOSREntry(Label* label, size_t byteCodeOffset)
+    {
+        label->addInfo(Label::kIsOSREntry);
+        m_osrEntries.push_back(OSREntry(label, byteCodeOffset));
+    }
 
     void appendLabel(Label* label)
     {
@@ -795,18 +864,67 @@ public:
         m_moduleFunction = moduleFunction;
     }
 
+    void addDirectCallTarget(ModuleFunction* moduleFunction)
+    {
+        m_directCallTargets.insert(moduleFunction);
+    }
+
+    // Functions compiled by other compilers in parallel. They are called
+    // through rewritable calls, which are patched by linkCode().
+    void setRemoteDirectCallTargets(const std::unordered_set<ModuleFunction*>* targets)
+    {
+        m_remoteDirectCallTargets = targets;
+    }
+
+    bool isDirectCallTarget(ModuleFunction* moduleFunction);
+
+    bool isLocalDirectCallTarget(ModuleFunction* moduleFunction)
+    {
+        return m_directCallTargets.find(moduleFunction) != m_directCallTargets.end();
+    }
+
+    bool isRemoteDirectCallTarget(ModuleFunction* moduleFunction)
+    {
+        return m_remoteDirectCallTargets != nullptr && m_remoteDirectCallTargets->find(moduleFunction) != m_remoteDirectCallTargets->end();
+    }
+
+    void appendDirectCall(sljit_jump* jump, ModuleFunction* target)
+    {
+        m_directCalls.push_back(DirectCall(jump, target));
+    }
+
+    bool hasDirectCall() { return m_hasDirectCall; }
+    void setHasDirectCall() { m_hasDirectCall = true; }
+
+    // Rewrites the instruction list before the variables are built. Level 1
+    // folds constants and propagates copies inside the basic blocks, level 2
+    // also simplifies algebraic identities and removes the unused results.
+    // Both levels move the bounds checks of counted loops before the loops.
+    void optimize(uint32_t level);
     void buildVariables(uint32_t requiredStackSize);
     void allocateRegistersSimple();
     void allocateRegisters();
     void freeVariables();
 
     void compileFunction(JITFunction* jitFunc, bool isExternal);
+    // Generates the machine code without modifying the module, so
+    // multiple compilers of the same module can run it in parallel.
     void generateCode();
+    // Adds the generated code to the module. Must be called in the
+    // order of compiler creation, and never in parallel.
+    void registerCode();
+    // Patches the calls to the remote direct call targets, and sets
+    // the JIT function of the compiled functions.
+    void linkCode();
 
     std::vector<TryBlock>& tryBlocks() { return m_tryBlocks; }
     void initTryBlockStart() { m_tryBlockStart = m_tryBlocks.size(); }
     size_t tryBlockOffset() { return m_tryBlockOffset; }
 
+    // Used when the functions of a module are split between multiple compilers.
+    void setTryBlockOffset(size_t value) { m_tryBlockOffset = value; }
+    void disableEntryCode() { m_emitEntryCode = false; }
+
 #if !defined(NDEBUG)
     static const char** byteCodeNames()
     {
@@ -817,25 +935,83 @@ public:
 
 private:
     struct FunctionList {
-        FunctionList(JITFunction* jitFunc, bool isExported, size_t branchTableSize)
-            : jitFunc(jitFunc)
+        FunctionList(ModuleFunction* moduleFunction, JITFunction* jitFunc, bool isExported, size_t branchTableSize)
+            : moduleFunction(moduleFunction)
+            , jitFunc(jitFunc)
             , exportEntryLabel(nullptr)
+            , guardPageTrapLabel(nullptr)
             , isExported(isExported)
             , branchTableSize(branchTableSize)
         {
         }
 
+        ModuleFunction* moduleFunction;
         JITFunction* jitFunc;
         sljit_label* exportEntryLabel;
+        // Execution continues here after a fault caused by a guard page.
+        sljit_label* guardPageTrapLabel;
         bool isExported;
         size_t branchTableSize;
     };
 
+    struct DirectCall {
+        DirectCall(sljit_jump* jump, ModuleFunction* target)
+            : jump(jump)
+            , target(target)
+        {
+        }
+
+        sljit_jump* jump;
+        ModuleFunction* target;
+    };
+
+    struct OSREntry {
+        OSREntry(Label* label, size_t byteCodeOffset)
+            : label(label)
+            , byteCodeOffset(byteCodeOffset)
+            , stackInitList(nullptr)
+        {
+        }
+
+        Label* label;
+        size_t byteCodeOffset;
+        // Loads the variables allocated to registers from the frame.
+        InstructionListItem* stackInitList;
+    };
+
+    struct RemoteDirectCall {
+        RemoteDirectCall(sljit_uw address, ModuleFunction* target)
+            : address(address)
+            , target(target)
+        {
+        }
+
+        sljit_uw address;
+        ModuleFunction* target;
+    };
+
     void append(InstructionListItem* item);
+    ExtendedInstruction* createStackInit(VariableList::Variable& variable, VariableRef ref);
+
+    // Optimizer operations.
+    void propagateValues(uint32_t level);
+    void removeDeadResults();
+    void convertToConst(Instruction* instr, uint64_t value, bool is64Bit);
+    void convertToMove(Instruction* instr, Operand src, bool is64Bit);
+    void remove(InstructionListItem* prev, InstructionListItem* item);
+    void insertAfter(InstructionListItem* prev, InstructionListItem* item);
+    Instruction* copyInstruction(Instruction* instr);
+    void hoistBoundsChecks();
+    Label* versionLoop(InstructionListItem* prev, Label* loopLabel, Instruction* backEdge, LoopBoundsCheck* boundsCheck,
+                       const std::vector<Operand>& params, const std::vector<Instruction*>& checkedAccesses);
 
     // Backend operations.
+    void emitEnter();
     void emitProlog();
     void emitEpilog();
+    void addDebugEntry(Instruction* instr);
+    void dumpPerfInfo(void* code);
+    void emitOSREntries(JITFunction* jitFunc);
 
 #if !defined(NDEBUG)
     static const char* m_byteCodeNames[];
@@ -864,12 +1040,23 @@ private:
     uint8_t m_savedVectorRegCount;
 #endif /* SLJIT_SEPARATE_VECTOR_REGISTERS */
     uint8_t m_stackTmpSize;
+    bool m_hasDirectCall;
+    bool m_emitEntryCode;
+    void* m_code;
+    sljit_sw m_executableOffset;
 
     std::vector<TryBlock> m_tryBlocks;
     std::vector<FunctionList> m_functionList;
-#if defined(WALRUS_JITPERF) && !defined(NDEBUG)
+    std::vector<DirectCall> m_directCalls;
+    std::vector<RemoteDirectCall> m_remoteDirectCalls;
+    std::vector<OSREntry> m_osrEntries;
+    std::unordered_set<ModuleFunction*> m_directCallTargets;
+    const std::unordered_set<ModuleFunction*>* m_remoteDirectCallTargets;
     std::vector<DebugEntry> m_debugEntries;
-#endif /* WALRUS_JITPERF && !NDEBUG */
+    // Byte codes of the constants created by the optimizer.
+    std::deque<Const32> m_optimizerConst32;
+    std::deque<Const64> m_optimizerConst64;
+    std::deque<LoopBoundsCheck> m_loopBoundsChecks;
 };
 
 } // namespace Walrus
@@ -1003,16 +1003,103 @@ static void emitGCArrayAccess(sljit_compiler* compiler, Instruction* instr)
     emitGCDataCopy(compiler, operands + 2, tmpReg, startOffset, type, mode);
 }
 
+#ifdef ENABLE_GC
+// Removes the first object from the free list of its size class and
+// initializes its header. The object is returned in SLJIT_R0, and the
+// returned jump is taken when the free list is empty.
+static sljit_jump* emitGCStructAllocate(sljit_compiler* compiler, const StructType* type)
+{
+    sljit_sw listOffset = static_cast<sljit_sw>(GCAllocator::granules(type->structSize()) * sizeof(void*));
+
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_R1), OffsetOfContextField(gcFreeLists));
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R0, 0, SLJIT_MEM1(SLJIT_R1), listOffset);
+    sljit_jump* emptyList = sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 0);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_R0), 0);
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R1), listOffset, SLJIT_R2, 0);
+
+    // The vtable overwrites the link of the free list, the rest of the object is cleared.
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R0), 0, SLJIT_IMM, static_cast<sljit_sw>(GCStruct::vtable()));
+    sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R0), JITFieldAccessor::objectTypeInfo(), SLJIT_IMM, reinterpret_cast<sljit_sw>(type->subTypeList()));
+    // GCBase::UnassignedReference
+    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_R0), JITFieldAccessor::gcRefIndex(), SLJIT_IMM, -1);
+    return emptyList;
+}
+
+// Copies the fields from the frame to the object in SLJIT_R0.
+static void emitGCStructInit(sljit_compiler* compiler, const StructType* type, ByteCodeStackOffset* offsets)
+{
+    const MutableTypeVector::Types& fields = type->fields().types();
+    const VectorWithFixedSize<uint32_t, std::allocator<uint32_t>>& fieldOffsets = type->fieldOffsets();
+    size_t size = fields.size();
+
+    for (size_t i = 0; i < size; i++) {
+        sljit_sw dstOffset = static_cast<sljit_sw>(fieldOffsets[i]);
+        sljit_sw srcOffset = static_cast<sljit_sw>(offsets[i]);
+        sljit_sw valueSize;
+
+        switch (fields[i].type()) {
+        case Value::I8:
+        case Value::I16:
+            sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_R1, 0, SLJIT_MEM1(kFrameReg), srcOffset);
+            sljit_emit_op1(compiler, fields[i].type() == Value::I8 ? SLJIT_MOV32_U8 : SLJIT_MOV32_U16, SLJIT_MEM1(SLJIT_R0), dstOffset, SLJIT_R1, 0);
+            continue;
+        case Value::I32:
+        case Value::F32:
+            sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_R1, 0, SLJIT_MEM1(kFrameReg), srcOffset);
+            sljit_emit_op1(compiler, SLJIT_MOV32, SLJIT_MEM1(SLJIT_R0), dstOffset, SLJIT_R1, 0);
+            continue;
+        case Value::I64:
+        case Value::F64:
+            valueSize = 8;
+            break;
+        case Value::V128:
+            valueSize = 16;
+            break;
+        default:
+            ASSERT(Value::isRefType(fields[i].type()));
+            valueSize = static_cast<sljit_sw>(sizeof(void*));
+            break;
+        }
+
+        for (sljit_sw offset = 0; offset < valueSize; offset += static_cast<sljit_sw>(sizeof(sljit_sw))) {
+            sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_MEM1(kFrameReg), srcOffset + offset);
+            sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_R0), dstOffset + offset, SLJIT_R1, 0);
+        }
+    }
+}
+#endif /* ENABLE_GC */
+
 static void emitGCStructNew(sljit_compiler* compiler, Instruction* instr)
 {
     CompileContext* context = CompileContext::get(compiler);
+#ifdef ENABLE_GC
+    sljit_jump* emptyList = nullptr;
+    sljit_jump* done = nullptr;
+#endif /* ENABLE_GC */
 
     if (instr->opcode() == ByteCode::StructNewDefaultOpcode) {
         StructNewDefault* structNewDefault = reinterpret_cast<StructNewDefault*>(instr->byteCode());
+
+#ifdef ENABLE_GC
+        if (structNewDefault->typeInfo()->structSize() <= GCAllocator::kMaxGranules * GCAllocator::kGranuleSize) {
+            emptyList = emitGCStructAllocate(compiler, structNewDefault->typeInfo());
+            done = sljit_emit_jump(compiler, SLJIT_JUMP);
+            sljit_set_label(emptyList, sljit_emit_label(compiler));
+        }
+#endif /* ENABLE_GC */
+
         sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, reinterpret_cast<sljit_sw>(structNewDefault->typeInfo()));
         sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS1(P, P), SLJIT_IMM, GET_FUNC_ADDR(sljit_sw, GCStruct::structNewDefault));
         context->appendTrapJump(ExecutionContext::AllocationError,
                                 sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 0));
+
+#ifdef ENABLE_GC
+        if (done != nullptr) {
+            sljit_set_label(done, sljit_emit_label(compiler));
+        }
+#endif /* ENABLE_GC */
+
         JITArg dstArg(instr->operands());
         MOVE_FROM_REG(compiler, SLJIT_MOV, dstArg.arg, dstArg.argw, SLJIT_R0);
         return;
@@ -1026,12 +1113,28 @@ static void emitGCStructNew(sljit_compiler* compiler, Instruction* instr)
         emitGCStore(compiler, *stackOffset++, param++, it.type());
     }
 
+#ifdef ENABLE_GC
+    if (structNew->typeInfo()->structSize() <= GCAllocator::kMaxGranules * GCAllocator::kGranuleSize) {
+        emptyList = emitGCStructAllocate(compiler, structNew->typeInfo());
+        emitGCStructInit(compiler, structNew->typeInfo(), structNew->dataOffsets());
+        done = sljit_emit_jump(compiler, SLJIT_JUMP);
+        sljit_set_label(emptyList, sljit_emit_label(compiler));
+    }
+#endif /* ENABLE_GC */
+
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, reinterpret_cast<sljit_sw>(structNew->typeInfo()));
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, SLJIT_IMM, reinterpret_cast<sljit_sw>(structNew->dataOffsets()));
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, kFrameReg, 0);
     sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS3(P, P, P, P), SLJIT_IMM, GET_FUNC_ADDR(sljit_sw, GCStruct::structNew));
     context->appendTrapJump(ExecutionContext::AllocationError,
                             sljit_emit_cmp(compiler, SLJIT_EQUAL, SLJIT_R0, 0, SLJIT_IMM, 0));
+
+#ifdef ENABLE_GC
+    if (done != nullptr) {
+        sljit_set_label(done, sljit_emit_label(compiler));
+    }
+#endif /* ENABLE_GC */
+
     JITArg dstArg(param);
     MOVE_FROM_REG(compiler, SLJIT_MOV, dstArg.arg, dstArg.argw, SLJIT_R0);
 }
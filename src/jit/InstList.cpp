@@ -223,7 +223,7 @@ BrTableInstruction* JITCompiler::appendBrTable(ByteCode* byteCode, uint32_t numT
     return branch;
 }
 
-InstructionListItem* JITCompiler::insertStackInit(InstructionListItem* prev, VariableList::Variable& variable, VariableRef ref)
+ExtendedInstruction* JITCompiler::createStackInit(VariableList::Variable& variable, VariableRef ref)
 {
     uint32_t type = variable.info & Instruction::TypeMask;
     ByteCode::Opcode opcode;
@@ -253,6 +253,12 @@ InstructionListItem* JITCompiler::insertStackInit(InstructionListItem* prev, Var
     instr->m_resultCount = 1;
     instr->value().offset = variable.value;
     *instr->operands() = ref;
+    return instr;
+}
+
+InstructionListItem* JITCompiler::insertStackInit(InstructionListItem* prev, VariableList::Variable& variable, VariableRef ref)
+{
+    ExtendedInstruction* instr = createStackInit(variable, ref);
 
     if (m_last == prev) {
         m_last = instr;
@@ -284,12 +290,39 @@ void JITCompiler::insertStackInitList(InstructionListItem* prev, size_t variable
     }
 }
 
+void JITCompiler::buildOSRStackInitLists()
+{
+    size_t size = m_variableList->variables.size();
+
+    for (auto& it : m_osrEntries) {
+        size_t id = it.label->id();
+
+        // The interpreter keeps all values in the frame, so the variables
+        // which are alive in a register at the loop header must be loaded.
+        for (size_t i = 0; i < size; i++) {
+            VariableList::Variable& variable = m_variableList->variables[i];
+
+            if ((variable.info & (VariableList::kIsMerged | VariableList::kIsImmediate))
+                || variable.reg1 == VariableList::kUnusedReg
+                || variable.u.rangeStart >= id || variable.rangeEnd < id) {
+                continue;
+            }
+
+            ExtendedInstruction* instr = createStackInit(variable, i);
+            instr->m_next = it.stackInitList;
+            it.stackInitList = instr;
+        }
+    }
+}
+
 #if !defined(NDEBUG)
 
 const char* JITCompiler::m_byteCodeNames[] = {
 #define BYTECODE_NAME(name, ...) #name,
     FOR_EACH_BYTECODE(BYTECODE_NAME)
 #undef DECLARE_BYTECODE
+    // kLoopBoundsCheckOpcode
+    "LoopBoundsCheck",
 };
 
 void JITCompiler::dump()
@@ -324,6 +357,10 @@ void JITCompiler::dump()
                 break;
             }
             case Instruction::DirectBranch: {
+                if (instr->opcode() == kLoopBoundsCheckOpcode) {
+                    printf("  %sLoopBoundsCheck%s: %d ranges\n", highlightFlagText, defaultText,
+                           static_cast<int>(instr->asLoopBoundsCheck()->boundsCheck()->accesses.size()));
+                }
                 printf("  Jump to: %s%d%s\n", labelText, static_cast<int>(instr->asExtended()->value().targetLabel->id()), defaultText);
                 break;
             }
@@ -350,6 +387,11 @@ void JITCompiler::dump()
                 printf("  %sMergeCompare%s\n", highlightFlagText, defaultText);
             }
 
+            if ((instr->group() == Instruction::Load || instr->group() == Instruction::Store)
+                && (instr->info() & Instruction::kBoundsChecked)) {
+                printf("  %sBoundsChecked%s\n", highlightFlagText, defaultText);
+            }
+
             uint32_t paramCount = instr->paramCount();
             uint32_t size = paramCount + instr->resultCount();
             Operand* operand = instr->operands();
@@ -472,8 +514,9 @@ void JITCompiler::dump()
 
             Label* label = item->asLabel();
 
-            printf("%s%s\n", (label->info() & Label::kHasTryInfo) ? " hasTryInfo" : "",
-                   (label->info() & Label::kHasCatchInfo) ? " hasCatchInfo" : "");
+            printf("%s%s%s\n", (label->info() & Label::kHasTryInfo) ? " hasTryInfo" : "",
+                   (label->info() & Label::kHasCatchInfo) ? " hasCatchInfo" : "",
+                   (label->info() & Label::kIsOSREntry) ? " isOSREntry" : "");
 
             for (auto it : label->branches()) {
                 printf("  Jump from: %s%d%s\n", instrText, static_cast<int>(it->id()), defaultText);
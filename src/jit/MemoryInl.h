@@ -32,6 +32,8 @@ struct MemAddress {
         AbsoluteAddress = 1 << 6,
         NoOffset = 1 << 7,
         Memory64 = 1 << 8,
+        // The address range is checked before the loop which contains the access.
+        BoundsChecked = 1 << 9,
     };
 
     MemAddress(uint32_t options, uint8_t baseReg, uint8_t offsetReg, uint8_t sourceReg)
@@ -127,6 +129,14 @@ void MemAddress::check(sljit_compiler* compiler, Operand* offsetOperand, uint64_
 #endif /* SLJIT_64BIT_ARCHITECTURE */
 
     sljit_uw offset = static_cast<sljit_uw>(offset64);
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    // Out of bounds accesses are caught by the guard pages after the memory. Absolute
+    // addresses are excluded, since they might be passed to helper functions.
+    bool useGuardPages = !(options & (MemAddress::Memory64 | MemAddress::AbsoluteAddress))
+        && (context->compiler->options() & JITCompiler::kMemoryGuardPages);
+#else /* !WALRUS_MEMORY_GUARD_PAGES */
+    const bool useGuardPages = false;
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
 
     if (SLJIT_IS_IMM(offsetArg.arg)) {
         offset += static_cast<sljit_uw>(offsetArg.argw);
@@ -143,8 +153,13 @@ void MemAddress::check(sljit_compiler* compiler, Operand* offsetOperand, uint64_
             return;
         }
 
-        if (offset + size <= initialMemorySize) {
+        if (offset + size <= initialMemorySize || useGuardPages || (options & BoundsChecked)) {
             ASSERT(baseReg != 0);
+
+            if (offset + size > initialMemorySize && !(options & BoundsChecked)) {
+                context->hasGuardPageAccess = true;
+            }
+
             sljit_emit_op1(compiler, SLJIT_MOV_P, baseReg, 0, SLJIT_MEM1(kInstanceReg),
                            targetBufferOffset + offsetof(Memory::TargetBuffer, buffer));
             memArg.arg = SLJIT_MEM1(baseReg);
@@ -198,6 +213,39 @@ void MemAddress::check(sljit_compiler* compiler, Operand* offsetOperand, uint64_
     sljit_emit_op1(compiler, SLJIT_MOV_U32, offsetReg, 0, offsetArg.arg, offsetArg.argw);
 #endif /* SLJIT_64BIT_ARCHITECTURE */
 
+    if (useGuardPages || (options & BoundsChecked)) {
+        if (!(options & BoundsChecked)) {
+            context->hasGuardPageAccess = true;
+        }
+
+        sljit_emit_op1(compiler, SLJIT_MOV_P, baseReg, 0, SLJIT_MEM1(kInstanceReg),
+                       targetBufferOffset + offsetof(Memory::TargetBuffer, buffer));
+
+        load(compiler);
+
+        // The zero extended offset cannot overflow, and the
+        // bounds checked 64 bit offsets are less than 2^40.
+        if (offset > 0) {
+            sljit_emit_op2(compiler, SLJIT_ADD, offsetReg, 0, offsetReg, 0, SLJIT_IMM, static_cast<sljit_sw>(offset));
+        }
+
+        if (options & CheckNaturalAlignment) {
+            sljit_emit_op2u(compiler, SLJIT_AND | SLJIT_SET_Z, offsetReg, 0, SLJIT_IMM, size - 1);
+            context->appendTrapJump(ExecutionContext::UnalignedAtomicError, sljit_emit_jump(compiler, SLJIT_NOT_ZERO));
+        }
+
+        if (options & AbsoluteAddress) {
+            sljit_emit_op2(compiler, SLJIT_ADD, baseReg, 0, baseReg, 0, offsetReg, 0);
+            memArg.arg = SLJIT_MEM1(baseReg);
+            memArg.argw = 0;
+            return;
+        }
+
+        memArg.arg = SLJIT_MEM2(baseReg, offsetReg);
+        memArg.argw = 0;
+        return;
+    }
+
     if (initialMemorySize != maximumMemorySize) {
         /* The sizeInByte is always a 32 bit number on 32 bit systems. */
         sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_TMP_DEST_REG, 0, SLJIT_MEM1(kInstanceReg),
@@ -696,6 +744,10 @@ static void emitLoad(sljit_compiler* compiler, Instruction* instr)
         options |= MemAddress::Memory64;
     }
 
+    if (instr->info() & Instruction::kBoundsChecked) {
+        options |= MemAddress::BoundsChecked;
+    }
+
     if (!(options & MemAddress::NoOffset)) {
         if (!(options & MemAddress::Memory64)) {
             if (instr->info() & Instruction::kMultiMemory) {
@@ -1108,6 +1160,10 @@ static void emitStore(sljit_compiler* compiler, Instruction* instr)
         options |= MemAddress::Memory64;
     }
 
+    if (instr->info() & Instruction::kBoundsChecked) {
+        options |= MemAddress::BoundsChecked;
+    }
+
     if (!(options & MemAddress::NoOffset)) {
         if (!(options & MemAddress::Memory64)) {
 #ifdef HAS_SIMD
@@ -1311,6 +1367,81 @@ static void emitStore(sljit_compiler* compiler, Instruction* instr)
     sljit_emit_op1(compiler, opcode, addr.memArg.arg, addr.memArg.argw, addr.loadArg.arg, addr.loadArg.argw);
 }
 
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+static void emitLoopBoundsCheck(sljit_compiler* compiler, LoopBoundsCheckInstruction* instr)
+{
+    CompileContext* context = CompileContext::get(compiler);
+    LoopBoundsCheck* boundsCheck = instr->boundsCheck();
+    Label* slowPath = instr->value().targetLabel;
+    Operand* params = instr->params();
+    uint32_t termStart = instr->termStart();
+    uint32_t termCount = instr->paramCount() - termStart;
+    sljit_s32 movOpcode = boundsCheck->is64Bit ? SLJIT_MOV : SLJIT_MOV_U32;
+    sljit_s32 tmp = SLJIT_TMP_DEST_REG;
+    sljit_sw maxInput = static_cast<sljit_sw>(LoopBoundsCheck::kMaxInput32);
+    JITArg arg;
+
+    if (boundsCheck->is64Bit) {
+        maxInput = static_cast<sljit_sw>(LoopBoundsCheck::kMaxInput64);
+    }
+
+    // The 32 bit terms are zero extended, so only their sums need to be checked.
+    uint32_t inputCount = boundsCheck->is64Bit ? instr->paramCount() : termStart;
+
+    for (uint32_t i = 0; i < inputCount; i++) {
+        arg.set(params + i);
+        sljit_emit_op1(compiler, movOpcode, tmp, 0, arg.arg, arg.argw);
+        slowPath->jumpFrom(sljit_emit_cmp(compiler, SLJIT_GREATER, tmp, 0, SLJIT_IMM, maxInput));
+    }
+
+    for (auto& it : boundsCheck->accesses) {
+        sljit_sw sizeOffset = context->targetBuffersStart + it.memIndex * sizeof(Memory::TargetBuffer) + offsetof(Memory::TargetBuffer, sizeInByte);
+
+        for (int pass = 0; pass < 2; pass++) {
+            // The first pass checks the initial value of the loop variable, the second pass checks its maximum.
+            if (pass == 1 && it.factor == 0) {
+                break;
+            }
+
+            sljit_emit_op1(compiler, SLJIT_MOV, tmp, 0, SLJIT_IMM, static_cast<sljit_sw>(pass == 0 ? it.firstEnd : it.lastEnd));
+
+            for (uint32_t i = 0; i <= termCount; i++) {
+                uint64_t factor;
+
+                if (i < termCount) {
+                    factor = it.termFactors[i];
+                    arg.set(params + termStart + i);
+                } else {
+                    factor = it.factor;
+
+                    if (pass == 1 && !boundsCheck->hasLimitParam) {
+                        // The constant limit is included in the lastEnd.
+                        break;
+                    }
+
+                    arg.set(params + (pass == 0 ? 0 : 1));
+                }
+
+                if (factor == 0) {
+                    continue;
+                }
+
+                sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_MEM1(SLJIT_SP), context->stackTmpStart, tmp, 0);
+                sljit_emit_op1(compiler, movOpcode, tmp, 0, arg.arg, arg.argw);
+
+                if (factor != 1) {
+                    sljit_emit_op2(compiler, SLJIT_MUL, tmp, 0, tmp, 0, SLJIT_IMM, static_cast<sljit_sw>(factor));
+                }
+
+                sljit_emit_op2(compiler, SLJIT_ADD, tmp, 0, tmp, 0, SLJIT_MEM1(SLJIT_SP), context->stackTmpStart);
+            }
+
+            slowPath->jumpFrom(sljit_emit_cmp(compiler, SLJIT_GREATER, tmp, 0, SLJIT_MEM1(kInstanceReg), sizeOffset));
+        }
+    }
+}
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+
 
 #if (defined SLJIT_32BIT_ARCHITECTURE && SLJIT_32BIT_ARCHITECTURE)
 static void atomicRmwAdd64(uint64_t* shared_p, uint64_t* value, uint64_t* result)
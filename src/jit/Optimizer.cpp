@@ -0,0 +1,2146 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(WALRUS_ENABLE_JIT)
+
+#include "Walrus.h"
+
+#include "jit/Compiler.h"
+#include "util/BitOperation.h"
+
+#include <cfloat>
+
+namespace Walrus {
+
+// Float operations are only folded when the C++ compiler
+// evaluates them with the precision of their types.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+static const bool kFoldFloatArithmetic = true;
+#else
+static const bool kFoldFloatArithmetic = false;
+#endif
+
+// Values are at most 16 bytes long.
+static const uint8_t kMaxSlotCount = 4;
+static const uint8_t kUnknownType = 0xff;
+static const size_t kNoFlexibleOperand = ~static_cast<size_t>(0);
+static const size_t kRemovedInstruction = ~static_cast<size_t>(0);
+// Dead result elimination is skipped when its bit sets would be too large.
+static const size_t kMaxLivenessWords = 1 << 22;
+
+static uint8_t operandType(const uint8_t* list, size_t index)
+{
+    uint8_t type = list[index] & Instruction::TypeMask;
+    return type == Instruction::Int64LowOperand ? static_cast<uint8_t>(Instruction::Int64Operand) : type;
+}
+
+static uint8_t slotCount(uint8_t type)
+{
+    switch (type) {
+    case Instruction::Int32Operand:
+    case Instruction::Float32Operand:
+        return 1;
+    case Instruction::V128Operand:
+        return 4;
+    default:
+        ASSERT(type == Instruction::Int64Operand || type == Instruction::Float64Operand);
+        return 2;
+    }
+}
+
+// The operand descriptors of these instructions describe all operands.
+static bool hasTypedOperands(Instruction* instr)
+{
+    switch (instr->group()) {
+    case Instruction::Immediate:
+    case Instruction::Binary:
+    case Instruction::BinaryFloat:
+    case Instruction::Unary:
+    case Instruction::UnaryFloat:
+    case Instruction::Compare:
+    case Instruction::CompareFloat:
+    case Instruction::Convert:
+    case Instruction::ConvertFloat:
+    case Instruction::Load:
+    case Instruction::Store:
+    case Instruction::Move:
+        return *instr->getOperandDescriptor() != 0;
+    case Instruction::DirectBranch:
+        return instr->opcode() == ByteCode::JumpIfTrueOpcode || instr->opcode() == ByteCode::JumpIfFalseOpcode;
+    default:
+        return false;
+    }
+}
+
+// Returns with the index of the operand, which type is decided by the other
+// instructions using the same variable. Must follow VariableList::getOperandDescriptor.
+static size_t flexibleOperand(Instruction* instr)
+{
+    switch (instr->opcode()) {
+    case ByteCode::Const32Opcode:
+    case ByteCode::Const64Opcode:
+    case ByteCode::MoveI32Opcode:
+    case ByteCode::MoveI64Opcode:
+    case ByteCode::MoveF32Opcode:
+    case ByteCode::MoveF64Opcode:
+        return 0;
+    case ByteCode::Load32Opcode:
+    case ByteCode::Load32M64Opcode:
+    case ByteCode::Load64Opcode:
+    case ByteCode::Load64M64Opcode:
+    case ByteCode::Store32Opcode:
+    case ByteCode::Store32M64Opcode:
+    case ByteCode::Store64Opcode:
+    case ByteCode::Store64M64Opcode:
+    case ByteCode::I32StoreOpcode:
+    case ByteCode::I32StoreMemIdxOpcode:
+    case ByteCode::I32StoreM64Opcode:
+    case ByteCode::I32StoreMemIdxM64Opcode:
+    case ByteCode::I64StoreOpcode:
+    case ByteCode::I64StoreMemIdxOpcode:
+    case ByteCode::I64StoreM64Opcode:
+    case ByteCode::I64StoreMemIdxM64Opcode:
+        return 1;
+    default:
+        return kNoFlexibleOperand;
+    }
+}
+
+// Instructions which have no side effects and cannot trap.
+static bool isRemovable(Instruction* instr)
+{
+    switch (instr->group()) {
+    case Instruction::Binary:
+        switch (instr->opcode()) {
+        case ByteCode::I32DivSOpcode:
+        case ByteCode::I32DivUOpcode:
+        case ByteCode::I32RemSOpcode:
+        case ByteCode::I32RemUOpcode:
+        case ByteCode::I64DivSOpcode:
+        case ByteCode::I64DivUOpcode:
+        case ByteCode::I64RemSOpcode:
+        case ByteCode::I64RemUOpcode:
+            return false;
+        default:
+            return true;
+        }
+    case Instruction::ConvertFloat:
+        switch (instr->opcode()) {
+        case ByteCode::I32TruncF32SOpcode:
+        case ByteCode::I32TruncF32UOpcode:
+        case ByteCode::I32TruncF64SOpcode:
+        case ByteCode::I32TruncF64UOpcode:
+        case ByteCode::I64TruncF32SOpcode:
+        case ByteCode::I64TruncF32UOpcode:
+        case ByteCode::I64TruncF64SOpcode:
+        case ByteCode::I64TruncF64UOpcode:
+            return false;
+        default:
+            return true;
+        }
+    case Instruction::Immediate:
+    case Instruction::BinaryFloat:
+    case Instruction::Unary:
+    case Instruction::UnaryFloat:
+    case Instruction::Compare:
+    case Instruction::CompareFloat:
+    case Instruction::Convert:
+    case Instruction::Move:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static float toF32(uint64_t value)
+{
+    uint32_t bits = static_cast<uint32_t>(value);
+    float result;
+
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static double toF64(uint64_t value)
+{
+    double result;
+
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+static bool fromF32(float value, uint64_t& result)
+{
+    if (std::isnan(value)) {
+        // The payload of NaN values depends on the target.
+        return false;
+    }
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    result = bits;
+    return true;
+}
+
+static bool fromF64(double value, uint64_t& result)
+{
+    if (std::isnan(value)) {
+        return false;
+    }
+
+    memcpy(&result, &value, sizeof(result));
+    return true;
+}
+
+// Computes the result of an operation with constant arguments.
+// Returns false if the operation cannot be computed in advance.
+static bool foldOperation(ByteCode::Opcode opcode, const uint64_t* args, uint64_t& result)
+{
+    uint32_t lhs32 = static_cast<uint32_t>(args[0]);
+    uint32_t rhs32 = static_cast<uint32_t>(args[1]);
+    uint64_t lhs64 = args[0];
+    uint64_t rhs64 = args[1];
+
+    switch (opcode) {
+    case ByteCode::MoveI32Opcode:
+    case ByteCode::MoveI64Opcode:
+    case ByteCode::MoveF32Opcode:
+    case ByteCode::MoveF64Opcode:
+        // Reinterpretation does not change the bits.
+        result = lhs64;
+        return true;
+    case ByteCode::I32AddOpcode:
+        result = static_cast<uint32_t>(lhs32 + rhs32);
+        return true;
+    case ByteCode::I32SubOpcode:
+        result = static_cast<uint32_t>(lhs32 - rhs32);
+        return true;
+    case ByteCode::I32MulOpcode:
+        result = static_cast<uint32_t>(lhs32 * rhs32);
+        return true;
+    case ByteCode::I32DivSOpcode:
+        if (rhs32 == 0 || (lhs32 == 0x80000000 && rhs32 == 0xffffffff)) {
+            return false;
+        }
+        result = static_cast<uint32_t>(static_cast<int32_t>(lhs32) / static_cast<int32_t>(rhs32));
+        return true;
+    case ByteCode::I32DivUOpcode:
+        if (rhs32 == 0) {
+            return false;
+        }
+        result = lhs32 / rhs32;
+        return true;
+    case ByteCode::I32RemSOpcode:
+        if (rhs32 == 0) {
+            return false;
+        }
+        result = (rhs32 == 0xffffffff) ? 0 : static_cast<uint32_t>(static_cast<int32_t>(lhs32) % static_cast<int32_t>(rhs32));
+        return true;
+    case ByteCode::I32RemUOpcode:
+        if (rhs32 == 0) {
+            return false;
+        }
+        result = lhs32 % rhs32;
+        return true;
+    case ByteCode::I32AndOpcode:
+        result = lhs32 & rhs32;
+        return true;
+    case ByteCode::I32OrOpcode:
+        result = lhs32 | rhs32;
+        return true;
+    case ByteCode::I32XorOpcode:
+        result = lhs32 ^ rhs32;
+        return true;
+    case ByteCode::I32ShlOpcode:
+        result = static_cast<uint32_t>(lhs32 << (rhs32 & 31));
+        return true;
+    case ByteCode::I32ShrSOpcode:
+        result = static_cast<uint32_t>(static_cast<int32_t>(lhs32) >> (rhs32 & 31));
+        return true;
+    case ByteCode::I32ShrUOpcode:
+        result = lhs32 >> (rhs32 & 31);
+        return true;
+    case ByteCode::I32RotlOpcode:
+        rhs32 &= 31;
+        result = static_cast<uint32_t>((lhs32 << rhs32) | (lhs32 >> ((32 - rhs32) & 31)));
+        return true;
+    case ByteCode::I32RotrOpcode:
+        rhs32 &= 31;
+        result = static_cast<uint32_t>((lhs32 >> rhs32) | (lhs32 << ((32 - rhs32) & 31)));
+        return true;
+    case ByteCode::I32EqOpcode:
+        result = lhs32 == rhs32;
+        return true;
+    case ByteCode::I32NeOpcode:
+        result = lhs32 != rhs32;
+        return true;
+    case ByteCode::I32LtSOpcode:
+        result = static_cast<int32_t>(lhs32) < static_cast<int32_t>(rhs32);
+        return true;
+    case ByteCode::I32LtUOpcode:
+        result = lhs32 < rhs32;
+        return true;
+    case ByteCode::I32GtSOpcode:
+        result = static_cast<int32_t>(lhs32) > static_cast<int32_t>(rhs32);
+        return true;
+    case ByteCode::I32GtUOpcode:
+        result = lhs32 > rhs32;
+        return true;
+    case ByteCode::I32LeSOpcode:
+        result = static_cast<int32_t>(lhs32) <= static_cast<int32_t>(rhs32);
+        return true;
+    case ByteCode::I32LeUOpcode:
+        result = lhs32 <= rhs32;
+        return true;
+    case ByteCode::I32GeSOpcode:
+        result = static_cast<int32_t>(lhs32) >= static_cast<int32_t>(rhs32);
+        return true;
+    case ByteCode::I32GeUOpcode:
+        result = lhs32 >= rhs32;
+        return true;
+    case ByteCode::I32EqzOpcode:
+        result = lhs32 == 0;
+        return true;
+    case ByteCode::I32ClzOpcode:
+        result = static_cast<uint32_t>(clz(lhs32));
+        return true;
+    case ByteCode::I32CtzOpcode:
+        result = static_cast<uint32_t>(ctz(lhs32));
+        return true;
+    case ByteCode::I32PopcntOpcode:
+        result = static_cast<uint32_t>(popCount(lhs32));
+        return true;
+    case ByteCode::I32Extend8SOpcode:
+        result = static_cast<uint32_t>(static_cast<int32_t>(static_cast<int8_t>(lhs32)));
+        return true;
+    case ByteCode::I32Extend16SOpcode:
+        result = static_cast<uint32_t>(static_cast<int32_t>(static_cast<int16_t>(lhs32)));
+        return true;
+    case ByteCode::I32WrapI64Opcode:
+        result = static_cast<uint32_t>(lhs64);
+        return true;
+    case ByteCode::I64AddOpcode:
+        result = lhs64 + rhs64;
+        return true;
+    case ByteCode::I64SubOpcode:
+        result = lhs64 - rhs64;
+        return true;
+    case ByteCode::I64MulOpcode:
+        result = lhs64 * rhs64;
+        return true;
+    case ByteCode::I64DivSOpcode:
+        if (rhs64 == 0 || (lhs64 == 0x8000000000000000ull && rhs64 == ~static_cast<uint64_t>(0))) {
+            return false;
+        }
+        result = static_cast<uint64_t>(static_cast<int64_t>(lhs64) / static_cast<int64_t>(rhs64));
+        return true;
+    case ByteCode::I64DivUOpcode:
+        if (rhs64 == 0) {
+            return false;
+        }
+        result = lhs64 / rhs64;
+        return true;
+    case ByteCode::I64RemSOpcode:
+        if (rhs64 == 0) {
+            return false;
+        }
+        result = (rhs64 == ~static_cast<uint64_t>(0)) ? 0 : static_cast<uint64_t>(static_cast<int64_t>(lhs64) % static_cast<int64_t>(rhs64));
+        return true;
+    case ByteCode::I64RemUOpcode:
+        if (rhs64 == 0) {
+            return false;
+        }
+        result = lhs64 % rhs64;
+        return true;
+    case ByteCode::I64AndOpcode:
+        result = lhs64 & rhs64;
+        return true;
+    case ByteCode::I64OrOpcode:
+        result = lhs64 | rhs64;
+        return true;
+    case ByteCode::I64XorOpcode:
+        result = lhs64 ^ rhs64;
+        return true;
+    case ByteCode::I64ShlOpcode:
+        result = lhs64 << (rhs64 & 63);
+        return true;
+    case ByteCode::I64ShrSOpcode:
+        result = static_cast<uint64_t>(static_cast<int64_t>(lhs64) >> (rhs64 & 63));
+        return true;
+    case ByteCode::I64ShrUOpcode:
+        result = lhs64 >> (rhs64 & 63);
+        return true;
+    case ByteCode::I64RotlOpcode:
+        rhs64 &= 63;
+        result = (lhs64 << rhs64) | (lhs64 >> ((64 - rhs64) & 63));
+        return true;
+    case ByteCode::I64RotrOpcode:
+        rhs64 &= 63;
+        result = (lhs64 >> rhs64) | (lhs64 << ((64 - rhs64) & 63));
+        return true;
+    case ByteCode::I64EqOpcode:
+        result = lhs64 == rhs64;
+        return true;
+    case ByteCode::I64NeOpcode:
+        result = lhs64 != rhs64;
+        return true;
+    case ByteCode::I64LtSOpcode:
+        result = static_cast<int64_t>(lhs64) < static_cast<int64_t>(rhs64);
+        return true;
+    case ByteCode::I64LtUOpcode:
+        result = lhs64 < rhs64;
+        return true;
+    case ByteCode::I64GtSOpcode:
+        result = static_cast<int64_t>(lhs64) > static_cast<int64_t>(rhs64);
+        return true;
+    case ByteCode::I64GtUOpcode:
+        result = lhs64 > rhs64;
+        return true;
+    case ByteCode::I64LeSOpcode:
+        result = static_cast<int64_t>(lhs64) <= static_cast<int64_t>(rhs64);
+        return true;
+    case ByteCode::I64LeUOpcode:
+        result = lhs64 <= rhs64;
+        return true;
+    case ByteCode::I64GeSOpcode:
+        result = static_cast<int64_t>(lhs64) >= static_cast<int64_t>(rhs64);
+        return true;
+    case ByteCode::I64GeUOpcode:
+        result = lhs64 >= rhs64;
+        return true;
+    case ByteCode::I64EqzOpcode:
+        result = lhs64 == 0;
+        return true;
+    case ByteCode::I64ClzOpcode:
+        result = static_cast<uint64_t>(clz(lhs64));
+        return true;
+    case ByteCode::I64CtzOpcode:
+        result = static_cast<uint64_t>(ctz(lhs64));
+        return true;
+    case ByteCode::I64PopcntOpcode:
+        result = static_cast<uint64_t>(popCount(lhs64));
+        return true;
+    case ByteCode::I64Extend8SOpcode:
+        result = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int8_t>(lhs64)));
+        return true;
+    case ByteCode::I64Extend16SOpcode:
+        result = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int16_t>(lhs64)));
+        return true;
+    case ByteCode::I64Extend32SOpcode:
+    case ByteCode::I64ExtendI32SOpcode:
+        result = static_cast<uint64_t>(static_cast<int64_t>(static_cast<int32_t>(lhs32)));
+        return true;
+    case ByteCode::I64ExtendI32UOpcode:
+        result = lhs32;
+        return true;
+    case ByteCode::F32NegOpcode:
+        result = lhs32 ^ 0x80000000;
+        return true;
+    case ByteCode::F32AbsOpcode:
+        result = lhs32 & 0x7fffffff;
+        return true;
+    case ByteCode::F64NegOpcode:
+        result = lhs64 ^ 0x8000000000000000ull;
+        return true;
+    case ByteCode::F64AbsOpcode:
+        result = lhs64 & 0x7fffffffffffffffull;
+        return true;
+    case ByteCode::F32EqOpcode:
+        result = toF32(lhs64) == toF32(rhs64);
+        return true;
+    case ByteCode::F32NeOpcode:
+        result = toF32(lhs64) != toF32(rhs64);
+        return true;
+    case ByteCode::F32LtOpcode:
+        result = toF32(lhs64) < toF32(rhs64);
+        return true;
+    case ByteCode::F32LeOpcode:
+        result = toF32(lhs64) <= toF32(rhs64);
+        return true;
+    case ByteCode::F32GtOpcode:
+        result = toF32(lhs64) > toF32(rhs64);
+        return true;
+    case ByteCode::F32GeOpcode:
+        result = toF32(lhs64) >= toF32(rhs64);
+        return true;
+    case ByteCode::F64EqOpcode:
+        result = toF64(lhs64) == toF64(rhs64);
+        return true;
+    case ByteCode::F64NeOpcode:
+        result = toF64(lhs64) != toF64(rhs64);
+        return true;
+    case ByteCode::F64LtOpcode:
+        result = toF64(lhs64) < toF64(rhs64);
+        return true;
+    case ByteCode::F64LeOpcode:
+        result = toF64(lhs64) <= toF64(rhs64);
+        return true;
+    case ByteCode::F64GtOpcode:
+        result = toF64(lhs64) > toF64(rhs64);
+        return true;
+    case ByteCode::F64GeOpcode:
+        result = toF64(lhs64) >= toF64(rhs64);
+        return true;
+    case ByteCode::F32AddOpcode:
+        return kFoldFloatArithmetic && fromF32(toF32(lhs64) + toF32(rhs64), result);
+    case ByteCode::F32SubOpcode:
+        return kFoldFloatArithmetic && fromF32(toF32(lhs64) - toF32(rhs64), result);
+    case ByteCode::F32MulOpcode:
+        return kFoldFloatArithmetic && fromF32(toF32(lhs64) * toF32(rhs64), result);
+    case ByteCode::F32DivOpcode:
+        return kFoldFloatArithmetic && fromF32(toF32(lhs64) / toF32(rhs64), result);
+    case ByteCode::F64AddOpcode:
+        return kFoldFloatArithmetic && fromF64(toF64(lhs64) + toF64(rhs64), result);
+    case ByteCode::F64SubOpcode:
+        return kFoldFloatArithmetic && fromF64(toF64(lhs64) - toF64(rhs64), result);
+    case ByteCode::F64MulOpcode:
+        return kFoldFloatArithmetic && fromF64(toF64(lhs64) * toF64(rhs64), result);
+    case ByteCode::F64DivOpcode:
+        return kFoldFloatArithmetic && fromF64(toF64(lhs64) / toF64(rhs64), result);
+    default:
+        return false;
+    }
+}
+
+enum SimplifyResult {
+    NotSimplified,
+    SimplifiedToConst,
+    SimplifiedToLhs,
+    SimplifiedToRhs,
+};
+
+// Algebraic identities of integer operations, where one argument
+// is constant, or both arguments are the same value.
+static SimplifyResult simplifyOperation(ByteCode::Opcode opcode, const bool* isConst, const uint64_t* args,
+                                        bool sameArgs, bool is64Bit, uint64_t& result)
+{
+    uint64_t allOnes = is64Bit ? ~static_cast<uint64_t>(0) : 0xffffffff;
+    uint64_t shiftMask = is64Bit ? 63 : 31;
+    bool lhsIsZero = isConst[0] && args[0] == 0;
+    bool rhsIsZero = isConst[1] && args[1] == 0;
+
+    result = 0;
+
+    switch (opcode) {
+    case ByteCode::I32AddOpcode:
+    case ByteCode::I64AddOpcode:
+        if (rhsIsZero) {
+            return SimplifiedToLhs;
+        }
+        return lhsIsZero ? SimplifiedToRhs : NotSimplified;
+    case ByteCode::I32SubOpcode:
+    case ByteCode::I64SubOpcode:
+        if (rhsIsZero) {
+            return SimplifiedToLhs;
+        }
+        return sameArgs ? SimplifiedToConst : NotSimplified;
+    case ByteCode::I32MulOpcode:
+    case ByteCode::I64MulOpcode:
+        if (lhsIsZero || rhsIsZero) {
+            return SimplifiedToConst;
+        }
+        if (isConst[1] && args[1] == 1) {
+            return SimplifiedToLhs;
+        }
+        return (isConst[0] && args[0] == 1) ? SimplifiedToRhs : NotSimplified;
+    case ByteCode::I32DivSOpcode:
+    case ByteCode::I32DivUOpcode:
+    case ByteCode::I64DivSOpcode:
+    case ByteCode::I64DivUOpcode:
+        return (isConst[1] && args[1] == 1) ? SimplifiedToLhs : NotSimplified;
+    case ByteCode::I32AndOpcode:
+    case ByteCode::I64AndOpcode:
+        if (lhsIsZero || rhsIsZero) {
+            return SimplifiedToConst;
+        }
+        if ((isConst[1] && args[1] == allOnes) || sameArgs) {
+            return SimplifiedToLhs;
+        }
+        return (isConst[0] && args[0] == allOnes) ? SimplifiedToRhs : NotSimplified;
+    case ByteCode::I32OrOpcode:
+    case ByteCode::I64OrOpcode:
+        if ((isConst[0] && args[0] == allOnes) || (isConst[1] && args[1] == allOnes)) {
+            result = allOnes;
+            return SimplifiedToConst;
+        }
+        if (rhsIsZero || sameArgs) {
+            return SimplifiedToLhs;
+        }
+        return lhsIsZero ? SimplifiedToRhs : NotSimplified;
+    case ByteCode::I32XorOpcode:
+    case ByteCode::I64XorOpcode:
+        if (sameArgs) {
+            return SimplifiedToConst;
+        }
+        if (rhsIsZero) {
+            return SimplifiedToLhs;
+        }
+        return lhsIsZero ? SimplifiedToRhs : NotSimplified;
+    case ByteCode::I32ShlOpcode:
+    case ByteCode::I32ShrSOpcode:
+    case ByteCode::I32ShrUOpcode:
+    case ByteCode::I32RotlOpcode:
+    case ByteCode::I32RotrOpcode:
+    case ByteCode::I64ShlOpcode:
+    case ByteCode::I64ShrSOpcode:
+    case ByteCode::I64ShrUOpcode:
+    case ByteCode::I64RotlOpcode:
+    case ByteCode::I64RotrOpcode:
+        if (isConst[1] && (args[1] & shiftMask) == 0) {
+            return SimplifiedToLhs;
+        }
+        if (lhsIsZero) {
+            return SimplifiedToConst;
+        }
+        if (isConst[0] && args[0] == allOnes
+            && opcode != ByteCode::I32ShlOpcode && opcode != ByteCode::I32ShrUOpcode
+            && opcode != ByteCode::I64ShlOpcode && opcode != ByteCode::I64ShrUOpcode) {
+            result = allOnes;
+            return SimplifiedToConst;
+        }
+        return NotSimplified;
+    case ByteCode::I32EqOpcode:
+    case ByteCode::I32LeSOpcode:
+    case ByteCode::I32LeUOpcode:
+    case ByteCode::I32GeSOpcode:
+    case ByteCode::I32GeUOpcode:
+    case ByteCode::I64EqOpcode:
+    case ByteCode::I64LeSOpcode:
+    case ByteCode::I64LeUOpcode:
+    case ByteCode::I64GeSOpcode:
+    case ByteCode::I64GeUOpcode:
+        result = 1;
+        return sameArgs ? SimplifiedToConst : NotSimplified;
+    case ByteCode::I32NeOpcode:
+    case ByteCode::I32LtSOpcode:
+    case ByteCode::I32LtUOpcode:
+    case ByteCode::I32GtSOpcode:
+    case ByteCode::I32GtUOpcode:
+    case ByteCode::I64NeOpcode:
+    case ByteCode::I64LtSOpcode:
+    case ByteCode::I64LtUOpcode:
+    case ByteCode::I64GtSOpcode:
+    case ByteCode::I64GtUOpcode:
+        return sameArgs ? SimplifiedToConst : NotSimplified;
+    default:
+        return NotSimplified;
+    }
+}
+
+// Values of the frame slots, which are known inside the current basic block.
+class BlockValues {
+public:
+    static const uint8_t kIsConst = 1 << 0;
+    static const uint8_t kIsCopy = 1 << 1;
+    // Used by the bounds check hoisting.
+    static const uint8_t kIsAffine = 1 << 2;
+    static const uint8_t kIsCompare = 1 << 3;
+
+    struct Slot {
+        Slot()
+            : lastWrite(0)
+            , stamp(0)
+            , source(0)
+            , value(0)
+            , type(kUnknownType)
+            , width(0)
+            , flags(0)
+        {
+        }
+
+        // Stamp of the last write which modified this slot.
+        uint32_t lastWrite;
+        // The fields below describe the value which starts at this slot. They
+        // are valid until one of the slots covered by the value is modified.
+        uint32_t stamp;
+        Operand source;
+        uint64_t value;
+        uint8_t type;
+        uint8_t width;
+        uint8_t flags;
+    };
+
+    explicit BlockValues(size_t slotCount)
+        : m_slots(slotCount + kMaxSlotCount)
+        , m_stamp(1)
+        , m_blockStart(0)
+    {
+    }
+
+    void startBlock()
+    {
+        m_blockStart = ++m_stamp;
+    }
+
+    // Reads and writes of an instruction must use different stamps.
+    void nextStamp()
+    {
+        m_stamp++;
+    }
+
+    Slot* get(Operand offset, uint8_t width)
+    {
+        Slot& slot = m_slots[offset];
+
+        if (slot.stamp <= m_blockStart || slot.width != width || !isUnchanged(offset, width, slot.stamp)) {
+            return nullptr;
+        }
+
+        return &slot;
+    }
+
+    bool getConst(Operand offset, uint8_t width, uint64_t& value)
+    {
+        Slot* slot = get(offset, width);
+
+        if (slot == nullptr || !(slot->flags & kIsConst)) {
+            return false;
+        }
+
+        value = slot->value;
+        return true;
+    }
+
+    bool getCopySource(Operand offset, uint8_t width, uint8_t type, Operand& source)
+    {
+        Slot* slot = get(offset, width);
+
+        if (slot == nullptr || !(slot->flags & kIsCopy) || (type != kUnknownType && slot->type != type)
+            || !isUnchanged(slot->source, width, slot->stamp)) {
+            return false;
+        }
+
+        source = slot->source;
+        return true;
+    }
+
+    uint8_t getType(Operand offset, uint8_t width)
+    {
+        Slot* slot = get(offset, width);
+        return slot != nullptr ? slot->type : kUnknownType;
+    }
+
+    // The type of a value is known when it is read by a typed operand.
+    void read(Operand offset, uint8_t type)
+    {
+        uint8_t width = slotCount(type);
+        Slot* slot = get(offset, width);
+
+        if (slot != nullptr) {
+            if (slot->type == kUnknownType) {
+                slot->type = type;
+            }
+            return;
+        }
+
+        Slot& newSlot = m_slots[offset];
+        newSlot.stamp = m_stamp;
+        newSlot.type = type;
+        newSlot.width = width;
+        newSlot.flags = 0;
+    }
+
+    // A zero width invalidates the values which overlap with
+    // the maximum sized value starting at the given offset.
+    Slot& write(Operand offset, uint8_t width)
+    {
+        uint8_t count = width > 0 ? width : kMaxSlotCount;
+
+        for (uint8_t i = 0; i < count; i++) {
+            m_slots[offset + i].lastWrite = m_stamp;
+        }
+
+        Slot& slot = m_slots[offset];
+        slot.stamp = m_stamp;
+        slot.type = kUnknownType;
+        slot.width = width;
+        slot.flags = 0;
+        return slot;
+    }
+
+private:
+    bool isUnchanged(Operand offset, uint8_t width, uint32_t stamp)
+    {
+        for (uint8_t i = 0; i < width; i++) {
+            if (m_slots[offset + i].lastWrite > stamp) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::vector<Slot> m_slots;
+    uint32_t m_stamp;
+    uint32_t m_blockStart;
+};
+
+void JITCompiler::optimize(uint32_t level)
+{
+    if (moduleFunction()->requiredStackSize() == 0) {
+        return;
+    }
+
+    propagateValues(level);
+
+    if (level >= 2) {
+        removeDeadResults();
+    }
+
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+    hoistBoundsChecks();
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+}
+
+void JITCompiler::remove(InstructionListItem* prev, InstructionListItem* item)
+{
+    ASSERT(item->isInstruction() && (prev == nullptr ? m_first : prev->m_next) == item);
+
+    if (prev == nullptr) {
+        m_first = item->m_next;
+    } else {
+        prev->m_next = item->m_next;
+    }
+
+    if (m_last == item) {
+        m_last = prev;
+    }
+
+    item->deleteObject();
+}
+
+void JITCompiler::insertAfter(InstructionListItem* prev, InstructionListItem* item)
+{
+    if (prev == nullptr) {
+        item->m_next = m_first;
+        m_first = item;
+    } else {
+        item->m_next = prev->m_next;
+        prev->m_next = item;
+    }
+
+    if (m_last == prev) {
+        m_last = item;
+    }
+}
+
+Instruction* JITCompiler::copyInstruction(Instruction* instr)
+{
+    bool isExtended = (instr->info() & Instruction::kIsExtended) != 0;
+    size_t slots = instr->paramCount() + instr->internalResultCount();
+
+    if (instr->group() == Instruction::Call) {
+        slots = instr->paramCount() + instr->resultCount();
+    } else if (instr->group() == Instruction::BrTable) {
+        slots = BrTableInstruction::TargetLabelsIndex + instr->asBrTable()->targetLabelCount();
+    }
+
+    Instruction* copy = Instruction::create(instr->byteCode(), instr->group(), instr->opcode(), instr->paramCount(), slots, isExtended);
+
+    copy->m_resultCount = instr->m_resultCount;
+    copy->m_info = instr->m_info;
+    copy->u = instr->u;
+    memcpy(copy->operands(), instr->operands(), slots * sizeof(Operand));
+
+    if (isExtended) {
+        reinterpret_cast<ExtendedInstruction*>(copy)->value() = reinterpret_cast<ExtendedInstruction*>(instr)->value();
+    }
+
+    return copy;
+}
+
+void JITCompiler::propagateValues(uint32_t level)
+{
+    BlockValues values(STACK_OFFSET(moduleFunction()->requiredStackSize()));
+    Operand offset = 0;
+
+    for (auto it : moduleFunction()->functionType()->param().types()) {
+        values.read(offset, static_cast<uint8_t>(Instruction::valueTypeToOperandType(it)));
+        offset += STACK_OFFSET(valueStackAllocatedSize(it));
+    }
+
+    InstructionListItem* prev = nullptr;
+    InstructionListItem* next;
+
+    for (InstructionListItem* item = m_first; item != nullptr; prev = item, item = next) {
+        next = item->next();
+
+        if (item->isLabel()) {
+            values.startBlock();
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+        uint32_t resultCount = instr->resultCount();
+        Operand* operands = instr->operands();
+
+        values.nextStamp();
+
+        if (!hasTypedOperands(instr)) {
+            if (resultCount > 0) {
+                values.nextStamp();
+
+                for (uint32_t i = 0; i < resultCount; i++) {
+                    values.write(*instr->getResult(i), 0);
+                }
+            }
+            continue;
+        }
+
+        const uint8_t* list = instr->getOperandDescriptor();
+        uint32_t paramCount = instr->paramCount();
+        size_t flexible = flexibleOperand(instr);
+        uint64_t args[2] = { 0, 0 };
+        bool isConst[2] = { false, false };
+
+        ASSERT(resultCount <= 1);
+
+        for (uint32_t i = 0; i < paramCount; i++) {
+            uint8_t type = operandType(list, i);
+            uint8_t width = slotCount(type);
+            Operand source;
+
+            if (i == flexible) {
+                type = kUnknownType;
+            }
+
+            if (values.getCopySource(operands[i], width, type, source)) {
+                operands[i] = source;
+            }
+
+            if (i < 2) {
+                isConst[i] = values.getConst(operands[i], width, args[i]);
+            }
+
+            if (type != kUnknownType) {
+                values.read(operands[i], type);
+            }
+        }
+
+        if (resultCount == 0) {
+            continue;
+        }
+
+        uint8_t resultType = operandType(list, paramCount);
+        uint8_t resultWidth = slotCount(resultType);
+        Operand result = operands[paramCount];
+        uint64_t value;
+
+        if (flexible == paramCount) {
+            resultType = kUnknownType;
+        }
+
+        switch (instr->group()) {
+        case Instruction::Binary:
+        case Instruction::BinaryFloat:
+        case Instruction::Unary:
+        case Instruction::UnaryFloat:
+        case Instruction::Compare:
+        case Instruction::CompareFloat:
+        case Instruction::Convert:
+        case Instruction::ConvertFloat:
+        case Instruction::Move: {
+            if (paramCount > 2 || resultWidth > 2) {
+                break;
+            }
+
+            if (isConst[0] && (paramCount == 1 || isConst[1]) && foldOperation(instr->opcode(), args, value)) {
+                convertToConst(instr, value, resultWidth == 2);
+                break;
+            }
+
+            if (instr->group() == Instruction::Move && operands[0] == result && values.getType(result, resultWidth) == resultType) {
+                // Moving a value to itself has no effect.
+                remove(prev, item);
+                item = prev;
+                continue;
+            }
+
+            if (level < 2 || paramCount != 2 || (instr->group() != Instruction::Binary && instr->group() != Instruction::Compare)) {
+                break;
+            }
+
+            bool is64Bit = slotCount(operandType(list, 0)) == 2;
+            Operand lhs = operands[0];
+            Operand rhs = operands[1];
+
+            switch (simplifyOperation(instr->opcode(), isConst, args, lhs == rhs, is64Bit, value)) {
+            case SimplifiedToConst:
+                convertToConst(instr, value, resultWidth == 2);
+                break;
+            case SimplifiedToLhs:
+                convertToMove(instr, lhs, is64Bit);
+                break;
+            case SimplifiedToRhs:
+                convertToMove(instr, rhs, is64Bit);
+                break;
+            default:
+                break;
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+
+        Operand source = operands[0];
+        uint8_t sourceType = kUnknownType;
+
+        if (instr->group() == Instruction::Move) {
+            sourceType = values.getType(source, resultWidth);
+        }
+
+        values.nextStamp();
+        BlockValues::Slot& slot = values.write(result, resultWidth);
+        slot.type = resultType;
+
+        switch (instr->opcode()) {
+        case ByteCode::Const32Opcode:
+            slot.flags = BlockValues::kIsConst;
+            slot.value = reinterpret_cast<Const32*>(instr->byteCode())->value();
+            break;
+        case ByteCode::Const64Opcode:
+            slot.flags = BlockValues::kIsConst;
+            slot.value = reinterpret_cast<Const64*>(instr->byteCode())->value();
+            break;
+        default:
+            if (instr->group() == Instruction::Move && sourceType != kUnknownType && sourceType == resultType
+                && (source + resultWidth <= result || result + resultWidth <= source)) {
+                slot.flags = BlockValues::kIsCopy;
+                slot.source = source;
+            }
+            break;
+        }
+    }
+}
+
+static inline bool isLive(const uint64_t* live, Operand offset, uint8_t width)
+{
+    for (uint8_t i = 0; i < width; i++) {
+        Operand slot = offset + i;
+
+        if (live[slot >> 6] & (static_cast<uint64_t>(1) << (slot & 63))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static inline void setLive(uint64_t* live, Operand offset, uint8_t width, bool value)
+{
+    for (uint8_t i = 0; i < width; i++) {
+        Operand slot = offset + i;
+        uint64_t bit = static_cast<uint64_t>(1) << (slot & 63);
+
+        if (value) {
+            live[slot >> 6] |= bit;
+        } else {
+            live[slot >> 6] &= ~bit;
+        }
+    }
+}
+
+void JITCompiler::removeDeadResults()
+{
+    // The values used by the catch blocks are not tracked.
+    if (moduleFunction()->hasTryCatch()) {
+        return;
+    }
+
+    size_t wordCount = (STACK_OFFSET(moduleFunction()->requiredStackSize()) + kMaxSlotCount + 63) / 64;
+    std::vector<Instruction*> instructions;
+    std::vector<size_t> blockStart;
+
+    blockStart.push_back(0);
+
+    for (InstructionListItem* item = m_first; item != nullptr; item = item->next()) {
+        if (item->isLabel()) {
+            item->asLabel()->m_blockIndex = blockStart.size();
+            blockStart.push_back(instructions.size());
+            continue;
+        }
+
+        instructions.push_back(item->asInstruction());
+    }
+
+    size_t blockCount = blockStart.size();
+    blockStart.push_back(instructions.size());
+
+    if (blockCount * wordCount > kMaxLivenessWords) {
+        return;
+    }
+
+    // The slots which are live at the start of the blocks. Results which are
+    // computed by removable instructions are only live when they are used.
+    std::vector<uint64_t> liveIn((blockCount + 1) * wordCount, 0);
+    std::vector<uint64_t> live(wordCount);
+    bool changed;
+    bool removeResults = false;
+
+    do {
+        changed = false;
+
+        for (size_t block = blockCount; block > 0; block--) {
+            uint64_t* blockLiveIn = liveIn.data() + (block - 1) * wordCount;
+
+            // The block continues in the next one, unless it ends with a jump.
+            memcpy(live.data(), blockLiveIn + wordCount, wordCount * sizeof(uint64_t));
+
+            for (size_t i = blockStart[block]; i > blockStart[block - 1]; i--) {
+                Instruction* instr = instructions[i - 1];
+                uint32_t paramCount = instr->paramCount();
+                Operand* operands = instr->operands();
+
+                if (instr->group() == Instruction::DirectBranch) {
+                    const uint64_t* target = liveIn.data() + instr->asExtended()->value().targetLabel->m_blockIndex * wordCount;
+
+                    if (instr->opcode() == ByteCode::JumpOpcode) {
+                        memcpy(live.data(), target, wordCount * sizeof(uint64_t));
+                    } else {
+                        for (size_t j = 0; j < wordCount; j++) {
+                            live[j] |= target[j];
+                        }
+                    }
+                } else if (instr->group() == Instruction::BrTable) {
+                    Label** label = instr->asBrTable()->targetLabels();
+                    Label** end = label + instr->asBrTable()->targetLabelCount();
+
+                    std::fill(live.begin(), live.end(), 0);
+
+                    for (; label < end; label++) {
+                        const uint64_t* target = liveIn.data() + (*label)->m_blockIndex * wordCount;
+
+                        for (size_t j = 0; j < wordCount; j++) {
+                            live[j] |= target[j];
+                        }
+                    }
+                }
+
+                bool typed = hasTypedOperands(instr);
+                const uint8_t* list = typed ? instr->getOperandDescriptor() : nullptr;
+
+                if (typed && instr->resultCount() == 1) {
+                    uint8_t width = slotCount(operandType(list, paramCount));
+
+                    if (isRemovable(instr) && !isLive(live.data(), operands[paramCount], width)) {
+                        if (removeResults) {
+                            instr->m_id = kRemovedInstruction;
+                        }
+                        continue;
+                    }
+
+                    setLive(live.data(), operands[paramCount], width, false);
+                }
+
+                for (uint32_t j = 0; j < paramCount; j++) {
+                    setLive(live.data(), operands[j], typed ? slotCount(operandType(list, j)) : kMaxSlotCount, true);
+                }
+            }
+
+            if (memcmp(live.data(), blockLiveIn, wordCount * sizeof(uint64_t)) != 0) {
+                memcpy(blockLiveIn, live.data(), wordCount * sizeof(uint64_t));
+                changed = true;
+            }
+        }
+
+        if (!changed && !removeResults) {
+            // The instructions are removed by an extra iteration.
+            removeResults = true;
+            changed = true;
+        }
+    } while (changed);
+
+    InstructionListItem* prev = nullptr;
+    InstructionListItem* next;
+
+    for (InstructionListItem* item = m_first; item != nullptr; item = next) {
+        next = item->next();
+
+        if (item->m_id == kRemovedInstruction) {
+            remove(prev, item);
+            continue;
+        }
+
+        prev = item;
+    }
+}
+
+#if (defined SLJIT_64BIT_ARCHITECTURE && SLJIT_64BIT_ARCHITECTURE)
+
+// Loops with larger bodies are not copied.
+static const size_t kMaxVersionedLoopSize = 256;
+static const size_t kMaxLoopVariableCandidates = 4;
+static const size_t kMaxLoopBoundsChecks = 8;
+// These limits ensure that the sums computed by the bounds checks cannot overflow.
+static const uint64_t kMaxAffineFactor = static_cast<uint64_t>(1) << 16;
+static const uint64_t kMaxAffineConstant = static_cast<uint64_t>(1) << 40;
+
+// Returns with the number of bytes accessed by a memory load or store, or
+// 0 if the bounds check of the instruction is never moved before a loop.
+static uint32_t memoryAccessSize(ByteCode::Opcode opcode)
+{
+    switch (opcode) {
+#define LOAD_ACCESS_SIZE(name, readType, writeType) \
+    case ByteCode::name##Opcode:                    \
+        return sizeof(readType);
+#define STORE_ACCESS_SIZE(name, readType, writeType) \
+    case ByteCode::name##Opcode:                     \
+        return sizeof(writeType);
+        FOR_EACH_BYTECODE_LOAD_OP(LOAD_ACCESS_SIZE)
+        FOR_EACH_BYTECODE_LOAD_M64_OP(LOAD_ACCESS_SIZE)
+        FOR_EACH_BYTECODE_LOAD_MEMIDX_OP(LOAD_ACCESS_SIZE)
+        FOR_EACH_BYTECODE_STORE_OP(STORE_ACCESS_SIZE)
+        FOR_EACH_BYTECODE_STORE_M64_OP(STORE_ACCESS_SIZE)
+        FOR_EACH_BYTECODE_STORE_MEMIDX_OP(STORE_ACCESS_SIZE)
+#undef LOAD_ACCESS_SIZE
+#undef STORE_ACCESS_SIZE
+    default:
+        return 0;
+    }
+}
+
+// Frame slots, which are set to the same constant by all writes, and
+// one of these writes is executed before the first label.
+class ConstSlots {
+public:
+    explicit ConstSlots(size_t slotCount)
+        : m_slots(slotCount + kMaxSlotCount)
+    {
+    }
+
+    void write(Operand offset, uint8_t width, bool isConst, uint64_t value, bool isEntry)
+    {
+        uint8_t count = width > 0 ? width : kMaxSlotCount;
+        Operand start = offset >= kMaxSlotCount - 1 ? offset - (kMaxSlotCount - 1) : 0;
+
+        for (Operand i = start; i < offset + count; i++) {
+            Slot& slot = m_slots[i];
+
+            if (i == offset && isConst
+                && (slot.state == NotWritten || (slot.state == Constant && slot.width == width && slot.value == value))) {
+                slot.state = Constant;
+                slot.width = width;
+                slot.value = value;
+                slot.isInitialized |= isEntry;
+                continue;
+            }
+
+            if (i < offset && (slot.state != Constant || i + slot.width <= offset)) {
+                continue;
+            }
+
+            slot.state = Variable;
+        }
+    }
+
+    bool get(Operand offset, uint8_t width, uint64_t& value)
+    {
+        Slot& slot = m_slots[offset];
+
+        if (slot.state != Constant || slot.width != width || !slot.isInitialized) {
+            return false;
+        }
+
+        value = slot.value;
+        return true;
+    }
+
+private:
+    enum State : uint8_t {
+        NotWritten,
+        Constant,
+        Variable,
+    };
+
+    struct Slot {
+        Slot()
+            : value(0)
+            , state(NotWritten)
+            , width(0)
+            , isInitialized(false)
+        {
+        }
+
+        uint64_t value;
+        uint8_t state;
+        uint8_t width;
+        bool isInitialized;
+    };
+
+    std::vector<Slot> m_slots;
+};
+
+// Integer value in the form of: factor * loop variable + sum(termFactors[i] * terms[i])
+// + constant, where the loop variable is the value at the start of the current iteration,
+// and the terms are not modified by the loop. The computation is exact, when the result
+// is less than 2^32 for 32 bit values, since all factors and constants are non-negative.
+struct AffineValue {
+    AffineValue()
+        : factor(0)
+        , constant(0)
+        , termCount(0)
+    {
+    }
+
+    bool isConstant() const { return factor == 0 && termCount == 0; }
+
+    bool isValid() const
+    {
+        if (factor > kMaxAffineFactor || constant >= kMaxAffineConstant) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < termCount; i++) {
+            if (termFactors[i] > kMaxAffineFactor) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool add(const AffineValue& other)
+    {
+        factor += other.factor;
+        constant += other.constant;
+
+        for (uint32_t i = 0; i < other.termCount; i++) {
+            uint32_t j = 0;
+
+            while (j < termCount && terms[j] != other.terms[i]) {
+                j++;
+            }
+
+            if (j == termCount) {
+                if (termCount >= LoopBoundsCheck::kMaxTerms) {
+                    return false;
+                }
+
+                terms[j] = other.terms[i];
+                termFactors[j] = 0;
+                termCount++;
+            }
+
+            termFactors[j] += other.termFactors[i];
+        }
+
+        return isValid();
+    }
+
+    bool multiply(uint64_t value)
+    {
+        if (value > kMaxAffineFactor) {
+            return false;
+        }
+
+        factor *= value;
+        constant *= value;
+
+        for (uint32_t i = 0; i < termCount; i++) {
+            termFactors[i] *= value;
+        }
+
+        if (value == 0) {
+            termCount = 0;
+        }
+
+        return isValid();
+    }
+
+    uint64_t factor;
+    uint64_t constant;
+    uint32_t termCount;
+    Operand terms[LoopBoundsCheck::kMaxTerms];
+    uint64_t termFactors[LoopBoundsCheck::kMaxTerms];
+};
+
+struct LoopAccess {
+    LoopAccess(Instruction* instr, const AffineValue& address, uint64_t end, uint16_t memIndex)
+        : instr(instr)
+        , address(address)
+        , end(end)
+        , memIndex(memIndex)
+    {
+    }
+
+    Instruction* instr;
+    AffineValue address;
+    // Static offset plus the access size.
+    uint64_t end;
+    uint16_t memIndex;
+};
+
+// Computes the affine values of a loop, which continues while its
+// loop variable is less than a limit. The loop variable is increased
+// by a constant step in the last basic block of the loop.
+class LoopValues {
+public:
+    LoopValues(size_t slotCount, ConstSlots& constSlots)
+        : m_values(slotCount)
+        , m_affineValues(slotCount + kMaxSlotCount)
+        , m_slotWrites(slotCount + kMaxSlotCount, 0)
+        , m_constSlots(constSlots)
+        , m_variable(0)
+        , m_variableWidth(0)
+        , m_variableUpdated(false)
+        , m_step(0)
+        , m_compareOffset(0)
+        , m_hasLimitParam(false)
+        , m_limit(0)
+    {
+    }
+
+    // Counts the writes of the loop body, and returns with the
+    // instructions which may increase the loop variable.
+    void countWrites(Label* loopLabel, Instruction* backEdge, std::vector<Instruction*>& updates, bool increase);
+    bool analyze(Label* loopLabel, Instruction* backEdge, Instruction* update, bool useGuardPages);
+
+    Operand variable() { return m_variable; }
+    bool is64Bit() { return m_variableWidth == 2; }
+    uint64_t step() { return m_step; }
+    uint64_t compareOffset() { return m_compareOffset; }
+    bool hasLimitParam() { return m_hasLimitParam; }
+    // Slot of the limit when hasLimitParam() is true, its value otherwise.
+    uint64_t limit() { return m_limit; }
+    std::vector<LoopAccess>& accesses() { return m_accesses; }
+
+private:
+    struct CompareInfo {
+        ByteCode::Opcode opcode;
+        AffineValue lhs;
+        AffineValue rhs;
+    };
+
+    bool isInvariant(Operand offset, uint8_t width)
+    {
+        for (uint8_t i = 0; i < width; i++) {
+            if (m_slotWrites[offset + i] != 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool read(Operand offset, uint8_t width, AffineValue& result);
+    bool checkBackEdge(Instruction* backEdge);
+
+    BlockValues m_values;
+    std::vector<AffineValue> m_affineValues;
+    std::vector<uint8_t> m_slotWrites;
+    std::vector<CompareInfo> m_compares;
+    std::vector<LoopAccess> m_accesses;
+    ConstSlots& m_constSlots;
+    Operand m_variable;
+    uint8_t m_variableWidth;
+    bool m_variableUpdated;
+    uint64_t m_step;
+    uint64_t m_compareOffset;
+    bool m_hasLimitParam;
+    uint64_t m_limit;
+};
+
+void LoopValues::countWrites(Label* loopLabel, Instruction* backEdge, std::vector<Instruction*>& updates, bool increase)
+{
+    for (InstructionListItem* item = loopLabel->next(); item != backEdge; item = item->next()) {
+        if (item->isLabel()) {
+            updates.clear();
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+
+        if (instr->resultCount() == 0) {
+            continue;
+        }
+
+        uint8_t width = kMaxSlotCount;
+
+        if (hasTypedOperands(instr)) {
+            width = slotCount(operandType(instr->getOperandDescriptor(), instr->paramCount()));
+
+            if (instr->opcode() == ByteCode::I32AddOpcode || instr->opcode() == ByteCode::I64AddOpcode) {
+                updates.push_back(instr);
+            }
+        }
+
+        for (uint32_t i = 0; i < instr->resultCount(); i++) {
+            Operand offset = *instr->getResult(i);
+
+            for (uint8_t j = 0; j < width; j++) {
+                uint8_t& writes = m_slotWrites[offset + j];
+
+                if (!increase) {
+                    writes = 0;
+                } else if (writes < 2) {
+                    writes++;
+                }
+            }
+        }
+    }
+}
+
+bool LoopValues::read(Operand offset, uint8_t width, AffineValue& result)
+{
+    result = AffineValue();
+
+    if (offset == m_variable && width == m_variableWidth && !m_variableUpdated) {
+        result.factor = 1;
+        return true;
+    }
+
+    uint64_t value;
+
+    if (m_constSlots.get(offset, width, value)) {
+        result.constant = value;
+        return result.isValid();
+    }
+
+    BlockValues::Slot* slot = m_values.get(offset, width);
+
+    if (slot != nullptr) {
+        if (!(slot->flags & BlockValues::kIsAffine)) {
+            return false;
+        }
+
+        result = m_affineValues[offset];
+        return true;
+    }
+
+    if (!isInvariant(offset, width)) {
+        return false;
+    }
+
+    result.termCount = 1;
+    result.terms[0] = offset;
+    result.termFactors[0] = 1;
+    return true;
+}
+
+bool LoopValues::analyze(Label* loopLabel, Instruction* backEdge, Instruction* update, bool useGuardPages)
+{
+    m_variable = *update->getResult(0);
+    m_variableWidth = update->opcode() == ByteCode::I64AddOpcode ? 2 : 1;
+    m_variableUpdated = false;
+    m_compares.clear();
+    m_accesses.clear();
+    m_values.startBlock();
+
+    for (uint8_t i = 0; i < m_variableWidth; i++) {
+        if (m_slotWrites[m_variable + i] != 1) {
+            return false;
+        }
+    }
+
+    for (InstructionListItem* item = loopLabel->next();; item = item->next()) {
+        if (item->isLabel()) {
+            m_values.startBlock();
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+
+        if (instr == backEdge) {
+            return checkBackEdge(backEdge);
+        }
+
+        m_values.nextStamp();
+
+        if (!hasTypedOperands(instr)) {
+            if (instr->resultCount() > 0) {
+                m_values.nextStamp();
+
+                for (uint32_t i = 0; i < instr->resultCount(); i++) {
+                    m_values.write(*instr->getResult(i), 0);
+                }
+            }
+            continue;
+        }
+
+        const uint8_t* list = instr->getOperandDescriptor();
+        uint32_t paramCount = instr->paramCount();
+        Operand* operands = instr->operands();
+        uint8_t width = paramCount > 0 ? slotCount(operandType(list, 0)) : 0;
+        AffineValue result;
+        AffineValue other;
+        bool isAffine = false;
+        bool isCompare = false;
+
+        switch (instr->opcode()) {
+        case ByteCode::Const32Opcode:
+            result.constant = reinterpret_cast<Const32*>(instr->byteCode())->value();
+            isAffine = true;
+            break;
+        case ByteCode::Const64Opcode:
+            result.constant = reinterpret_cast<Const64*>(instr->byteCode())->value();
+            isAffine = result.isValid();
+            break;
+        case ByteCode::MoveI32Opcode:
+        case ByteCode::MoveI64Opcode:
+            isAffine = read(operands[0], width, result);
+            break;
+        case ByteCode::I32AddOpcode:
+        case ByteCode::I64AddOpcode:
+            isAffine = read(operands[0], width, result) && read(operands[1], width, other) && result.add(other);
+            break;
+        case ByteCode::I32MulOpcode:
+        case ByteCode::I64MulOpcode:
+            if (!read(operands[0], width, result) || !read(operands[1], width, other)) {
+                break;
+            }
+
+            if (!other.isConstant()) {
+                std::swap(result, other);
+            }
+
+            isAffine = other.isConstant() && result.multiply(other.constant);
+            break;
+        case ByteCode::I32ShlOpcode:
+        case ByteCode::I64ShlOpcode:
+            if (read(operands[0], width, result) && read(operands[1], width, other) && other.isConstant()) {
+                uint64_t shift = other.constant & (width == 2 ? 63 : 31);
+                isAffine = shift <= 16 && result.multiply(static_cast<uint64_t>(1) << shift);
+            }
+            break;
+        case ByteCode::I32LtSOpcode:
+        case ByteCode::I32LtUOpcode:
+        case ByteCode::I32GtSOpcode:
+        case ByteCode::I32GtUOpcode:
+        case ByteCode::I32LeSOpcode:
+        case ByteCode::I32LeUOpcode:
+        case ByteCode::I32GeSOpcode:
+        case ByteCode::I32GeUOpcode:
+        case ByteCode::I64LtSOpcode:
+        case ByteCode::I64LtUOpcode:
+        case ByteCode::I64GtSOpcode:
+        case ByteCode::I64GtUOpcode:
+        case ByteCode::I64LeSOpcode:
+        case ByteCode::I64LeUOpcode:
+        case ByteCode::I64GeSOpcode:
+        case ByteCode::I64GeUOpcode:
+            if (read(operands[0], width, result) && read(operands[1], width, other)) {
+                CompareInfo compare = { instr->opcode(), result, other };
+                m_compares.push_back(compare);
+                isCompare = true;
+            }
+            break;
+        default: {
+            uint32_t size = memoryAccessSize(instr->opcode());
+
+            if (size == 0 || size > 8 || (useGuardPages && !(instr->info() & Instruction::kMemory64))) {
+                break;
+            }
+
+            bool isMemory64 = (instr->info() & Instruction::kMemory64) != 0;
+            uint64_t offset;
+            uint16_t memIndex = 0;
+
+            if (!isMemory64) {
+                if (instr->info() & Instruction::kMultiMemory) {
+                    ByteCodeOffset2ValueMemIdx* memIdxOperation = reinterpret_cast<ByteCodeOffset2ValueMemIdx*>(instr->byteCode());
+                    offset = memIdxOperation->uintValue();
+                    memIndex = memIdxOperation->memIndex();
+                } else {
+                    offset = reinterpret_cast<ByteCodeOffset2Value*>(instr->byteCode())->uintValue();
+                }
+            } else if (instr->info() & Instruction::kMultiMemory) {
+                ByteCodeOffset2Value64MemIdx* memIdxM64Operation = reinterpret_cast<ByteCodeOffset2Value64MemIdx*>(instr->byteCode());
+                offset = memIdxM64Operation->uintValue();
+                memIndex = memIdxM64Operation->memIndex();
+            } else {
+                offset = reinterpret_cast<ByteCodeOffset2Value64*>(instr->byteCode())->uintValue();
+            }
+
+            if (offset < kMaxAffineConstant && isMemory64 == (m_variableWidth == 2)
+                && read(operands[0], isMemory64 ? 2 : 1, other) && !other.isConstant()) {
+                m_accesses.push_back(LoopAccess(instr, other, offset + size, memIndex));
+            }
+            break;
+        }
+        }
+
+        if (instr == update) {
+            if (!isAffine || result.factor != 1 || result.termCount != 0
+                || result.constant == 0 || result.constant > kMaxAffineFactor) {
+                return false;
+            }
+
+            m_variableUpdated = true;
+            m_step = result.constant;
+        }
+
+        if (instr->resultCount() == 0) {
+            continue;
+        }
+
+        m_values.nextStamp();
+        Operand resultOffset = operands[paramCount];
+        BlockValues::Slot& slot = m_values.write(resultOffset, slotCount(operandType(list, paramCount)));
+
+        if (isAffine) {
+            slot.flags = BlockValues::kIsAffine;
+            m_affineValues[resultOffset] = result;
+        } else if (isCompare) {
+            slot.flags = BlockValues::kIsCompare;
+            slot.value = m_compares.size() - 1;
+        }
+    }
+}
+
+bool LoopValues::checkBackEdge(Instruction* backEdge)
+{
+    BlockValues::Slot* slot = m_values.get(*backEdge->getParam(0), 1);
+
+    if (!m_variableUpdated || slot == nullptr || !(slot->flags & BlockValues::kIsCompare)) {
+        return false;
+    }
+
+    CompareInfo& compare = m_compares[slot->value];
+    bool jumpIfTrue = backEdge->opcode() == ByteCode::JumpIfTrueOpcode;
+    AffineValue* variable;
+    AffineValue* limit;
+
+    // The loop continues while variable < limit.
+    switch (compare.opcode) {
+    case ByteCode::I32LtSOpcode:
+    case ByteCode::I32LtUOpcode:
+    case ByteCode::I64LtSOpcode:
+    case ByteCode::I64LtUOpcode:
+        variable = &compare.lhs;
+        limit = &compare.rhs;
+        break;
+    case ByteCode::I32GtSOpcode:
+    case ByteCode::I32GtUOpcode:
+    case ByteCode::I64GtSOpcode:
+    case ByteCode::I64GtUOpcode:
+        variable = &compare.rhs;
+        limit = &compare.lhs;
+        break;
+    case ByteCode::I32GeSOpcode:
+    case ByteCode::I32GeUOpcode:
+    case ByteCode::I64GeSOpcode:
+    case ByteCode::I64GeUOpcode:
+        jumpIfTrue = !jumpIfTrue;
+        variable = &compare.lhs;
+        limit = &compare.rhs;
+        break;
+    default:
+        ASSERT(compare.opcode == ByteCode::I32LeSOpcode || compare.opcode == ByteCode::I32LeUOpcode
+               || compare.opcode == ByteCode::I64LeSOpcode || compare.opcode == ByteCode::I64LeUOpcode);
+        jumpIfTrue = !jumpIfTrue;
+        variable = &compare.rhs;
+        limit = &compare.lhs;
+        break;
+    }
+
+    if (!jumpIfTrue || variable->factor != 1 || variable->termCount != 0
+        || (variable->constant != 0 && variable->constant != m_step) || limit->factor != 0) {
+        return false;
+    }
+
+    m_compareOffset = variable->constant;
+
+    if (limit->termCount == 0) {
+        m_hasLimitParam = false;
+        m_limit = limit->constant;
+        return true;
+    }
+
+    if (limit->termCount != 1 || limit->termFactors[0] != 1 || limit->constant != 0) {
+        return false;
+    }
+
+    m_hasLimitParam = true;
+    m_limit = limit->terms[0];
+    return true;
+}
+
+// Returns with the loop back edge, if the label is the start of an innermost
+// loop, which has no other entry points than the label and can be copied.
+static Instruction* findLoop(Label* label)
+{
+    if (label->branches().size() != 1) {
+        return nullptr;
+    }
+
+    Instruction* backEdge = label->branches()[0];
+    size_t start = label->id();
+
+    if ((backEdge->opcode() != ByteCode::JumpIfTrueOpcode && backEdge->opcode() != ByteCode::JumpIfFalseOpcode)
+        || backEdge->id() <= start || backEdge->id() - start > kMaxVersionedLoopSize) {
+        return nullptr;
+    }
+
+    size_t end = backEdge->id();
+    bool hasAccess = false;
+
+    for (InstructionListItem* item = label->next(); item != backEdge; item = item->next()) {
+        if (item->isLabel()) {
+            if (item->info() != 0) {
+                return nullptr;
+            }
+
+            for (auto it : item->asLabel()->branches()) {
+                // Only forward branches from the loop body are allowed.
+                if (it->id() <= start || it->id() >= item->id()) {
+                    return nullptr;
+                }
+            }
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+
+        if (instr->group() == Instruction::DirectBranch) {
+            size_t target = instr->asExtended()->value().targetLabel->id();
+
+            if (instr->opcode() == kLoopBoundsCheckOpcode || (target >= start && target <= end && target < instr->id())) {
+                return nullptr;
+            }
+        } else if (instr->group() == Instruction::BrTable) {
+            Label** targetLabel = instr->asBrTable()->targetLabels();
+            Label** targetEnd = targetLabel + instr->asBrTable()->targetLabelCount();
+
+            for (; targetLabel < targetEnd; targetLabel++) {
+                size_t target = (*targetLabel)->id();
+
+                if (target >= start && target <= end && target < instr->id()) {
+                    return nullptr;
+                }
+            }
+        } else if (instr->group() == Instruction::Load || instr->group() == Instruction::Store) {
+            hasAccess = true;
+        }
+    }
+
+    return hasAccess ? backEdge : nullptr;
+}
+
+void JITCompiler::hoistBoundsChecks()
+{
+    // The values used by the catch blocks are not tracked.
+    if (moduleFunction()->hasTryCatch()) {
+        return;
+    }
+
+    size_t stackSlotCount = STACK_OFFSET(moduleFunction()->requiredStackSize());
+    ConstSlots constSlots(stackSlotCount);
+    // The items before the labels are kept, since the
+    // bounds check of a loop is inserted before its label.
+    std::vector<std::pair<Label*, InstructionListItem*>> labels;
+    InstructionListItem* prev = nullptr;
+    bool isEntry = true;
+    size_t id = 0;
+
+    for (InstructionListItem* item = m_first; item != nullptr; prev = item, item = item->next()) {
+        item->m_id = id++;
+
+        if (item->isLabel()) {
+            labels.push_back(std::make_pair(item->asLabel(), prev));
+            isEntry = false;
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+
+        if (instr->group() == Instruction::DirectBranch || instr->group() == Instruction::BrTable) {
+            isEntry = false;
+        }
+
+        if (instr->resultCount() == 0) {
+            continue;
+        }
+
+        if (!hasTypedOperands(instr)) {
+            for (uint32_t i = 0; i < instr->resultCount(); i++) {
+                constSlots.write(*instr->getResult(i), 0, false, 0, isEntry);
+            }
+            continue;
+        }
+
+        Operand result = *instr->getResult(0);
+
+        switch (instr->opcode()) {
+        case ByteCode::Const32Opcode:
+            constSlots.write(result, 1, true, reinterpret_cast<Const32*>(instr->byteCode())->value(), isEntry);
+            break;
+        case ByteCode::Const64Opcode:
+            constSlots.write(result, 2, true, reinterpret_cast<Const64*>(instr->byteCode())->value(), isEntry);
+            break;
+        default:
+            constSlots.write(result, slotCount(operandType(instr->getOperandDescriptor(), instr->paramCount())), false, 0, isEntry);
+            break;
+        }
+    }
+
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    // Accesses of 32 bit memories are checked by the guard pages.
+    bool useGuardPages = (options() & kMemoryGuardPages) != 0;
+#else /* !WALRUS_MEMORY_GUARD_PAGES */
+    const bool useGuardPages = false;
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
+
+    LoopValues loopValues(stackSlotCount, constSlots);
+    std::vector<Instruction*> updates;
+    std::vector<Operand> params;
+    std::vector<Instruction*> checkedAccesses;
+
+    for (size_t i = 0; i < labels.size(); i++) {
+        Label* label = labels[i].first;
+        Instruction* backEdge = findLoop(label);
+
+        if (backEdge == nullptr) {
+            continue;
+        }
+
+        updates.clear();
+        loopValues.countWrites(label, backEdge, updates, true);
+
+        if (updates.size() > kMaxLoopVariableCandidates) {
+            updates.resize(kMaxLoopVariableCandidates);
+        }
+
+        bool found = false;
+
+        for (auto it : updates) {
+            if (loopValues.analyze(label, backEdge, it, useGuardPages) && !loopValues.accesses().empty()) {
+                found = true;
+                break;
+            }
+        }
+
+        updates.clear();
+        loopValues.countWrites(label, backEdge, updates, false);
+
+        if (!found) {
+            continue;
+        }
+
+        // The inputs of the bounds check must be small enough to
+        // avoid any overflow of the loop variable or the sums.
+        uint64_t maxInput = LoopBoundsCheck::kMaxInput32;
+
+        if (loopValues.is64Bit()) {
+            maxInput = LoopBoundsCheck::kMaxInput64;
+        }
+
+        if (!loopValues.hasLimitParam() && loopValues.limit() > maxInput) {
+            continue;
+        }
+
+        LoopBoundsCheck boundsCheck;
+        boundsCheck.is64Bit = loopValues.is64Bit();
+        boundsCheck.hasLimitParam = loopValues.hasLimitParam();
+
+        params.clear();
+        params.push_back(loopValues.variable());
+
+        if (boundsCheck.hasLimitParam) {
+            params.push_back(static_cast<Operand>(loopValues.limit()));
+        }
+
+        size_t termStart = params.size();
+        // The loop variable is at most max(initial value, limit - 1 + step - compareOffset)
+        // at the start of any iteration. The lastEnd covers the second case.
+        uint64_t lastDelta = loopValues.step() - loopValues.compareOffset() - 1;
+
+        checkedAccesses.clear();
+
+        for (auto& it : loopValues.accesses()) {
+            LoopBoundsCheck::Access access;
+            AffineValue& address = it.address;
+            size_t termCount = params.size();
+
+            access.memIndex = it.memIndex;
+            access.factor = address.factor;
+            access.firstEnd = address.constant + it.end;
+            memset(access.termFactors, 0, sizeof(access.termFactors));
+
+            for (uint32_t i = 0; i < address.termCount; i++) {
+                size_t j = termStart;
+
+                while (j < params.size() && params[j] != address.terms[i]) {
+                    j++;
+                }
+
+                if (j == params.size()) {
+                    params.push_back(address.terms[i]);
+                }
+
+                if (j - termStart < LoopBoundsCheck::kMaxTerms) {
+                    access.termFactors[j - termStart] = address.termFactors[i];
+                }
+            }
+
+            if (params.size() - termStart > LoopBoundsCheck::kMaxTerms) {
+                params.resize(termCount);
+                continue;
+            }
+
+            std::vector<LoopBoundsCheck::Access>::iterator check = boundsCheck.accesses.begin();
+
+            for (; check != boundsCheck.accesses.end(); check++) {
+                if (check->memIndex == access.memIndex && check->factor == access.factor
+                    && memcmp(check->termFactors, access.termFactors, sizeof(access.termFactors)) == 0) {
+                    break;
+                }
+            }
+
+            if (check == boundsCheck.accesses.end()) {
+                if (boundsCheck.accesses.size() >= kMaxLoopBoundsChecks) {
+                    params.resize(termCount);
+                    continue;
+                }
+
+                boundsCheck.accesses.push_back(access);
+            } else if (check->firstEnd < access.firstEnd) {
+                check->firstEnd = access.firstEnd;
+            }
+
+            checkedAccesses.push_back(it.instr);
+        }
+
+        if (checkedAccesses.empty()) {
+            continue;
+        }
+
+        for (auto& it : boundsCheck.accesses) {
+            // Negative values are converted to large unsigned numbers, so the check fails.
+            it.lastEnd = it.firstEnd + it.factor * lastDelta;
+
+            if (!boundsCheck.hasLimitParam) {
+                it.lastEnd += it.factor * loopValues.limit();
+            }
+        }
+
+        m_loopBoundsChecks.push_back(boundsCheck);
+        Label* exitLabel = versionLoop(labels[i].second, label, backEdge, &m_loopBoundsChecks.back(), params, checkedAccesses);
+
+        // The exit label is inserted after the back edge.
+        if (i + 1 < labels.size() && labels[i + 1].second == backEdge) {
+            labels[i + 1].second = exitLabel;
+        }
+    }
+}
+
+Label* JITCompiler::versionLoop(InstructionListItem* prev, Label* loopLabel, Instruction* backEdge, LoopBoundsCheck* boundsCheck,
+                                const std::vector<Operand>& params, const std::vector<Instruction*>& checkedAccesses)
+{
+    uint32_t paramCount = static_cast<uint32_t>(params.size());
+    ExtendedInstruction* check = ExtendedInstruction::create(nullptr, Instruction::DirectBranch, kLoopBoundsCheckOpcode, paramCount, paramCount + 1);
+
+    memcpy(check->operands(), params.data(), paramCount * sizeof(Operand));
+    check->operands()[paramCount] = reinterpret_cast<Operand>(boundsCheck);
+    check->value().targetLabel = loopLabel;
+    loopLabel->m_branches.push_back(check);
+    insertAfter(prev, check);
+
+    // The copy of the loop is executed, when the check is successful.
+    size_t start = loopLabel->id();
+    std::vector<Label*> labelCopies(backEdge->id() - start, nullptr);
+    std::vector<Label*> labels(backEdge->id() - start, nullptr);
+    InstructionListItem* last = new Label();
+
+    labels[0] = loopLabel;
+    labelCopies[0] = last->asLabel();
+    insertAfter(check, last);
+
+    for (auto it : checkedAccesses) {
+        it->addInfo(Instruction::kBoundsChecked);
+    }
+
+    InstructionListItem* firstCopy = nullptr;
+
+    for (InstructionListItem* item = loopLabel->next();; item = item->next()) {
+        InstructionListItem* copy;
+
+        if (item->isLabel()) {
+            copy = new Label();
+            labels[item->id() - start] = item->asLabel();
+            labelCopies[item->id() - start] = copy->asLabel();
+        } else {
+            copy = copyInstruction(item->asInstruction());
+        }
+
+        insertAfter(last, copy);
+        last = copy;
+
+        if (firstCopy == nullptr) {
+            firstCopy = copy;
+        }
+
+        if (item == backEdge) {
+            break;
+        }
+    }
+
+    for (auto it : checkedAccesses) {
+        it->clearInfo(Instruction::kBoundsChecked);
+    }
+
+    for (InstructionListItem* item = firstCopy;; item = item->next()) {
+        if (item->isLabel()) {
+            continue;
+        }
+
+        Instruction* instr = item->asInstruction();
+
+        if (instr->group() == Instruction::DirectBranch) {
+            Label*& target = instr->asExtended()->value().targetLabel;
+            size_t index = target->id() - start;
+
+            if (target->id() >= start && index < labels.size() && labels[index] == target) {
+                target = labelCopies[index];
+            }
+
+            target->m_branches.push_back(instr);
+        } else if (instr->group() == Instruction::BrTable) {
+            Label** targetLabel = instr->asBrTable()->targetLabels();
+            Label** targetEnd = targetLabel + instr->asBrTable()->targetLabelCount();
+
+            for (; targetLabel < targetEnd; targetLabel++) {
+                size_t index = (*targetLabel)->id() - start;
+
+                if ((*targetLabel)->id() >= start && index < labels.size() && labels[index] == *targetLabel) {
+                    *targetLabel = labelCopies[index];
+                }
+
+                (*targetLabel)->append(instr);
+            }
+        }
+
+        if (item == last) {
+            break;
+        }
+    }
+
+    Label* exitLabel = new Label();
+    ExtendedInstruction* jump = ExtendedInstruction::create(nullptr, Instruction::DirectBranch, ByteCode::JumpOpcode, 0, 0);
+
+    jump->value().targetLabel = exitLabel;
+    exitLabel->m_branches.push_back(jump);
+    insertAfter(last, jump);
+    insertAfter(backEdge, exitLabel);
+    return exitLabel;
+}
+
+#endif /* SLJIT_64BIT_ARCHITECTURE */
+
+} // namespace Walrus
+
+#endif // WALRUS_ENABLE_JIT
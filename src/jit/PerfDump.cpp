@@ -16,10 +16,12 @@
 
 #include "Walrus.h"
 
-#if defined WALRUS_JITPERF
+#if defined(WALRUS_ENABLE_JIT)
 #include "jit/PerfDump.h"
+#include "runtime/Module.h"
 
 #include <fcntl.h>
+#include <inttypes.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <thread>
@@ -45,6 +47,9 @@
 #elif defined(CPU_ARM64)
 #define ELFMACH 183
 
+#elif defined(CPU_RISCV32) || defined(CPU_RISCV64)
+#define ELFMACH 243
+
 #else
 #error "Could't find cpu arch."
 #endif
@@ -60,6 +65,9 @@ enum RecordType : uint32_t {
     JIT_CODE_UNWINDING_INFO = 4 // record describing a function unwinding information
 };
 
+// Source file name of the debug entries, their line numbers are wasm code offsets.
+static const char s_debugFileName[] = "wasm";
+
 PerfDump& PerfDump::instance()
 {
     static PerfDump instance;
@@ -67,32 +75,44 @@ PerfDump& PerfDump::instance()
 }
 
 PerfDump::PerfDump()
-    : m_pid((uint32_t)getpid())
+    : m_mapFile(nullptr)
+    , m_dumpFile(nullptr)
+    , m_mapFileOpened(false)
+    , m_dumpFileOpened(false)
+    , m_pid((uint32_t)getpid())
     , m_codeLoadIndex(0)
-#if !defined(NDEBUG)
-    , m_line(0)
-#endif /* !NDEBUG */
 {
+}
+
+bool PerfDump::openDumpFile()
+{
+    if (m_dumpFileOpened) {
+        return m_dumpFile != nullptr;
+    }
+
+    m_dumpFileOpened = true;
+
     const char* path = getenv("WALRUS_PERF_DIR");
 
     if (path == nullptr || *path == '\0') {
-        return;
+        path = "/tmp";
     }
 
-#if !defined(NDEBUG)
-    m_sourceFileName = std::string(path) + "/jit-" + std::to_string(m_pid) + "-codedump.txt";
-    this->m_sourceFile = fopen(m_sourceFileName.c_str(), "w");
-#endif /* !NDEBUG */
+    std::string fileName = std::string(path) + "/jit-" + std::to_string(m_pid) + ".dump";
+    m_dumpFile = fopen(fileName.c_str(), "w");
 
-    std::string tmpName = std::string(path) + "/jit-" + std::to_string(m_pid) + ".dump";
-    this->m_file = fopen(tmpName.c_str(), "w");
-    this->dumpFileHeader();
+    if (m_dumpFile == nullptr) {
+        return false;
+    }
+
+    dumpFileHeader();
 
     // Perf keeps track only executable mappings. This mapping allows
     // the inject operation to find the location of the jitdump file later.
-    int fd = open(tmpName.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC, 0);
     mmap(NULL, 1, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
     close(fd);
+    return true;
 }
 
 static uint64_t getMonotonicTime()
@@ -125,7 +145,7 @@ void PerfDump::dumpFileHeader()
         .flags = 0
     };
 
-    fwrite(&fileHeader, sizeof(fileHeader), 1, m_file);
+    fwrite(&fileHeader, sizeof(fileHeader), 1, m_dumpFile);
 }
 
 void PerfDump::dumpRecordHeader(const uint32_t recordType, const uint32_t entrySize)
@@ -140,10 +160,43 @@ void PerfDump::dumpRecordHeader(const uint32_t recordType, const uint32_t entryS
         .timestamp = getMonotonicTime()
     };
 
-    fwrite(&recordHeader, sizeof(recordHeader), 1, m_file);
+    fwrite(&recordHeader, sizeof(recordHeader), 1, m_dumpFile);
+}
+
+void PerfDump::dumpPadding(uint32_t size, uint32_t alignedSize)
+{
+    ASSERT(size <= alignedSize && size + 8 > alignedSize);
+
+    if (size < alignedSize) {
+        uint8_t data[8] = { 0 };
+
+        fwrite(data, 1, alignedSize - size, m_dumpFile);
+    }
 }
 
-void PerfDump::dumpCodeLoad(const uint64_t vma, const uint64_t codeAddr, const uint64_t codeSize, const std::string& functionName, const uint8_t* nativeCode)
+void PerfDump::dumpFunction(uint32_t JITFlags, uint64_t codeAddr, uint64_t codeSize, const std::string& functionName)
+{
+    if (JITFlags & JITFlagValue::perfMap) {
+        if (!m_mapFileOpened) {
+            m_mapFileOpened = true;
+
+            std::string fileName = "/tmp/perf-" + std::to_string(m_pid) + ".map";
+            m_mapFile = fopen(fileName.c_str(), "w");
+        }
+
+        if (m_mapFile != nullptr) {
+            fprintf(m_mapFile, "%" PRIx64 " %" PRIx64 " %s\n", codeAddr, codeSize, functionName.c_str());
+            // Perf may read the map while the process is running.
+            fflush(m_mapFile);
+        }
+    }
+
+    if ((JITFlags & JITFlagValue::perfJITDump) && openDumpFile()) {
+        dumpCodeLoad(codeAddr, codeSize, functionName);
+    }
+}
+
+void PerfDump::dumpCodeLoad(uint64_t codeAddr, uint64_t codeSize, const std::string& functionName)
 {
     struct {
         const uint32_t pid;
@@ -155,7 +208,7 @@ void PerfDump::dumpCodeLoad(const uint64_t vma, const uint64_t codeAddr, const u
     } codeLoad = {
         .pid = m_pid,
         .tid = (uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id()),
-        .vma = vma,
+        .vma = codeAddr,
         .codeAddr = codeAddr,
         .codeSize = codeSize,
         .codeLoadIndex = m_codeLoadIndex++
@@ -166,204 +219,68 @@ void PerfDump::dumpCodeLoad(const uint64_t vma, const uint64_t codeAddr, const u
     uint32_t alignedSize = (size + 7) & ~(size_t)0x7;
 
     dumpRecordHeader(JIT_CODE_LOAD, alignedSize);
-    fwrite(&codeLoad, sizeof(codeLoad), 1, m_file);
-    fwrite(functionName.c_str(), nameSize, 1, m_file);
-
-    ASSERT(size <= alignedSize && size + 8 > alignedSize);
-
-    if (size < alignedSize) {
-        uint8_t data[8] = { 0 };
-
-        fwrite(data, 1, alignedSize - size, m_file);
-    }
-
-    fwrite(nativeCode, codeSize, 1, m_file);
+    fwrite(&codeLoad, sizeof(codeLoad), 1, m_dumpFile);
+    fwrite(functionName.c_str(), nameSize, 1, m_dumpFile);
+    dumpPadding(size, alignedSize);
+    fwrite(reinterpret_cast<const uint8_t*>(codeAddr), codeSize, 1, m_dumpFile);
 }
 
-#if !defined(NDEBUG)
-
 struct DebugEntry {
     uint64_t codeAddress;
     uint32_t line;
     uint32_t discrim;
 };
 
-size_t PerfDump::dumpDebugInfo(std::vector<JITCompiler::DebugEntry>& debugEntries, size_t debugEntryStart, const uint64_t codeAddr)
+void PerfDump::dumpDebugInfo(const JITCompiler::DebugEntry* debugEntries, size_t numberOfEntries, uint64_t codeAddr)
 {
-    ASSERT(debugEntryStart < debugEntries.size());
-
-    size_t end = debugEntryStart;
-
-    do {
-        end++;
-    } while (debugEntries[end].line != 0);
-
-    size_t numberOfEntries = end - debugEntryStart;
+    if (numberOfEntries == 0 || !openDumpFile()) {
+        return;
+    }
 
     struct {
         const uint64_t codeAddress;
         const uint64_t nrEntry;
     } debugInfo = {
         .codeAddress = codeAddr,
-        .nrEntry = end - debugEntryStart
+        .nrEntry = numberOfEntries
     };
 
-    const size_t nameSize = m_sourceFileName.size() + 1;
+    const size_t nameSize = sizeof(s_debugFileName);
     uint32_t size = sizeof(debugInfo) + (numberOfEntries * (sizeof(DebugEntry) + nameSize));
     uint32_t alignedSize = (size + 7) & ~(size_t)0x7;
 
     dumpRecordHeader(JIT_DEBUG_INFO, alignedSize);
-    fwrite(&debugInfo, sizeof(debugInfo), 1, m_file);
+    fwrite(&debugInfo, sizeof(debugInfo), 1, m_dumpFile);
 
     DebugEntry debugEntry;
     debugEntry.discrim = 0;
 
-    for (size_t i = debugEntryStart; i < end; i++) {
+    for (size_t i = 0; i < numberOfEntries; i++) {
         debugEntry.codeAddress = debugEntries[i].u.address;
         debugEntry.line = debugEntries[i].line;
-        fwrite(&debugEntry, sizeof(debugEntry), 1, m_file);
-        fwrite(m_sourceFileName.data(), 1, nameSize, m_file);
+        fwrite(&debugEntry, sizeof(debugEntry), 1, m_dumpFile);
+        fwrite(s_debugFileName, 1, nameSize, m_dumpFile);
     }
 
-    ASSERT(size <= alignedSize && size + 8 > alignedSize);
-
-    if (size < alignedSize) {
-        uint8_t data[8] = { 0 };
-
-        fwrite(data, 1, alignedSize - size, m_file);
-    }
-
-    return end + 1;
+    dumpPadding(size, alignedSize);
 }
 
-#endif /* !NDEBUG */
-
 void PerfDump::dumpCodeClose()
 {
     dumpRecordHeader(JIT_CODE_CLOSE, 0);
 }
 
-#if !defined(NDEBUG)
-
-uint32_t PerfDump::dumpProlog(Module* module, ModuleFunction* function)
-{
-    if (m_line > 0) {
-        fprintf(m_sourceFile, "\n");
-        m_line++;
-    }
-
-    size_t size = module->numberOfFunctions();
-    int functionIndex = 0;
-    ExportType* exportType = nullptr;
-
-    for (auto exp : module->exports()) {
-        if (module->function(exp->itemIndex()) == function) {
-            exportType = exp;
-            break;
-        }
-    }
-
-    for (size_t i = 0; i < size; i++) {
-        if (module->function(i) == function) {
-            functionIndex = static_cast<int>(i);
-            break;
-        }
-    }
-
-    if (exportType == nullptr) {
-        fprintf(m_sourceFile, "--- FUNCTION:%d ---\nProlog\n", functionIndex);
-    } else {
-        fprintf(m_sourceFile, "--- FUNCTION:%d [%s] ---\nProlog\n", functionIndex, exportType->name().data());
-    }
-
-    m_line += 2;
-    return m_line;
-}
-
-uint32_t PerfDump::dumpByteCode(InstructionListItem* item)
+PerfDump::~PerfDump()
 {
-    const char** byteCodeNames = JITCompiler::byteCodeNames();
-
-    if (!item->isInstruction()) {
-        fprintf(m_sourceFile, "[%d] Label\n", static_cast<int>(item->id()));
-        return ++m_line;
-    }
-
-    Instruction* instr = item->asInstruction();
-
-    uint32_t paramCount = instr->paramCount();
-    uint32_t size = paramCount + instr->resultCount();
-    Operand* operand = instr->operands();
-    VariableRef ref;
-    bool newline = false;
-
-    fprintf(m_sourceFile, "[%d] %s", static_cast<int>(instr->id()), byteCodeNames[instr->opcode()]);
-
-    for (uint32_t i = 0; i < size; ++i) {
-        char prefix = !newline ? ':' : ',';
-        newline = true;
-
-        if (i < paramCount) {
-            fprintf(m_sourceFile, "%c P%d", prefix, static_cast<int>(i));
-        } else {
-            fprintf(m_sourceFile, "%c R%d", prefix, static_cast<int>(i - paramCount));
-        }
-
-        switch (VARIABLE_TYPE(*operand)) {
-        case Instruction::ConstPtr:
-            fprintf(m_sourceFile, "(imm)");
-            break;
-        case Instruction::Register:
-            ref = VARIABLE_GET_REF(*operand);
-
-            if (SLJIT_IS_REG_PAIR(ref)) {
-                fprintf(m_sourceFile, "(r%d,r%d)", static_cast<int>((ref & 0xff) - 1), static_cast<int>((ref >> 8) - 1));
-            } else {
-                fprintf(m_sourceFile, "(r%d)", static_cast<int>(ref - 1));
-            }
-            break;
-        default:
-            ASSERT(VARIABLE_TYPE(*operand) == Instruction::Offset);
-            fprintf(m_sourceFile, "(o:%d)", static_cast<int>(VARIABLE_GET_OFFSET(*operand)));
-            break;
-        }
-
-        operand++;
+    if (m_dumpFile != nullptr) {
+        dumpCodeClose();
+        fclose(m_dumpFile);
     }
 
-    for (uint32_t i = 0; i < 4; ++i) {
-        uint8_t reg = instr->requiredReg(i);
-
-        if (reg == 0) {
-            continue;
-        }
-
-        fprintf(m_sourceFile, "%c T%d(r%d)", (!newline ? ':' : ','), static_cast<int>(i), static_cast<int>(reg - 1));
-        newline = true;
-    }
-
-    fprintf(m_sourceFile, "\n");
-    return ++m_line;
-}
-
-uint32_t PerfDump::dumpEpilog()
-{
-    fprintf(m_sourceFile, "Epilog\n");
-    return ++m_line;
-}
-
-#endif /* !NDEBUG */
-
-PerfDump::~PerfDump()
-{
-    if (this->m_file != nullptr) {
-        this->dumpCodeClose();
-        fclose(this->m_file);
-#if !defined(NDEBUG)
-        fclose(this->m_sourceFile);
-#endif /* !NDEBUG */
+    if (m_mapFile != nullptr) {
+        fclose(m_mapFile);
     }
 }
 
 } // namespace Walrus
-#endif
+#endif // WALRUS_ENABLE_JIT
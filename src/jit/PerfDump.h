@@ -14,48 +14,59 @@
  * limitations under the License.
  */
 
-#if defined WALRUS_JITPERF
-#ifndef __WalrusJITPERF__
-#define __WalrusJITPERF_
+#ifndef __WalrusPerfDump__
+#define __WalrusPerfDump__
+
+#if defined(WALRUS_ENABLE_JIT)
 
 #include "jit/Compiler.h"
 
+#include <mutex>
+
 namespace Walrus {
 
+// Describes the compiled code for the perf tool. The perf map
+// (/tmp/perf-<pid>.map) only lists the function symbols, while the jitdump
+// file (jit-<pid>.dump) also contains the machine code and maps it back to
+// wasm code offsets. The outputs are selected by the perfMap and perfJITDump
+// JIT flags, and the files are created when the first function is written.
+// Interpreted functions have no symbols: calls between them are dispatched by
+// one interpreter loop without native frames, so their samples are attributed
+// to the interpreter. The sampling profiler (--profile) walks the value stack,
+// and reports interpreted functions as well.
 class PerfDump {
 public:
     static PerfDump& instance();
 
-    PerfDump();
-    bool perfEnabled() { return m_file != nullptr; }
-    void dumpRecordHeader(const uint32_t recordType, const uint32_t entrySize);
-    void dumpCodeLoad(const uint64_t vma, const uint64_t codeAddr, const uint64_t codeSize, const std::string& functionName, const uint8_t* nativeCode);
-#if !defined(NDEBUG)
-    size_t dumpDebugInfo(std::vector<JITCompiler::DebugEntry>& debugEntries, size_t debugEntryStart, const uint64_t codeAddr);
-#endif /* !NDEBUG */
-    void dumpCodeClose();
-    ~PerfDump();
+    // Held while the records of a compiler are written, since
+    // modules may be compiled by multiple threads.
+    std::mutex& lock() { return m_lock; }
 
-#if !defined(NDEBUG)
-    uint32_t dumpProlog(Module* module, ModuleFunction* function);
-    uint32_t dumpByteCode(InstructionListItem* item);
-    uint32_t dumpEpilog();
-#endif /* !NDEBUG */
+    void dumpFunction(uint32_t JITFlags, uint64_t codeAddr, uint64_t codeSize, const std::string& functionName);
+    // Writes the debug entries of a function, which must be followed by its dumpFunction.
+    void dumpDebugInfo(const JITCompiler::DebugEntry* debugEntries, size_t numberOfEntries, uint64_t codeAddr);
 
 private:
+    PerfDump();
+    ~PerfDump();
+
+    bool openDumpFile();
     void dumpFileHeader();
+    void dumpRecordHeader(const uint32_t recordType, const uint32_t entrySize);
+    void dumpPadding(uint32_t size, uint32_t alignedSize);
+    void dumpCodeLoad(uint64_t codeAddr, uint64_t codeSize, const std::string& functionName);
+    void dumpCodeClose();
 
-    FILE* m_file = nullptr;
+    std::mutex m_lock;
+    FILE* m_mapFile;
+    FILE* m_dumpFile;
+    bool m_mapFileOpened;
+    bool m_dumpFileOpened;
     uint32_t m_pid;
     uint64_t m_codeLoadIndex;
-
-#if !defined(NDEBUG)
-    std::string m_sourceFileName;
-    FILE* m_sourceFile = nullptr;
-    uint32_t m_line;
-#endif /* !NDEBUG */
 };
 
 } // namespace Walrus
-#endif
-#endif
+
+#endif // WALRUS_ENABLE_JIT
+#endif // __WalrusPerfDump__
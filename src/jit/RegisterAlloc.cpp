@@ -698,12 +698,12 @@ void JITCompiler::allocateRegisters()
             ASSERT(instr->opcode() == ByteCode::EndOpcode || instr->opcode() == ByteCode::ThrowOpcode
                    || instr->opcode() == ByteCode::CallOpcode || instr->opcode() == ByteCode::CallIndirectOpcode
                    || instr->opcode() == ByteCode::CallRefOpcode || instr->opcode() == ByteCode::ReturnCallOpcode
-                   || instr->opcode() == ByteCode::JumpOpcode
+                   || instr->opcode() == ByteCode::JumpOpcode || instr->opcode() == kLoopBoundsCheckOpcode
                    || instr->opcode() == ByteCode::ElemDropOpcode || instr->opcode() == ByteCode::DataDropOpcode
                    || instr->opcode() == ByteCode::StructNewOpcode || instr->opcode() == ByteCode::ArrayNewFixedOpcode
                    || instr->opcode() == ByteCode::ArrayInitDataOpcode || instr->opcode() == ByteCode::ArrayInitElemOpcode
                    || instr->opcode() == ByteCode::ArrayFillOpcode || instr->opcode() == ByteCode::ArrayCopyOpcode
-                   || instr->opcode() == ByteCode::UnreachableOpcode || NOP_CHECK);
+                   || instr->opcode() == ByteCode::UnreachableOpcode || instr->opcode() == ByteCode::CheckEpochOpcode || NOP_CHECK);
 
             if (!hasResult) {
                 continue;
@@ -962,6 +962,8 @@ void JITCompiler::allocateRegisters()
         insertStackInitList(it.handler, it.variableListStart, it.variableListSize);
     }
 
+    buildOSRStackInitLists();
+
     size_t size = m_variableList->variables.size();
     for (size_t i = 0; i < size; i++) {
         VariableList::Variable& variable = m_variableList->variables[i];
@@ -1036,12 +1038,12 @@ void JITCompiler::allocateRegistersSimple()
             ASSERT(instr->opcode() == ByteCode::EndOpcode || instr->opcode() == ByteCode::ThrowOpcode
                    || instr->opcode() == ByteCode::CallOpcode || instr->opcode() == ByteCode::CallIndirectOpcode
                    || instr->opcode() == ByteCode::CallRefOpcode || instr->opcode() == ByteCode::ReturnCallOpcode
-                   || instr->opcode() == ByteCode::JumpOpcode
+                   || instr->opcode() == ByteCode::JumpOpcode || instr->opcode() == kLoopBoundsCheckOpcode
                    || instr->opcode() == ByteCode::ElemDropOpcode || instr->opcode() == ByteCode::DataDropOpcode
                    || instr->opcode() == ByteCode::StructNewOpcode || instr->opcode() == ByteCode::ArrayNewFixedOpcode
                    || instr->opcode() == ByteCode::ArrayInitDataOpcode || instr->opcode() == ByteCode::ArrayInitElemOpcode
                    || instr->opcode() == ByteCode::ArrayFillOpcode || instr->opcode() == ByteCode::ArrayCopyOpcode
-                   || instr->opcode() == ByteCode::UnreachableOpcode || NOP_CHECK);
+                   || instr->opcode() == ByteCode::UnreachableOpcode || instr->opcode() == ByteCode::CheckEpochOpcode || NOP_CHECK);
             continue;
         }
 
@@ -1186,6 +1188,13 @@ void JITCompiler::freeVariables()
         }
     }
 
+    for (auto& it : m_osrEntries) {
+        for (InstructionListItem* item = it.stackInitList; item != nullptr; item = item->next()) {
+            Operand* operand = item->asInstruction()->operands();
+            *operand = m_variableList->variables[*operand].value;
+        }
+    }
+
     delete m_variableList;
     m_variableList = nullptr;
 }
@@ -36,10 +36,12 @@ static size_t trapListCountItems(std::vector<TrapBlock>& trapBlocks)
 }
 
 InstanceConstData::InstanceConstData(std::vector<TrapBlock>& trapBlocks, std::vector<Walrus::TryBlock>& tryBlocks)
+    : m_readers(0)
 {
+    Tables* tables = new Tables;
     sljit_uw lastAddress = 0;
 
-    m_trapList.reserve(trapListCountItems(trapBlocks));
+    tables->trapList.reserve(trapListCountItems(trapBlocks));
 
     for (auto it : trapBlocks) {
         sljit_uw endAddress = sljit_get_label_addr(it.endLabel);
@@ -47,31 +49,36 @@ InstanceConstData::InstanceConstData(std::vector<TrapBlock>& trapBlocks, std::ve
         ASSERT(lastAddress <= endAddress && endAddress != 0);
 
         if (endAddress != lastAddress) {
-            m_trapList.push_back(endAddress);
-            m_trapList.push_back(sljit_get_label_addr(it.u.handlerLabel));
+            tables->trapList.push_back(endAddress);
+            tables->trapList.push_back(sljit_get_label_addr(it.u.handlerLabel));
             lastAddress = endAddress;
         }
     }
 
     size_t catchStart = 0;
-    m_tryBlocks.reserve(tryBlocks.size());
+    tables->tryBlocks.reserve(tryBlocks.size());
 
     for (auto it : tryBlocks) {
         size_t catchCount = it.catchBlocks.size();
 
         ASSERT(catchCount > 0);
-        m_tryBlocks.push_back(TryBlock(catchStart, catchCount, it.parent, sljit_get_label_addr(it.returnToLabel)));
+        tables->tryBlocks.push_back(TryBlock(catchStart, catchCount, it.parent, sljit_get_label_addr(it.returnToLabel)));
 
         for (auto catchIt : it.catchBlocks) {
-            m_catchBlocks.push_back(CatchBlock(sljit_get_label_addr(catchIt.u.handlerLabel), catchIt.stackSizeToBe, catchIt.tagIndex));
+            tables->catchBlocks.push_back(CatchBlock(sljit_get_label_addr(catchIt.u.handlerLabel), catchIt.stackSizeToBe, catchIt.tagIndex));
         }
 
         catchStart += catchCount;
     }
+
+    m_tables.store(tables);
 }
 
 void InstanceConstData::append(std::vector<TrapBlock>& trapBlocks, std::vector<Walrus::TryBlock>& tryBlocks)
 {
+    std::lock_guard<std::mutex> guard(m_lock);
+    Tables* oldTables = m_tables.load();
+    Tables* tables = new Tables(*oldTables);
     sljit_uw itemCount = trapListCountItems(trapBlocks);
     sljit_uw endAddress = sljit_get_label_addr(trapBlocks[0].endLabel);
     sljit_uw pos = 0;
@@ -79,13 +86,13 @@ void InstanceConstData::append(std::vector<TrapBlock>& trapBlocks, std::vector<W
     ASSERT(itemCount > 0);
 
     while (true) {
-        if (pos >= m_trapList.size()) {
-            m_trapList.resize(m_trapList.size() + itemCount);
+        if (pos >= tables->trapList.size()) {
+            tables->trapList.resize(tables->trapList.size() + itemCount);
             break;
         }
 
-        if (endAddress < m_trapList[pos]) {
-            m_trapList.insert(m_trapList.begin() + pos, itemCount, static_cast<sljit_uw>(0));
+        if (endAddress < tables->trapList[pos]) {
+            tables->trapList.insert(tables->trapList.begin() + pos, itemCount, static_cast<sljit_uw>(0));
             break;
         }
 
@@ -100,16 +107,16 @@ void InstanceConstData::append(std::vector<TrapBlock>& trapBlocks, std::vector<W
         ASSERT(lastAddress <= endAddress && endAddress != 0);
 
         if (endAddress != lastAddress) {
-            m_trapList[pos] = endAddress;
-            m_trapList[pos + 1] = sljit_get_label_addr(it.u.handlerLabel);
+            tables->trapList[pos] = endAddress;
+            tables->trapList[pos + 1] = sljit_get_label_addr(it.u.handlerLabel);
             lastAddress = endAddress;
             pos += 2;
         }
     }
 
-    size_t catchStart = m_catchBlocks.size();
-    size_t tryBlockOffset = m_tryBlocks.size();
-    m_tryBlocks.reserve(tryBlockOffset + tryBlocks.size());
+    size_t catchStart = tables->catchBlocks.size();
+    size_t tryBlockOffset = tables->tryBlocks.size();
+    tables->tryBlocks.reserve(tryBlockOffset + tryBlocks.size());
 
     for (auto it : tryBlocks) {
         size_t catchCount = it.catchBlocks.size();
@@ -121,19 +128,30 @@ void InstanceConstData::append(std::vector<TrapBlock>& trapBlocks, std::vector<W
             parent += tryBlockOffset;
         }
 
-        m_tryBlocks.push_back(TryBlock(catchStart, catchCount, parent, sljit_get_label_addr(it.returnToLabel)));
+        tables->tryBlocks.push_back(TryBlock(catchStart, catchCount, parent, sljit_get_label_addr(it.returnToLabel)));
 
         for (auto catchIt : it.catchBlocks) {
-            m_catchBlocks.push_back(CatchBlock(sljit_get_label_addr(catchIt.u.handlerLabel), catchIt.stackSizeToBe, catchIt.tagIndex));
+            tables->catchBlocks.push_back(CatchBlock(sljit_get_label_addr(catchIt.u.handlerLabel), catchIt.stackSizeToBe, catchIt.tagIndex));
         }
 
         catchStart += catchCount;
     }
+
+    m_tables.store(tables);
+
+    // Readers increase the counter before loading the tables, so no
+    // reader can use oldTables after the counter drops to zero.
+    while (m_readers.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    delete oldTables;
 }
 
 static sljit_uw SLJIT_FUNC getTrapHandler(ExecutionContext* context, sljit_uw returnAddr)
 {
-    return context->currentInstanceConstData->find(returnAddr);
+    InstanceConstData::Reader tables(context->currentInstanceConstData);
+    return tables->find(returnAddr);
 }
 
 static void emitTry(CompileContext* context, Label* label)
@@ -155,7 +173,8 @@ static void emitTry(CompileContext* context, Label* label)
 
 static sljit_sw findCatch(sljit_sw current, uint8_t* bp, ExecutionContext* context)
 {
-    std::vector<InstanceConstData::TryBlock>& tryBlocks = context->currentInstanceConstData->tryBlocks();
+    InstanceConstData::Reader tables(context->currentInstanceConstData);
+    std::vector<InstanceConstData::TryBlock>& tryBlocks = tables->tryBlocks;
 
     ASSERT(context->error != ExecutionContext::NoError);
 
@@ -163,7 +182,7 @@ static sljit_sw findCatch(sljit_sw current, uint8_t* bp, ExecutionContext* conte
         return tryBlocks[current].returnToAddr;
     }
 
-    std::vector<InstanceConstData::CatchBlock>& catchBlocks = context->currentInstanceConstData->catchBlocks();
+    std::vector<InstanceConstData::CatchBlock>& catchBlocks = tables->catchBlocks;
     Tag* tag = context->capturedException->tag().value();
     Instance* instance = context->instance;
 
@@ -214,7 +233,15 @@ static void emitCatch(sljit_compiler* compiler, CompileContext* context)
 
     tryBlock.throwJumps.clear();
 
-    sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    if (context->compiler->hasDirectCall()) {
+        // Direct calls return here with the frame of the callee.
+        sljit_emit_op1(compiler, SLJIT_MOV, kFrameReg, 0, SLJIT_MEM1(SLJIT_SP), kSavedFrameOffset);
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+        sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_R1, 0, SLJIT_MEM1(SLJIT_SP), kDirectCallFrameOffset);
+        sljit_emit_op1(compiler, SLJIT_MOV_P, SLJIT_MEM1(SLJIT_R2), OffsetOfContextField(frameStackTop), SLJIT_R1, 0);
+    } else {
+        sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R2, 0, SLJIT_MEM1(SLJIT_SP), kContextOffset);
+    }
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R0, 0, SLJIT_IMM, static_cast<sljit_sw>(context->compiler->tryBlockOffset() + context->currentTryBlock));
     sljit_emit_op1(compiler, SLJIT_MOV, SLJIT_R1, 0, kFrameReg, 0);
     sljit_emit_icall(compiler, SLJIT_CALL, SLJIT_ARGS3(W, W, W, W), SLJIT_IMM, GET_FUNC_ADDR(sljit_sw, findCatch));
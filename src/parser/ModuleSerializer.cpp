@@ -0,0 +1,1339 @@
+/*
+ * Copyright (c) 2022-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Walrus.h"
+
+#include "parser/WASMParser.h"
+#include "interpreter/ByteCode.h"
+#include "runtime/Module.h"
+#include "runtime/Store.h"
+#include "runtime/TypeStore.h"
+
+#include <unordered_map>
+
+#define WALRUS_SERIALIZER_STRING(x) #x
+#define WALRUS_SERIALIZER_EXPAND_STRING(x) WALRUS_SERIALIZER_STRING(x)
+
+namespace Walrus {
+
+// Layout of the serialized data:
+//   SerializedModuleHeader
+//   original binary (aligned to 8 bytes)
+//   module data (aligned to 8 bytes)
+// Arrays of the module data are stored in their in-memory layout, and
+// every array is aligned to 8 bytes. Types are stored in the binary
+// format, and recreated from the type section of the original binary.
+// Loading copies the arrays into the module, since the byte code must be
+// relocated, so the serialized data can be freed after loading.
+struct SerializedModuleHeader {
+    static const uint32_t kMagic = 0x534c4157; // "WALS"
+    // Must be increased when the layout of the serialized data changes.
+    static const uint32_t kFormatVersion = 2;
+
+    uint32_t magic;
+    uint32_t formatVersion;
+    char buildId[64];
+    uint64_t configurationHash;
+    uint32_t byteCodeFlags;
+    uint32_t typeSectionOffset;
+    uint32_t typeSectionSize;
+    uint32_t reserved;
+    uint64_t binarySize;
+    uint64_t dataSize;
+    uint64_t dataChecksum;
+};
+
+COMPILE_ASSERT((sizeof(SerializedModuleHeader) & 0x7) == 0, "header must keep the data aligned");
+
+static const uint32_t kNoIndex = ~static_cast<uint32_t>(0);
+static const uint32_t kDefaultFunctionTypeBit = 0x80000000;
+
+// Number of the function types returned by Store::getDefaultFunctionType.
+#define COUNT_VALUE_TYPE(name) +1
+static const uint32_t kDefaultFunctionTypeCount = 0 FOR_EACH_VALUE_TYPE(COUNT_VALUE_TYPE);
+#undef COUNT_VALUE_TYPE
+
+// clang-format off
+static const size_t g_serializedByteCodeSize[ByteCode::OpcodeKindEnd] = {
+#define DECLARE_BYTECODE_SIZE(name, ...) sizeof(name),
+    FOR_EACH_BYTECODE(DECLARE_BYTECODE_SIZE)
+#undef DECLARE_BYTECODE_SIZE
+};
+// clang-format on
+
+static size_t alignedSize(size_t size)
+{
+    return (size + 0x7) & ~static_cast<size_t>(0x7);
+}
+
+static void getBuildId(char* buildId)
+{
+#if defined(WALRUS_BUILD_ID)
+    static const char s_buildId[] = WALRUS_SERIALIZER_EXPAND_STRING(WALRUS_BUILD_ID);
+#else
+    static const char s_buildId[] = "unknown";
+#endif
+
+    size_t length = std::min(sizeof(s_buildId), sizeof(SerializedModuleHeader::buildId) - 1);
+    memset(buildId, 0, sizeof(SerializedModuleHeader::buildId));
+    memcpy(buildId, s_buildId, length);
+}
+
+static uint64_t getConfigurationHash()
+{
+    // Everything which affects the in-memory layout of the module data.
+    std::vector<uint64_t> configuration;
+    uint32_t endianTest = 1;
+
+    configuration.push_back(sizeof(void*));
+    configuration.push_back(*reinterpret_cast<uint8_t*>(&endianTest));
+    configuration.push_back(sizeof(ModuleFunction::CatchInfo));
+    configuration.push_back(sizeof(ByteCodeStackOffset));
+    configuration.push_back(sizeof(Value));
+    configuration.push_back(ByteCode::OpcodeKindEnd);
+    for (size_t i = 0; i < ByteCode::OpcodeKindEnd; i++) {
+        configuration.push_back(g_serializedByteCodeSize[i]);
+    }
+
+    uint64_t options = 0;
+#if defined(ENABLE_GC)
+    options |= 1 << 0;
+#endif
+#if defined(WALRUS_ENABLE_JIT)
+    options |= 1 << 1;
+#endif
+#if defined(NDEBUG)
+    options |= 1 << 2;
+#endif
+    configuration.push_back(options);
+
+    return WASMParser::hashBinary(reinterpret_cast<uint8_t*>(configuration.data()), configuration.size() * sizeof(uint64_t));
+}
+
+static bool readLEB128(const uint8_t* data, size_t len, size_t& pos, uint32_t& result)
+{
+    result = 0;
+
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        if (pos >= len) {
+            return false;
+        }
+
+        uint8_t byte = data[pos++];
+        result |= static_cast<uint32_t>(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns with the position and size of the type section including its header.
+static bool findTypeSection(const uint8_t* data, size_t len, uint32_t& offset, uint32_t& size)
+{
+    const uint8_t kTypeSectionId = 1;
+    size_t pos = 8;
+
+    offset = 0;
+    size = 0;
+
+    while (pos < len) {
+        size_t start = pos;
+        uint8_t id = data[pos++];
+        uint32_t sectionSize;
+
+        if (!readLEB128(data, len, pos, sectionSize) || sectionSize > len - pos) {
+            return false;
+        }
+
+        pos += sectionSize;
+
+        if (id == kTypeSectionId) {
+            offset = static_cast<uint32_t>(start);
+            size = static_cast<uint32_t>(pos - start);
+            return true;
+        }
+    }
+
+    return true;
+}
+
+class SerializedWriter {
+public:
+    SerializedWriter(std::vector<uint8_t>& out)
+        : m_out(out)
+    {
+    }
+
+    template <typename T>
+    void write(const T& value)
+    {
+        append(&value, sizeof(T));
+    }
+
+    void writeArray(const void* data, size_t size)
+    {
+        write<uint64_t>(size);
+        align();
+        append(data, size);
+        align();
+    }
+
+    void writeString(const std::string& str)
+    {
+        writeArray(str.data(), str.size());
+    }
+
+    // Reserves space for an array, which is filled by the caller.
+    size_t reserveArray(size_t size)
+    {
+        write<uint64_t>(size);
+        align();
+        size_t offset = m_out.size();
+        m_out.resize(offset + alignedSize(size));
+        return offset;
+    }
+
+    uint8_t* at(size_t offset)
+    {
+        return m_out.data() + offset;
+    }
+
+    void align()
+    {
+        m_out.resize(alignedSize(m_out.size()));
+    }
+
+private:
+    void append(const void* data, size_t size)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+        m_out.insert(m_out.end(), bytes, bytes + size);
+    }
+
+    std::vector<uint8_t>& m_out;
+};
+
+class SerializedReader {
+public:
+    SerializedReader(const uint8_t* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+        , m_position(0)
+        , m_hasError(false)
+    {
+    }
+
+    bool hasError() const { return m_hasError; }
+
+    template <typename T>
+    T read()
+    {
+        T value;
+
+        if (m_size - m_position < sizeof(T)) {
+            m_hasError = true;
+            memset(&value, 0, sizeof(T));
+            return value;
+        }
+
+        memcpy(&value, m_data + m_position, sizeof(T));
+        m_position += sizeof(T);
+        return value;
+    }
+
+    // Returns with the number of items, which must be at
+    // least minItemSize bytes long in the serialized data.
+    uint32_t readCount(size_t minItemSize)
+    {
+        uint32_t count = read<uint32_t>();
+
+        if (count > (m_size - m_position) / minItemSize) {
+            m_hasError = true;
+            return 0;
+        }
+        return count;
+    }
+
+    const uint8_t* readArray(size_t& size)
+    {
+        uint64_t arraySize = read<uint64_t>();
+        align();
+
+        if (m_hasError || arraySize > m_size - m_position) {
+            m_hasError = true;
+            size = 0;
+            return nullptr;
+        }
+
+        const uint8_t* result = m_data + m_position;
+        size = static_cast<size_t>(arraySize);
+        m_position += size;
+        align();
+        return result;
+    }
+
+    template <typename T, typename VectorType>
+    void readVector(VectorType& vector)
+    {
+        size_t size;
+        const uint8_t* data = readArray(size);
+
+        if (size % sizeof(T) != 0) {
+            m_hasError = true;
+            return;
+        }
+
+        vector.resizeWithUninitializedValues(size / sizeof(T));
+        if (size > 0) {
+            memcpy(reinterpret_cast<void*>(vector.data()), data, size);
+        }
+    }
+
+    std::string readString()
+    {
+        size_t size;
+        const uint8_t* data = readArray(size);
+        return std::string(reinterpret_cast<const char*>(data), size);
+    }
+
+private:
+    void align()
+    {
+        size_t position = alignedSize(m_position);
+
+        if (position > m_size) {
+            m_hasError = true;
+            return;
+        }
+        m_position = position;
+    }
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_position;
+    bool m_hasError;
+};
+
+class ModuleSerializer {
+public:
+    static bool serialize(Module* module, SerializedWriter& writer);
+    static std::string deserialize(SerializedReader& reader, WASMParsingResult& result);
+
+private:
+    ModuleSerializer(Module* module);
+
+    bool writeModule(SerializedWriter& writer);
+    bool writeFunction(SerializedWriter& writer, ModuleFunction* function);
+    bool writeByteCode(SerializedWriter& writer, ModuleFunction* function);
+    uint32_t functionIndex(const ModuleFunction* function);
+    uint32_t functionTypeIndex(const FunctionType* functionType);
+    uint32_t compositeTypeIndex(const CompositeType* type);
+    uint32_t subTypeListIndex(const CompositeType** subTypeList);
+    void writeType(SerializedWriter& writer, const Type& type);
+
+    static ModuleFunction* readFunction(SerializedReader& reader, WASMParsingResult& result);
+    static bool readByteCode(SerializedReader& reader, WASMParsingResult& result, ModuleFunction* function);
+    static FunctionType* readFunctionType(SerializedReader& reader, WASMParsingResult& result);
+    static bool readType(SerializedReader& reader, WASMParsingResult& result, Type& type);
+    static void setOpcode(ByteCode* code, ByteCode::Opcode opcode);
+
+    Module* m_module;
+    bool m_hasError;
+    std::unordered_map<const CompositeType*, uint32_t> m_compositeTypeIndex;
+    std::unordered_map<const CompositeType**, uint32_t> m_subTypeListIndex;
+    std::unordered_map<const ModuleFunction*, uint32_t> m_functionIndex;
+};
+
+ModuleSerializer::ModuleSerializer(Module* module)
+    : m_module(module)
+    , m_hasError(false)
+{
+    for (size_t i = 0; i < module->m_compositeTypes.size(); i++) {
+        m_compositeTypeIndex.insert(std::make_pair(module->m_compositeTypes[i], static_cast<uint32_t>(i)));
+        m_subTypeListIndex.insert(std::make_pair(module->m_compositeTypes[i]->subTypeList(), static_cast<uint32_t>(i)));
+    }
+
+    for (size_t i = 0; i < module->m_functions.size(); i++) {
+        m_functionIndex.insert(std::make_pair(module->m_functions[i], static_cast<uint32_t>(i)));
+    }
+}
+
+bool ModuleSerializer::serialize(Module* module, SerializedWriter& writer)
+{
+    ModuleSerializer serializer(module);
+    return serializer.writeModule(writer) && !serializer.m_hasError;
+}
+
+uint32_t ModuleSerializer::compositeTypeIndex(const CompositeType* type)
+{
+    if (type == nullptr) {
+        return kNoIndex;
+    }
+
+    auto it = m_compositeTypeIndex.find(type);
+    if (it == m_compositeTypeIndex.end()) {
+        m_hasError = true;
+        return kNoIndex;
+    }
+    return it->second;
+}
+
+uint32_t ModuleSerializer::subTypeListIndex(const CompositeType** subTypeList)
+{
+    auto it = m_subTypeListIndex.find(subTypeList);
+    if (it == m_subTypeListIndex.end()) {
+        m_hasError = true;
+        return kNoIndex;
+    }
+    return it->second;
+}
+
+uint32_t ModuleSerializer::functionIndex(const ModuleFunction* function)
+{
+    auto it = m_functionIndex.find(function);
+    if (it == m_functionIndex.end()) {
+        m_hasError = true;
+        return kNoIndex;
+    }
+    return it->second;
+}
+
+uint32_t ModuleSerializer::functionTypeIndex(const FunctionType* functionType)
+{
+    auto it = m_compositeTypeIndex.find(functionType);
+    if (it != m_compositeTypeIndex.end()) {
+        return it->second;
+    }
+
+    // Init expressions use the default function types of the store.
+    const FunctionType* defaultTypes = Store::getDefaultFunctionType(static_cast<Value::Type>(0));
+    if (functionType >= defaultTypes && functionType < defaultTypes + kDefaultFunctionTypeCount) {
+        return kDefaultFunctionTypeBit | static_cast<uint32_t>(functionType - defaultTypes);
+    }
+
+    m_hasError = true;
+    return kNoIndex;
+}
+
+void ModuleSerializer::writeType(SerializedWriter& writer, const Type& type)
+{
+    writer.write<uint32_t>(type.type());
+    writer.write<uint32_t>(compositeTypeIndex(type.isConcreteType() ? type.ref() : nullptr));
+}
+
+bool ModuleSerializer::writeModule(SerializedWriter& writer)
+{
+    Module* module = m_module;
+
+    writer.write<uint32_t>(module->m_compositeTypes.size());
+
+    writer.write<uint32_t>(module->m_globalTypes.size());
+    for (size_t i = 0; i < module->m_globalTypes.size(); i++) {
+        GlobalType* globalType = module->m_globalTypes[i];
+        writeType(writer, globalType->type());
+        writer.write<uint32_t>(globalType->isMutable());
+        writer.write<uint32_t>(globalType->function() != nullptr);
+        if (globalType->function() != nullptr && !writeFunction(writer, globalType->function())) {
+            return false;
+        }
+    }
+
+    writer.write<uint32_t>(module->m_tableTypes.size());
+    for (size_t i = 0; i < module->m_tableTypes.size(); i++) {
+        TableType* tableType = module->m_tableTypes[i];
+        writeType(writer, tableType->type());
+        writer.write<uint64_t>(tableType->initialSize());
+        writer.write<uint64_t>(tableType->maximumSize());
+        writer.write<uint32_t>(tableType->is64());
+        writer.write<uint32_t>(tableType->function() != nullptr);
+        if (tableType->function() != nullptr && !writeFunction(writer, tableType->function())) {
+            return false;
+        }
+    }
+
+    writer.write<uint32_t>(module->m_memoryTypes.size());
+    for (size_t i = 0; i < module->m_memoryTypes.size(); i++) {
+        MemoryType* memoryType = module->m_memoryTypes[i];
+        writer.write<uint64_t>(memoryType->initialSize());
+        writer.write<uint64_t>(memoryType->maximumSize());
+        writer.write<uint32_t>(memoryType->isShared());
+        writer.write<uint32_t>(memoryType->is64());
+    }
+
+    writer.write<uint32_t>(module->m_tagTypes.size());
+    for (size_t i = 0; i < module->m_tagTypes.size(); i++) {
+        writer.write<uint32_t>(functionTypeIndex(module->m_tagTypes[i]->functionType()));
+    }
+
+    writer.write<uint32_t>(module->m_functions.size());
+    for (size_t i = 0; i < module->m_functions.size(); i++) {
+        if (!writeFunction(writer, module->m_functions[i])) {
+            return false;
+        }
+    }
+
+    // Imported items are the first items of their index spaces.
+    uint32_t importCounts[ImportType::Tag + 1] = {};
+
+    writer.write<uint32_t>(module->m_imports.size());
+    for (size_t i = 0; i < module->m_imports.size(); i++) {
+        ImportType* import = module->m_imports[i];
+        uint32_t index = importCounts[import->importType()]++;
+        const ObjectType* expected = nullptr;
+
+        switch (import->importType()) {
+        case ImportType::Function:
+            expected = index < module->m_functions.size() ? module->m_functions[index]->functionType() : nullptr;
+            break;
+        case ImportType::Table:
+            expected = index < module->m_tableTypes.size() ? module->m_tableTypes[index] : nullptr;
+            break;
+        case ImportType::Memory:
+            expected = index < module->m_memoryTypes.size() ? module->m_memoryTypes[index] : nullptr;
+            break;
+        case ImportType::Global:
+            expected = index < module->m_globalTypes.size() ? module->m_globalTypes[index] : nullptr;
+            break;
+        case ImportType::Tag:
+            expected = index < module->m_tagTypes.size() ? module->m_tagTypes[index] : nullptr;
+            break;
+        }
+
+        if (expected != import->type()) {
+            return false;
+        }
+
+        writer.write<uint32_t>(import->importType());
+        writer.writeString(import->moduleName());
+        writer.writeString(import->fieldName());
+    }
+
+    writer.write<uint32_t>(module->m_exports.size());
+    for (size_t i = 0; i < module->m_exports.size(); i++) {
+        ExportType* exportType = module->m_exports[i];
+        writer.write<uint32_t>(exportType->exportType());
+        writer.write<uint32_t>(exportType->itemIndex());
+        writer.writeString(exportType->name());
+    }
+
+    writer.write<uint32_t>(module->m_datas.size());
+    for (size_t i = 0; i < module->m_datas.size(); i++) {
+        Data* data = module->m_datas[i];
+        writer.write<uint32_t>(data->memIndex());
+        writer.write<uint32_t>(functionIndex(data->moduleFunction()));
+        writer.writeArray(data->initData().data(), data->initData().size());
+    }
+
+    writer.write<uint32_t>(module->m_elements.size());
+    for (size_t i = 0; i < module->m_elements.size(); i++) {
+        Element* element = module->m_elements[i];
+        writer.write<uint32_t>(static_cast<uint32_t>(element->mode()));
+        writer.write<uint32_t>(element->tableIndex());
+        writer.write<uint32_t>(element->hasOffsetFunction() ? functionIndex(element->offsetFunction()) : kNoIndex);
+
+        const Vector<ModuleFunction*>& exprFunctions = element->exprFunctions();
+        writer.write<uint32_t>(exprFunctions.size());
+        for (size_t j = 0; j < exprFunctions.size(); j++) {
+            writer.write<uint32_t>(functionIndex(exprFunctions[j]));
+        }
+    }
+
+    writer.write<uint32_t>(module->m_version);
+    writer.write<uint32_t>(module->m_start);
+    writer.write<uint32_t>(module->m_seenStartAttribute);
+    writer.align();
+    return true;
+}
+
+bool ModuleSerializer::writeFunction(SerializedWriter& writer, ModuleFunction* function)
+{
+    uint32_t requiredStackSize = function->m_requiredStackSize;
+#if defined(WALRUS_ENABLE_JIT)
+    // The inline stack is reserved again when the module is compiled.
+    if (function->m_inlineStackSize > 0) {
+        requiredStackSize = function->m_inlineStackStart;
+    }
+#endif
+
+    writer.write<uint32_t>(functionTypeIndex(function->m_functionType));
+    writer.write<uint32_t>(function->m_hasTryCatch);
+    writer.write<uint32_t>(requiredStackSize);
+    writer.writeArray(function->m_local.data(), function->m_local.size() * sizeof(Value::Type));
+    writer.writeString(function->m_name);
+
+    if (!writeByteCode(writer, function)) {
+        return false;
+    }
+
+    writer.writeArray(function->m_catchInfo.data(), function->m_catchInfo.size() * sizeof(ModuleFunction::CatchInfo));
+    writer.writeArray(function->m_codeOffsets.data(), function->m_codeOffsets.size() * sizeof(std::pair<uint32_t, uint32_t>));
+#ifdef ENABLE_GC
+    writer.writeArray(function->m_referenceRanges.data(), function->m_referenceRanges.size() * sizeof(ModuleFunction::ReferenceRange));
+#endif
+#if !defined(NDEBUG)
+    writer.writeArray(function->m_localDebugData.data(), function->m_localDebugData.size() * sizeof(size_t));
+    writer.writeArray(function->m_constantDebugData.data(), function->m_constantDebugData.size() * sizeof(std::pair<Value, size_t>));
+#endif
+    return true;
+}
+
+template <typename T>
+static T* indexToPointer(uint32_t index)
+{
+    return reinterpret_cast<T*>(static_cast<uintptr_t>(index));
+}
+
+template <typename T>
+static uint32_t pointerToIndex(T* pointer)
+{
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(pointer));
+}
+
+bool ModuleSerializer::writeByteCode(SerializedWriter& writer, ModuleFunction* function)
+{
+    size_t size = function->m_byteCode.size();
+    size_t offset = writer.reserveArray(size);
+    const uint8_t* source = function->m_byteCode.data();
+    size_t position = 0;
+
+    if (size > 0) {
+        memcpy(writer.at(offset), source, size);
+    }
+
+    // The serialized byte code contains opcode numbers instead of
+    // handler addresses, and type indices instead of type pointers.
+    while (position < size) {
+        const ByteCode* code = reinterpret_cast<const ByteCode*>(source + position);
+        ByteCode::Opcode opcode = code->opcode();
+        uint8_t* target = writer.at(offset) + position;
+
+        switch (opcode) {
+        case ByteCode::CallIndirectOpcode: {
+            const CallIndirect* callIndirect = reinterpret_cast<const CallIndirect*>(code);
+            new (target) CallIndirect(callIndirect->calleeOffset(), callIndirect->tableIndex(),
+                                      indexToPointer<FunctionType>(functionTypeIndex(callIndirect->functionType())),
+                                      callIndirect->parameterOffsetsSize(), callIndirect->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::CallRefOpcode: {
+            const CallRef* callRef = reinterpret_cast<const CallRef*>(code);
+            new (target) CallRef(callRef->calleeOffset(), indexToPointer<FunctionType>(functionTypeIndex(callRef->functionType())),
+                                 callRef->parameterOffsetsSize(), callRef->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::ReturnCallIndirectOpcode: {
+            const ReturnCallIndirect* returnCallIndirect = reinterpret_cast<const ReturnCallIndirect*>(code);
+            new (target) ReturnCallIndirect(returnCallIndirect->calleeOffset(), returnCallIndirect->tableIndex(),
+                                            indexToPointer<FunctionType>(functionTypeIndex(returnCallIndirect->functionType())),
+                                            returnCallIndirect->parameterOffsetsSize(), returnCallIndirect->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::ReturnCallRefOpcode: {
+            const ReturnCallRef* returnCallRef = reinterpret_cast<const ReturnCallRef*>(code);
+            new (target) ReturnCallRef(returnCallRef->calleeOffset(), indexToPointer<FunctionType>(functionTypeIndex(returnCallRef->functionType())),
+                                       returnCallRef->parameterOffsetsSize(), returnCallRef->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::JumpIfCastDefinedOpcode: {
+            const JumpIfCastDefined* jumpIfCast = reinterpret_cast<const JumpIfCastDefined*>(code);
+            JumpIfCastDefined* newCode = new (target) JumpIfCastDefined(jumpIfCast->srcOffset(), jumpIfCast->offset());
+            newCode->init(indexToPointer<const CompositeType*>(subTypeListIndex(jumpIfCast->typeInfo())), jumpIfCast->srcInfo());
+            break;
+        }
+        case ByteCode::RefCastDefinedOpcode: {
+            const RefCastDefined* refCast = reinterpret_cast<const RefCastDefined*>(code);
+            new (target) RefCastDefined(refCast->srcOffset(), indexToPointer<const CompositeType*>(subTypeListIndex(refCast->typeInfo())), refCast->srcInfo());
+            break;
+        }
+        case ByteCode::RefTestDefinedOpcode: {
+            const RefTestDefined* refTest = reinterpret_cast<const RefTestDefined*>(code);
+            new (target) RefTestDefined(refTest->srcOffset(), refTest->dstOffset(),
+                                        indexToPointer<const CompositeType*>(subTypeListIndex(refTest->typeInfo())), refTest->srcInfo());
+            break;
+        }
+        case ByteCode::ArrayNewOpcode: {
+            const ArrayNew* arrayNew = reinterpret_cast<const ArrayNew*>(code);
+            new (target) ArrayNew(indexToPointer<const ArrayType>(compositeTypeIndex(arrayNew->typeInfo())),
+                                  arrayNew->src0Offset(), arrayNew->src1Offset(), arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::ArrayNewDefaultOpcode: {
+            const ArrayNewDefault* arrayNew = reinterpret_cast<const ArrayNewDefault*>(code);
+            new (target) ArrayNewDefault(indexToPointer<const ArrayType>(compositeTypeIndex(arrayNew->typeInfo())),
+                                         arrayNew->srcOffset(), arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::ArrayNewFixedOpcode: {
+            const ArrayNewFixed* arrayNew = reinterpret_cast<const ArrayNewFixed*>(code);
+            ArrayNewFixed* newCode = new (target) ArrayNewFixed(indexToPointer<const ArrayType>(compositeTypeIndex(arrayNew->typeInfo())), arrayNew->length());
+            newCode->setDstOffset(arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::ArrayNewDataOpcode:
+        case ByteCode::ArrayNewElemOpcode: {
+            ArrayNewFrom* arrayNew = reinterpret_cast<ArrayNewFrom*>(const_cast<ByteCode*>(code));
+            new (target) ArrayNewFrom(opcode, indexToPointer<const ArrayType>(compositeTypeIndex(arrayNew->typeInfo())), arrayNew->index(),
+                                      arrayNew->src0Offset(), arrayNew->src1Offset(), arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::StructNewOpcode: {
+            const StructNew* structNew = reinterpret_cast<const StructNew*>(code);
+            StructNew* newCode = new (target) StructNew(indexToPointer<const StructType>(compositeTypeIndex(structNew->typeInfo())));
+            newCode->setDstOffset(structNew->dstOffset());
+            break;
+        }
+        case ByteCode::StructNewDefaultOpcode: {
+            const StructNewDefault* structNew = reinterpret_cast<const StructNewDefault*>(code);
+            new (target) StructNewDefault(indexToPointer<const StructType>(compositeTypeIndex(structNew->typeInfo())), structNew->dstOffset());
+            break;
+        }
+        default:
+            break;
+        }
+
+        ByteCode* newCode = reinterpret_cast<ByteCode*>(target);
+#if defined(WALRUS_ENABLE_COMPUTED_GOTO)
+        newCode->m_opcodeInAddress = nullptr;
+#endif
+        newCode->m_opcode = opcode;
+
+        // The size must be computed from the original byte code.
+        position += code->getSize();
+    }
+
+    return position == size;
+}
+
+std::string ModuleSerializer::deserialize(SerializedReader& reader, WASMParsingResult& result)
+{
+    const std::string invalidData("invalid serialized module");
+
+    if (reader.read<uint32_t>() != result.m_compositeTypes.size()) {
+        return invalidData;
+    }
+
+    uint32_t count = reader.readCount(sizeof(uint32_t) * 4);
+    result.m_globalTypes.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        Type type;
+        if (!readType(reader, result, type)) {
+            return invalidData;
+        }
+
+        bool isMutable = reader.read<uint32_t>() != 0;
+        GlobalType* globalType = new GlobalType(MutableType(type.type(), type.isConcreteType() ? type.ref() : nullptr, isMutable));
+        result.m_globalTypes.push_back(globalType);
+
+        if (reader.read<uint32_t>() != 0) {
+            ModuleFunction* function = readFunction(reader, result);
+            if (function == nullptr) {
+                return invalidData;
+            }
+            globalType->setFunction(function);
+        }
+    }
+
+    count = reader.readCount(sizeof(uint32_t) * 4 + sizeof(uint64_t) * 2);
+    result.m_tableTypes.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        Type type;
+        if (!readType(reader, result, type)) {
+            return invalidData;
+        }
+
+        uint64_t initialSize = reader.read<uint64_t>();
+        uint64_t maximumSize = reader.read<uint64_t>();
+        bool is64 = reader.read<uint32_t>() != 0;
+        TableType* tableType = new TableType(type, initialSize, maximumSize, is64);
+        result.m_tableTypes.push_back(tableType);
+
+        if (reader.read<uint32_t>() != 0) {
+            ModuleFunction* function = readFunction(reader, result);
+            if (function == nullptr) {
+                return invalidData;
+            }
+            tableType->setFunction(function);
+        }
+    }
+
+    count = reader.readCount(sizeof(uint32_t) * 2 + sizeof(uint64_t) * 2);
+    result.m_memoryTypes.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t initialSize = reader.read<uint64_t>();
+        uint64_t maximumSize = reader.read<uint64_t>();
+        bool isShared = reader.read<uint32_t>() != 0;
+        bool is64 = reader.read<uint32_t>() != 0;
+        result.m_memoryTypes.push_back(new MemoryType(initialSize, maximumSize, isShared, is64));
+    }
+
+    count = reader.readCount(sizeof(uint32_t));
+    result.m_tagTypes.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        FunctionType* functionType = readFunctionType(reader, result);
+        if (functionType == nullptr) {
+            return invalidData;
+        }
+        result.m_tagTypes.push_back(new TagType(functionType));
+    }
+
+    count = reader.readCount(sizeof(uint32_t) * 3);
+    result.m_functions.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        ModuleFunction* function = readFunction(reader, result);
+        if (function == nullptr) {
+            return invalidData;
+        }
+        result.m_functions.push_back(function);
+    }
+
+    uint32_t importCounts[ImportType::Tag + 1] = {};
+
+    count = reader.readCount(sizeof(uint32_t));
+    result.m_imports.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t importType = reader.read<uint32_t>();
+        std::string moduleName = reader.readString();
+        std::string fieldName = reader.readString();
+
+        if (reader.hasError() || importType > ImportType::Tag) {
+            return invalidData;
+        }
+
+        uint32_t index = importCounts[importType]++;
+        const ObjectType* type = nullptr;
+
+        switch (importType) {
+        case ImportType::Function:
+            type = index < result.m_functions.size() ? result.m_functions[index]->functionType() : nullptr;
+            break;
+        case ImportType::Table:
+            type = index < result.m_tableTypes.size() ? result.m_tableTypes[index] : nullptr;
+            break;
+        case ImportType::Memory:
+            type = index < result.m_memoryTypes.size() ? result.m_memoryTypes[index] : nullptr;
+            break;
+        case ImportType::Global:
+            type = index < result.m_globalTypes.size() ? result.m_globalTypes[index] : nullptr;
+            break;
+        case ImportType::Tag:
+            type = index < result.m_tagTypes.size() ? result.m_tagTypes[index] : nullptr;
+            break;
+        }
+
+        if (type == nullptr) {
+            return invalidData;
+        }
+
+        result.m_imports.push_back(new ImportType(static_cast<ImportType::Type>(importType), moduleName, fieldName, type));
+    }
+
+    count = reader.readCount(sizeof(uint32_t) * 2);
+    result.m_exports.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t exportType = reader.read<uint32_t>();
+        uint32_t itemIndex = reader.read<uint32_t>();
+        std::string name = reader.readString();
+
+        if (reader.hasError() || exportType > ExportType::Tag) {
+            return invalidData;
+        }
+
+        result.m_exports.push_back(new ExportType(static_cast<ExportType::Type>(exportType), name, itemIndex));
+    }
+
+    count = reader.readCount(sizeof(uint32_t) * 2);
+    result.m_datas.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t memIndex = reader.read<uint32_t>();
+        uint32_t functionIndex = reader.read<uint32_t>();
+        Vector<uint8_t, std::allocator<uint8_t>> initData;
+        reader.readVector<uint8_t>(initData);
+
+        if (reader.hasError() || functionIndex >= result.m_functions.size()) {
+            return invalidData;
+        }
+
+        result.m_datas.push_back(new Data(memIndex, result.m_functions[functionIndex], std::move(initData)));
+    }
+
+    count = reader.readCount(sizeof(uint32_t) * 4);
+    result.m_elements.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t mode = reader.read<uint32_t>();
+        uint32_t tableIndex = reader.read<uint32_t>();
+        uint32_t offsetFunctionIndex = reader.read<uint32_t>();
+        uint32_t exprCount = reader.readCount(sizeof(uint32_t));
+        Vector<ModuleFunction*> exprFunctions;
+
+        if (mode > static_cast<uint32_t>(SegmentMode::Declared)) {
+            return invalidData;
+        }
+
+        exprFunctions.reserve(exprCount);
+        for (uint32_t j = 0; j < exprCount; j++) {
+            uint32_t functionIndex = reader.read<uint32_t>();
+            if (functionIndex >= result.m_functions.size()) {
+                return invalidData;
+            }
+            exprFunctions.push_back(result.m_functions[functionIndex]);
+        }
+
+        if (offsetFunctionIndex == kNoIndex) {
+            result.m_elements.push_back(new Element(static_cast<SegmentMode>(mode), tableIndex, std::move(exprFunctions)));
+        } else {
+            if (offsetFunctionIndex >= result.m_functions.size()) {
+                return invalidData;
+            }
+            result.m_elements.push_back(new Element(static_cast<SegmentMode>(mode), tableIndex, result.m_functions[offsetFunctionIndex], std::move(exprFunctions)));
+        }
+    }
+
+    result.m_version = reader.read<uint32_t>();
+    result.m_start = reader.read<uint32_t>();
+    result.m_seenStartAttribute = reader.read<uint32_t>() != 0;
+
+    if (reader.hasError()) {
+        return invalidData;
+    }
+
+    return std::string();
+}
+
+FunctionType* ModuleSerializer::readFunctionType(SerializedReader& reader, WASMParsingResult& result)
+{
+    uint32_t index = reader.read<uint32_t>();
+
+    if (index & kDefaultFunctionTypeBit) {
+        index &= ~kDefaultFunctionTypeBit;
+        if (index >= kDefaultFunctionTypeCount) {
+            return nullptr;
+        }
+        return Store::getDefaultFunctionType(static_cast<Value::Type>(index));
+    }
+
+    if (index >= result.m_compositeTypes.size() || result.m_compositeTypes[index]->kind() != ObjectType::FunctionKind) {
+        return nullptr;
+    }
+    return result.m_compositeTypes[index]->asFunction();
+}
+
+bool ModuleSerializer::readType(SerializedReader& reader, WASMParsingResult& result, Type& type)
+{
+    uint32_t kind = reader.read<uint32_t>();
+    uint32_t index = reader.read<uint32_t>();
+
+    if (reader.hasError() || kind >= kDefaultFunctionTypeCount) {
+        return false;
+    }
+
+    Value::Type valueType = static_cast<Value::Type>(kind);
+
+    if (valueType == Value::DefinedRef || valueType == Value::NullDefinedRef) {
+        if (index >= result.m_compositeTypes.size()) {
+            return false;
+        }
+        type = Type(valueType, result.m_compositeTypes[index]);
+        return true;
+    }
+
+    if (index != kNoIndex) {
+        return false;
+    }
+    type = Type(valueType);
+    return true;
+}
+
+ModuleFunction* ModuleSerializer::readFunction(SerializedReader& reader, WASMParsingResult& result)
+{
+    FunctionType* functionType = readFunctionType(reader, result);
+
+    if (functionType == nullptr) {
+        return nullptr;
+    }
+
+    ModuleFunction* function = new ModuleFunction(functionType);
+    function->m_hasTryCatch = reader.read<uint32_t>() != 0;
+    function->m_requiredStackSize = reader.read<uint32_t>();
+    reader.readVector<Value::Type>(function->m_local);
+    function->m_name = reader.readString();
+
+    bool success = readByteCode(reader, result, function);
+
+    reader.readVector<ModuleFunction::CatchInfo>(function->m_catchInfo);
+    reader.readVector<std::pair<uint32_t, uint32_t>>(function->m_codeOffsets);
+#ifdef ENABLE_GC
+    reader.readVector<ModuleFunction::ReferenceRange>(function->m_referenceRanges);
+#endif
+#if !defined(NDEBUG)
+    reader.readVector<size_t>(function->m_localDebugData);
+    reader.readVector<std::pair<Value, size_t>>(function->m_constantDebugData);
+#endif
+
+    if (!success || reader.hasError()) {
+        delete function;
+        return nullptr;
+    }
+
+    size_t byteCodeSize = function->m_byteCode.size();
+    for (size_t i = 0; i < function->m_catchInfo.size(); i++) {
+        const ModuleFunction::CatchInfo& info = function->m_catchInfo[i];
+        if (info.m_tryStart > byteCodeSize || info.m_tryEnd > byteCodeSize || info.m_catchStartPosition > byteCodeSize) {
+            delete function;
+            return nullptr;
+        }
+    }
+
+    return function;
+}
+
+void ModuleSerializer::setOpcode(ByteCode* code, ByteCode::Opcode opcode)
+{
+#if defined(WALRUS_ENABLE_COMPUTED_GOTO)
+    code->m_opcodeInAddress = g_byteCodeTable.m_addressTable[opcode];
+#else
+    code->m_opcode = opcode;
+#endif
+}
+
+bool ModuleSerializer::readByteCode(SerializedReader& reader, WASMParsingResult& result, ModuleFunction* function)
+{
+    size_t size;
+    const uint8_t* data = reader.readArray(size);
+
+    if (reader.hasError()) {
+        return false;
+    }
+
+    // Byte code is copied since the opcodes and the type references
+    // are replaced by the values used by this process.
+    function->m_byteCode.reserve(size);
+    uint8_t* byteCode = function->m_byteCode.data();
+    size_t position = 0;
+
+    if (size > 0) {
+        memcpy(byteCode, data, size);
+    }
+
+    Vector<CompositeType*>& types = result.m_compositeTypes;
+
+    while (position < size) {
+        if (size - position < sizeof(ByteCode)) {
+            return false;
+        }
+
+        ByteCode* code = reinterpret_cast<ByteCode*>(byteCode + position);
+        uint32_t opcodeValue = code->m_opcode;
+
+        if (opcodeValue >= ByteCode::OpcodeKindEnd || size - position < g_serializedByteCodeSize[opcodeValue]) {
+            return false;
+        }
+
+        ByteCode::Opcode opcode = static_cast<ByteCode::Opcode>(opcodeValue);
+        uint32_t index;
+
+        // The constructors also set the opcode of the byte code.
+        switch (opcode) {
+        case ByteCode::CallIndirectOpcode: {
+            CallIndirect* callIndirect = reinterpret_cast<CallIndirect*>(code);
+            index = pointerToIndex(callIndirect->functionType());
+            if (index >= types.size() || types[index]->kind() != ObjectType::FunctionKind) {
+                return false;
+            }
+            new (code) CallIndirect(callIndirect->calleeOffset(), callIndirect->tableIndex(), types[index]->asFunction(),
+                                    callIndirect->parameterOffsetsSize(), callIndirect->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::CallRefOpcode: {
+            CallRef* callRef = reinterpret_cast<CallRef*>(code);
+            index = pointerToIndex(callRef->functionType());
+            if (index >= types.size() || types[index]->kind() != ObjectType::FunctionKind) {
+                return false;
+            }
+            new (code) CallRef(callRef->calleeOffset(), types[index]->asFunction(),
+                               callRef->parameterOffsetsSize(), callRef->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::ReturnCallIndirectOpcode: {
+            ReturnCallIndirect* returnCallIndirect = reinterpret_cast<ReturnCallIndirect*>(code);
+            index = pointerToIndex(returnCallIndirect->functionType());
+            if (index >= types.size() || types[index]->kind() != ObjectType::FunctionKind) {
+                return false;
+            }
+            new (code) ReturnCallIndirect(returnCallIndirect->calleeOffset(), returnCallIndirect->tableIndex(), types[index]->asFunction(),
+                                          returnCallIndirect->parameterOffsetsSize(), returnCallIndirect->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::ReturnCallRefOpcode: {
+            ReturnCallRef* returnCallRef = reinterpret_cast<ReturnCallRef*>(code);
+            index = pointerToIndex(returnCallRef->functionType());
+            if (index >= types.size() || types[index]->kind() != ObjectType::FunctionKind) {
+                return false;
+            }
+            new (code) ReturnCallRef(returnCallRef->calleeOffset(), types[index]->asFunction(),
+                                     returnCallRef->parameterOffsetsSize(), returnCallRef->resultOffsetsSize());
+            break;
+        }
+        case ByteCode::JumpIfCastDefinedOpcode: {
+            JumpIfCastDefined* jumpIfCast = reinterpret_cast<JumpIfCastDefined*>(code);
+            index = pointerToIndex(jumpIfCast->typeInfo());
+            if (index >= types.size()) {
+                return false;
+            }
+            ByteCodeStackOffset srcOffset = jumpIfCast->srcOffset();
+            int32_t offset = jumpIfCast->offset();
+            uint8_t srcInfo = jumpIfCast->srcInfo();
+            JumpIfCastDefined* newCode = new (code) JumpIfCastDefined(srcOffset, offset);
+            newCode->init(types[index]->subTypeList(), srcInfo);
+            break;
+        }
+        case ByteCode::RefCastDefinedOpcode: {
+            RefCastDefined* refCast = reinterpret_cast<RefCastDefined*>(code);
+            index = pointerToIndex(refCast->typeInfo());
+            if (index >= types.size()) {
+                return false;
+            }
+            new (code) RefCastDefined(refCast->srcOffset(), types[index]->subTypeList(), refCast->srcInfo());
+            break;
+        }
+        case ByteCode::RefTestDefinedOpcode: {
+            RefTestDefined* refTest = reinterpret_cast<RefTestDefined*>(code);
+            index = pointerToIndex(refTest->typeInfo());
+            if (index >= types.size()) {
+                return false;
+            }
+            new (code) RefTestDefined(refTest->srcOffset(), refTest->dstOffset(), types[index]->subTypeList(), refTest->srcInfo());
+            break;
+        }
+        case ByteCode::ArrayNewOpcode: {
+            ArrayNew* arrayNew = reinterpret_cast<ArrayNew*>(code);
+            index = pointerToIndex(arrayNew->typeInfo());
+            if (index >= types.size() || types[index]->kind() != ObjectType::ArrayKind) {
+                return false;
+            }
+            TypeStore::PinType(types[index]);
+            new (code) ArrayNew(types[index]->asArray(), arrayNew->src0Offset(), arrayNew->src1Offset(), arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::ArrayNewDefaultOpcode: {
+            ArrayNewDefault* arrayNew = reinterpret_cast<ArrayNewDefault*>(code);
+            index = pointerToIndex(arrayNew->typeInfo());
+            if (index >= types.size() || types[index]->kind() != ObjectType::ArrayKind) {
+                return false;
+            }
+            TypeStore::PinType(types[index]);
+            new (code) ArrayNewDefault(types[index]->asArray(), arrayNew->srcOffset(), arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::ArrayNewFixedOpcode: {
+            ArrayNewFixed* arrayNew = reinterpret_cast<ArrayNewFixed*>(code);
+            index = pointerToIndex(arrayNew->typeInfo());
+            if (index >= types.size() || types[index]->kind() != ObjectType::ArrayKind) {
+                return false;
+            }
+            TypeStore::PinType(types[index]);
+            ByteCodeStackOffset dstOffset = arrayNew->dstOffset();
+            ArrayNewFixed* newCode = new (code) ArrayNewFixed(types[index]->asArray(), arrayNew->length());
+            newCode->setDstOffset(dstOffset);
+            break;
+        }
+        case ByteCode::ArrayNewDataOpcode:
+        case ByteCode::ArrayNewElemOpcode: {
+            ArrayNewFrom* arrayNew = reinterpret_cast<ArrayNewFrom*>(code);
+            index = pointerToIndex(arrayNew->typeInfo());
+            if (index >= types.size() || types[index]->kind() != ObjectType::ArrayKind) {
+                return false;
+            }
+            TypeStore::PinType(types[index]);
+            new (code) ArrayNewFrom(opcode, types[index]->asArray(), arrayNew->index(),
+                                    arrayNew->src0Offset(), arrayNew->src1Offset(), arrayNew->dstOffset());
+            break;
+        }
+        case ByteCode::StructNewOpcode: {
+            StructNew* structNew = reinterpret_cast<StructNew*>(code);
+            index = pointerToIndex(structNew->typeInfo());
+            if (index >= types.size() || types[index]->kind() != ObjectType::StructKind) {
+                return false;
+            }
+            TypeStore::PinType(types[index]);
+            ByteCodeStackOffset dstOffset = structNew->dstOffset();
+            StructNew* newCode = new (code) StructNew(types[index]->asStruct());
+            newCode->setDstOffset(dstOffset);
+            break;
+        }
+        case ByteCode::StructNewDefaultOpcode: {
+            StructNewDefault* structNew = reinterpret_cast<StructNewDefault*>(code);
+            index = pointerToIndex(structNew->typeInfo());
+            if (index >= types.size() || types[index]->kind() != ObjectType::StructKind) {
+                return false;
+            }
+            TypeStore::PinType(types[index]);
+            new (code) StructNewDefault(types[index]->asStruct(), structNew->dstOffset());
+            break;
+        }
+        default:
+            setOpcode(code, opcode);
+            break;
+        }
+
+        size_t codeSize = code->getSize();
+
+        if (codeSize == 0 || codeSize > size - position) {
+            return false;
+        }
+        position += codeSize;
+    }
+
+    return true;
+}
+
+bool WASMParser::serialize(Module* module, const uint8_t* binary, size_t binarySize, std::vector<uint8_t>& out)
+{
+    SerializedModuleHeader header;
+
+    memset(&header, 0, sizeof(SerializedModuleHeader));
+    header.magic = SerializedModuleHeader::kMagic;
+    header.formatVersion = SerializedModuleHeader::kFormatVersion;
+    getBuildId(header.buildId);
+    header.configurationHash = getConfigurationHash();
+    header.byteCodeFlags = module->byteCodeFlags();
+    header.binarySize = binarySize;
+
+    if (binarySize < 8 || !findTypeSection(binary, binarySize, header.typeSectionOffset, header.typeSectionSize)) {
+        return false;
+    }
+
+    size_t dataStart = sizeof(SerializedModuleHeader) + alignedSize(binarySize);
+
+    out.clear();
+    out.resize(dataStart);
+    memcpy(out.data() + sizeof(SerializedModuleHeader), binary, binarySize);
+
+    SerializedWriter writer(out);
+    if (!ModuleSerializer::serialize(module, writer)) {
+        out.clear();
+        return false;
+    }
+
+    header.dataSize = out.size() - dataStart;
+    header.dataChecksum = hashBinary(out.data() + dataStart, header.dataSize);
+    memcpy(out.data(), &header, sizeof(SerializedModuleHeader));
+    return true;
+}
+
+static bool readHeader(const uint8_t* data, size_t len, SerializedModuleHeader& header)
+{
+    if (len < sizeof(SerializedModuleHeader)) {
+        return false;
+    }
+
+    memcpy(&header, data, sizeof(SerializedModuleHeader));
+
+    if (header.magic != SerializedModuleHeader::kMagic || header.formatVersion != SerializedModuleHeader::kFormatVersion) {
+        return false;
+    }
+
+    size_t maxSize = len - sizeof(SerializedModuleHeader);
+    if (header.binarySize > maxSize || alignedSize(header.binarySize) + header.dataSize != maxSize) {
+        return false;
+    }
+
+    return true;
+}
+
+bool WASMParser::serializedBinary(const uint8_t* data, size_t len, const uint8_t** binary, size_t* binarySize)
+{
+    SerializedModuleHeader header;
+
+    if (!readHeader(data, len, header)) {
+        return false;
+    }
+
+    *binary = data + sizeof(SerializedModuleHeader);
+    *binarySize = header.binarySize;
+    return true;
+}
+
+std::pair<Optional<Module*>, std::string> WASMParser::parseSerialized(Store* store, const std::string& filename, const uint8_t* data, size_t len,
+                                                                      const uint8_t* expectedBinary, size_t expectedBinarySize,
+                                                                      const uint32_t JITFlags, const uint32_t featureFlags)
+{
+    SerializedModuleHeader header;
+
+    if (!readHeader(data, len, header)) {
+        return std::make_pair(nullptr, std::string("invalid serialized module"));
+    }
+
+    char buildId[sizeof(SerializedModuleHeader::buildId)];
+    getBuildId(buildId);
+
+    if (memcmp(header.buildId, buildId, sizeof(buildId)) != 0 || header.configurationHash != getConfigurationHash()) {
+        return std::make_pair(nullptr, std::string("serialized module was created by a different engine build"));
+    }
+
+    uint32_t flags = byteCodeFlags(store, JITFlags, featureFlags);
+    if (header.byteCodeFlags != flags) {
+        return std::make_pair(nullptr, std::string("serialized module was created with different options"));
+    }
+
+    const uint8_t* binary = data + sizeof(SerializedModuleHeader);
+
+    if (expectedBinary != nullptr
+        && (header.binarySize != expectedBinarySize || memcmp(binary, expectedBinary, expectedBinarySize) != 0)) {
+        return std::make_pair(nullptr, std::string("serialized module was created from a different binary"));
+    }
+
+    const uint8_t* moduleData = binary + alignedSize(header.binarySize);
+
+    if (header.dataChecksum != hashBinary(moduleData, header.dataSize)
+        || header.binarySize < 8 || header.typeSectionOffset > header.binarySize
+        || header.typeSectionSize > header.binarySize - header.typeSectionOffset) {
+        return std::make_pair(nullptr, std::string("corrupted serialized module"));
+    }
+
+    WASMParsingResult result;
+
+    if (header.typeSectionSize > 0) {
+        // A module which only contains the type section.
+        std::vector<uint8_t> typeModule(binary, binary + 8);
+        typeModule.insert(typeModule.end(), binary + header.typeSectionOffset, binary + header.typeSectionOffset + header.typeSectionSize);
+
+        std::string error = parseTypeSection(store, filename, typeModule.data(), typeModule.size(), featureFlags, result);
+        if (error.length()) {
+            return std::make_pair(nullptr, error);
+        }
+    }
+
+    SerializedReader reader(moduleData, header.dataSize);
+    std::string error = ModuleSerializer::deserialize(reader, result);
+
+    if (error.length()) {
+        if (result.m_typesAddedToStore) {
+            store->getTypeStore().releaseTypes(result.m_compositeTypes);
+        }
+        result.clear();
+        return std::make_pair(nullptr, error);
+    }
+
+    result.m_byteCodeFlags = flags;
+    Module* module = new Module(store, result);
+    finishParsing(module, JITFlags);
+
+    return std::make_pair(module, std::string());
+}
+
+} // namespace Walrus
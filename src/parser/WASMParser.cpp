@@ -338,6 +338,7 @@ private:
             enum JumpToEndType {
                 IsJump,
                 IsJumpIf,
+                IsJumpIfI32Compare,
                 IsBrTable,
             };
 
@@ -627,7 +628,7 @@ private:
     Walrus::FunctionType* m_currentFunctionType;
     Walrus::Vector<uint8_t, std::allocator<uint8_t>> m_currentByteCode;
     uint32_t m_initialFunctionStackSize;
-    uint16_t m_functionStackSizeSoFar;
+    uint32_t m_functionStackSizeSoFar;
     Index m_recursiveTypeStart;
     Index m_recursiveTypeEnd;
 
@@ -652,6 +653,39 @@ private:
     };
     std::vector<LocalInfo> m_localInfo;
 
+    // Locals which do not fit into the range of ByteCodeStackOffset are
+    // moved after it, and only accessed by the MoveWide byte codes.
+    static constexpr size_t s_farLocalStart = static_cast<size_t>(std::numeric_limits<Walrus::ByteCodeStackOffset>::max()) + 1;
+    // The rest of the 16 bit range is left for the operand stack.
+    static constexpr size_t s_maxNearLocalSize = s_farLocalStart - 16 * 1024;
+
+    static bool isFarPosition(size_t position)
+    {
+        return position >= s_farLocalStart;
+    }
+
+#ifdef ENABLE_GC
+    // Pointer sized words of the current frame which may hold a reference.
+    std::vector<bool> m_referenceSlots;
+#endif
+
+    void markReferenceSlot(Walrus::Value::Type type, size_t pos)
+    {
+#ifdef ENABLE_GC
+        if (!Walrus::Value::isRefType(type) || m_preprocessData.m_inPreprocess) {
+            return;
+        }
+
+        ASSERT(pos % sizeof(void*) == 0);
+        size_t index = pos / sizeof(void*);
+
+        if (index >= m_referenceSlots.size()) {
+            m_referenceSlots.resize(index + 1);
+        }
+        m_referenceSlots[index] = true;
+#endif
+    }
+
     Walrus::Vector<uint8_t, std::allocator<uint8_t>> m_memoryInitData;
     size_t m_dataSegmentMemIndex = -1;
 
@@ -668,7 +702,19 @@ private:
     // i32.eqz and JumpIf can be unified in some cases
     static const size_t s_noI32Eqz = SIZE_MAX - sizeof(Walrus::I32Eqz);
     size_t m_lastI32EqzPos;
+    // superinstruction candidates, only used by the interpreter
+    static const size_t s_noI32Const = SIZE_MAX - sizeof(Walrus::Const32);
+    size_t m_lastI32ConstPos;
+    static const size_t s_noI32Compare = SIZE_MAX - sizeof(Walrus::I32Eq);
+    size_t m_lastI32ComparePos;
+    static const size_t s_noI32AddImm = SIZE_MAX - sizeof(Walrus::I32AddImm);
+    size_t m_lastI32AddImmPos;
     bool m_useJIT;
+    bool m_recordCodeOffsets;
+    bool m_epochInterruption;
+    // Offsets of the function body and the current instruction in the binary.
+    size_t m_codeStartOffset;
+    size_t m_opcodeOffset;
 
     Walrus::FunctionType* getFunctionType(Index index)
     {
@@ -698,12 +744,18 @@ private:
             m_preprocessData.addLocalVariableUsage(localIndex);
         }
 
+        markReferenceSlot(type, pos);
+        markReferenceSlot(type, m_functionStackSizeSoFar);
         m_vmStack.push_back(VMStackInfo(*this, type, pos, m_functionStackSizeSoFar, localIndex));
         size_t allocSize = Walrus::valueStackAllocatedSize(type);
 
         m_functionStackSizeSoFar += allocSize;
         m_currentFunction->m_requiredStackSize = std::max(
             m_currentFunction->m_requiredStackSize, m_functionStackSizeSoFar);
+
+        if (UNLIKELY(m_functionStackSizeSoFar > s_farLocalStart) && !m_preprocessData.m_inPreprocess) {
+            m_walrusParseError = std::string("Function stack usage is larger then supported maxium (65536 bytes).");
+        }
     }
 
     VMStackInfo popVMStackInfo()
@@ -764,6 +816,9 @@ private:
         m_currentFunctionType = mf->functionType();
         m_localInfo.clear();
         m_localInfo.reserve(m_currentFunctionType->param().size());
+#ifdef ENABLE_GC
+        m_referenceSlots.clear();
+#endif
         size_t pos = 0;
         const Walrus::TypeVector::Types& param = m_currentFunctionType->param().types();
         for (size_t i = 0; i < param.size(); i++) {
@@ -784,6 +839,26 @@ private:
 
     void endFunction()
     {
+#ifdef ENABLE_GC
+        // The positions of the locals are final at this point.
+        for (const auto& info : m_localInfo) {
+            markReferenceSlot(info.m_valueType, info.m_position);
+        }
+
+        // Adjacent reference slots are merged into one range.
+        size_t slotCount = m_referenceSlots.size();
+        for (size_t i = 0; i < slotCount; i++) {
+            if (m_referenceSlots[i]) {
+                size_t start = i;
+                while (i < slotCount && m_referenceSlots[i]) {
+                    i++;
+                }
+                m_currentFunction->m_referenceRanges.push_back(std::make_pair(static_cast<uint32_t>(start * sizeof(void*)), static_cast<uint32_t>(i * sizeof(void*))));
+            }
+        }
+        m_referenceSlots.clear();
+#endif
+
         // Copy the final byte code.
         m_currentFunction->m_byteCode.reserve(m_currentByteCode.size());
         memcpy(m_currentFunction->m_byteCode.data(), m_currentByteCode.data(), m_currentByteCode.size());
@@ -810,12 +885,30 @@ private:
         m_currentByteCode.resizeWithUninitializedValues(newSize);
     }
 
+    void recordCodeOffset(size_t position)
+    {
+        auto& offsets = m_currentFunction->m_codeOffsets;
+
+        // Byte codes may be removed, and replaced by the following ones.
+        while (!offsets.empty() && offsets.back().first >= position) {
+            offsets.pop_back();
+        }
+
+        if (offsets.empty() || offsets.back().second != m_opcodeOffset) {
+            offsets.push_back(std::make_pair(static_cast<uint32_t>(position), static_cast<uint32_t>(m_opcodeOffset)));
+        }
+    }
+
     template <typename CodeType>
     void pushByteCode(const CodeType& code)
     {
         char* first = (char*)&code;
         size_t start = m_currentByteCode.size();
 
+        if (UNLIKELY(m_recordCodeOffsets) && !m_preprocessData.m_inPreprocess) {
+            recordCodeOffset(start);
+        }
+
         m_currentByteCode.resizeWithUninitializedValues(m_currentByteCode.size() + sizeof(CodeType));
         for (size_t i = 0; i < sizeof(CodeType); i++) {
             m_currentByteCode[start++] = *first;
@@ -848,6 +941,119 @@ private:
             && (peekByteCode<Walrus::UnaryOperation>(m_lastI32EqzPos)->dstOffset() == stackPos);
     }
 
+    // The last byte code is an i32 comparison, which result is only used by the
+    // following conditional jump. Values of local.get are excluded, since the
+    // comparison may write the local directly.
+    inline bool canFuseI32Compare(const VMStackInfo& info)
+    {
+        return (m_lastI32ComparePos + sizeof(Walrus::I32Eq) == m_currentByteCode.size())
+            && !info.hasValidLocalIndex()
+            && (peekByteCode<Walrus::BinaryOperation>(m_lastI32ComparePos)->dstOffset() == info.position());
+    }
+
+    inline bool canFuseI32AddImm(const VMStackInfo& info)
+    {
+        return (m_lastI32AddImmPos + sizeof(Walrus::I32AddImm) == m_currentByteCode.size())
+            && !info.hasValidLocalIndex()
+            && (peekByteCode<Walrus::BinaryImmOperation>(m_lastI32AddImmPos)->dstOffset() == info.position());
+    }
+
+    // Returns true if the value is an i32 constant. The Const32 byte code
+    // which sets the value is removed when it is the last byte code.
+    bool takeI32Constant(const VMStackInfo& info, uint32_t& value)
+    {
+        if ((m_lastI32ConstPos + sizeof(Walrus::Const32) == m_currentByteCode.size())
+            && !info.hasValidLocalIndex()
+            && (peekByteCode<Walrus::Const32>(m_lastI32ConstPos)->dstOffset() == info.position())) {
+            value = peekByteCode<Walrus::Const32>(m_lastI32ConstPos)->value();
+            resizeByteCode(m_lastI32ConstPos);
+            m_lastI32ConstPos = s_noI32Const;
+            return true;
+        }
+
+        if (!m_preprocessData.m_inPreprocess) {
+            for (const auto& constant : m_preprocessData.m_constantData) {
+                if (constant.second == info.position() && constant.first.type() == Walrus::Value::Type::I32) {
+                    value = static_cast<uint32_t>(constant.first.asI32());
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Removes the last i32 comparison, which is merged into a conditional jump.
+    Walrus::ByteCode::Opcode takeI32Compare(Walrus::ByteCodeStackOffset& src0, Walrus::ByteCodeStackOffset& src1)
+    {
+        auto compare = peekByteCode<Walrus::BinaryOperation>(m_lastI32ComparePos);
+        auto opcode = compare->opcode();
+
+        src0 = compare->srcOffset()[0];
+        src1 = compare->srcOffset()[1];
+        resizeByteCode(m_lastI32ComparePos);
+        m_lastI32ComparePos = s_noI32Compare;
+        return opcode;
+    }
+
+    void generateJumpIfI32CompareCode(Walrus::ByteCode::Opcode compare, bool isInverted, Walrus::ByteCodeStackOffset src0, Walrus::ByteCodeStackOffset src1, WASMOpcode opcode, int32_t offset = 0)
+    {
+        if (isInverted) {
+            switch (compare) {
+            case Walrus::ByteCode::I32EqOpcode:
+                compare = Walrus::ByteCode::I32NeOpcode;
+                break;
+            case Walrus::ByteCode::I32NeOpcode:
+                compare = Walrus::ByteCode::I32EqOpcode;
+                break;
+            case Walrus::ByteCode::I32LtSOpcode:
+                compare = Walrus::ByteCode::I32GeSOpcode;
+                break;
+            case Walrus::ByteCode::I32LtUOpcode:
+                compare = Walrus::ByteCode::I32GeUOpcode;
+                break;
+            case Walrus::ByteCode::I32LeSOpcode:
+                compare = Walrus::ByteCode::I32GtSOpcode;
+                break;
+            case Walrus::ByteCode::I32LeUOpcode:
+                compare = Walrus::ByteCode::I32GtUOpcode;
+                break;
+            case Walrus::ByteCode::I32GtSOpcode:
+                compare = Walrus::ByteCode::I32LeSOpcode;
+                break;
+            case Walrus::ByteCode::I32GtUOpcode:
+                compare = Walrus::ByteCode::I32LeUOpcode;
+                break;
+            case Walrus::ByteCode::I32GeSOpcode:
+                compare = Walrus::ByteCode::I32LtSOpcode;
+                break;
+            default:
+                ASSERT(compare == Walrus::ByteCode::I32GeUOpcode);
+                compare = Walrus::ByteCode::I32LtUOpcode;
+                break;
+            }
+        }
+
+        switch (compare) {
+#define GENERATE_JUMP_IF_COMPARE_CODE_CASE(name, compareName, ...) \
+    case Walrus::ByteCode::compareName##Opcode:                    \
+        pushByteCode(Walrus::name(src0, src1, offset), opcode);    \
+        break;
+            FOR_EACH_BYTECODE_JUMP_IF_COMPARE_OP(GENERATE_JUMP_IF_COMPARE_CODE_CASE)
+#undef GENERATE_JUMP_IF_COMPARE_CODE_CASE
+        default:
+            ASSERT_NOT_REACHED();
+            break;
+        }
+    }
+
+    void clearSuperInstructionCandidates()
+    {
+        m_lastI32EqzPos = s_noI32Eqz;
+        m_lastI32ConstPos = s_noI32Const;
+        m_lastI32ComparePos = s_noI32Compare;
+        m_lastI32AddImmPos = s_noI32AddImm;
+    }
+
     Walrus::Optional<uint8_t> lookaheadUnsigned8(size_t offset = 0)
     {
         if (*m_readerOffsetPointer + offset < m_codeEndOffset) {
@@ -881,7 +1087,7 @@ private:
     }
 
 public:
-    WASMBinaryReader(Walrus::TypeStore& typeStore, bool useJIT = false)
+    WASMBinaryReader(Walrus::TypeStore& typeStore, bool useJIT = false, bool recordCodeOffsets = false, bool epochInterruption = false)
         : m_readerOffsetPointer(nullptr)
         , m_readerDataPointer(nullptr)
         , m_codeEndOffset(0)
@@ -897,7 +1103,14 @@ public:
         , m_segmentMode(Walrus::SegmentMode::None)
         , m_preprocessData(*this)
         , m_lastI32EqzPos(s_noI32Eqz)
+        , m_lastI32ConstPos(s_noI32Const)
+        , m_lastI32ComparePos(s_noI32Compare)
+        , m_lastI32AddImmPos(s_noI32AddImm)
         , m_useJIT(useJIT)
+        , m_recordCodeOffsets(recordCodeOffsets)
+        , m_epochInterruption(epochInterruption)
+        , m_codeStartOffset(0)
+        , m_opcodeOffset(0)
     {
     }
 
@@ -1351,6 +1564,13 @@ public:
         m_result.m_start = funcIndex;
     }
 
+    virtual void OnFunctionName(Index funcIndex, std::string name) override
+    {
+        if (funcIndex < m_result.m_functions.size()) {
+            m_result.m_functions[funcIndex]->m_name = std::move(name);
+        }
+    }
+
     virtual void BeginFunctionBody(Index index, Offset size) override
     {
         ASSERT(resumeGenerateByteCodeAfterNBlockEnd() == 0);
@@ -1384,8 +1604,6 @@ public:
             m_localInfo.push_back(LocalInfo(wType, m_functionStackSizeSoFar));
             auto sz = Walrus::valueStackAllocatedSize(wType);
 
-            // FIXME too many stack usage. we could not support this(yet)
-
             m_initialFunctionStackSize += sz;
             m_functionStackSizeSoFar += sz;
             count--;
@@ -1394,10 +1612,33 @@ public:
             m_currentFunction->m_requiredStackSize, m_functionStackSizeSoFar);
     }
 
+    void assignFarLocals(size_t constantSize)
+    {
+        size_t nearPosition = m_currentFunctionType->paramStackSize();
+        size_t farPosition = s_farLocalStart;
+
+        for (size_t i = m_currentFunctionType->param().size(); i < m_localInfo.size(); i++) {
+            auto& info = m_localInfo[i];
+            size_t size = Walrus::valueStackAllocatedSize(info.m_valueType);
+
+            if (nearPosition + constantSize + size <= s_maxNearLocalSize) {
+                info.m_position = nearPosition;
+                nearPosition += size;
+            } else {
+                info.m_position = farPosition;
+                farPosition += size;
+            }
+        }
+
+        m_initialFunctionStackSize = nearPosition;
+        m_currentFunction->m_requiredStackSize = std::max(m_currentFunction->m_requiredStackSize, static_cast<uint32_t>(farPosition));
+    }
+
     // FIXME remove preprocess
     virtual void OnStartReadInstructions(Offset start, Offset end) override
     {
         ASSERT(start == *m_readerOffsetPointer);
+        m_codeStartOffset = m_opcodeOffset = start;
         m_codeEndOffset = end;
     }
 
@@ -1410,6 +1651,8 @@ public:
     virtual void OnEndPreprocess() override
     {
         m_preprocessData.m_inPreprocess = false;
+        // The initialization of the locals belongs to the function start.
+        m_opcodeOffset = m_codeStartOffset;
         m_skipValidationUntil = *m_readerOffsetPointer - 1;
         m_shouldContinueToGenerateByteCode = true;
         m_recursiveTypeStart = 0;
@@ -1425,6 +1668,15 @@ public:
 
         m_preprocessData.organizeData();
 
+        size_t constantSize = 0;
+        for (size_t i = 0; i < m_preprocessData.m_constantData.size(); i++) {
+            constantSize += Walrus::valueStackAllocatedSize(m_preprocessData.m_constantData[i].first.type());
+        }
+
+        if (UNLIKELY(m_initialFunctionStackSize + constantSize > s_maxNearLocalSize)) {
+            assignFarLocals(constantSize);
+        }
+
         // set const variables position
         for (size_t i = 0; i < m_preprocessData.m_constantData.size(); i++) {
             auto constType = m_preprocessData.m_constantData[i].first.type();
@@ -1443,6 +1695,9 @@ public:
             // put already aligned variables first
             for (size_t i = m_currentFunctionType->param().size(); i < m_localInfo.size(); i++) {
                 auto& info = m_localInfo[i];
+                if (isFarPosition(info.m_position)) {
+                    continue;
+                }
                 if (Walrus::hasCPUWordAlignedSize(info.m_valueType) || needsCPUWordAlignedAddress(info.m_valueType)) {
                     info.m_position = m_initialFunctionStackSize;
                     m_initialFunctionStackSize += Walrus::valueStackAllocatedSize(info.m_valueType);
@@ -1459,6 +1714,9 @@ public:
             // pack rest values
             for (size_t i = m_currentFunctionType->param().size(); i < m_localInfo.size(); i++) {
                 auto& info = m_localInfo[i];
+                if (isFarPosition(info.m_position)) {
+                    continue;
+                }
                 if (!Walrus::hasCPUWordAlignedSize(info.m_valueType) && !needsCPUWordAlignedAddress(info.m_valueType)) {
                     info.m_position = m_initialFunctionStackSize;
                     m_initialFunctionStackSize += Walrus::valueSize(info.m_valueType);
@@ -1486,6 +1744,10 @@ public:
             if (m_preprocessData.m_localVariableInfo[i].m_needsExplicitInitOnStartup) {
                 auto localPos = m_localInfo[i].m_position;
                 auto size = Walrus::valueSize(m_localInfo[i].m_valueType);
+                if (isFarPosition(localPos)) {
+                    // Initialized through the first free slot of the operand stack.
+                    localPos = m_functionStackSizeSoFar;
+                }
                 if (size == 4) {
                     pushByteCode(Walrus::Const32(localPos, 0), WASMOpcode::I32ConstOpcode);
                 } else if (size == 8) {
@@ -1497,6 +1759,7 @@ public:
                     };
                     pushByteCode(Walrus::Const128(localPos, empty), WASMOpcode::V128ConstOpcode);
                 }
+                generateMoveCodeIfNeeds(localPos, m_localInfo[i].m_position, m_localInfo[i].m_valueType);
             }
 #if !defined(NDEBUG)
             m_currentFunction->m_localDebugData.push_back(m_localInfo[i].m_position);
@@ -1524,10 +1787,15 @@ public:
             m_currentFunction->m_constantDebugData.pushBack(m_preprocessData.m_constantData[i]);
 #endif
         }
+
+        if (m_epochInterruption) {
+            pushByteCode(Walrus::CheckEpoch());
+        }
     }
 
-    virtual void OnOpcode(uint32_t opcode) override
+    virtual void OnOpcode(uint32_t opcode, size_t offset) override
     {
+        m_opcodeOffset = offset;
     }
 
     uint16_t computeFunctionParameterOrResultOffsetCount(const Walrus::TypeVector& types)
@@ -1705,7 +1973,9 @@ public:
         if (processConstValue(Walrus::Value(Walrus::Value::Type::I32, reinterpret_cast<uint8_t*>(&value)))) {
             return;
         }
-        pushByteCode(Walrus::Const32(computeExprResultPosition(Walrus::Value::Type::I32), value), WASMOpcode::I32ConstOpcode);
+        auto dst = computeExprResultPosition(Walrus::Value::Type::I32);
+        m_lastI32ConstPos = m_currentByteCode.size();
+        pushByteCode(Walrus::Const32(dst, value), WASMOpcode::I32ConstOpcode);
     }
 
     virtual void OnI64ConstExpr(uint64_t value) override
@@ -1748,9 +2018,11 @@ public:
             auto localSetInfo = readAheadLocalGetIfExists();
             if (localSetInfo.first) {
                 auto pos = m_localInfo[localSetInfo.first.value()].m_position;
-                // skip local.set opcode
-                *m_readerOffsetPointer += localSetInfo.second;
-                return pos;
+                if (!isFarPosition(pos)) {
+                    // skip local.set opcode
+                    *m_readerOffsetPointer += localSetInfo.second;
+                    return pos;
+                }
             }
         }
 
@@ -1762,6 +2034,11 @@ public:
         auto localPos = m_localInfo[localIndex].m_position;
         auto localValueType = m_localInfo[localIndex].m_valueType;
 
+        if (isFarPosition(localPos) && !m_preprocessData.m_inPreprocess) {
+            generateMoveCodeIfNeeds(localPos, pushVMStack(localValueType), localValueType);
+            return;
+        }
+
         bool canUseDirectReference = true;
         size_t pos = *m_readerOffsetPointer;
         for (const auto& r : m_preprocessData.m_localVariableInfo[localIndex].m_usageInfo) {
@@ -1843,11 +2120,103 @@ public:
     {
         auto code = static_cast<WASMOpcode>(opcode);
         ASSERT(WASMCodeInfo::codeTypeToValueType(g_wasmCodeInfo[opcode].m_paramTypes[1]) == peekVMStackValueType());
-        auto src1 = popVMStack();
+        auto src1 = popVMStackInfo();
         ASSERT(WASMCodeInfo::codeTypeToValueType(g_wasmCodeInfo[opcode].m_paramTypes[0]) == peekVMStackValueType());
-        auto src0 = popVMStack();
+        auto src0 = popVMStackInfo();
         auto dst = computeExprResultPosition(WASMCodeInfo::codeTypeToValueType(g_wasmCodeInfo[opcode].m_resultType));
-        generateBinaryCode(code, src0, src1, dst);
+
+        // The JIT compiler selects its own instructions, so superinstructions
+        // are only generated for the interpreter.
+        if (m_useJIT) {
+            generateBinaryCode(code, src0.position(), src1.position(), dst);
+            return;
+        }
+
+        if (generateI32BinaryImmCode(code, src0, src1, dst)) {
+            return;
+        }
+
+        size_t pos = m_currentByteCode.size();
+        generateBinaryCode(code, src0.position(), src1.position(), dst);
+
+        switch (code) {
+#define I32_COMPARE_CASE(name, compareName, ...) case WASMOpcode::compareName##Opcode:
+            FOR_EACH_BYTECODE_JUMP_IF_COMPARE_OP(I32_COMPARE_CASE)
+#undef I32_COMPARE_CASE
+            m_lastI32ComparePos = pos;
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool generateI32BinaryImmCode(WASMOpcode code, const VMStackInfo& src0, const VMStackInfo& src1, size_t dst)
+    {
+        bool isCommutative = false;
+
+        switch (code) {
+        case WASMOpcode::I32AddOpcode:
+        case WASMOpcode::I32MulOpcode:
+        case WASMOpcode::I32AndOpcode:
+        case WASMOpcode::I32OrOpcode:
+        case WASMOpcode::I32XorOpcode:
+            isCommutative = true;
+            break;
+        case WASMOpcode::I32SubOpcode:
+        case WASMOpcode::I32ShlOpcode:
+        case WASMOpcode::I32ShrSOpcode:
+        case WASMOpcode::I32ShrUOpcode:
+            break;
+        default:
+            return false;
+        }
+
+        uint32_t value;
+        size_t src;
+
+        if (takeI32Constant(src1, value)) {
+            src = src0.position();
+        } else if (isCommutative && takeI32Constant(src0, value)) {
+            src = src1.position();
+        } else {
+            return false;
+        }
+
+        size_t pos = m_currentByteCode.size();
+
+        switch (code) {
+        case WASMOpcode::I32AddOpcode:
+            pushByteCode(Walrus::I32AddImm(src, dst, value), code);
+            m_lastI32AddImmPos = pos;
+            break;
+        case WASMOpcode::I32SubOpcode:
+            pushByteCode(Walrus::I32AddImm(src, dst, 0 - value), code);
+            m_lastI32AddImmPos = pos;
+            break;
+        case WASMOpcode::I32MulOpcode:
+            pushByteCode(Walrus::I32MulImm(src, dst, value), code);
+            break;
+        case WASMOpcode::I32AndOpcode:
+            pushByteCode(Walrus::I32AndImm(src, dst, value), code);
+            break;
+        case WASMOpcode::I32OrOpcode:
+            pushByteCode(Walrus::I32OrImm(src, dst, value), code);
+            break;
+        case WASMOpcode::I32XorOpcode:
+            pushByteCode(Walrus::I32XorImm(src, dst, value), code);
+            break;
+        case WASMOpcode::I32ShlOpcode:
+            pushByteCode(Walrus::I32ShlImm(src, dst, value), code);
+            break;
+        case WASMOpcode::I32ShrSOpcode:
+            pushByteCode(Walrus::I32ShrSImm(src, dst, value), code);
+            break;
+        default:
+            ASSERT(code == WASMOpcode::I32ShrUOpcode);
+            pushByteCode(Walrus::I32ShrUImm(src, dst, value), code);
+            break;
+        }
+        return true;
     }
 
     virtual void OnUnaryExpr(uint32_t opcode) override
@@ -1895,7 +2264,21 @@ public:
     virtual void OnIfExpr(Type sigType) override
     {
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
-        auto stackPos = popVMStack();
+        auto info = popVMStackInfo();
+        auto stackPos = info.position();
+
+        if (!m_useJIT && canFuseI32Compare(info)) {
+            Walrus::ByteCodeStackOffset src0, src1;
+            auto compare = takeI32Compare(src0, src1);
+
+            BlockInfo b(BlockInfo::IfElse, sigType, *this);
+            b.m_jumpToEndBrInfo.push_back({ BlockInfo::JumpToEndBrInfo::IsJumpIfI32Compare, b.m_position });
+            m_blockInfo.push_back(b);
+
+            generateJumpIfI32CompareCode(compare, true, src0, src1, WASMOpcode::IfOpcode);
+            m_preprocessData.seenBranch();
+            return;
+        }
 
         bool isInverted = canBeInverted(stackPos);
         if (UNLIKELY(isInverted)) {
@@ -1967,6 +2350,7 @@ public:
         keepBlockResultsIfNeeds(blockInfo);
 
         ASSERT(blockInfo.m_blockType == BlockInfo::IfElse);
+        auto jumpToElse = blockInfo.m_jumpToEndBrInfo.front();
         blockInfo.m_jumpToEndBrInfo.erase(blockInfo.m_jumpToEndBrInfo.begin());
 
         if (!blockInfo.byteCodeGenerationStopped()) {
@@ -1976,14 +2360,26 @@ public:
 
         blockInfo.clearByteCodeGenerationStopped();
         restoreVMStackBy(blockInfo);
-        peekByteCode<Walrus::JumpIfFalse>(blockInfo.m_position)
-            ->setOffset(m_currentByteCode.size() - blockInfo.m_position);
+        if (jumpToElse.m_type == BlockInfo::JumpToEndBrInfo::IsJumpIfI32Compare) {
+            peekByteCode<Walrus::JumpIfI32Compare>(blockInfo.m_position)
+                ->setOffset(m_currentByteCode.size() - blockInfo.m_position);
+        } else {
+            peekByteCode<Walrus::JumpIfFalse>(blockInfo.m_position)
+                ->setOffset(m_currentByteCode.size() - blockInfo.m_position);
+        }
     }
 
     virtual void OnLoopExpr(Type sigType) override
     {
+        // the start of the loop is a jump target
+        clearSuperInstructionCandidates();
         BlockInfo b(BlockInfo::Loop, sigType, *this);
         m_blockInfo.push_back(b);
+
+        // Backward branches jump here.
+        if (m_epochInterruption) {
+            pushByteCode(Walrus::CheckEpoch());
+        }
     }
 
     virtual void OnBlockExpr(Type sigType) override
@@ -2063,8 +2459,43 @@ public:
         return std::make_pair(dropValueSize, parameterSize);
     }
 
+    void generateWideMoveCode(size_t srcPosition, size_t dstPosition, Walrus::Value::Type type)
+    {
+        switch (type) {
+        case Walrus::Value::I32:
+            pushByteCode(Walrus::MoveWideI32(srcPosition, dstPosition));
+            break;
+        case Walrus::Value::F32:
+            pushByteCode(Walrus::MoveWideF32(srcPosition, dstPosition));
+            break;
+        case Walrus::Value::I64:
+            pushByteCode(Walrus::MoveWideI64(srcPosition, dstPosition));
+            break;
+        case Walrus::Value::F64:
+            pushByteCode(Walrus::MoveWideF64(srcPosition, dstPosition));
+            break;
+        case Walrus::Value::V128:
+            pushByteCode(Walrus::MoveWideV128(srcPosition, dstPosition));
+            break;
+        default:
+            ASSERT(Walrus::Value::isRefType(type));
+
+            if (sizeof(size_t) == 4) {
+                pushByteCode(Walrus::MoveWideI32(srcPosition, dstPosition));
+            } else {
+                pushByteCode(Walrus::MoveWideI64(srcPosition, dstPosition));
+            }
+            break;
+        }
+    }
+
     void generateMoveCodeIfNeeds(size_t srcPosition, size_t dstPosition, Walrus::Value::Type type)
     {
+        if (UNLIKELY(isFarPosition(srcPosition) || isFarPosition(dstPosition))) {
+            generateWideMoveCode(srcPosition, dstPosition, type);
+            return;
+        }
+
         if (srcPosition != dstPosition) {
             switch (type) {
             case Walrus::Value::I32:
@@ -2235,6 +2666,18 @@ public:
         stopToGenerateByteCodeWhileBlockEnd();
     }
 
+    // Returns true if GenerateConditionalBranch emits a single conditional jump
+    bool hasSimpleConditionalBranch(Index depth)
+    {
+        if (m_blockInfo.size() == depth || dropStackValuesBeforeBrIfNeeds(depth).second) {
+            return false;
+        }
+
+        auto& blockInfo = findBlockInfoInBr(depth);
+        return blockInfo.m_blockType != BlockInfo::Loop || !blockInfo.returnValueIsIndex()
+            || getFunctionType(blockInfo.m_returnValueIndex)->param().size() == 0;
+    }
+
     template <typename JumpType, typename JumpTypeInverted, WASMOpcode opcode>
     size_t GenerateConditionalBranch(Index depth, size_t stackPos)
     {
@@ -2304,7 +2747,22 @@ public:
     {
         m_preprocessData.seenBranch(depth + 1);
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
-        size_t stackPos = popVMStack();
+        auto info = popVMStackInfo();
+        size_t stackPos = info.position();
+
+        if (!m_useJIT && canFuseI32Compare(info) && hasSimpleConditionalBranch(depth)) {
+            Walrus::ByteCodeStackOffset src0, src1;
+            auto compare = takeI32Compare(src0, src1);
+            auto& blockInfo = findBlockInfoInBr(depth);
+            auto offset = (int32_t)blockInfo.m_position - (int32_t)m_currentByteCode.size();
+
+            if (blockInfo.m_blockType != BlockInfo::Loop) {
+                blockInfo.m_jumpToEndBrInfo.push_back({ BlockInfo::JumpToEndBrInfo::IsJumpIfI32Compare, m_currentByteCode.size() });
+            }
+            generateJumpIfI32CompareCode(compare, false, src0, src1, WASMOpcode::BrIfOpcode, offset);
+            return;
+        }
+
         bool isInverted = canBeInverted(stackPos);
 
         if (UNLIKELY(isInverted)) {
@@ -2689,11 +3147,27 @@ public:
     {
         auto code = static_cast<WASMOpcode>(opcode);
         ASSERT((m_result.m_memoryTypes[memidx]->is64() ? Walrus::Value::I64 : Walrus::Value::I32) == peekVMStackValueType());
-        auto src = popVMStack();
+        auto srcInfo = popVMStackInfo();
+        auto src = srcInfo.position();
         auto dst = computeExprResultPosition(WASMCodeInfo::codeTypeToValueType(g_wasmCodeInfo[opcode].m_resultType));
 
         if (!m_result.m_memoryTypes[memidx]->is64()) {
-            if ((opcode == (int)WASMOpcode::I32LoadOpcode || opcode == (int)WASMOpcode::F32LoadOpcode) && offset == 0 && memidx == 0) {
+            if (!m_useJIT && memidx == 0 && canFuseI32AddImm(srcInfo)
+                && (opcode == (int)WASMOpcode::I32LoadOpcode || opcode == (int)WASMOpcode::F32LoadOpcode
+                    || opcode == (int)WASMOpcode::I64LoadOpcode || opcode == (int)WASMOpcode::F64LoadOpcode)) {
+                auto addImm = peekByteCode<Walrus::BinaryImmOperation>(m_lastI32AddImmPos);
+                auto base = addImm->srcOffset();
+                auto value = addImm->value();
+
+                resizeByteCode(m_lastI32AddImmPos);
+                m_lastI32AddImmPos = s_noI32AddImm;
+
+                if (opcode == (int)WASMOpcode::I32LoadOpcode || opcode == (int)WASMOpcode::F32LoadOpcode) {
+                    pushByteCode(Walrus::Load32AddImm(base, dst, value, offset), code);
+                } else {
+                    pushByteCode(Walrus::Load64AddImm(base, dst, value, offset), code);
+                }
+            } else if ((opcode == (int)WASMOpcode::I32LoadOpcode || opcode == (int)WASMOpcode::F32LoadOpcode) && offset == 0 && memidx == 0) {
                 pushByteCode(Walrus::Load32(src, dst), code);
             } else if ((opcode == (int)WASMOpcode::I64LoadOpcode || opcode == (int)WASMOpcode::F64LoadOpcode) && offset == 0 && memidx == 0) {
                 pushByteCode(Walrus::Load64(src, dst), code);
@@ -3217,6 +3691,7 @@ public:
     virtual void OnArrayNewExpr(Index type_index) override
     {
         const Walrus::ArrayType* typeInfo = m_result.m_compositeTypes[type_index]->asArray();
+        Walrus::TypeStore::PinType(typeInfo);
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
         auto src1 = popVMStack();
         auto src0 = popVMStack();
@@ -3227,6 +3702,7 @@ public:
     virtual void OnArrayNewDefaultExpr(Index type_index) override
     {
         const Walrus::ArrayType* typeInfo = m_result.m_compositeTypes[type_index]->asArray();
+        Walrus::TypeStore::PinType(typeInfo);
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
         auto src = popVMStack();
         auto dst = computeExprResultPosition(Walrus::Value::Type::DefinedRef);
@@ -3236,6 +3712,7 @@ public:
     virtual void OnArrayNewFixedExpr(Index type_index, Index count) override
     {
         const Walrus::ArrayType* typeInfo = m_result.m_compositeTypes[type_index]->asArray();
+        Walrus::TypeStore::PinType(typeInfo);
         auto pos = m_currentByteCode.size();
 
         pushByteCode(Walrus::ArrayNewFixed(typeInfo, count), WASMOpcode::ArrayNewFixedOpcode);
@@ -3254,6 +3731,7 @@ public:
     virtual void OnArrayNewDataExpr(Index type_index, Index data_index) override
     {
         const Walrus::ArrayType* typeInfo = m_result.m_compositeTypes[type_index]->asArray();
+        Walrus::TypeStore::PinType(typeInfo);
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
         auto src1 = popVMStack();
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
@@ -3265,6 +3743,7 @@ public:
     virtual void OnArrayNewElemExpr(Index type_index, Index elem_index) override
     {
         const Walrus::ArrayType* typeInfo = m_result.m_compositeTypes[type_index]->asArray();
+        Walrus::TypeStore::PinType(typeInfo);
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
         auto src1 = popVMStack();
         ASSERT(peekVMStackValueType() == Walrus::Value::Type::I32);
@@ -3383,6 +3862,7 @@ public:
     virtual void OnStructNewExpr(Index type_index) override
     {
         const Walrus::StructType* typeInfo = m_result.m_compositeTypes[type_index]->asStruct();
+        Walrus::TypeStore::PinType(typeInfo);
         auto pos = m_currentByteCode.size();
 
         pushByteCode(Walrus::StructNew(typeInfo), WASMOpcode::StructNewOpcode);
@@ -3402,6 +3882,7 @@ public:
     virtual void OnStructNewDefaultExpr(Index type_index) override
     {
         const Walrus::StructType* typeInfo = m_result.m_compositeTypes[type_index]->asStruct();
+        Walrus::TypeStore::PinType(typeInfo);
         auto dst = computeExprResultPosition(Walrus::Value::Type::DefinedRef);
         pushByteCode(Walrus::StructNewDefault(typeInfo, dst), WASMOpcode::StructNewDefaultOpcode);
     }
@@ -3461,7 +3942,7 @@ public:
     {
         // combining an i32.eqz at the end of a block followed by a JumpIf cannot be combined
         // because it is possible to jump to the location after i32.eqz
-        m_lastI32EqzPos = s_noI32Eqz;
+        clearSuperInstructionCandidates();
         if (m_blockInfo.size()) {
             auto dropSize = dropStackValuesBeforeBrIfNeeds(0);
             auto blockInfo = m_blockInfo.back();
@@ -3527,6 +4008,10 @@ public:
                     peekByteCode<Walrus::JumpIfFalse>(blockInfo.m_jumpToEndBrInfo[i].m_position)
                         ->setOffset(m_currentByteCode.size() - blockInfo.m_jumpToEndBrInfo[i].m_position);
                     break;
+                case BlockInfo::JumpToEndBrInfo::IsJumpIfI32Compare:
+                    peekByteCode<Walrus::JumpIfI32Compare>(blockInfo.m_jumpToEndBrInfo[i].m_position)
+                        ->setOffset(m_currentByteCode.size() - blockInfo.m_jumpToEndBrInfo[i].m_position);
+                    break;
                 default:
                     ASSERT(blockInfo.m_jumpToEndBrInfo[i].m_type == BlockInfo::JumpToEndBrInfo::IsBrTable);
 
@@ -3549,13 +4034,7 @@ public:
 
     virtual void EndFunctionBody(Index index) override
     {
-        // FIXME too many stack usage. we could not support this(yet)
-        if (m_initialFunctionStackSize > std::numeric_limits<Walrus::ByteCodeStackOffset>::max()) {
-            m_walrusParseError = std::string("Function stack usage is larger then supported maxium (65535 bytes).");
-            return;
-        }
-
-        m_lastI32EqzPos = s_noI32Eqz;
+        clearSuperInstructionCandidates();
 #if !defined(NDEBUG)
         if (getenv("DUMP_BYTECODE") && strlen(getenv("DUMP_BYTECODE"))) {
             m_currentFunction->dumpByteCode(m_currentByteCode);
@@ -3992,6 +4471,7 @@ WASMParsingResult::WASMParsingResult()
     , m_typesAddedToStore(false)
     , m_version(0)
     , m_start(0)
+    , m_byteCodeFlags(0)
 {
 }
 
@@ -4040,11 +4520,52 @@ void WASMParsingResult::clear()
     }
 }
 
+uint32_t WASMParser::byteCodeFlags(Store* store, const uint32_t JITFlags, const uint32_t featureFlags)
+{
+    uint32_t flags = 0;
+
+    if (JITFlags & JITFlagValue::useJIT) {
+        flags |= ByteCodeFlagValue::byteCodeForJIT;
+    }
+
+    if (store->epochInterruption()) {
+        flags |= ByteCodeFlagValue::byteCodeEpochChecks;
+    }
+
+    if ((JITFlags & JITFlagValue::perfJITDump) || (featureFlags & wabt::FeatureFlagValue::recordCodeOffsets)) {
+        flags |= ByteCodeFlagValue::byteCodeCodeOffsets;
+    }
+
+    if ((JITFlags & (JITFlagValue::perfMap | JITFlagValue::perfJITDump)) || (featureFlags & wabt::FeatureFlagValue::readFunctionNames)) {
+        flags |= ByteCodeFlagValue::byteCodeFunctionNames;
+    }
+
+    return flags;
+}
+
+void WASMParser::finishParsing(Module* module, const uint32_t JITFlags)
+{
+#if defined(WALRUS_ENABLE_JIT)
+    if (JITFlags & JITFlagValue::tieredJIT) {
+        module->enableTieredCompilation(JITFlags);
+    } else if (JITFlags & JITFlagValue::useJIT) {
+        module->jitCompile(nullptr, 0, JITFlags);
+    }
+#endif
+}
+
 std::pair<Optional<Module*>, std::string> WASMParser::parseBinary(Store* store, const std::string& filename, const uint8_t* data, size_t len, const uint32_t JITFlags, const uint32_t featureFlags)
 {
-    wabt::WASMBinaryReader delegate(store->getTypeStore(), JITFlags & JITFlagValue::useJIT);
+    uint32_t flags = byteCodeFlags(store, JITFlags, featureFlags);
+    wabt::WASMBinaryReader delegate(store->getTypeStore(), flags & ByteCodeFlagValue::byteCodeForJIT,
+                                    flags & ByteCodeFlagValue::byteCodeCodeOffsets, flags & ByteCodeFlagValue::byteCodeEpochChecks);
+    uint32_t readerFlags = featureFlags;
+
+    if (flags & ByteCodeFlagValue::byteCodeFunctionNames) {
+        readerFlags |= wabt::FeatureFlagValue::readFunctionNames;
+    }
 
-    std::string error = ReadWasmBinary(filename, data, len, &delegate, featureFlags);
+    std::string error = ReadWasmBinary(filename, data, len, &delegate, readerFlags);
 
     if (delegate.WalrusParseError().length()) {
         if (delegate.parsingResult().m_typesAddedToStore) {
@@ -4060,14 +4581,45 @@ std::pair<Optional<Module*>, std::string> WASMParser::parseBinary(Store* store,
         return std::make_pair(nullptr, error);
     }
 
+    delegate.parsingResult().m_byteCodeFlags = flags;
     Module* module = new Module(store, delegate.parsingResult());
-#if defined(WALRUS_ENABLE_JIT)
-    if (JITFlags & JITFlagValue::useJIT) {
-        module->jitCompile(nullptr, 0, JITFlags);
-    }
-#endif
+    finishParsing(module, JITFlags);
 
     return std::make_pair(module, std::string());
 }
 
+std::string WASMParser::parseTypeSection(Store* store, const std::string& filename, const uint8_t* data, size_t len, const uint32_t featureFlags, WASMParsingResult& result)
+{
+    wabt::WASMBinaryReader delegate(store->getTypeStore());
+
+    std::string error = ReadWasmBinary(filename, data, len, &delegate, featureFlags & ~wabt::FeatureFlagValue::readFunctionNames);
+
+    if (delegate.WalrusParseError().length()) {
+        error = delegate.WalrusParseError();
+    }
+
+    if (error.length()) {
+        if (delegate.parsingResult().m_typesAddedToStore) {
+            store->getTypeStore().releaseTypes(delegate.parsingResult().m_compositeTypes);
+        }
+        return error;
+    }
+
+    result.m_typesAddedToStore = delegate.parsingResult().m_typesAddedToStore;
+    result.m_compositeTypes = std::move(delegate.parsingResult().m_compositeTypes);
+    return std::string();
+}
+
+uint64_t WASMParser::hashBinary(const uint8_t* data, size_t len)
+{
+    // 64 bit FNV-1a hash
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
 } // namespace Walrus
@@ -36,6 +36,7 @@ struct WASMParsingResult {
     bool m_typesAddedToStore;
     uint32_t m_version;
     uint32_t m_start;
+    uint32_t m_byteCodeFlags;
 
     Vector<ImportType*> m_imports;
     Vector<ExportType*> m_exports;
@@ -56,6 +57,30 @@ class WASMParser {
 public:
     // returns <result, error>
     static std::pair<Optional<Module*>, std::string> parseBinary(Store* store, const std::string& filename, const uint8_t* data, size_t len, const uint32_t JITFlags = 0, const uint32_t featureFlags = 0);
+
+    // Serialized modules contain the original binary and the parsed state of the
+    // module (types, byte code, catch info and segments). The compiled code is
+    // not stored, it is generated again when the module is loaded.
+    static bool serialize(Module* module, const uint8_t* binary, size_t binarySize, std::vector<uint8_t>& out);
+    // Returns with the original binary stored in the serialized data.
+    static bool serializedBinary(const uint8_t* data, size_t len, const uint8_t** binary, size_t* binarySize);
+    // Hash of the binary, only suitable for selecting cache files.
+    static uint64_t hashBinary(const uint8_t* data, size_t len);
+    // When expectedBinary is not null, the serialized module is only accepted
+    // when it was created from exactly the same binary.
+    // returns <result, error>
+    static std::pair<Optional<Module*>, std::string> parseSerialized(Store* store, const std::string& filename, const uint8_t* data, size_t len,
+                                                                     const uint8_t* expectedBinary, size_t expectedBinarySize,
+                                                                     const uint32_t JITFlags = 0, const uint32_t featureFlags = 0);
+
+private:
+    friend class ModuleSerializer;
+
+    // Parser options which change the generated byte code.
+    static uint32_t byteCodeFlags(Store* store, const uint32_t JITFlags, const uint32_t featureFlags);
+    // Only the type section of the binary is processed.
+    static std::string parseTypeSection(Store* store, const std::string& filename, const uint8_t* data, size_t len, const uint32_t featureFlags, WASMParsingResult& result);
+    static void finishParsing(Module* module, const uint32_t JITFlags);
 };
 
 } // namespace Walrus
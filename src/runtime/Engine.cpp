@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Walrus.h"
+#include "runtime/Engine.h"
+#include "runtime/GCAllocator.h"
+#include "runtime/JITExec.h"
+#include "interpreter/ValueStack.h"
+
+namespace Walrus {
+
+void Engine::releaseThreadResources()
+{
+    // The value stack must also be unlinked from the roots scanned by the collector.
+    ValueStack::releaseCurrent();
+    GCAllocator::releaseCurrent();
+    ExecutionContext::releaseDirectCallFrameStack();
+}
+
+} // namespace Walrus
@@ -17,9 +17,160 @@
 #ifndef __WalrusEngine__
 #define __WalrusEngine__
 
+#include <atomic>
+
 namespace Walrus {
 
 class Engine {
+public:
+    static const uint32_t kDefaultJITInlineSize = 16;
+    static const uint32_t kDefaultJITTierUpThreshold = 1000;
+
+    Engine()
+        : m_useMemoryGuardPages(false)
+        , m_reportGCStats(false)
+        , m_JITThreadCount(1)
+        , m_JITOptLevel(1)
+        , m_JITInlineSize(kDefaultJITInlineSize)
+        , m_JITTierUpThreshold(kDefaultJITTierUpThreshold)
+        , m_epochInterruption(false)
+        , m_epoch(0)
+    {
+    }
+
+    // Must be set before any memories are created. Ignored
+    // when guard pages are not supported by the platform.
+    void setUseMemoryGuardPages(bool value)
+    {
+        m_useMemoryGuardPages = value;
+    }
+
+    bool useMemoryGuardPages() const
+    {
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+        return m_useMemoryGuardPages;
+#else
+        return false;
+#endif
+    }
+
+    // Must be set before the first store is created. The pause times of
+    // the garbage collector are printed when a store is destroyed.
+    void setReportGCStats(bool value)
+    {
+        m_reportGCStats = value;
+    }
+
+    bool reportGCStats() const
+    {
+#ifdef ENABLE_GC
+        return m_reportGCStats;
+#else
+        return false;
+#endif
+    }
+
+    // Number of threads used by the JIT compiler of a module.
+    void setJITThreadCount(uint32_t value)
+    {
+        m_JITThreadCount = value > 0 ? value : 1;
+    }
+
+    uint32_t JITThreadCount() const
+    {
+        return m_JITThreadCount;
+    }
+
+    // Optimization level of the JIT compiler. Level 0 disables the
+    // optimizations, level 1 folds constants and propagates copies, and
+    // level 2 also simplifies algebraic identities and removes unused results.
+    void setJITOptLevel(uint32_t value)
+    {
+        m_JITOptLevel = value;
+
+        if (value > kMaxJITOptLevel) {
+            m_JITOptLevel = kMaxJITOptLevel;
+        }
+    }
+
+    uint32_t JITOptLevel() const
+    {
+        return m_JITOptLevel;
+    }
+
+    // Calls of functions with at most this many byte codes, which contain
+    // no branches and no calls, are inlined by the JIT compiler. Zero
+    // disables inlining. Must be set before modules are parsed.
+    void setJITInlineSize(uint32_t value)
+    {
+        m_JITInlineSize = value;
+    }
+
+    uint32_t JITInlineSize() const
+    {
+        return m_JITInlineSize;
+    }
+
+    // Number of calls and loop iterations before an interpreted function is
+    // compiled by the tiered compiler. Must be set before modules are parsed.
+    void setJITTierUpThreshold(uint32_t value)
+    {
+        m_JITTierUpThreshold = value > 0 ? value : 1;
+    }
+
+    uint32_t JITTierUpThreshold() const
+    {
+        return m_JITTierUpThreshold;
+    }
+
+    // Must be set before modules are parsed. Loop headers and function
+    // entries of the modules parsed later check the epoch deadline of
+    // their store, see Store::setEpochDeadline.
+    void setEpochInterruption(bool value)
+    {
+        m_epochInterruption = value;
+    }
+
+    bool epochInterruption() const
+    {
+        return m_epochInterruption;
+    }
+
+    // Can be called from any thread, typically from a timer.
+    void incrementEpoch()
+    {
+        m_epoch.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    size_t epoch() const
+    {
+        return m_epoch.load(std::memory_order_relaxed);
+    }
+
+    const std::atomic<size_t>* epochCounter() const
+    {
+        return &m_epoch;
+    }
+
+    // The value stack, the allocator and the direct call frame buffer of a
+    // thread are created when it first runs wasm code, and are kept until
+    // this is called. Threads which called into wasm must call it before
+    // they exit, when no wasm code is running on the thread. The thread
+    // may call into wasm again later, which creates new buffers.
+    static void releaseThreadResources();
+
+private:
+    static const uint32_t kMaxJITOptLevel = 2;
+
+    bool m_useMemoryGuardPages;
+    bool m_reportGCStats;
+    uint32_t m_JITThreadCount;
+    uint32_t m_JITOptLevel;
+    uint32_t m_JITInlineSize;
+    uint32_t m_JITTierUpThreshold;
+    bool m_epochInterruption;
+    // Word sized, so compiled code can compare it with a single load.
+    std::atomic<size_t> m_epoch;
 };
 
 } // namespace Walrus
@@ -20,6 +20,7 @@
 namespace Walrus {
 
 Exception::Exception(ExecutionState& state)
+    : m_staticMessage(nullptr)
 {
     Optional<ExecutionState*> s = &state;
 
@@ -36,6 +36,13 @@ public:
         return std::unique_ptr<Exception>(new Exception(state, m));
     }
 
+    // Only string literals are accepted, the message is copied only when requested.
+    template <size_t N>
+    static std::unique_ptr<Exception> create(ExecutionState& state, const char (&m)[N])
+    {
+        return std::unique_ptr<Exception>(new Exception(state, static_cast<const char*>(m)));
+    }
+
     static std::unique_ptr<Exception> create(ExecutionState& state, Tag* tag, Vector<uint8_t>&& userExceptionData)
     {
         return std::unique_ptr<Exception>(new Exception(state, tag, std::move(userExceptionData)));
@@ -43,7 +50,7 @@ public:
 
     bool isBuiltinException()
     {
-        return !m_message.empty();
+        return m_staticMessage != nullptr || !m_message.empty();
     }
 
     bool isUserException()
@@ -53,6 +60,10 @@ public:
 
     std::string& message()
     {
+        if (m_staticMessage != nullptr) {
+            m_message = m_staticMessage;
+            m_staticMessage = nullptr;
+        }
         return m_message;
     }
 
@@ -70,14 +81,22 @@ private:
     friend class Interpreter;
     Exception(const std::string& message)
         : m_message(message)
+        , m_staticMessage(nullptr)
     {
     }
 
     Exception(ExecutionState& state);
+    // Only user exceptions are caught by wasm code, so traps
+    // do not need the program counters of the execution states.
     Exception(ExecutionState& state, const std::string& message)
-        : Exception(state)
+        : m_message(message)
+        , m_staticMessage(nullptr)
+    {
+    }
+
+    Exception(ExecutionState& state, const char* message)
+        : m_staticMessage(message)
     {
-        m_message = message;
     }
 
     Exception(ExecutionState& state, Tag* tag, Vector<uint8_t>&& userExceptionData)
@@ -88,6 +107,7 @@ private:
     }
 
     std::string m_message;
+    const char* m_staticMessage;
     Optional<Tag*> m_tag;
     Vector<uint8_t> m_userExceptionData;
     Vector<std::pair<ExecutionState*, size_t>> m_programCounterInfo;
@@ -20,6 +20,8 @@
 #include "util/Optional.h"
 #include "util/Util.h"
 
+#include <atomic>
+
 namespace Walrus {
 
 class Function;
@@ -29,19 +31,31 @@ public:
     friend class Exception;
     friend class Trap;
     friend class Interpreter;
+    friend class Profiler;
 
     ExecutionState(ExecutionState& parent)
         : m_parent(&parent)
         , m_currentFunction(nullptr)
         , m_stackLimit(parent.m_stackLimit)
+        , m_callerFrame(nullptr)
     {
+        makeCurrent();
     }
 
     ExecutionState(ExecutionState& parent, Function* currentFunction)
         : m_parent(&parent)
         , m_currentFunction(currentFunction)
         , m_stackLimit(parent.m_stackLimit)
+        , m_callerFrame(nullptr)
     {
+        makeCurrent();
+    }
+
+    ~ExecutionState()
+    {
+        if (m_isLinked) {
+            s_current = m_previous;
+        }
     }
 
     Optional<Function*> currentFunction() const
@@ -59,7 +73,9 @@ private:
     ExecutionState()
         : m_parent(nullptr)
         , m_currentFunction(nullptr)
+        , m_callerFrame(nullptr)
     {
+        makeCurrent();
         m_stackLimit = (size_t)currentStackPointer();
 
 #ifdef STACK_GROWS_DOWN
@@ -69,10 +85,34 @@ private:
 #endif
     }
 
+    // The thread local list is only maintained while the profiler
+    // is running, so the states are cheap to create otherwise.
+    void makeCurrent()
+    {
+        m_isLinked = s_isProfiling.load(std::memory_order_relaxed);
+
+        if (m_isLinked) {
+            m_previous = s_current;
+            // The state must be initialized before a signal handler can see it.
+            std::atomic_signal_fence(std::memory_order_release);
+            s_current = this;
+        }
+    }
+
+    // Innermost linked state of the thread, read by the sampling profiler.
+    // The states created before the profiler is started are not linked.
+    static MAY_THREAD_LOCAL ExecutionState* s_current;
+    static std::atomic<bool> s_isProfiling;
+
     Optional<ExecutionState*> m_parent;
     Optional<Function*> m_currentFunction;
     size_t m_stackLimit;
     Optional<size_t*> m_programCounterPointer;
+    // Innermost value stack frame of the caller when a defined
+    // function is entered, so the frames can be walked across calls.
+    void* m_callerFrame;
+    ExecutionState* m_previous;
+    bool m_isLinked;
 };
 
 } // namespace Walrus
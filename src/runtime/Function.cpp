@@ -31,6 +31,8 @@ DEFINE_GLOBAL_TYPE_INFO(functionTypeInfo, FunctionKind);
 Function::Function(const FunctionType* functionType)
     : Extern(functionType->subTypeList() != nullptr ? functionType->subTypeList() : GET_GLOBAL_TYPE_INFO(functionTypeInfo))
     , m_functionType(functionType)
+    , m_typedEntry(nullptr)
+    , m_typeID(0)
 {
 }
 
@@ -49,56 +51,97 @@ DefinedFunction::DefinedFunction(Instance* instance,
     , m_instance(instance)
     , m_moduleFunction(moduleFunction)
 {
+    m_typeID = moduleFunction->functionType()->typeID();
 }
 
 void DefinedFunction::call(ExecutionState& state, Value* argv, Value* result)
 {
     const FunctionType* ft = functionType();
-    size_t valueBufferSize = std::max(ft->paramStackSize(), ft->resultStackSize());
-    ALLOCA(uint8_t, valueBuffer, valueBufferSize);
-    uint16_t parameterOffsetSize = ft->paramStackSize() / sizeof(size_t);
-    uint16_t resultOffsetSize = ft->resultStackSize() / sizeof(size_t);
-    ALLOCA(uint16_t, offsetBuffer, (parameterOffsetSize + resultOffsetSize) * sizeof(uint16_t));
-    const TypeVector::Types& paramTypeInfo = ft->param().types();
-    const TypeVector::Types& resultTypeInfo = ft->result().types();
+    ALLOCA(uint8_t, valueBuffer, PreparedCall::bufferSize(ft));
+    ALLOCA(uint16_t, offsetBuffer, PreparedCall::offsetCount(ft) * sizeof(uint16_t));
+
+    PreparedCall::computeOffsets(ft, offsetBuffer);
+    PreparedCall::call(state, this, valueBuffer, offsetBuffer, argv, result);
+}
+
+void DefinedFunction::interpreterCall(ExecutionState& state, uint8_t* bp, ByteCodeStackOffset* offsets,
+                                      uint16_t parameterOffsetCount, uint16_t resultOffsetCount)
+{
+    Interpreter::callInterpreter(state, this, bp, offsets, parameterOffsetCount, resultOffsetCount);
+}
+
+PreparedCall::PreparedCall(Function* function)
+    : m_function(function)
+    , m_offsets(new ByteCodeStackOffset[offsetCount(function->functionType())])
+    , m_bufferSize(bufferSize(function->functionType()))
+{
+    computeOffsets(function->functionType(), m_offsets);
+}
+
+PreparedCall::~PreparedCall()
+{
+    delete[] m_offsets;
+}
 
-    size_t argc = paramTypeInfo.size();
-    uint8_t* paramBuffer = valueBuffer;
+size_t PreparedCall::bufferSize(const FunctionType* functionType)
+{
+    return std::max(functionType->paramStackSize(), functionType->resultStackSize());
+}
+
+size_t PreparedCall::offsetCount(const FunctionType* functionType)
+{
+    return (functionType->paramStackSize() + functionType->resultStackSize()) / sizeof(size_t);
+}
+
+void PreparedCall::computeOffsets(const FunctionType* functionType, ByteCodeStackOffset* offsets)
+{
+    const TypeVector::Types& paramTypeInfo = functionType->param().types();
+    const TypeVector::Types& resultTypeInfo = functionType->result().types();
     size_t offsetIndex = 0;
-    for (size_t i = 0; i < argc; i++) {
-        ASSERT(Value::isRefType(paramTypeInfo[i]) ? argv[i].isRef() : argv[i].type() == paramTypeInfo[i]);
-        argv[i].writeToMemory(paramBuffer);
+
+    size_t paramOffset = 0;
+    for (size_t i = 0; i < paramTypeInfo.size(); i++) {
         size_t stackAllocatedSize = valueStackAllocatedSize(paramTypeInfo[i]);
         for (size_t j = 0; j < stackAllocatedSize; j += sizeof(size_t)) {
-            offsetBuffer[offsetIndex++] = reinterpret_cast<size_t>(paramBuffer) - reinterpret_cast<size_t>(valueBuffer) + j;
+            offsets[offsetIndex++] = paramOffset + j;
         }
-        paramBuffer += stackAllocatedSize;
+        paramOffset += stackAllocatedSize;
     }
-    ASSERT(offsetIndex == parameterOffsetSize);
+    ASSERT(offsetIndex == functionType->paramStackSize() / sizeof(size_t));
 
     size_t resultOffset = 0;
     for (size_t i = 0; i < resultTypeInfo.size(); i++) {
         size_t stackAllocatedSize = valueStackAllocatedSize(resultTypeInfo[i]);
         for (size_t j = 0; j < stackAllocatedSize; j += sizeof(size_t)) {
-            offsetBuffer[offsetIndex++] = resultOffset + j;
+            offsets[offsetIndex++] = resultOffset + j;
         }
         resultOffset += stackAllocatedSize;
     }
-    ASSERT(offsetIndex == parameterOffsetSize + resultOffsetSize);
-    interpreterCall(state, valueBuffer, offsetBuffer, parameterOffsetSize, resultOffsetSize);
-
-    size_t resultOffsetIndex = 0;
-    for (size_t i = 0; i < resultTypeInfo.size(); i++) {
-        result[i] = Value(resultTypeInfo[i], valueBuffer + offsetBuffer[resultOffsetIndex + parameterOffsetSize]);
-        size_t stackAllocatedSize = valueStackAllocatedSize(resultTypeInfo[i]);
-        resultOffsetIndex += stackAllocatedSize / sizeof(size_t);
-    }
+    ASSERT(offsetIndex == offsetCount(functionType));
 }
 
-void DefinedFunction::interpreterCall(ExecutionState& state, uint8_t* bp, ByteCodeStackOffset* offsets,
-                                      uint16_t parameterOffsetCount, uint16_t resultOffsetCount)
+void PreparedCall::call(ExecutionState& state, Function* function, uint8_t* buffer,
+                        ByteCodeStackOffset* offsets, const Value* argv, Value* result)
 {
-    Interpreter::callInterpreter(state, this, bp, offsets, parameterOffsetCount, resultOffsetCount);
+    const FunctionType* ft = function->functionType();
+    const TypeVector::Types& paramTypeInfo = ft->param().types();
+    const TypeVector::Types& resultTypeInfo = ft->result().types();
+    uint16_t parameterOffsetSize = ft->paramStackSize() / sizeof(size_t);
+    uint16_t resultOffsetSize = ft->resultStackSize() / sizeof(size_t);
+
+    size_t offsetIndex = 0;
+    for (size_t i = 0; i < paramTypeInfo.size(); i++) {
+        ASSERT(Value::isRefType(paramTypeInfo[i]) ? argv[i].isRef() : argv[i].type() == paramTypeInfo[i]);
+        argv[i].writeToMemory(buffer + offsets[offsetIndex]);
+        offsetIndex += valueStackAllocatedSize(paramTypeInfo[i]) / sizeof(size_t);
+    }
+
+    function->interpreterCall(state, buffer, offsets, parameterOffsetSize, resultOffsetSize);
+
+    for (size_t i = 0; i < resultTypeInfo.size(); i++) {
+        result[i] = Value(resultTypeInfo[i], buffer + offsets[offsetIndex]);
+        offsetIndex += valueStackAllocatedSize(resultTypeInfo[i]) / sizeof(size_t);
+    }
 }
 
 void NativeFunction::interpreterCall(ExecutionState& state, uint8_t* bp, ByteCodeStackOffset* offsets,
@@ -163,4 +206,61 @@ void WasiFunction::call(ExecutionState& state, Value* argv, Value* result)
     m_callback(newState, argv, result, this->m_runningInstance);
 }
 
+TypedFunction* TypedFunction::createTypedFunction(Store* store, const Value::Type* paramTypes, size_t paramCount,
+                                                 Value::Type resultType, void (*callback)(), void* data,
+                                                 TypedEntry frameEntry, ValueEntry valueEntry)
+{
+    size_t resultCount = resultType != Value::Void ? 1 : 0;
+    const CompositeType** noIndex = reinterpret_cast<const CompositeType**>(TypeStore::NoIndex);
+    FunctionType* functionType = new FunctionType(paramCount, 0, resultCount, 0, true, noIndex);
+    TypeVector* params = functionType->initParam();
+
+    for (size_t i = 0; i < paramCount; i++) {
+        params->setType(i, paramTypes[i]);
+    }
+    if (resultCount > 0) {
+        functionType->initResult()->setType(0, resultType);
+    }
+    functionType->initDone();
+
+    // Canonical types are required by the type checks of call_indirect and ref.cast.
+    functionType = store->canonicalFunctionType(functionType);
+
+    TypedFunction* func = new TypedFunction(functionType, callback, data, frameEntry, valueEntry);
+    store->appendExtern(func);
+    return func;
+}
+
+TypedFunction::TypedFunction(FunctionType* functionType, void (*callback)(), void* data,
+                             TypedEntry frameEntry, ValueEntry valueEntry)
+    : NativeFunction(functionType)
+    , m_callback(callback)
+    , m_data(data)
+    , m_valueEntry(valueEntry)
+{
+    m_typedEntry = frameEntry;
+}
+
+TypedFunction::~TypedFunction()
+{
+    TypeStore::ReleaseRef(m_functionType->subTypeList());
+}
+
+void TypedFunction::call(ExecutionState& state, Value* argv, Value* result)
+{
+    ExecutionState newState(state, this);
+    CHECK_STACK_LIMIT(newState);
+    m_valueEntry(newState, this, argv, result);
+}
+
+void TypedFunction::interpreterCall(ExecutionState& state, uint8_t* bp, ByteCodeStackOffset* offsets,
+                                    uint16_t parameterOffsetCount, uint16_t resultOffsetCount)
+{
+    Exception* exception = m_typedEntry(state, this, bp, offsets);
+
+    if (UNLIKELY(exception != nullptr)) {
+        throw std::unique_ptr<Exception>(exception);
+    }
+}
+
 } // namespace Walrus
@@ -45,13 +45,17 @@ class DefinedFunction;
 class ImportedFunction;
 class LoweredFunction;
 class WasiFunction;
+class TypedFunction;
 
 class Function : public Extern {
+    friend class JITFieldAccessor;
+
 public:
     enum Kind {
         DefinedFunctionKind,
         ImportedFunctionKind,
         WasiFunctionKind,
+        TypedFunctionKind,
         // Function types used by component support.
         LoweredFunctionKind,
         CanonFunctionKind,
@@ -59,6 +63,14 @@ public:
     };
 
     const FunctionType* functionType() const { return m_functionType; }
+    // Type ID of defined functions with a canonical type, zero otherwise.
+    // Indirect calls of defined functions only compare the type IDs.
+    uint32_t typeID() const { return m_typeID; }
+
+    bool hasTypeID(uint32_t typeID) const
+    {
+        return m_typeID != 0 && m_typeID == typeID;
+    }
 
     virtual Kind kind() const = 0;
     virtual void call(ExecutionState& state, Value* argv, Value* result) = 0;
@@ -84,14 +96,28 @@ public:
         return reinterpret_cast<WasiFunction*>(this);
     }
 
+    TypedFunction* asTypedFunction()
+    {
+        ASSERT(kind() == TypedFunctionKind);
+        return reinterpret_cast<TypedFunction*>(this);
+    }
+
+    // Reads the arguments from the frame and writes the results back. The
+    // exception is returned instead of thrown, so compiled code can call it.
+    typedef Exception* (*TypedEntry)(ExecutionState& state, Function* function, uint8_t* bp, ByteCodeStackOffset* offsets);
+
 protected:
     Function(const FunctionType* functionType);
 
     const FunctionType* m_functionType;
+    // Only set by typed functions.
+    TypedEntry m_typedEntry;
+    uint32_t m_typeID;
 };
 
 class DefinedFunction : public Function {
     friend class Module;
+    friend class JITFieldAccessor;
 
 public:
     static DefinedFunction* createDefinedFunction(Store* store,
@@ -118,6 +144,36 @@ protected:
     ModuleFunction* m_moduleFunction;
 };
 
+// Buffer layout of calling a function with Values. The layout only depends
+// on the function type, so it can be computed once and reused by the calls.
+// The parameters are stored from the start of the buffer, and the results
+// overwrite them when the function returns.
+class PreparedCall {
+public:
+    PreparedCall(Function* function);
+    ~PreparedCall();
+
+    Function* function() const { return m_function; }
+    size_t bufferSize() const { return m_bufferSize; }
+
+    // The buffer must be at least bufferSize() bytes long and aligned to size_t.
+    void call(ExecutionState& state, uint8_t* buffer, const Value* argv, Value* result) const
+    {
+        call(state, m_function, buffer, m_offsets, argv, result);
+    }
+
+    static size_t bufferSize(const FunctionType* functionType);
+    static size_t offsetCount(const FunctionType* functionType);
+    static void computeOffsets(const FunctionType* functionType, ByteCodeStackOffset* offsets);
+    static void call(ExecutionState& state, Function* function, uint8_t* buffer,
+                     ByteCodeStackOffset* offsets, const Value* argv, Value* result);
+
+private:
+    Function* m_function;
+    ByteCodeStackOffset* m_offsets;
+    size_t m_bufferSize;
+};
+
 class NativeFunction : public Function {
 public:
     virtual void interpreterCall(ExecutionState& state, uint8_t* bp, ByteCodeStackOffset* offsets,
@@ -178,6 +234,11 @@ public:
         m_runningInstance = instance;
     }
 
+    const WasiFunctionCallback& callback() const
+    {
+        return m_callback;
+    }
+
     virtual void call(ExecutionState& state, Value* argv, Value* result) override;
 
 protected:
@@ -193,6 +254,187 @@ protected:
     Instance* m_runningInstance;
 };
 
+template <typename T>
+struct TypedFunctionValue;
+
+template <>
+struct TypedFunctionValue<int32_t> {
+    static const Value::Type type = Value::I32;
+    static int32_t fromValue(const Value& value) { return value.asI32(); }
+};
+
+template <>
+struct TypedFunctionValue<int64_t> {
+    static const Value::Type type = Value::I64;
+    static int64_t fromValue(const Value& value) { return value.asI64(); }
+};
+
+template <>
+struct TypedFunctionValue<float> {
+    static const Value::Type type = Value::F32;
+    static float fromValue(const Value& value) { return value.asF32(); }
+};
+
+template <>
+struct TypedFunctionValue<double> {
+    static const Value::Type type = Value::F64;
+    static double fromValue(const Value& value) { return value.asF64(); }
+};
+
+// Index of the first stack offset of an argument, or the
+// index of the first result offset when index == sizeof...(Args).
+template <typename... Args>
+struct TypedFunctionOffsets;
+
+template <>
+struct TypedFunctionOffsets<> {
+    static constexpr size_t index(size_t) { return 0; }
+};
+
+template <typename T, typename... Rest>
+struct TypedFunctionOffsets<T, Rest...> {
+    static constexpr size_t index(size_t argument)
+    {
+        return argument == 0 ? 0 : (sizeof(T) + sizeof(size_t) - 1) / sizeof(size_t) + TypedFunctionOffsets<Rest...>::index(argument - 1);
+    }
+};
+
+template <size_t... Indices>
+struct TypedFunctionIndices {
+};
+
+template <size_t N, size_t... Indices>
+struct MakeTypedFunctionIndices : MakeTypedFunctionIndices<N - 1, N - 1, Indices...> {
+};
+
+template <size_t... Indices>
+struct MakeTypedFunctionIndices<0, Indices...> {
+    typedef TypedFunctionIndices<Indices...> Type;
+};
+
+template <typename R, typename... Args>
+struct TypedFunctionCaller {
+    typedef R (*Callback)(ExecutionState& state, void* data, Args... args);
+
+    template <size_t... Indices>
+    static void callWithFrame(ExecutionState& state, Callback callback, void* data, uint8_t* bp,
+                              ByteCodeStackOffset* offsets, TypedFunctionIndices<Indices...>)
+    {
+        R result = callback(state, data, *reinterpret_cast<Args*>(bp + offsets[TypedFunctionOffsets<Args...>::index(Indices)])...);
+        *reinterpret_cast<R*>(bp + offsets[TypedFunctionOffsets<Args...>::index(sizeof...(Args))]) = result;
+    }
+
+    template <size_t... Indices>
+    static void callWithValues(ExecutionState& state, Callback callback, void* data, Value* argv,
+                               Value* result, TypedFunctionIndices<Indices...>)
+    {
+        result[0] = Value(callback(state, data, TypedFunctionValue<Args>::fromValue(argv[Indices])...));
+    }
+};
+
+template <typename... Args>
+struct TypedFunctionCaller<void, Args...> {
+    typedef void (*Callback)(ExecutionState& state, void* data, Args... args);
+
+    template <size_t... Indices>
+    static void callWithFrame(ExecutionState& state, Callback callback, void* data, uint8_t* bp,
+                              ByteCodeStackOffset* offsets, TypedFunctionIndices<Indices...>)
+    {
+        callback(state, data, *reinterpret_cast<Args*>(bp + offsets[TypedFunctionOffsets<Args...>::index(Indices)])...);
+    }
+
+    template <size_t... Indices>
+    static void callWithValues(ExecutionState& state, Callback callback, void* data, Value* argv,
+                               Value* result, TypedFunctionIndices<Indices...>)
+    {
+        callback(state, data, TypedFunctionValue<Args>::fromValue(argv[Indices])...);
+    }
+};
+
+// Host function with a statically typed signature. The arguments are read
+// from the frame of the caller without boxing them into Values, and compiled
+// code calls the entry of the function without the generic call helper.
+class TypedFunction : public NativeFunction {
+public:
+    typedef void (*ValueEntry)(ExecutionState& state, TypedFunction* function, Value* argv, Value* result);
+
+    // The parameter and result types must be int32_t, int64_t, float or double.
+    template <typename R, typename... Args>
+    static TypedFunction* createTypedFunction(Store* store,
+                                              R (*callback)(ExecutionState& state, void* data, Args... args),
+                                              void* data)
+    {
+        Value::Type paramTypes[sizeof...(Args) + 1] = { TypedFunctionValue<Args>::type..., Value::Void };
+
+        return createTypedFunction(store, paramTypes, sizeof...(Args), resultType<R>(),
+                                   reinterpret_cast<void (*)()>(callback), data,
+                                   &frameEntry<R, Args...>, &valueEntry<R, Args...>);
+    }
+
+    virtual Kind kind() const override
+    {
+        return TypedFunctionKind;
+    }
+
+    void* data() const
+    {
+        return m_data;
+    }
+
+    virtual void call(ExecutionState& state, Value* argv, Value* result) override;
+    virtual void interpreterCall(ExecutionState& state, uint8_t* bp, ByteCodeStackOffset* offsets,
+                                 uint16_t parameterOffsetCount, uint16_t resultOffsetCount) override;
+
+    virtual ~TypedFunction();
+
+protected:
+    TypedFunction(FunctionType* functionType, void (*callback)(), void* data,
+                  TypedEntry frameEntry, ValueEntry valueEntry);
+
+    static TypedFunction* createTypedFunction(Store* store, const Value::Type* paramTypes, size_t paramCount,
+                                              Value::Type resultType, void (*callback)(), void* data,
+                                              TypedEntry frameEntry, ValueEntry valueEntry);
+
+    template <typename R>
+    static Value::Type resultType()
+    {
+        return TypedFunctionValue<R>::type;
+    }
+
+    template <typename R, typename... Args>
+    static Exception* frameEntry(ExecutionState& state, Function* function, uint8_t* bp, ByteCodeStackOffset* offsets)
+    {
+        TypedFunction* self = static_cast<TypedFunction*>(function);
+
+        try {
+            ExecutionState newState(state, self);
+            CHECK_STACK_LIMIT(newState);
+            TypedFunctionCaller<R, Args...>::callWithFrame(newState, reinterpret_cast<typename TypedFunctionCaller<R, Args...>::Callback>(self->m_callback),
+                                                           self->m_data, bp, offsets, typename MakeTypedFunctionIndices<sizeof...(Args)>::Type());
+        } catch (std::unique_ptr<Exception>& exception) {
+            return exception.release();
+        }
+        return nullptr;
+    }
+
+    template <typename R, typename... Args>
+    static void valueEntry(ExecutionState& state, TypedFunction* function, Value* argv, Value* result)
+    {
+        TypedFunctionCaller<R, Args...>::callWithValues(state, reinterpret_cast<typename TypedFunctionCaller<R, Args...>::Callback>(function->m_callback),
+                                                        function->m_data, argv, result, typename MakeTypedFunctionIndices<sizeof...(Args)>::Type());
+    }
+
+    void (*m_callback)();
+    void* m_data;
+    ValueEntry m_valueEntry;
+};
+
+template <>
+inline Value::Type TypedFunction::resultType<void>()
+{
+    return Value::Void;
+}
+
 } // namespace Walrus
 
 #endif // __WalrusFunction__
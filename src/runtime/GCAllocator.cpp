@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Walrus.h"
+
+#include "runtime/GCAllocator.h"
+
+#ifdef ENABLE_GC
+#include "GCUtil.h"
+#endif /* ENABLE_GC */
+
+namespace Walrus {
+
+MAY_THREAD_LOCAL GCAllocator* GCAllocator::s_current;
+
+GCAllocator::GCAllocator()
+{
+    for (size_t i = 0; i <= kMaxGranules; i++) {
+        m_freeLists[i] = nullptr;
+    }
+}
+
+GCAllocator* GCAllocator::create()
+{
+    // The allocator is reused for the lifetime of the thread.
+#ifdef ENABLE_GC
+    void* memory = GC_MALLOC_UNCOLLECTABLE(sizeof(GCAllocator));
+#else
+    void* memory = malloc(sizeof(GCAllocator));
+#endif
+    RELEASE_ASSERT(memory != nullptr);
+    return new (memory) GCAllocator();
+}
+
+void GCAllocator::releaseCurrent()
+{
+    if (s_current == nullptr) {
+        return;
+    }
+
+#ifdef ENABLE_GC
+    GC_FREE(s_current);
+#else
+    free(s_current);
+#endif
+    s_current = nullptr;
+}
+
+void* GCAllocator::allocateSlowCase(size_t size)
+{
+#ifdef ENABLE_GC
+    size_t index = granules(size);
+
+    if (index > kMaxGranules) {
+        return GC_MALLOC(size);
+    }
+
+    // The collector appends an extra byte to the requested size when
+    // interior pointers are recognized, which would otherwise move the
+    // objects into the next size class.
+    size_t requestSize = index * kGranuleSize;
+    if (GC_get_all_interior_pointers()) {
+        requestSize--;
+    }
+
+    void* list = GC_malloc_many(requestSize);
+
+    if (UNLIKELY(list == nullptr)) {
+        return nullptr;
+    }
+
+    // The compiled code relies on the size class of the list, so a
+    // collector with a different granule size must not be used.
+    RELEASE_ASSERT(GC_size(list) >= index * kGranuleSize);
+    ASSERT(GC_size(list) == index * kGranuleSize);
+
+    ASSERT(m_freeLists[index] == nullptr);
+    m_freeLists[index] = GC_NEXT(list);
+    GC_NEXT(list) = nullptr;
+    return list;
+#else // !ENABLE_GC
+    return nullptr;
+#endif // ENABLE_GC
+}
+
+} // namespace Walrus
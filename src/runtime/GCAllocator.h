@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WalrusGCAllocator__
+#define __WalrusGCAllocator__
+
+namespace Walrus {
+
+// Per-thread free lists of small GC objects indexed by their size in
+// granules. The lists are filled by GC_malloc_many, and both the runtime
+// and the compiled code allocate an object by removing the first item of
+// a list. The objects are cleared, except the link in their first word.
+class GCAllocator {
+public:
+    static const size_t kGranuleSize = 2 * sizeof(void*);
+    static const size_t kMaxGranules = 16;
+
+    static GCAllocator* current()
+    {
+        if (UNLIKELY(s_current == nullptr)) {
+            s_current = create();
+        }
+        return s_current;
+    }
+
+    // Frees the allocator of the current thread before the thread exits.
+    // The objects on its free lists are reclaimed by the next collection.
+    static void releaseCurrent();
+
+    static size_t granules(size_t size)
+    {
+        return (size + kGranuleSize - 1) / kGranuleSize;
+    }
+
+    // Returns with cleared memory, or nullptr when the allocation fails.
+    void* allocate(size_t size)
+    {
+        size_t index = granules(size);
+
+        if (index <= kMaxGranules) {
+            void* object = m_freeLists[index];
+
+            if (LIKELY(object != nullptr)) {
+                m_freeLists[index] = *reinterpret_cast<void**>(object);
+                *reinterpret_cast<void**>(object) = nullptr;
+                return object;
+            }
+        }
+
+        return allocateSlowCase(size);
+    }
+
+    void** freeLists()
+    {
+        return m_freeLists;
+    }
+
+private:
+    GCAllocator();
+
+    static GCAllocator* create();
+    void* allocateSlowCase(size_t size);
+
+    static MAY_THREAD_LOCAL GCAllocator* s_current;
+
+    // The objects on the lists are allocated, so the
+    // lists must be reachable for the collector.
+    void* m_freeLists[kMaxGranules + 1];
+};
+
+} // namespace Walrus
+
+#endif // __WalrusGCAllocator__
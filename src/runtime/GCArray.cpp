@@ -18,7 +18,6 @@
 #include "GCArray.h"
 #include "runtime/Instance.h"
 #include "runtime/GCStruct.h"
-#include "runtime/TypeStore.h"
 
 #ifdef ENABLE_GC
 #include "GCUtil.h"
@@ -27,11 +26,6 @@
 namespace Walrus {
 
 #ifdef ENABLE_GC
-static void GC_CALLBACK arrayFinalizer(void* /* ignored ptr */, void* subTypeList)
-{
-    TypeStore::ReleaseRef(reinterpret_cast<const CompositeType**>(subTypeList));
-}
-
 static inline uint32_t getAlignedStartOffset(uint32_t size)
 {
     return (static_cast<uint32_t>(sizeof(GCArray)) + (size - 1)) & ~(size - 1);
@@ -85,9 +79,6 @@ GCArray* GCArray::arrayNew(uint32_t length, const ArrayType* type, uint8_t* valu
     if (currentSize < size) {
         memcpy(dst + currentSize, dst, size - currentSize);
     }
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, arrayFinalizer, type->subTypeList(), nullptr, nullptr);
     return result;
 #else // !ENABLE_GC
     return nullptr;
@@ -118,9 +109,6 @@ GCArray* GCArray::arrayNewDefault(uint32_t length, const ArrayType* type)
     new (result) GCArray(type, length);
 
     memset(reinterpret_cast<uint8_t*>(result) + startOffset, 0, length << log2Size);
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, arrayFinalizer, type->subTypeList(), nullptr, nullptr);
     return result;
 #else // !ENABLE_GC
     return nullptr;
@@ -188,9 +176,6 @@ GCArray* GCArray::arrayNewFixed(uint32_t length, const ArrayType* type, ByteCode
         }
         break;
     }
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, arrayFinalizer, type->subTypeList(), nullptr, nullptr);
     return result;
 #else // !ENABLE_GC
     return nullptr;
@@ -227,9 +212,6 @@ GCArray* GCArray::arrayNewData(uint32_t offset, uint32_t size, const ArrayType*
     new (result) GCArray(type, size);
 
     memcpy(reinterpret_cast<uint8_t*>(result) + startOffset, data->data() + offset, size << log2Size);
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, arrayFinalizer, type->subTypeList(), nullptr, nullptr);
     return result;
 #else // !ENABLE_GC
     return nullptr;
@@ -262,9 +244,6 @@ GCArray* GCArray::arrayNewElem(uint32_t offset, uint32_t size, const ArrayType*
     new (result) GCArray(type, size);
 
     memcpy(reinterpret_cast<uint8_t*>(result) + startOffset, elem->elements() + offset, size * sizeof(void*));
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, arrayFinalizer, type->subTypeList(), nullptr, nullptr);
     return result;
 #else // !ENABLE_GC
     return nullptr;
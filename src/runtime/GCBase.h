@@ -22,6 +22,7 @@
 namespace Walrus {
 
 class GCBase : public Object {
+    friend class JITFieldAccessor;
     friend class TypeStore;
 
 public:
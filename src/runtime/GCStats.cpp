@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Walrus.h"
+
+#include "runtime/GCStats.h"
+
+#ifdef ENABLE_GC
+#include "GCUtil.h"
+#include <chrono>
+#endif /* ENABLE_GC */
+
+namespace Walrus {
+
+#ifdef ENABLE_GC
+
+// Updated by the collecting thread while it holds the allocation lock.
+static bool s_enabled;
+static size_t s_collectionCount;
+static std::chrono::nanoseconds s_totalPause;
+static std::chrono::nanoseconds s_maxPause;
+static std::chrono::steady_clock::time_point s_collectionStart;
+static GC_on_collection_event_proc s_previousEventHandler;
+
+static void GC_CALLBACK collectionEvent(GC_EventType event)
+{
+    if (event == GC_EVENT_START) {
+        s_collectionStart = std::chrono::steady_clock::now();
+    } else if (event == GC_EVENT_END) {
+        std::chrono::nanoseconds pause = std::chrono::steady_clock::now() - s_collectionStart;
+
+        s_collectionCount++;
+        s_totalPause += pause;
+        s_maxPause = std::max(s_maxPause, pause);
+    }
+
+    if (s_previousEventHandler != nullptr) {
+        s_previousEventHandler(event);
+    }
+}
+
+void GCStats::enable()
+{
+    if (s_enabled) {
+        return;
+    }
+
+    s_enabled = true;
+    s_previousEventHandler = GC_get_on_collection_event();
+    GC_set_on_collection_event(collectionEvent);
+}
+
+void GCStats::report(FILE* output)
+{
+    if (!s_enabled) {
+        return;
+    }
+
+    double totalPause = std::chrono::duration<double, std::milli>(s_totalPause).count();
+    double maxPause = std::chrono::duration<double, std::milli>(s_maxPause).count();
+
+    fprintf(output, "GC: %zu collections, %.3f ms total pause, %.3f ms max pause, %.3f ms average pause, %zu KB heap\n",
+            s_collectionCount, totalPause, maxPause, s_collectionCount > 0 ? totalPause / s_collectionCount : 0.0,
+            static_cast<size_t>(GC_get_heap_size() / 1024));
+}
+
+#else
+
+void GCStats::enable()
+{
+}
+
+void GCStats::report(FILE* output)
+{
+}
+
+#endif /* ENABLE_GC */
+
+} // namespace Walrus
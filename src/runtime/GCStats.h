@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef __WalrusGCStats__
+#define __WalrusGCStats__
+
+namespace Walrus {
+
+// Pause times of the garbage collector. Every thread is stopped while the
+// collector runs, so the duration of a collection is a pause of the program.
+// The statistics are collected for the whole process.
+class GCStats {
+public:
+    // Must be called after the collector is initialized.
+    static void enable();
+    static void report(FILE* output);
+};
+
+} // namespace Walrus
+
+#endif // __WalrusGCStats__
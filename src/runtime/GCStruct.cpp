@@ -16,7 +16,7 @@
 #include "Walrus.h"
 
 #include "GCStruct.h"
-#include "runtime/TypeStore.h"
+#include "runtime/GCAllocator.h"
 
 #ifdef ENABLE_GC
 #include "GCUtil.h"
@@ -24,19 +24,12 @@
 
 namespace Walrus {
 
-#ifdef ENABLE_GC
-static void GC_CALLBACK structFinalizer(void* /* ignored ptr */, void* subTypeList)
-{
-    TypeStore::ReleaseRef(reinterpret_cast<const CompositeType**>(subTypeList));
-}
-#endif // ENABLE_GC
-
 GCStruct* GCStruct::structNew(const StructType* type, ByteCodeStackOffset* offsets, uint8_t* bp)
 {
 #ifdef ENABLE_GC
     // TODO: The object is currently stored on the stack, which is good enough for testing,
     // but several GC related improvements needs to be added to the code later.
-    GCStruct* result = reinterpret_cast<GCStruct*>(GC_MALLOC(type->structSize()));
+    GCStruct* result = reinterpret_cast<GCStruct*>(GCAllocator::current()->allocate(type->structSize()));
     if (UNLIKELY(result == nullptr)) {
         return result;
     }
@@ -52,9 +45,6 @@ GCStruct* GCStruct::structNew(const StructType* type, ByteCodeStackOffset* offse
     for (size_t i = 0; i < size; i++) {
         set(dst + fieldOffsets[i], bp + offsets[i], fields[i].type());
     }
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, structFinalizer, type->subTypeList(), nullptr, nullptr);
     return result;
 #else // !ENABLE_GC
     return nullptr;
@@ -64,7 +54,7 @@ GCStruct* GCStruct::structNew(const StructType* type, ByteCodeStackOffset* offse
 GCStruct* GCStruct::structNewDefault(const StructType* type)
 {
 #ifdef ENABLE_GC
-    GCStruct* result = reinterpret_cast<GCStruct*>(GC_MALLOC(type->structSize()));
+    GCStruct* result = reinterpret_cast<GCStruct*>(GCAllocator::current()->allocate(type->structSize()));
     if (UNLIKELY(result == nullptr)) {
         return result;
     }
@@ -72,17 +62,17 @@ GCStruct* GCStruct::structNewDefault(const StructType* type)
     // Placement new to initialize the common part.
     new (result) GCStruct(type);
 
-    const VectorWithFixedSize<uint32_t, std::allocator<uint32_t>>& fieldOffsets = type->fieldOffsets();
-    if (fieldOffsets.size() > 0) {
-        memset(reinterpret_cast<uint8_t*>(result) + fieldOffsets[0], 0, type->structSize() - fieldOffsets[0]);
-    }
-
-    TypeStore::AddRef(type);
-    GC_REGISTER_FINALIZER_NO_ORDER(result, structFinalizer, type->subTypeList(), nullptr, nullptr);
+    // The fields are cleared by the allocator.
     return result;
 #else // !ENABLE_GC
     return nullptr;
 #endif // ENABLE_GC
 }
 
+uintptr_t GCStruct::vtable()
+{
+    GCStruct object(static_cast<const CompositeType**>(nullptr));
+    return *reinterpret_cast<uintptr_t*>(&object);
+}
+
 } // namespace Walrus
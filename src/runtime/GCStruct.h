@@ -30,6 +30,9 @@ public:
     static GCStruct* structNew(const StructType* type, ByteCodeStackOffset* offsets, uint8_t* bp);
     static GCStruct* structNewDefault(const StructType* type);
 
+    // The first word of the objects, which is stored by the compiled code.
+    static uintptr_t vtable();
+
     static inline void set(uint8_t* dst, uint8_t* src, Value::Type type)
     {
         switch (type) {
@@ -97,6 +100,11 @@ private:
         : GCBase(type->subTypeList())
     {
     }
+
+    GCStruct(const CompositeType** typeInfo)
+        : GCBase(typeInfo)
+    {
+    }
 };
 
 } // namespace Walrus
@@ -33,7 +33,7 @@ namespace Walrus {
 
 DEFINE_GLOBAL_TYPE_INFO(instanceTypeInfo, InstanceKind);
 
-ElementSegment::ElementSegment(size_t size)
+ElementSegment::ElementSegment(size_t size, const Type& type)
     : m_size(size)
 {
     if (size == 0) {
@@ -41,9 +41,16 @@ ElementSegment::ElementSegment(size_t size)
         return;
     }
 
-    // The references are initialized during instantiation.
+    // The references are initialized during instantiation. The instance
+    // is not allocated by the collector, so the elements must be a root
+    // until the segment is dropped. Functions are not collected, so the
+    // elements of function references are not scanned.
 #ifdef ENABLE_GC
-    m_elements = reinterpret_cast<void**>(GC_MALLOC_UNCOLLECTABLE(size * sizeof(void*)));
+    if (type.isFunctionRef()) {
+        m_elements = reinterpret_cast<void**>(GC_MALLOC_ATOMIC_UNCOLLECTABLE(size * sizeof(void*)));
+    } else {
+        m_elements = reinterpret_cast<void**>(GC_MALLOC_UNCOLLECTABLE(size * sizeof(void*)));
+    }
 #else
     m_elements = reinterpret_cast<void**>(malloc(size * sizeof(void*)));
 #endif
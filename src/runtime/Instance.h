@@ -59,7 +59,7 @@ private:
 
 class ElementSegment {
 public:
-    ElementSegment(size_t size);
+    ElementSegment(size_t size, const Type& type);
 
     size_t size() const
     {
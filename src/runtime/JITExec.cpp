@@ -17,21 +17,353 @@
 #include "Walrus.h"
 
 #include "runtime/JITExec.h"
+#include "runtime/GCAllocator.h"
 #include "runtime/Instance.h"
+#include "runtime/Memory.h"
 #include "runtime/Module.h"
+#include "runtime/Store.h"
 #include "runtime/Trap.h"
 #include "runtime/Value.h"
 
+#ifdef ENABLE_GC
+#include "GCUtil.h"
+#endif /* ENABLE_GC */
+
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+#include <atomic>
+#include <mutex>
+#include <signal.h>
+#include <thread>
+#include <ucontext.h>
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
+
 namespace Walrus {
 
-ByteCodeStackOffset* JITFunction::call(ExecutionState& state, Instance* instance, uint8_t* bp) const
+// Frames of directly called functions are allocated from a per-thread buffer.
+// Nested JIT entries (e.g. JIT -> host -> JIT) continue above the frames of
+// the enclosing context, which is the current context of the buffer.
+struct DirectCallFrameStack {
+    uint8_t* start;
+    ExecutionContext* currentContext;
+#ifdef ENABLE_GC
+    DirectCallFrameStack* next;
+#endif /* ENABLE_GC */
+};
+
+static MAY_THREAD_LOCAL DirectCallFrameStack* s_directCallFrameStack;
+
+#ifdef ENABLE_GC
+// Protected by the allocation lock of the collector.
+static DirectCallFrameStack* s_firstDirectCallFrameStack;
+static GC_push_other_roots_proc s_previousPushOtherRoots;
+static bool s_pushOtherRootsInstalled;
+
+// The buffers are not allocated by the collector. Only their used part,
+// which ends at the frame stack top of the current context, is pushed.
+// The frames have no function header, so they are scanned conservatively.
+static void pushDirectCallFrames()
+{
+    for (DirectCallFrameStack* stack = s_firstDirectCallFrameStack; stack != nullptr; stack = stack->next) {
+        ExecutionContext* context = stack->currentContext;
+
+        if (context != nullptr && context->frameStackTop > stack->start) {
+            GC_push_all_eager(stack->start, context->frameStackTop);
+        }
+    }
+
+    if (s_previousPushOtherRoots != nullptr) {
+        s_previousPushOtherRoots();
+    }
+}
+
+static void* registerDirectCallFrameStack(void* stack)
+{
+    if (!s_pushOtherRootsInstalled) {
+        s_previousPushOtherRoots = GC_get_push_other_roots();
+        GC_set_push_other_roots(pushDirectCallFrames);
+        s_pushOtherRootsInstalled = true;
+    }
+
+    reinterpret_cast<DirectCallFrameStack*>(stack)->next = s_firstDirectCallFrameStack;
+    s_firstDirectCallFrameStack = reinterpret_cast<DirectCallFrameStack*>(stack);
+    return nullptr;
+}
+
+static void* unregisterDirectCallFrameStack(void* stack)
+{
+    DirectCallFrameStack** link = &s_firstDirectCallFrameStack;
+
+    while (*link != stack) {
+        ASSERT(*link != nullptr);
+        link = &(*link)->next;
+    }
+
+    *link = reinterpret_cast<DirectCallFrameStack*>(stack)->next;
+    return nullptr;
+}
+#endif /* ENABLE_GC */
+
+static void initDirectCallFrameStack(ExecutionContext& context, ExecutionContext* parentContext)
+{
+    if (parentContext != nullptr) {
+        context.frameStackTop = parentContext->frameStackTop;
+        context.frameStackEnd = parentContext->frameStackEnd;
+        return;
+    }
+
+    DirectCallFrameStack* stack = s_directCallFrameStack;
+
+    if (UNLIKELY(stack == nullptr)) {
+        // The buffer is reused for the lifetime of the thread.
+        stack = new DirectCallFrameStack;
+        stack->start = reinterpret_cast<uint8_t*>(malloc(ExecutionContext::kDirectCallFrameStackSize));
+        RELEASE_ASSERT(stack->start != nullptr);
+        stack->currentContext = nullptr;
+#ifdef ENABLE_GC
+        GC_call_with_alloc_lock(registerDirectCallFrameStack, stack);
+#endif /* ENABLE_GC */
+        s_directCallFrameStack = stack;
+    }
+
+    context.frameStackTop = stack->start;
+    context.frameStackEnd = stack->start + ExecutionContext::kDirectCallFrameStackSize;
+}
+
+void ExecutionContext::releaseDirectCallFrameStack()
+{
+    DirectCallFrameStack* stack = s_directCallFrameStack;
+
+    if (stack == nullptr) {
+        return;
+    }
+
+    ASSERT(stack->currentContext == nullptr);
+    s_directCallFrameStack = nullptr;
+
+#ifdef ENABLE_GC
+    GC_call_with_alloc_lock(unregisterDirectCallFrameStack, stack);
+#endif /* ENABLE_GC */
+    free(stack->start);
+    delete stack;
+}
+
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+
+// Modules which have functions accessing memories without bounds checks.
+// The signal handler cannot take locks, so the traps of all modules are
+// published as an immutable table sorted by start address. Updates are
+// serialized by s_guardPageModulesLock and replace the whole table. A
+// retired table is freed only after the readers which may still use it
+// have left the signal handler.
+struct GuardPageTrapTable {
+    std::vector<JITModule::GuardPageTrap> traps;
+};
+
+static std::mutex s_guardPageModulesLock;
+static std::vector<JITModule*> s_guardPageModules;
+static std::atomic<GuardPageTrapTable*> s_guardPageTrapTable;
+static std::atomic<size_t> s_guardPageTrapReaders;
+static struct sigaction s_prevSegvAction;
+
+// Only the faults inside a memory reservation of the instance running
+// on this thread are wasm traps. Any other fault of the same instruction
+// (e.g. a bad pointer passed by the embedder) goes to the previous handler.
+static bool isGuardPageFault(void* faultAddress)
+{
+    DirectCallFrameStack* stack = s_directCallFrameStack;
+
+    if (stack == nullptr || stack->currentContext == nullptr) {
+        return false;
+    }
+
+    Instance* instance = stack->currentContext->instance;
+    uintptr_t address = reinterpret_cast<uintptr_t>(faultAddress);
+    size_t memoryCount = instance->module()->numberOfMemoryTypes();
+
+    for (size_t i = 0; i < memoryCount; i++) {
+        Memory* memory = instance->memory(i);
+
+        if (memory->hasGuardPages() && memory->isReservedAddress(address)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void guardPageSignalHandler(int signal, siginfo_t* info, void* context)
+{
+    ucontext_t* ucontext = reinterpret_cast<ucontext_t*>(context);
+#if defined(CPU_X86_64)
+    auto& pc = ucontext->uc_mcontext.gregs[REG_RIP];
+#else /* CPU_ARM64 */
+    auto& pc = ucontext->uc_mcontext.pc;
+#endif
+    uintptr_t handler = JITModule::findGuardPageTrap(static_cast<uintptr_t>(pc));
+
+    if (handler != 0 && isGuardPageFault(info->si_addr)) {
+        // The trap handler of the faulting function sets the error code and unwinds the stack.
+        pc = handler;
+        return;
+    }
+
+    if (s_prevSegvAction.sa_flags & SA_SIGINFO) {
+        s_prevSegvAction.sa_sigaction(signal, info, context);
+        return;
+    }
+
+    if (s_prevSegvAction.sa_handler != SIG_DFL && s_prevSegvAction.sa_handler != SIG_IGN) {
+        s_prevSegvAction.sa_handler(signal);
+        return;
+    }
+
+    // The faulting instruction is executed again with the default action.
+    sigaction(SIGSEGV, &s_prevSegvAction, nullptr);
+}
+
+// Must be called with s_guardPageModulesLock held.
+static void publishGuardPageTraps()
+{
+    GuardPageTrapTable* table = nullptr;
+
+    if (!s_guardPageModules.empty()) {
+        table = new GuardPageTrapTable;
+
+        for (auto module : s_guardPageModules) {
+            module->collectGuardPageTraps(table->traps);
+        }
+
+        std::sort(table->traps.begin(), table->traps.end(),
+                  [](const JITModule::GuardPageTrap& a, const JITModule::GuardPageTrap& b) { return a.start < b.start; });
+    }
+
+    GuardPageTrapTable* oldTable = s_guardPageTrapTable.exchange(table);
+
+    if (oldTable == nullptr) {
+        return;
+    }
+
+    // Readers increase the counter before loading the table, so no
+    // reader can see oldTable after the counter drops to zero.
+    while (s_guardPageTrapReaders.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    delete oldTable;
+}
+
+void JITModule::appendGuardPageTraps(const std::vector<GuardPageTrap>& traps)
+{
+    static std::once_flag installHandler;
+
+    std::call_once(installHandler, []() {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = guardPageSignalHandler;
+        action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+        sigemptyset(&action.sa_mask);
+        RELEASE_ASSERT(sigaction(SIGSEGV, &action, &s_prevSegvAction) == 0);
+    });
+
+    std::lock_guard<std::mutex> guard(s_guardPageModulesLock);
+
+    if (m_guardPageTraps.empty()) {
+        s_guardPageModules.push_back(this);
+    }
+
+    m_guardPageTraps.insert(m_guardPageTraps.end(), traps.begin(), traps.end());
+    publishGuardPageTraps();
+}
+
+void JITModule::removeGuardPageTraps()
+{
+    if (m_guardPageTraps.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(s_guardPageModulesLock);
+    s_guardPageModules.erase(std::find(s_guardPageModules.begin(), s_guardPageModules.end(), this));
+    publishGuardPageTraps();
+}
+
+void JITModule::collectGuardPageTraps(std::vector<GuardPageTrap>& traps) const
+{
+    traps.insert(traps.end(), m_guardPageTraps.begin(), m_guardPageTraps.end());
+}
+
+uintptr_t JITModule::findGuardPageTrap(uintptr_t address)
 {
-    ASSERT(m_exportEntry);
+    // Called from the signal handler: only lock-free atomics are used.
+    uintptr_t result = 0;
+
+    s_guardPageTrapReaders.fetch_add(1);
+    GuardPageTrapTable* table = s_guardPageTrapTable.load();
+
+    if (table != nullptr) {
+        const GuardPageTrap* begin = table->traps.data();
+        size_t size = table->traps.size();
+
+        // Find the last range which starts at or below address.
+        while (size > 0) {
+            size_t half = size / 2;
+
+            if (begin[half].start <= address) {
+                begin += half + 1;
+                size -= half + 1;
+            } else {
+                size = half;
+            }
+        }
+
+        if (begin != table->traps.data() && address < begin[-1].end) {
+            result = begin[-1].handler;
+        }
+    }
+
+    s_guardPageTrapReaders.fetch_sub(1);
+    return result;
+}
+
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
+
+void* JITFunction::osrEntry(size_t byteCodeOffset) const
+{
+    auto it = std::lower_bound(m_osrEntries.begin(), m_osrEntries.end(), byteCodeOffset,
+                               [](const OSREntry& entry, size_t offset) { return entry.byteCodeOffset < offset; });
+
+    if (it == m_osrEntries.end() || it->byteCodeOffset != byteCodeOffset) {
+        return nullptr;
+    }
+
+    return it->u.address;
+}
+
+ByteCodeStackOffset* JITFunction::call(ExecutionState& state, Instance* instance, uint8_t* bp, void* entry) const
+{
+    ASSERT(m_exportEntry && entry);
 
     ExecutionContext context(m_module->instanceConstData(), state, instance);
-    Memory* memory0 = nullptr;
+    DirectCallFrameStack* stack = s_directCallFrameStack;
+    ExecutionContext* parentContext = stack != nullptr ? stack->currentContext : nullptr;
 
-    ByteCodeStackOffset* resultOffsets = m_module->exportCall()(&context, bp, m_exportEntry);
+    initDirectCallFrameStack(context, parentContext);
+    stack = s_directCallFrameStack;
+#ifdef ENABLE_GC
+    context.gcFreeLists = GCAllocator::current()->freeLists();
+#endif /* ENABLE_GC */
+    Store* store = instance->module()->store();
+    context.epochCounter = store->epochCounter();
+    context.epochDeadline = store->epochDeadlineAddress();
+    if (store->epochInterruption()) {
+        // Each context has its own buffer, since the deadline callback
+        // may enter compiled code again. It must live until the call returns.
+        context.epochSaveArea = reinterpret_cast<uint8_t*>(alloca(ExecutionContext::kEpochSaveAreaSize));
+    }
+    stack->currentContext = &context;
+
+    ByteCodeStackOffset* resultOffsets = m_module->exportCall()(&context, bp, entry);
+
+    stack->currentContext = parentContext;
 
     if (context.error != ExecutionContext::NoError) {
         switch (context.error) {
@@ -109,6 +441,9 @@ ByteCodeStackOffset* JITFunction::call(ExecutionState& state, Instance* instance
         case ExecutionContext::ExpectedSharedMemError:
             Trap::throwException(state, "expected shared memory");
             return resultOffsets;
+        case ExecutionContext::EpochDeadlineError:
+            Trap::throwException(state, "epoch deadline reached");
+            return resultOffsets;
         default:
             Trap::throwException(state, "unknown exception");
             return resultOffsets;
@@ -21,6 +21,8 @@
 #include "runtime/Instance.h"
 #include "runtime/Memory.h"
 
+struct sljit_label;
+
 namespace Walrus {
 
 class Exception;
@@ -54,6 +56,7 @@ struct ExecutionContext {
         UnreachableError,
         UnalignedAtomicError,
         ExpectedSharedMemError,
+        EpochDeadlineError,
 
         // These three in this order must be the last items of the list.
         GenericTrap, // Error code received in SLJIT_R0.
@@ -61,11 +64,28 @@ struct ExecutionContext {
         ErrorCodesEnd,
     };
 
+    // Size of the per-thread buffer which holds the frames of directly called functions.
+    static const size_t kDirectCallFrameStackSize = 1024 * 1024;
+
+    // Frees the buffer of the current thread before the thread exits.
+    static void releaseDirectCallFrameStack();
+
+    // Size of the buffer which keeps the scratch registers of a compiled
+    // function while the epoch deadline callback is running.
+    static const size_t kEpochSaveAreaSize = 64 * 16;
+
     ExecutionContext(InstanceConstData* currentInstanceConstData, ExecutionState& state, Instance* instance)
         : currentInstanceConstData(currentInstanceConstData)
         , state(state)
         , instance(instance)
         , capturedException(nullptr)
+        , stackLimit(state.stackLimit())
+        , frameStackTop(nullptr)
+        , frameStackEnd(nullptr)
+        , gcFreeLists(nullptr)
+        , epochCounter(nullptr)
+        , epochDeadline(nullptr)
+        , epochSaveArea(nullptr)
         , error(NoError)
     {
     }
@@ -81,6 +101,18 @@ struct ExecutionContext {
     ExecutionState& state;
     Instance* instance;
     Exception* capturedException;
+    // Fields accessed by direct calls between compiled functions.
+    size_t stackLimit;
+    uint8_t* frameStackTop;
+    uint8_t* frameStackEnd;
+    // Free lists of the GCAllocator of the current thread.
+    void** gcFreeLists;
+    // Checked by the CheckEpoch instructions of the current store.
+    const std::atomic<size_t>* epochCounter;
+    const std::atomic<size_t>* epochDeadline;
+    // Buffer of kEpochSaveAreaSize bytes, which is only
+    // allocated when the store has epoch interruption enabled.
+    uint8_t* epochSaveArea;
     ErrorCodes error;
 };
 
@@ -106,15 +138,40 @@ public:
 
     InstanceConstData* instanceConstData() { return m_instanceConstData; }
 
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    // Maps the faulting instructions of a function to its trap handler.
+    struct GuardPageTrap {
+        GuardPageTrap(uintptr_t start, uintptr_t end, uintptr_t handler)
+            : start(start)
+            , end(end)
+            , handler(handler)
+        {
+        }
+
+        uintptr_t start;
+        uintptr_t end;
+        uintptr_t handler;
+    };
+
+    void appendGuardPageTraps(const std::vector<GuardPageTrap>& traps);
+    void removeGuardPageTraps();
+    void collectGuardPageTraps(std::vector<GuardPageTrap>& traps) const;
+    static uintptr_t findGuardPageTrap(uintptr_t address);
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
+
 private:
     InstanceConstData* m_instanceConstData;
     void* m_moduleStart;
     // Does not include m_moduleStart code block
     std::vector<void*> m_codeBlocks;
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    std::vector<GuardPageTrap> m_guardPageTraps;
+#endif /* WALRUS_MEMORY_GUARD_PAGES */
 };
 
 class JITFunction {
     friend class JITCompiler;
+    friend class JITFieldAccessor;
 
 public:
     JITFunction()
@@ -132,12 +189,38 @@ public:
     }
 
     bool isCompiled() const { return m_exportEntry != nullptr; }
-    ByteCodeStackOffset* call(ExecutionState& state, Instance* instance, uint8_t* bp) const;
+    void* exportEntry() const { return m_exportEntry; }
+
+    ByteCodeStackOffset* call(ExecutionState& state, Instance* instance, uint8_t* bp) const
+    {
+        return call(state, instance, bp, m_exportEntry);
+    }
+
+    // Continues the execution of an interpreted function from a loop header.
+    ByteCodeStackOffset* call(ExecutionState& state, Instance* instance, uint8_t* bp, void* entry) const;
+    // Returns with nullptr, if the loop header at byteCodeOffset has no entry.
+    void* osrEntry(size_t byteCodeOffset) const;
 
 private:
+    struct OSREntry {
+        OSREntry(size_t byteCodeOffset, sljit_label* label)
+            : byteCodeOffset(byteCodeOffset)
+        {
+            u.label = label;
+        }
+
+        size_t byteCodeOffset;
+        union {
+            sljit_label* label;
+            void* address;
+        } u;
+    };
+
     void* m_exportEntry;
     void* m_constData;
     JITModule* m_module;
+    // Sorted by byte code offset.
+    std::vector<OSREntry> m_osrEntries;
 };
 
 } // namespace Walrus
@@ -20,24 +20,31 @@
 #include "runtime/Trap.h"
 #include "runtime/Instance.h"
 #include "runtime/Module.h"
+#include <mutex>
 
 #if defined(OS_POSIX)
 #define WALRUS_USE_MMAP
 #include <sys/mman.h>
+#if defined(__linux__)
+#define WALRUS_USE_MREMAP
+#endif
 #endif
 
 namespace Walrus {
 
 DEFINE_GLOBAL_TYPE_INFO(memoryTypeInfo, MemoryKind);
 
+// Shared memories can be grown and imported by multiple threads.
+static std::mutex g_sharedMemoryLock;
+
 Memory* Memory::createMemory(Store* store, uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isShared, bool is64)
 {
-    Memory* mem = new Memory(initialSizeInByte, maximumSizeInByte, isShared, is64);
+    Memory* mem = new Memory(initialSizeInByte, maximumSizeInByte, isShared, is64, store->useMemoryGuardPages());
     store->appendExtern(mem);
     return mem;
 }
 
-Memory::Memory(uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isShared, bool is64)
+Memory::Memory(uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isShared, bool is64, bool useGuardPages)
     : Extern(GET_GLOBAL_TYPE_INFO(memoryTypeInfo))
     , m_sizeInByte(initialSizeInByte)
     , m_reservedSizeInByte(0)
@@ -46,15 +53,35 @@ Memory::Memory(uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isSh
     , m_targetBuffers(nullptr)
     , m_isShared(isShared)
     , m_is64(is64)
+    , m_hasGuardPages(false)
 {
     RELEASE_ASSERT(initialSizeInByte <= std::numeric_limits<size_t>::max());
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    if (useGuardPages && !is64) {
+        // The buffer is never moved, since the maximum size of 32 bit memories is 4GB.
+        // Accesses outside of the accessible part are caught by the signal handler
+        // of the JIT, which converts them to out of bounds traps.
+        ASSERT(m_maximumSizeInByte <= (static_cast<uint64_t>(1) << 32));
+        m_reservedSizeInByte = s_guardPagesReservedSize;
+        m_buffer = reinterpret_cast<uint8_t*>(mmap(NULL, m_reservedSizeInByte, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+        RELEASE_ASSERT(MAP_FAILED != m_buffer);
+        if (initialSizeInByte > 0) {
+            mprotect(m_buffer, initialSizeInByte, (PROT_READ | PROT_WRITE));
+        }
+        m_hasGuardPages = true;
+        return;
+    }
+#else
+    UNUSED_PARAMETER(useGuardPages);
+#endif
 #if defined(WALRUS_USE_MMAP)
     if (m_maximumSizeInByte) {
 #ifndef WALRUS_32_MEMORY_INITIAL_MMAP_RESERVED_ADDRESS_SIZE
 #define WALRUS_32_MEMORY_INITIAL_MMAP_RESERVED_ADDRESS_SIZE (1024 * 1024 * 64)
 #endif
 #ifndef WALRUS_64_MEMORY_INITIAL_MMAP_RESERVED_ADDRESS_SIZE
-#define WALRUS_64_MEMORY_INITIAL_MMAP_RESERVED_ADDRESS_SIZE (1024 * 1024 * 512)
+// Large enough for any 32 bit memory, so their buffer is never moved.
+#define WALRUS_64_MEMORY_INITIAL_MMAP_RESERVED_ADDRESS_SIZE (1024ULL * 1024 * 1024 * 8)
 #endif
         uint64_t initialReservedSize =
 #if defined(WALRUS_32)
@@ -62,8 +89,19 @@ Memory::Memory(uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isSh
 #else
             WALRUS_64_MEMORY_INITIAL_MMAP_RESERVED_ADDRESS_SIZE;
 #endif
+        if (isShared && !is64) {
+            // Other threads may access the buffer, so it is never moved.
+            initialReservedSize = m_maximumSizeInByte;
+        }
         m_reservedSizeInByte = std::min(std::max(initialReservedSize, initialSizeInByte), m_maximumSizeInByte);
-        m_buffer = reinterpret_cast<uint8_t*>(mmap(NULL, m_reservedSizeInByte, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        // Only the accessible part of the reservation consumes memory.
+        m_buffer = reinterpret_cast<uint8_t*>(mmap(NULL, m_reservedSizeInByte, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+        while (MAP_FAILED == m_buffer && isShared && m_reservedSizeInByte > initialSizeInByte) {
+            // The address space may be too small for the maximum size (e.g. on 32 bit
+            // hosts). A smaller reservation limits how far the shared memory can grow.
+            m_reservedSizeInByte = std::max((m_reservedSizeInByte / 2) & ~static_cast<uint64_t>(s_memoryPageSize - 1), initialSizeInByte);
+            m_buffer = reinterpret_cast<uint8_t*>(mmap(NULL, m_reservedSizeInByte, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+        }
         RELEASE_ASSERT(MAP_FAILED != m_buffer);
         mprotect(m_buffer, initialSizeInByte, (PROT_READ | PROT_WRITE));
     } else {
@@ -91,6 +129,11 @@ Memory::~Memory()
 
 bool Memory::grow(uint64_t growSizeInByte)
 {
+    std::unique_lock<std::mutex> lock(g_sharedMemoryLock, std::defer_lock);
+    if (m_isShared) {
+        lock.lock();
+    }
+
     uint64_t newSizeInByte = growSizeInByte + m_sizeInByte;
     if (newSizeInByte > m_sizeInByte && newSizeInByte <= m_maximumSizeInByte) {
 #if defined(WALRUS_USE_MMAP)
@@ -98,11 +141,27 @@ bool Memory::grow(uint64_t growSizeInByte)
             mprotect(m_buffer + m_sizeInByte, growSizeInByte, (PROT_READ | PROT_WRITE));
             m_sizeInByte = newSizeInByte;
         } else {
+            if (m_isShared) {
+                // Other threads may access the buffer, so it cannot be moved.
+                return false;
+            }
+
             auto newReservedSizeInByte = std::min(newSizeInByte * 2, m_maximumSizeInByte);
-            auto newBuffer = reinterpret_cast<uint8_t*>(mmap(NULL, newReservedSizeInByte, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            auto newBuffer = reinterpret_cast<uint8_t*>(mmap(NULL, newReservedSizeInByte, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
             if (MAP_FAILED == newBuffer) {
                 return false;
             }
+#if defined(WALRUS_USE_MREMAP)
+            // Move the pages into the new reservation without copying them.
+            if (m_sizeInByte > 0 && mremap(m_buffer, m_sizeInByte, m_sizeInByte, MREMAP_MAYMOVE | MREMAP_FIXED, newBuffer) == MAP_FAILED) {
+                munmap(newBuffer, newReservedSizeInByte);
+                return false;
+            }
+            if (m_reservedSizeInByte > m_sizeInByte) {
+                munmap(m_buffer + m_sizeInByte, m_reservedSizeInByte - m_sizeInByte);
+            }
+            mprotect(newBuffer + m_sizeInByte, growSizeInByte, (PROT_READ | PROT_WRITE));
+#else /* !WALRUS_USE_MREMAP */
             mprotect(newBuffer, newSizeInByte, (PROT_READ | PROT_WRITE));
 
             // Slower copy than memcpy, but reduces the memory peak increase.
@@ -139,6 +198,10 @@ bool Memory::grow(uint64_t growSizeInByte)
                 dst++;
             }
             munmap(start, reinterpret_cast<uint8_t*>(bufferEnd) - start);
+            if (m_reservedSizeInByte > m_sizeInByte) {
+                munmap(bufferEnd, m_reservedSizeInByte - m_sizeInByte);
+            }
+#endif /* WALRUS_USE_MREMAP */
 
             m_buffer = newBuffer;
             m_sizeInByte = newSizeInByte;
@@ -296,6 +359,11 @@ void Memory::fillMemory(size_t start, uint8_t value, size_t size)
 
 void Memory::TargetBuffer::enque(Memory* memory)
 {
+    std::unique_lock<std::mutex> lock(g_sharedMemoryLock, std::defer_lock);
+    if (memory->isShared()) {
+        lock.lock();
+    }
+
     next = memory->m_targetBuffers;
     buffer = memory->buffer();
     sizeInByte = memory->sizeInByte();
@@ -310,6 +378,11 @@ void Memory::TargetBuffer::deque(Memory* memory)
         return;
     }
 
+    std::unique_lock<std::mutex> lock(g_sharedMemoryLock, std::defer_lock);
+    if (memory->isShared()) {
+        lock.lock();
+    }
+
     TargetBuffer* current = memory->m_targetBuffers;
 
     if (current == this) {
@@ -36,6 +36,10 @@ public:
     static const uint64_t s_maxMemory64Grow = ~static_cast<uint64_t>(0) / s_memoryPageSize;
     static const uint64_t s_maxMemory64 = ~static_cast<uint64_t>(0);
     static const uint32_t s_maxMemory32 = ~static_cast<uint32_t>(0);
+#if defined(WALRUS_MEMORY_GUARD_PAGES)
+    // Any 32 bit address plus any 32 bit constant offset (and the access size) is inside this region.
+    static const uint64_t s_guardPagesReservedSize = (static_cast<uint64_t>(1) << 33) + s_memoryPageSize;
+#endif
 
     // Caching memory target for fast access.
     struct TargetBuffer {
@@ -97,6 +101,17 @@ public:
         return m_is64;
     }
 
+    bool hasGuardPages() const
+    {
+        return m_hasGuardPages;
+    }
+
+    // True when the address is inside the reserved address range of the memory.
+    bool isReservedAddress(uintptr_t address) const
+    {
+        return address - reinterpret_cast<uintptr_t>(m_buffer) < m_reservedSizeInByte;
+    }
+
     bool grow(uint64_t growSizeInByte);
 
     template <typename T>
@@ -297,44 +312,7 @@ public:
     template <typename T>
     void atomicWait(ExecutionState& state, Store* store, uint8_t* absoluteAddress, const T& expect, int64_t timeOut, uint32_t* out) const
     {
-        T read;
-        atomicLoad(state, absoluteAddress - m_buffer, 0, &read);
-        if (read != expect) {
-            // "not-equal", the loaded value did not match the expected value
-            *out = 1;
-        } else {
-            // wait process
-            bool notified = false;
-            Waiter* waiter = store->getWaiter(static_cast<void*>(absoluteAddress));
-
-            // lock waiter
-            std::unique_lock<std::mutex> lock(waiter->m_mutex);
-
-            Waiter::WaiterItem* item = new Waiter::WaiterItem(waiter);
-            waiter->m_waiterItemList.push_back(item);
-
-            // wait
-            notified = (waiter->m_condition.wait_for(lock, std::chrono::nanoseconds(timeOut)) == std::cv_status::no_timeout);
-
-            ASSERT(std::find(waiter->m_waiterItemList.begin(), waiter->m_waiterItemList.end(), item) != waiter->m_waiterItemList.end());
-            auto iter = waiter->m_waiterItemList.begin();
-            while (iter != waiter->m_waiterItemList.end()) {
-                if (*iter == item) {
-                    waiter->m_waiterItemList.erase(iter);
-                    break;
-                }
-                iter++;
-            }
-            delete item;
-
-            if (notified) {
-                // "ok", woken by another agent in the cluster
-                *out = 0;
-            } else {
-                // "timed-out", not woken before timeout expired
-                *out = 2;
-            }
-        }
+        *out = store->waiterTable().wait(absoluteAddress, expect, timeOut);
     }
 
     void atomicNotify(ExecutionState& state, Store* store, uint32_t offset, uint32_t addend, const uint32_t& count, uint32_t* out) const
@@ -361,17 +339,7 @@ public:
 
     void atomicNotify(Store* store, uint8_t* absoluteAddress, const uint32_t& count, uint32_t* out) const
     {
-        Waiter* waiter = store->getWaiter(static_cast<void*>(absoluteAddress));
-
-        waiter->m_mutex.lock();
-        uint32_t realCount = std::min(waiter->m_waiterItemList.size(), (size_t)count);
-
-        for (uint32_t i = 0; i < realCount; i++) {
-            waiter->m_waiterItemList[i]->m_waiter->m_condition.notify_one();
-        }
-
-        waiter->m_mutex.unlock();
-        *out = realCount;
+        *out = store->waiterTable().notify(absoluteAddress, count);
     }
 
 #ifdef CPU_ARM32
@@ -424,7 +392,7 @@ public:
     void fillMemory(size_t start, uint8_t value, size_t size);
 
 private:
-    Memory(uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isShared, bool is64);
+    Memory(uint64_t initialSizeInByte, uint64_t maximumSizeInByte, bool isShared, bool is64, bool useGuardPages);
 
     void throwRangeException(ExecutionState& state, uint32_t offset, uint32_t addend, uint32_t size) const;
 
@@ -478,6 +446,7 @@ private:
     TargetBuffer* m_targetBuffers;
     bool m_isShared;
     bool m_is64;
+    bool m_hasGuardPages;
 };
 
 } // namespace Walrus
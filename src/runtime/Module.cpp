@@ -40,6 +40,9 @@ ModuleFunction::ModuleFunction(FunctionType* functionType)
     , m_functionType(functionType)
 #if defined(WALRUS_ENABLE_JIT)
     , m_jitFunction(nullptr)
+    , m_tierUpCounter(0)
+    , m_inlineStackStart(0)
+    , m_inlineStackSize(0)
 #endif
 {
 }
@@ -50,6 +53,7 @@ Module::Module(Store* store, WASMParsingResult& result)
     , m_seenStartAttribute(result.m_seenStartAttribute)
     , m_version(result.m_version)
     , m_start(result.m_start)
+    , m_byteCodeFlags(result.m_byteCodeFlags)
     , m_imports(std::move(result.m_imports))
     , m_exports(std::move(result.m_exports))
     , m_functions(std::move(result.m_functions))
@@ -62,6 +66,7 @@ Module::Module(Store* store, WASMParsingResult& result)
     , m_tagTypes(std::move(result.m_tagTypes))
 #if defined(WALRUS_ENABLE_JIT)
     , m_jitModule(nullptr)
+    , m_tieredJITFlags(0)
 #endif
 {
     store->appendModule(this);
@@ -70,12 +75,62 @@ Module::Module(Store* store, WASMParsingResult& result)
 ModuleFunction::~ModuleFunction()
 {
 #if defined(WALRUS_ENABLE_JIT)
-    if (m_jitFunction != nullptr) {
-        delete m_jitFunction;
+    JITFunction* jitFunction = m_jitFunction.load();
+
+    if (jitFunction != nullptr) {
+        delete jitFunction;
     }
 #endif
 }
 
+std::string Module::symbolName(ModuleFunction* function)
+{
+    if (!function->name().empty()) {
+        return function->name();
+    }
+
+    size_t size = numberOfFunctions();
+    size_t functionIndex = 0;
+
+    for (size_t i = 0; i < size; i++) {
+        if (m_functions[i] == function) {
+            functionIndex = i;
+            break;
+        }
+    }
+
+    std::string name = "function" + std::to_string(functionIndex);
+    for (auto exp : m_exports) {
+        if (exp->exportType() != ExportType::Function) {
+            continue;
+        }
+        if (m_functions[exp->itemIndex()] == function) {
+            name += "_" + exp->name();
+            break;
+        }
+    }
+    return name;
+}
+
+uint32_t ModuleFunction::codeOffset(size_t byteCodePosition) const
+{
+    // Binary search for the last pair which starts before the position.
+    size_t begin = 0;
+    size_t end = m_codeOffsets.size();
+
+    while (begin < end) {
+        size_t middle = (begin + end) / 2;
+
+        if (m_codeOffsets[middle].first <= byteCodePosition) {
+            begin = middle + 1;
+        } else {
+            end = middle;
+        }
+    }
+
+    return begin > 0 ? m_codeOffsets[begin - 1].second : 0;
+}
+
 Module::~Module()
 {
     // Types are freed by the type store.
@@ -318,7 +373,13 @@ Instance* Module::instantiate(ExecutionState& state, const ExternVector& imports
         Element* elem = m_elements[i];
         const auto& exprs = elem->exprFunctions();
 
-        new (instance->m_elementSegments + i) ElementSegment(exprs.size());
+        // The type of the segment is the result type of its expressions.
+        Type elementType;
+        if (exprs.size() > 0) {
+            elementType = Type(exprs[0]->functionType()->result().types()[0], nullptr);
+        }
+
+        new (instance->m_elementSegments + i) ElementSegment(exprs.size(), elementType);
         void** result = instance->m_elementSegments[i].elements();
 
         for (size_t j = 0; j < exprs.size(); j++) {
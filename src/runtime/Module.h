@@ -20,6 +20,8 @@
 #include "runtime/ObjectType.h"
 #include "runtime/Object.h"
 
+#include <atomic>
+
 namespace wabt {
 class WASMBinaryReader;
 class WASMComponentBinaryReader;
@@ -40,6 +42,21 @@ enum JITFlagValue : uint32_t {
     JITVerbose = 1 << 1,
     JITVerboseColor = 1 << 2,
     disableRegAlloc = 1 << 3,
+    // Functions are interpreted first, and compiled in the background when they become hot.
+    tieredJIT = 1 << 4,
+    // Symbols of the compiled functions are written to /tmp/perf-<pid>.map.
+    perfMap = 1 << 5,
+    // Compiled code and its wasm code offsets are written to a jitdump file.
+    perfJITDump = 1 << 6,
+};
+
+// Options of the parser which change the generated byte code. Serialized
+// byte code is only reused when it was generated with the same options.
+enum ByteCodeFlagValue : uint32_t {
+    byteCodeForJIT = 1 << 0,
+    byteCodeEpochChecks = 1 << 1,
+    byteCodeCodeOffsets = 1 << 2,
+    byteCodeFunctionNames = 1 << 3,
 };
 
 enum class SegmentMode {
@@ -202,6 +219,8 @@ private:
 
 class ModuleFunction {
     friend class wabt::WASMBinaryReader;
+    friend class JITFieldAccessor;
+    friend class ModuleSerializer;
 
 public:
     struct CatchInfo {
@@ -216,8 +235,10 @@ public:
     ~ModuleFunction();
 
     bool hasTryCatch() const { return m_hasTryCatch; }
-    uint16_t requiredStackSize() const { return m_requiredStackSize; }
+    uint32_t requiredStackSize() const { return m_requiredStackSize; }
     FunctionType* functionType() const { return m_functionType; }
+    // Name from the name section, empty when it is not read.
+    const std::string& name() const { return m_name; }
 
     const uint8_t* byteCode() const { return m_byteCode.data(); }
 
@@ -241,22 +262,80 @@ public:
         return m_catchInfo;
     }
 
+    // Returns with the wasm code offset of the instruction which generated
+    // the byte code at the position, or 0 when the offsets are not recorded.
+    uint32_t codeOffset(size_t byteCodePosition) const;
+
+#ifdef ENABLE_GC
+    typedef std::pair<uint32_t, uint32_t> ReferenceRange;
+
+    // Byte ranges of the frame which may hold references. Only these
+    // ranges of the frame are scanned by the garbage collector. The
+    // ranges are derived from the types of the slots, not from their
+    // liveness, so a dead reference slot may keep an object alive until
+    // the slot is overwritten or the frame is popped. A per-instruction
+    // liveness map would need a safepoint table for every call site.
+    const Vector<ReferenceRange, std::allocator<ReferenceRange>>& referenceRanges() const
+    {
+        return m_referenceRanges;
+    }
+#endif
+
 #if defined(WALRUS_ENABLE_JIT)
+    // Frame area of the function which holds the frames of the inlined
+    // callees. Reserved before the module is executed or compiled.
+    uint32_t inlineStackStart() const { return m_inlineStackStart; }
+    uint32_t inlineStackSize() const { return m_inlineStackSize; }
+
+    void reserveInlineStack(uint32_t size)
+    {
+        ASSERT(m_inlineStackSize == 0 && size > 0);
+        m_inlineStackStart = (m_requiredStackSize + 0xf) & ~static_cast<uint32_t>(0xf);
+        m_inlineStackSize = size;
+        m_requiredStackSize = m_inlineStackStart + size;
+    }
+
+    // The JIT function may be set by a background thread, and it
+    // is only set after the function is completely compiled.
     void setJITFunction(JITFunction* jitFunction)
     {
-        ASSERT(m_jitFunction == nullptr);
-        m_jitFunction = jitFunction;
+        ASSERT(m_jitFunction.load(std::memory_order_relaxed) == nullptr);
+        m_jitFunction.store(jitFunction, std::memory_order_release);
     }
 
     JITFunction* jitFunction()
     {
-        return m_jitFunction;
+        return m_jitFunction.load(std::memory_order_acquire);
+    }
+
+    // The threshold is the number of calls and loop iterations
+    // before the interpreted function is compiled.
+    void enableTierUpCounter(uint32_t threshold)
+    {
+        ASSERT(threshold > 0);
+        m_tierUpCounter.store(threshold, std::memory_order_relaxed);
+    }
+
+    // Returns true when the function becomes hot. The counter stops at zero, so
+    // only one of the threads running the function sees the 1 -> 0 transition.
+    bool countTierUpEvent()
+    {
+        uint32_t counter = m_tierUpCounter.load(std::memory_order_relaxed);
+
+        do {
+            if (LIKELY(counter == 0)) {
+                // Counter is disabled, or the function is already hot.
+                return false;
+            }
+        } while (!m_tierUpCounter.compare_exchange_weak(counter, counter - 1, std::memory_order_relaxed));
+
+        return counter == 1;
     }
 #endif
 
 private:
     bool m_hasTryCatch;
-    uint16_t m_requiredStackSize;
+    uint32_t m_requiredStackSize;
     FunctionType* m_functionType;
     ValueTypeVector m_local;
     VectorWithFixedSize<uint8_t, std::allocator<uint8_t>> m_byteCode;
@@ -265,8 +344,18 @@ private:
     Vector<std::pair<Value, size_t>, std::allocator<std::pair<Value, size_t>>> m_constantDebugData;
 #endif
     Vector<CatchInfo, std::allocator<CatchInfo>> m_catchInfo;
+    // Pairs of byte code positions and wasm code offsets ordered by the
+    // positions. Only recorded for the jitdump output and the profiler.
+    Vector<std::pair<uint32_t, uint32_t>, std::allocator<std::pair<uint32_t, uint32_t>>> m_codeOffsets;
+    std::string m_name;
+#ifdef ENABLE_GC
+    Vector<ReferenceRange, std::allocator<ReferenceRange>> m_referenceRanges;
+#endif
 #if defined(WALRUS_ENABLE_JIT)
-    JITFunction* m_jitFunction;
+    std::atomic<JITFunction*> m_jitFunction;
+    std::atomic<uint32_t> m_tierUpCounter;
+    uint32_t m_inlineStackStart;
+    uint32_t m_inlineStackSize;
 #endif
 };
 
@@ -354,6 +443,7 @@ class Module : public Object {
     friend class wabt::WASMComponentBinaryReader;
     friend class JITCompiler;
     friend class Store;
+    friend class ModuleSerializer;
 
 public:
     Module(Store* store, WASMParsingResult& result);
@@ -452,20 +542,41 @@ public:
 
     void postParsing();
 
+    // Combination of ByteCodeFlagValue bits used by the parser.
+    uint32_t byteCodeFlags() const
+    {
+        return m_byteCodeFlags;
+    }
+
+    // Name of the function in profiles: the name from the name section
+    // when it is read, otherwise the index and the first export name.
+    std::string symbolName(ModuleFunction* function);
+
     Instance* instantiate(ExecutionState& state, const ExternVector& imports);
 
 #if defined(WALRUS_ENABLE_JIT)
     /* Passing 0 as functionsLength compiles all functions. */
     void jitCompile(ModuleFunction** functions, size_t functionsLength, uint32_t JITFlags);
+
+    // Functions are compiled by the tiered compiler of the store after they become hot.
+    void enableTieredCompilation(uint32_t JITFlags);
+    uint32_t tieredJITFlags() const { return m_tieredJITFlags; }
+    void tierUp(ModuleFunction* function);
 #endif
 
 private:
+#if defined(WALRUS_ENABLE_JIT)
+    void jitCompileFunctions(ModuleFunction** functions, size_t functionsLength, uint32_t JITFlags);
+    void reserveInlineStacks();
+#endif
+
     ~Module();
 
     Store* m_store;
     bool m_seenStartAttribute;
     uint32_t m_version;
     uint32_t m_start;
+    uint32_t m_byteCodeFlags;
 
     VectorWithFixedSize<ImportType*, std::allocator<ImportType*>> m_imports;
     VectorWithFixedSize<ExportType*, std::allocator<ExportType*>> m_exports;
@@ -482,6 +593,7 @@ private:
     TagTypeVector m_tagTypes;
 #if defined(WALRUS_ENABLE_JIT)
     JITModule* m_jitModule;
+    uint32_t m_tieredJITFlags;
 #endif
 };
 
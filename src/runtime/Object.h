@@ -18,6 +18,7 @@
 #define __WalrusObject__
 
 #include "util/Vector.h"
+#include <atomic>
 
 namespace Walrus {
 
@@ -180,7 +181,7 @@ class Extern : public Object {
 public:
 #ifndef NDEBUG
     // count the total number of created Extern objects
-    static size_t g_externCount;
+    static std::atomic<size_t> g_externCount;
 #endif
 
     virtual ~Extern()
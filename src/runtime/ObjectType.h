@@ -164,6 +164,7 @@ public:
         , m_resultTypes(resultTypesCount, resultRefsCount)
         , m_paramStackSize(0)
         , m_resultStackSize(0)
+        , m_typeID(0)
     {
     }
 
@@ -174,6 +175,7 @@ public:
         , m_resultTypes(resultTypesCount, resultRefsCount)
         , m_paramStackSize(0)
         , m_resultStackSize(0)
+        , m_typeID(0)
     {
     }
 
@@ -183,6 +185,7 @@ public:
         , m_resultTypes(1, 0)
         , m_paramStackSize(0)
         , m_resultStackSize(valueStackAllocatedSize(type))
+        , m_typeID(0)
     {
         m_resultTypes.setType(0, type);
     }
@@ -206,11 +209,16 @@ public:
 
     bool equals(const FunctionType* other, bool isSubType = false) const;
 
+    // Canonical function types of a store have unique, non-zero IDs, so
+    // two types are equal if their IDs are the same non-zero value.
+    uint32_t typeID() const { return m_typeID; }
+
 private:
     TypeVector m_paramTypes;
     TypeVector m_resultTypes;
     size_t m_paramStackSize;
     size_t m_resultStackSize;
+    uint32_t m_typeID;
 
     static size_t computeStackSize(const TypeVector& v)
     {
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Walrus.h"
+
+#include "runtime/Profiler.h"
+
+#if defined(WALRUS_ENABLE_PROFILER)
+#include "runtime/ExecutionState.h"
+#include "runtime/Function.h"
+#include "runtime/Instance.h"
+#include "runtime/Module.h"
+#include "interpreter/ValueStack.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <errno.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace Walrus {
+
+#if defined(WALRUS_ENABLE_PROFILER)
+
+struct ProfilerSample {
+    static const size_t kMaxDepth = 64;
+    // Byte code position of frames running compiled code.
+    static const size_t kUnknownPosition = SIZE_MAX;
+
+    enum State : uint32_t {
+        Empty,
+        Writing,
+        Ready,
+    };
+
+    struct Frame {
+        // Both are nullptr for host functions.
+        Module* module;
+        ModuleFunction* function;
+        size_t position;
+    };
+
+    std::atomic<uint32_t> state;
+    uint32_t depth;
+    // The outermost frames did not fit into the sample.
+    bool truncated;
+    // Innermost frame first.
+    Frame frames[kMaxDepth];
+};
+
+// The samples are written by the signal handler, and merged into
+// folded stacks by a background thread.
+class ProfilerData {
+public:
+    static const size_t kSampleCount = 256;
+    static const int kMergeInterval = 50; // milliseconds
+
+    ProfilerData(FILE* file)
+        : m_file(file)
+        , m_nextSample(0)
+        , m_droppedSamples(0)
+        , m_stopping(false)
+    {
+        for (size_t i = 0; i < kSampleCount; i++) {
+            m_samples[i].state.store(ProfilerSample::Empty, std::memory_order_relaxed);
+        }
+
+        m_mergeThread = std::thread([this] {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            while (!m_stopping) {
+                m_condition.wait_for(lock, std::chrono::milliseconds(kMergeInterval));
+                merge();
+            }
+        });
+    }
+
+    // Returns with nullptr when every sample is in use.
+    ProfilerSample* reserveSample()
+    {
+        size_t index = m_nextSample.fetch_add(1, std::memory_order_relaxed) % kSampleCount;
+        ProfilerSample& sample = m_samples[index];
+        uint32_t expected = ProfilerSample::Empty;
+
+        if (!sample.state.compare_exchange_strong(expected, ProfilerSample::Writing, std::memory_order_acquire)) {
+            m_droppedSamples.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &sample;
+    }
+
+    // Writes the profile. No samples can be taken anymore.
+    void finish()
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_one();
+        m_mergeThread.join();
+
+        merge();
+
+        for (auto& stack : m_stacks) {
+            fprintf(m_file, "%s %zu\n", stack.first.c_str(), stack.second);
+        }
+
+        size_t droppedSamples = m_droppedSamples.load(std::memory_order_relaxed);
+        if (droppedSamples > 0) {
+            fprintf(m_file, "[dropped] %zu\n", droppedSamples);
+        }
+
+        fclose(m_file);
+    }
+
+private:
+    const std::string& label(const ProfilerSample::Frame& frame)
+    {
+        static const std::string hostLabel("[host]");
+
+        if (frame.function == nullptr) {
+            return hostLabel;
+        }
+
+        auto it = m_labels.find(frame.function);
+        if (it == m_labels.end()) {
+            it = m_labels.insert(std::make_pair(frame.function, frame.module->symbolName(frame.function))).first;
+        }
+        return it->second;
+    }
+
+    void merge()
+    {
+        for (size_t i = 0; i < kSampleCount; i++) {
+            ProfilerSample& sample = m_samples[i];
+
+            if (sample.state.load(std::memory_order_acquire) != ProfilerSample::Ready) {
+                continue;
+            }
+
+            std::string stack(sample.truncated ? "[truncated]" : "");
+
+            for (size_t j = sample.depth; j > 0; j--) {
+                if (!stack.empty()) {
+                    stack += ';';
+                }
+                stack += label(sample.frames[j - 1]);
+            }
+
+            // The sampled instruction is an extra frame above its function,
+            // so the hot instructions are shown inside the function.
+            const ProfilerSample::Frame& leaf = sample.frames[0];
+            if (leaf.function != nullptr && leaf.position != ProfilerSample::kUnknownPosition) {
+                uint32_t offset = leaf.function->codeOffset(leaf.position);
+
+                if (offset != 0) {
+                    char buffer[16];
+                    snprintf(buffer, sizeof(buffer), "+0x%x", offset);
+                    stack += ';';
+                    stack += label(leaf);
+                    stack += buffer;
+                }
+            }
+
+            sample.state.store(ProfilerSample::Empty, std::memory_order_release);
+            m_stacks[stack]++;
+        }
+    }
+
+    FILE* m_file;
+    ProfilerSample m_samples[kSampleCount];
+    std::atomic<size_t> m_nextSample;
+    std::atomic<size_t> m_droppedSamples;
+
+    std::thread m_mergeThread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+
+    // Only accessed by the merging thread.
+    std::map<std::string, size_t> m_stacks;
+    std::unordered_map<ModuleFunction*, std::string> m_labels;
+};
+
+static std::mutex s_profilerLock;
+static std::atomic<ProfilerData*> s_profiler;
+// Signal handlers which may still use the profiler data.
+static std::atomic<uint32_t> s_activeHandlerCount;
+static bool s_signalHandlerInstalled;
+
+void Profiler::signalHandler(int signal)
+{
+    int savedErrno = errno;
+
+    s_activeHandlerCount.fetch_add(1);
+    ProfilerData* profiler = s_profiler.load();
+
+    if (profiler != nullptr) {
+        ProfilerSample* sample = profiler->reserveSample();
+
+        if (sample != nullptr) {
+            takeSample(*sample);
+            // Samples taken outside of wasm code are not recorded.
+            sample->state.store(sample->depth > 0 ? ProfilerSample::Ready : ProfilerSample::Empty, std::memory_order_release);
+        }
+    }
+
+    s_activeHandlerCount.fetch_sub(1);
+    errno = savedErrno;
+}
+
+void Profiler::takeSample(ProfilerSample& sample)
+{
+    // Runs in a signal handler: nothing is allocated, and only
+    // the states and frames of the interrupted thread are read.
+    // The walk follows the parents of the innermost linked state,
+    // so unlinked states are only missed when they are innermost.
+    Optional<ExecutionState*> state = ExecutionState::s_current;
+    ValueStack* stack = ValueStack::currentIfExists();
+    ValueStack::Frame* frame = stack != nullptr ? stack->currentFrame() : nullptr;
+    size_t depth = 0;
+
+    sample.truncated = false;
+
+    for (; state; state = state->m_parent) {
+        if (!state->m_currentFunction) {
+            continue;
+        }
+
+        if (state->m_currentFunction->kind() != Function::DefinedFunctionKind) {
+            if (depth == ProfilerSample::kMaxDepth) {
+                sample.truncated = true;
+                break;
+            }
+            sample.frames[depth++] = { nullptr, nullptr, ProfilerSample::kUnknownPosition };
+            continue;
+        }
+
+        // The state entered the interpreter or compiled code, and the
+        // calls between interpreted functions are linked on the value stack.
+        bool hasProgramCounter = state->m_programCounterPointer.hasValue();
+        size_t programCounter = hasProgramCounter ? *state->m_programCounterPointer.value() : 0;
+
+        while (frame != nullptr && depth < ProfilerSample::kMaxDepth) {
+            ModuleFunction* moduleFunction = frame->function->moduleFunction();
+            size_t position = programCounter - reinterpret_cast<size_t>(moduleFunction->byteCode());
+
+            // The program counter may belong to the caller while a call is in progress.
+            if (!hasProgramCounter || position >= moduleFunction->byteCodeSize()) {
+                position = ProfilerSample::kUnknownPosition;
+            }
+
+            sample.frames[depth++] = { frame->function->instance()->module(), moduleFunction, position };
+
+            if (frame->parent == nullptr) {
+                break;
+            }
+
+            programCounter = frame->returnProgramCounter;
+            hasProgramCounter = true;
+            frame = frame->parent;
+        }
+
+        if (depth == ProfilerSample::kMaxDepth) {
+            sample.truncated = true;
+            break;
+        }
+
+        frame = reinterpret_cast<ValueStack::Frame*>(state->m_callerFrame);
+    }
+
+    sample.depth = static_cast<uint32_t>(depth);
+}
+
+bool Profiler::start(const char* fileName, uint32_t interval)
+{
+    std::lock_guard<std::mutex> guard(s_profilerLock);
+
+    if (s_profiler.load() != nullptr) {
+        return false;
+    }
+
+    FILE* file = fopen(fileName, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    if (!s_signalHandlerInstalled) {
+        // The handler is never removed, since a signal which
+        // is still pending would terminate the process.
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = signalHandler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+
+        if (sigaction(SIGPROF, &action, nullptr) != 0) {
+            fclose(file);
+            return false;
+        }
+        s_signalHandlerInstalled = true;
+    }
+
+    if (interval == 0) {
+        interval = kDefaultInterval;
+    }
+
+    s_profiler.store(new ProfilerData(file));
+    ExecutionState::s_isProfiling.store(true);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = interval / 1000000;
+    timer.it_interval.tv_usec = interval % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    return true;
+}
+
+void Profiler::stop()
+{
+    std::lock_guard<std::mutex> guard(s_profilerLock);
+    ProfilerData* profiler = s_profiler.load();
+
+    if (profiler == nullptr) {
+        return;
+    }
+
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    s_profiler.store(nullptr);
+    ExecutionState::s_isProfiling.store(false);
+    while (s_activeHandlerCount.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    profiler->finish();
+    delete profiler;
+}
+
+bool Profiler::isRunning()
+{
+    return s_profiler.load() != nullptr;
+}
+
+#else
+
+bool Profiler::start(const char* fileName, uint32_t interval)
+{
+    return false;
+}
+
+void Profiler::stop()
+{
+}
+
+bool Profiler::isRunning()
+{
+    return false;
+}
+
+#endif
+
+} // namespace Walrus
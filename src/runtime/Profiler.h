@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WalrusProfiler__
+#define __WalrusProfiler__
+
+#if defined(__linux__) || defined(__APPLE__)
+#define WALRUS_ENABLE_PROFILER
+#endif
+
+namespace Walrus {
+
+struct ProfilerSample;
+
+// Sampling profiler of the wasm call stacks. A CPU time timer signal
+// interrupts the running thread, and the signal handler walks the
+// execution states and the value stack frames of that thread. Interpreted
+// frames are recorded with their byte code positions, while compiled code
+// is attributed to the function which entered it. The functions called
+// directly by compiled code have no execution state, so they are missing
+// from the stacks. The execution states are only tracked while the
+// profiler is running, so the first samples may miss the states which
+// were created before it was started. A background thread merges the
+// samples, and the profile is written in the folded stack format of the
+// flamegraph tools when the profiler is stopped. Modules must not be
+// released while the profiler is running.
+class Profiler {
+public:
+    // Sampling period in microseconds of CPU time.
+    static const uint32_t kDefaultInterval = 1000;
+
+    // Returns false when the profiler is already running, the file
+    // cannot be created, or the platform is not supported.
+    static bool start(const char* fileName, uint32_t interval = kDefaultInterval);
+    // Stops sampling and writes the profile. Does nothing when
+    // the profiler is not running.
+    static void stop();
+    static bool isRunning();
+
+private:
+    static void signalHandler(int signal);
+    static void takeSample(ProfilerSample& sample);
+};
+
+} // namespace Walrus
+
+#endif // __WalrusProfiler__
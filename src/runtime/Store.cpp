@@ -16,11 +16,14 @@
 #include "Walrus.h"
 
 #include "runtime/Store.h"
+#include "runtime/Engine.h"
+#include "runtime/GCStats.h"
 #include "runtime/Module.h"
 #include "runtime/Instance.h"
 #include "runtime/Component.h"
 #include "runtime/ComponentInstance.h"
 #include "runtime/ObjectType.h"
+#include "runtime/TieredCompiler.h"
 
 #ifdef ENABLE_GC
 #include "GCUtil.h"
@@ -29,7 +32,7 @@
 namespace Walrus {
 
 #ifndef NDEBUG
-size_t Extern::g_externCount;
+std::atomic<size_t> Extern::g_externCount;
 #endif
 
 static const FunctionType g_defaultFunctionTypes[] = {
@@ -40,20 +43,38 @@ static const FunctionType g_defaultFunctionTypes[] = {
 
 Store::Store(Engine* engine)
     : m_engine(engine)
+#if defined(WALRUS_ENABLE_JIT)
+    , m_tieredCompiler(nullptr)
+#endif
+    , m_epochCounter(engine->epochCounter())
+    , m_epochDeadline(SIZE_MAX)
+    , m_epochDeadlineCallback(nullptr)
+    , m_epochDeadlineCallbackData(nullptr)
 #ifdef ENABLE_WASI
     , m_wasiData(nullptr)
 #endif
 {
-    memset(m_definedFuncTypes, 0, sizeof(m_definedFuncTypes));
+    for (size_t i = 0; i < FUNC_TYPES_NUM; i++) {
+        m_definedFuncTypes[i].store(nullptr, std::memory_order_relaxed);
+    }
 #ifdef ENABLE_GC
     GC_INIT();
+
+    if (engine->reportGCStats()) {
+        GCStats::enable();
+    }
 #endif /* ENABLE_GC */
 }
 
 Store::~Store()
 {
+#if defined(WALRUS_ENABLE_JIT)
+    // Must be stopped before the modules are freed.
+    delete m_tieredCompiler;
+#endif
+
     for (size_t i = 0; i < FUNC_TYPES_NUM; i++) {
-        FunctionType* type = m_definedFuncTypes[i];
+        FunctionType* type = m_definedFuncTypes[i].load(std::memory_order_relaxed);
         if (type != nullptr) {
             TypeStore::ReleaseRef(type->subTypeList());
         }
@@ -69,6 +90,8 @@ Store::~Store()
         delete m_modules[i];
     }
 
+    getTypeStore().releasePinnedTypes();
+
     for (size_t i = 0; i < m_componentInstances.size(); i++) {
         delete m_componentInstances[i];
     }
@@ -81,13 +104,13 @@ Store::~Store()
         delete m_externs[i];
     }
 
-    for (size_t i = 0; i < m_waiterList.size(); i++) {
-        delete m_waiterList[i];
-    }
-
     Store::finalize();
 
 #ifdef ENABLE_GC
+    if (m_engine->reportGCStats()) {
+        GCStats::report(stderr);
+    }
+
     GC_gcollect_and_unmap();
     GC_invoke_finalizers();
 #endif /* ENABLE_GC */
@@ -106,27 +129,92 @@ FunctionType* Store::getDefaultFunctionType(Value::Type type)
     return const_cast<FunctionType*>(g_defaultFunctionTypes + static_cast<size_t>(type));
 }
 
-Waiter* Store::getWaiter(void* address)
+bool Store::useMemoryGuardPages() const
 {
-    std::lock_guard<std::mutex> guard(m_waiterListLock);
-    for (size_t i = 0; i < m_waiterList.size(); i++) {
-        if (m_waiterList[i]->m_address == address) {
-            return m_waiterList[i];
-        }
+    return m_engine->useMemoryGuardPages();
+}
+
+uint32_t Store::JITThreadCount() const
+{
+    return m_engine->JITThreadCount();
+}
+
+uint32_t Store::JITOptLevel() const
+{
+    return m_engine->JITOptLevel();
+}
+
+uint32_t Store::JITInlineSize() const
+{
+    return m_engine->JITInlineSize();
+}
+
+uint32_t Store::JITTierUpThreshold() const
+{
+    return m_engine->JITTierUpThreshold();
+}
+
+bool Store::epochInterruption() const
+{
+    return m_engine->epochInterruption();
+}
+
+void Store::setEpochDeadline(size_t ticks)
+{
+    size_t epoch = m_epochCounter->load(std::memory_order_relaxed);
+    m_epochDeadline.store((ticks > SIZE_MAX - epoch) ? SIZE_MAX : epoch + ticks, std::memory_order_relaxed);
+}
+
+bool Store::extendEpochDeadline(ExecutionState& state)
+{
+    if (m_epochDeadlineCallback == nullptr) {
+        return false;
+    }
+
+    size_t ticks = m_epochDeadlineCallback(state, m_epochDeadlineCallbackData);
+
+    if (ticks == 0) {
+        return false;
+    }
+
+    setEpochDeadline(ticks);
+    return true;
+}
+
+#if defined(WALRUS_ENABLE_JIT)
+TieredCompiler* Store::tieredCompiler()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if (m_tieredCompiler == nullptr) {
+        m_tieredCompiler = new TieredCompiler();
     }
+    return m_tieredCompiler;
+}
+#endif
 
-    Waiter* waiter = new Waiter(address);
-    m_waiterList.push_back(waiter);
-    return waiter;
+FunctionType* Store::canonicalFunctionType(FunctionType* functionType)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    Vector<CompositeType*> typeList;
+    typeList.push_back(functionType);
+    m_typeStore.updateTypes(typeList);
+    return typeList[0]->asFunction();
 }
 
 FunctionType* Store::createDefinedFunctionType(DefinedFunctionType type)
 {
+    std::lock_guard<std::mutex> guard(m_lock);
     const CompositeType** noIndex = reinterpret_cast<const CompositeType**>(TypeStore::NoIndex);
-    FunctionType* functionType;
+    FunctionType* functionType = m_definedFuncTypes[type].load(std::memory_order_relaxed);
     TypeVector* param;
     TypeVector* result;
 
+    if (functionType != nullptr) {
+        // Created by another thread.
+        return functionType;
+    }
+
     switch (type) {
     case NONE:
         functionType = new FunctionType(0, 0, 0, 0, true, noIndex);
@@ -136,6 +224,12 @@ FunctionType* Store::createDefinedFunctionType(DefinedFunctionType type)
         param = functionType->initParam();
         param->setType(0, Value::Type::I32);
         break;
+    case I32I32R:
+        functionType = new FunctionType(2, 0, 0, 0, true, noIndex);
+        param = functionType->initParam();
+        param->setType(0, Value::Type::I32);
+        param->setType(1, Value::Type::I32);
+        break;
     case I32_RI32:
         functionType = new FunctionType(1, 0, 1, 0, true, noIndex);
         param = functionType->initParam();
@@ -329,7 +423,7 @@ FunctionType* Store::createDefinedFunctionType(DefinedFunctionType type)
     m_typeStore.updateTypes(typeList);
     functionType = typeList[0]->asFunction();
 
-    m_definedFuncTypes[type] = functionType;
+    m_definedFuncTypes[type].store(functionType, std::memory_order_release);
     return functionType;
 }
 
@@ -20,12 +20,15 @@
 #include "util/Vector.h"
 #include "runtime/TypeStore.h"
 #include "runtime/Value.h"
+#include "runtime/WaiterTable.h"
+#include <atomic>
 #include <mutex>
-#include <condition_variable>
 
 namespace Walrus {
 
 class Engine;
+class ExecutionState;
+class TieredCompiler;
 class Function;
 class Module;
 class Instance;
@@ -38,33 +41,13 @@ class FunctionType;
 class WasiStoreData;
 #endif
 
-struct Waiter {
-    struct WaiterItem {
-        WaiterItem(Waiter* waiter)
-            : m_waiter(waiter)
-        {
-        }
-
-        Waiter* m_waiter;
-    };
-
-    Waiter(void* addr)
-        : m_address(addr)
-    {
-    }
-
-    void* m_address;
-    std::mutex m_mutex;
-    std::condition_variable m_condition;
-    std::vector<WaiterItem*> m_waiterItemList;
-};
-
 class Store {
 public:
     enum DefinedFunctionType : uint8_t {
         // The R is meant to represent the results, after R are the result types.
         NONE = 0,
         I32R,
+        I32I32R,
         I32_RI32,
         I32I32_RI32,
         I32I64I32_RI32,
@@ -131,39 +114,51 @@ public:
 
     FunctionType* getDefinedFunctionType(DefinedFunctionType type)
     {
-        if (m_definedFuncTypes[type] != nullptr) {
-            return m_definedFuncTypes[type];
+        FunctionType* functionType = m_definedFuncTypes[type].load(std::memory_order_acquire);
+        if (functionType != nullptr) {
+            return functionType;
         }
         return createDefinedFunctionType(type);
     }
 
+    // Returns with the canonical type which is equal to the function type.
+    // The passed type is deleted when the type store already has an equal
+    // type. The reference is released by TypeStore::ReleaseRef.
+    FunctionType* canonicalFunctionType(FunctionType* functionType);
+
     void appendModule(Module* module)
     {
+        std::lock_guard<std::mutex> guard(m_lock);
         m_modules.push_back(module);
     }
 
     void appendInstance(Instance* instance)
     {
+        std::lock_guard<std::mutex> guard(m_lock);
         m_instances.push_back(instance);
     }
 
     void appendComponent(Component* component)
     {
+        std::lock_guard<std::mutex> guard(m_lock);
         m_components.push_back(component);
     }
 
     void appendComponentInstance(ComponentInstance* instance)
     {
+        std::lock_guard<std::mutex> guard(m_lock);
         m_componentInstances.push_back(instance);
     }
 
     void appendExtern(Extern* ext)
     {
+        std::lock_guard<std::mutex> guard(m_lock);
         m_externs.push_back(ext);
     }
 
     Instance* getLastInstance()
     {
+        std::lock_guard<std::mutex> guard(m_lock);
         ASSERT(m_instances.size());
         return m_instances.back();
     }
@@ -173,7 +168,59 @@ public:
         return m_typeStore;
     }
 
-    Waiter* getWaiter(void* address);
+    WaiterTable& waiterTable()
+    {
+        return m_waiterTable;
+    }
+
+    bool useMemoryGuardPages() const;
+    uint32_t JITThreadCount() const;
+    uint32_t JITOptLevel() const;
+    uint32_t JITInlineSize() const;
+    uint32_t JITTierUpThreshold() const;
+    bool epochInterruption() const;
+
+    // Returns with the number of epoch ticks the deadline is extended
+    // by, or zero to trap. Must not throw, it is called from compiled code.
+    typedef size_t (*EpochDeadlineCallback)(ExecutionState& state, void* data);
+
+    // The deadline is reached when the epoch of the engine is incremented
+    // ticks times after this call. There is no deadline by default. May
+    // be called from any thread, running code observes the new deadline
+    // at its next epoch check.
+    void setEpochDeadline(size_t ticks);
+
+    // Called when the deadline is reached instead of trapping.
+    void setEpochDeadlineCallback(EpochDeadlineCallback callback, void* data)
+    {
+        m_epochDeadlineCallback = callback;
+        m_epochDeadlineCallbackData = data;
+    }
+
+    bool epochDeadlineReached() const
+    {
+        return m_epochCounter->load(std::memory_order_relaxed) >= m_epochDeadline.load(std::memory_order_relaxed);
+    }
+
+    // Returns false when the execution must be trapped.
+    bool extendEpochDeadline(ExecutionState& state);
+
+    const std::atomic<size_t>* epochCounter() const
+    {
+        return m_epochCounter;
+    }
+
+    // Compiled code reads the deadline with plain loads, which are
+    // relaxed atomic loads on the supported targets.
+    const std::atomic<size_t>* epochDeadlineAddress() const
+    {
+        return &m_epochDeadline;
+    }
+
+#if defined(WALRUS_ENABLE_JIT)
+    // Created by the first module which uses tiered compilation.
+    TieredCompiler* tieredCompiler();
+#endif
 
     ComponentContext* context() const
     {
@@ -198,17 +245,27 @@ private:
 
     Engine* m_engine;
     TypeStore m_typeStore;
+#if defined(WALRUS_ENABLE_JIT)
+    TieredCompiler* m_tieredCompiler;
+#endif
 
-    FunctionType* m_definedFuncTypes[FUNC_TYPES_NUM];
+    std::atomic<FunctionType*> m_definedFuncTypes[FUNC_TYPES_NUM];
 
     Vector<Module*> m_modules;
     Vector<Instance*> m_instances;
     Vector<Component*> m_components;
     Vector<ComponentInstance*> m_componentInstances;
     Vector<Extern*> m_externs;
+    // Guards the lists above, since wasi threads instantiate
+    // modules while other threads are running.
+    std::mutex m_lock;
+
+    WaiterTable m_waiterTable;
 
-    std::mutex m_waiterListLock;
-    std::vector<Waiter*> m_waiterList;
+    const std::atomic<size_t>* m_epochCounter;
+    std::atomic<size_t> m_epochDeadline;
+    EpochDeadlineCallback m_epochDeadlineCallback;
+    void* m_epochDeadlineCallbackData;
 
     ComponentContext* m_context;
 #ifdef ENABLE_WASI
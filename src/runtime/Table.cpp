@@ -56,13 +56,27 @@ Table::Table(Type type, uint64_t initialSize, uint64_t maximumSize, bool is64, v
     }
 
 #ifdef ENABLE_GC
-    m_elements = reinterpret_cast<void**>(GC_MALLOC_UNCOLLECTABLE(static_cast<size_t>(initialSize) * sizeof(void*)));
+    m_elements = reinterpret_cast<void**>(allocateElements(static_cast<size_t>(initialSize)));
 #else
     m_elements = reinterpret_cast<void**>(malloc(static_cast<size_t>(initialSize) * sizeof(void*)));
 #endif
     std::fill(m_elements, m_elements + initialSize, init);
 }
 
+#ifdef ENABLE_GC
+void* Table::allocateElements(size_t size)
+{
+    // Tables are not allocated by the collector, so the elements are a
+    // root for the lifetime of the table. Functions are not collected,
+    // so the elements of function tables are not scanned. The kind of
+    // the allocation is kept by GC_REALLOC.
+    if (m_type.isFunctionRef()) {
+        return GC_MALLOC_ATOMIC_UNCOLLECTABLE(size * sizeof(void*));
+    }
+    return GC_MALLOC_UNCOLLECTABLE(size * sizeof(void*));
+}
+#endif /* ENABLE_GC */
+
 Table::~Table()
 {
 #ifdef ENABLE_GC
@@ -88,7 +102,7 @@ void Table::grow(uint64_t newSize, void* val)
     if (LIKELY(m_elements != nullptr)) {
         m_elements = reinterpret_cast<void**>(GC_REALLOC(m_elements, static_cast<size_t>(newSize) * sizeof(void*)));
     } else {
-        m_elements = reinterpret_cast<void**>(GC_MALLOC_UNCOLLECTABLE(static_cast<size_t>(newSize) * sizeof(void*)));
+        m_elements = reinterpret_cast<void**>(allocateElements(static_cast<size_t>(newSize)));
     }
 #else
     m_elements = reinterpret_cast<void**>(realloc(m_elements, static_cast<size_t>(newSize) * sizeof(void*)));
@@ -133,6 +133,9 @@ private:
     }
 
     void throwException(ExecutionState& state) const;
+#ifdef ENABLE_GC
+    void* allocateElements(size_t size);
+#endif /* ENABLE_GC */
 
     // Table has elements of reference type (FuncRef | ExternRef)
     Type m_type;
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(WALRUS_ENABLE_JIT)
+
+#include "Walrus.h"
+
+#include "runtime/TieredCompiler.h"
+#include "runtime/Module.h"
+
+namespace Walrus {
+
+TieredCompiler::TieredCompiler()
+    : m_terminate(false)
+{
+}
+
+TieredCompiler::~TieredCompiler()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_terminate = true;
+        m_queue.clear();
+    }
+
+    m_condition.notify_one();
+
+    if (m_thread.joinable()) {
+        // Waits for the currently compiled batch.
+        m_thread.join();
+    }
+}
+
+void TieredCompiler::enqueue(Module* module, ModuleFunction* function)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        if (m_terminate) {
+            return;
+        }
+
+        m_queue.push_back(Request(module, function));
+
+        if (!m_thread.joinable()) {
+            m_thread = std::thread(&TieredCompiler::run, this);
+        }
+    }
+
+    m_condition.notify_one();
+}
+
+void TieredCompiler::run()
+{
+    std::vector<Request> requests;
+    std::vector<ModuleFunction*> functions;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_condition.wait(lock, [this] { return m_terminate || !m_queue.empty(); });
+
+            if (m_terminate) {
+                return;
+            }
+
+            requests.swap(m_queue);
+        }
+
+        // Functions which became hot at the same time are compiled
+        // together, so they can call each other directly.
+        size_t size = requests.size();
+
+        for (size_t i = 0; i < size; i++) {
+            Module* module = requests[i].module;
+
+            if (module == nullptr) {
+                continue;
+            }
+
+            functions.clear();
+
+            for (size_t j = i; j < size; j++) {
+                if (requests[j].module == module) {
+                    functions.push_back(requests[j].function);
+                    requests[j].module = nullptr;
+                }
+            }
+
+            module->jitCompile(functions.data(), functions.size(), module->tieredJITFlags());
+        }
+
+        requests.clear();
+    }
+}
+
+} // namespace Walrus
+
+#endif // WALRUS_ENABLE_JIT
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WalrusTieredCompiler__
+#define __WalrusTieredCompiler__
+
+#if defined(WALRUS_ENABLE_JIT)
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Walrus {
+
+class Module;
+class ModuleFunction;
+
+// Compiles the hot functions of the modules of a store on a background thread.
+class TieredCompiler {
+public:
+    TieredCompiler();
+    ~TieredCompiler();
+
+    void enqueue(Module* module, ModuleFunction* function);
+
+private:
+    struct Request {
+        Request(Module* module, ModuleFunction* function)
+            : module(module)
+            , function(function)
+        {
+        }
+
+        Module* module;
+        ModuleFunction* function;
+    };
+
+    void run();
+
+    std::mutex m_lock;
+    std::condition_variable m_condition;
+    std::vector<Request> m_queue;
+    std::thread m_thread;
+    bool m_terminate;
+};
+
+} // namespace Walrus
+
+#endif // WALRUS_ENABLE_JIT
+#endif // __WalrusTieredCompiler__
@@ -43,6 +43,12 @@ public:
     TrapResult run(void (*runner)(ExecutionState&, void*), void* data);
     static void throwException(const std::string& message);
     static void throwException(ExecutionState& state, const std::string& message);
+    // Only string literals are accepted, since the message is not copied.
+    template <size_t N>
+    static void throwException(ExecutionState& state, const char (&message)[N])
+    {
+        throw Exception::create(state, message);
+    }
     static void throwException(ExecutionState& state, Tag* tag, Vector<uint8_t>&& userExceptionData);
     static void throwException(ExecutionState& state, std::unique_ptr<Exception>&& e);
 };
@@ -33,6 +33,17 @@ static Value::Type toGenericType(const CompositeType* ref)
     }
 }
 
+bool Type::isFunctionRef() const
+{
+    Value::Type refType = Value::toNonNullableRefType(type());
+
+    if (refType == Value::DefinedRef) {
+        return m_ref != nullptr && m_ref->kind() == ObjectType::FunctionKind;
+    }
+
+    return refType == Value::FuncRef || refType == Value::NoFuncRef;
+}
+
 bool Type::isSubType(const Type& expected) const
 {
     Value::Type actualType = type();
@@ -97,6 +97,11 @@ public:
         return type() == Value::DefinedRef || type() == Value::NullDefinedRef;
     }
 
+    // Function references never point to objects of the garbage
+    // collector. Concrete types without a known composite type are
+    // assumed to be other references.
+    bool isFunctionRef() const;
+
     bool isSubType(const Type& expected) const;
 
 private:
@@ -372,6 +372,11 @@ void TypeStore::updateTypes(Vector<CompositeType*>& types)
         do {
             nextSubType = updateRefs(compType, types, nextSubType);
             compType->m_recursiveType = recType;
+
+            if (compType->kind() == ObjectType::FunctionKind) {
+                compType->asFunction()->m_typeID = ++m_lastFunctionTypeID;
+            }
+
             compType = compType->getNextType();
         } while (compType != nullptr);
 
@@ -435,6 +440,21 @@ void TypeStore::ReleaseRef(const CompositeType** typeInfo)
     }
 }
 
+void TypeStore::releasePinnedTypes()
+{
+    RecursiveType* current = m_first;
+
+    while (current != nullptr) {
+        RecursiveType* next = current->m_next;
+
+        if (current->m_isPinned) {
+            current->m_isPinned = false;
+            releaseRecursiveType(current);
+        }
+        current = next;
+    }
+}
+
 #ifdef ENABLE_GC
 
 void TypeStore::insertRootRef(GCBase* object)
@@ -54,6 +54,7 @@ private:
         , m_prev(nullptr)
         , m_firstType(firstType)
         , m_refCount(1)
+        , m_isPinned(false)
         , m_typeCount(typeCount)
         , m_hashCode(hashCode)
     {
@@ -70,6 +71,7 @@ private:
     RecursiveType* m_prev;
     CompositeType* m_firstType;
     size_t m_refCount;
+    bool m_isPinned;
     size_t m_typeCount;
     size_t m_hashCode;
     // Concatenation of subtype arrays used by all types
@@ -82,6 +84,7 @@ public:
 
     TypeStore()
         : m_first(nullptr)
+        , m_lastFunctionTypeID(0)
 #ifdef ENABLE_GC
         , m_rootRefs(nullptr)
         , m_refCounts(nullptr)
@@ -107,6 +110,20 @@ public:
 
     static void ReleaseRef(const CompositeType** typeInfo);
 
+    // Types of GC objects are kept alive until the store is destroyed,
+    // so the objects do not need a finalizer which releases their type.
+    static void PinType(const CompositeType* type)
+    {
+        RecursiveType* recType = type->getRecursiveType();
+
+        if (!recType->m_isPinned) {
+            recType->m_isPinned = true;
+            recType->m_refCount++;
+        }
+    }
+
+    void releasePinnedTypes();
+
 #ifdef ENABLE_GC
     inline void addRef(GCBase* object)
     {
@@ -148,6 +165,7 @@ private:
 #endif
 
     RecursiveType* m_first;
+    uint32_t m_lastFunctionTypeID;
 
 #ifdef ENABLE_GC
     Object** m_rootRefs;
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Walrus.h"
+
+#include "runtime/WaiterTable.h"
+
+#if defined(WALRUS_USE_FUTEX)
+#include <errno.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace Walrus {
+
+WaiterTable::WaiterTable()
+{
+}
+
+WaiterTable::~WaiterTable()
+{
+#ifndef NDEBUG
+    for (size_t i = 0; i < kBucketCount; i++) {
+        ASSERT(m_buckets[i].head == nullptr);
+    }
+#endif
+}
+
+void WaiterTable::append(Bucket& bucket, WaitNode* node)
+{
+    node->prev = bucket.tail;
+    node->next = nullptr;
+
+    if (bucket.tail != nullptr) {
+        bucket.tail->next = node;
+    } else {
+        bucket.head = node;
+    }
+    bucket.tail = node;
+}
+
+void WaiterTable::remove(Bucket& bucket, WaitNode* node)
+{
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    } else {
+        bucket.head = node->next;
+    }
+
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    } else {
+        bucket.tail = node->prev;
+    }
+}
+
+#if defined(WALRUS_USE_FUTEX)
+
+static long futex(uint32_t* address, int operation, uint32_t value, const struct timespec* timeout, uint32_t mask)
+{
+    return syscall(SYS_futex, address, operation, value, timeout, nullptr, mask);
+}
+
+uint32_t WaiterTable::futexWait(uint8_t* address, uint32_t expect, int64_t timeout)
+{
+    Bucket& bucket = bucketFor(address);
+    struct timespec deadline;
+    struct timespec* deadlinePtr = nullptr;
+
+    if (timeout >= 0) {
+        // Absolute deadline, so an interrupted wait can be restarted.
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        int64_t nanoseconds = deadline.tv_nsec + timeout % 1000000000;
+        deadline.tv_sec += static_cast<time_t>(timeout / 1000000000 + nanoseconds / 1000000000);
+        deadline.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+        deadlinePtr = &deadline;
+    }
+
+    // Paired with the load in notify: either the notifier sees this
+    // counter, or the kernel sees the value stored before the notify.
+    bucket.futexWaiterCount.fetch_add(1);
+
+    // A notify which started before this point may still wake the thread
+    // when it has not finished yet, so both counters are recorded.
+    uint32_t notifyStart = bucket.futexNotifyStart.load();
+    uint32_t notifyEnd = bucket.futexNotifyEnd.load();
+    bool hasWaited = false;
+
+    uint32_t result;
+    while (true) {
+        if (futex(reinterpret_cast<uint32_t*>(address), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, expect, deadlinePtr, FUTEX_BITSET_MATCH_ANY) == 0) {
+            // The kernel may return without a wake, so the thread waits again
+            // unless a notify of this bucket overlapped with the wait.
+            if (notifyStart != notifyEnd || bucket.futexNotifyStart.load() != notifyStart) {
+                result = Ok;
+                break;
+            }
+            hasWaited = true;
+            continue;
+        }
+
+        if (errno == EAGAIN) {
+            // After a spurious wake, the value was changed by another agent
+            // since the wait started, and the thread cannot wait for the
+            // notify in the kernel anymore, so it is treated as woken.
+            result = hasWaited ? Ok : NotEqual;
+            break;
+        }
+
+        if (errno == ETIMEDOUT) {
+            result = TimedOut;
+            break;
+        }
+
+        ASSERT(errno == EINTR);
+    }
+
+    bucket.futexWaiterCount.fetch_sub(1);
+    return result;
+}
+
+#endif
+
+uint32_t WaiterTable::notify(uint8_t* address, uint32_t count)
+{
+    Bucket& bucket = bucketFor(address);
+    uint32_t woken = 0;
+
+    if (count == 0) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(bucket.lock);
+        WaitNode* node = bucket.head;
+
+        while (node != nullptr && woken < count) {
+            WaitNode* next = node->next;
+
+            if (node->address == address) {
+                remove(bucket, node);
+                node->notified = true;
+                // Must be signalled under the lock, since the node
+                // is freed as soon as its thread leaves the wait.
+                node->condition.notify_one();
+                woken++;
+            }
+            node = next;
+        }
+    }
+
+#if defined(WALRUS_USE_FUTEX)
+    if (woken < count && bucket.futexWaiterCount.load() != 0) {
+        int wakeCount = static_cast<int>(std::min(count - woken, static_cast<uint32_t>(INT_MAX)));
+        bucket.futexNotifyStart.fetch_add(1);
+        long result = futex(reinterpret_cast<uint32_t*>(address), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, wakeCount, nullptr, 0);
+        bucket.futexNotifyEnd.fetch_add(1);
+
+        if (result > 0) {
+            woken += static_cast<uint32_t>(result);
+        }
+    }
+#endif
+
+    return woken;
+}
+
+} // namespace Walrus
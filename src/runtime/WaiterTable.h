@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WalrusWaiterTable__
+#define __WalrusWaiterTable__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+#if defined(__linux__)
+#define WALRUS_USE_FUTEX
+#endif
+
+namespace Walrus {
+
+// Wait queues of memory.atomic.wait and memory.atomic.notify. The table
+// is sharded by the waited address, and each bucket has its own lock.
+// Waiting threads are linked into the bucket by a node allocated on their
+// own stack, so nothing is kept for an address after its last waiter leaves.
+class WaiterTable {
+public:
+    static const size_t kBucketCount = 64;
+
+    enum WaitResult : uint32_t {
+        // Woken by another agent.
+        Ok = 0,
+        // The loaded value did not match the expected value.
+        NotEqual = 1,
+        // Not woken before the timeout expired.
+        TimedOut = 2,
+    };
+
+    WaiterTable();
+    ~WaiterTable();
+
+    // A negative timeout means waiting forever.
+    template <typename T>
+    uint32_t wait(uint8_t* address, const T& expect, int64_t timeout)
+    {
+        static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Unsupported wait size");
+
+#if defined(WALRUS_USE_FUTEX)
+        if (sizeof(T) == 4) {
+            // The kernel compares the value and queues the thread atomically.
+            return futexWait(address, static_cast<uint32_t>(expect), timeout);
+        }
+#endif
+
+        Bucket& bucket = bucketFor(address);
+        WaitNode node(address);
+        std::unique_lock<std::mutex> lock(bucket.lock);
+
+        // Checked under the bucket lock, so a notify cannot be missed.
+        if (reinterpret_cast<std::atomic<T>*>(address)->load() != expect) {
+            return NotEqual;
+        }
+
+        append(bucket, &node);
+
+        if (timeout < 0) {
+            node.condition.wait(lock, [&node] { return node.notified; });
+            return Ok;
+        }
+
+        if (!node.condition.wait_for(lock, std::chrono::nanoseconds(timeout), [&node] { return node.notified; })) {
+            remove(bucket, &node);
+            return TimedOut;
+        }
+        return Ok;
+    }
+
+    // Returns with the number of woken waiters.
+    uint32_t notify(uint8_t* address, uint32_t count);
+
+private:
+    struct WaitNode {
+        WaitNode(uint8_t* address)
+            : address(address)
+            , next(nullptr)
+            , prev(nullptr)
+            , notified(false)
+        {
+        }
+
+        uint8_t* address;
+        WaitNode* next;
+        WaitNode* prev;
+        std::condition_variable condition;
+        bool notified;
+    };
+
+    struct Bucket {
+        Bucket()
+            : head(nullptr)
+            , tail(nullptr)
+#if defined(WALRUS_USE_FUTEX)
+            , futexWaiterCount(0)
+            , futexNotifyStart(0)
+            , futexNotifyEnd(0)
+#endif
+        {
+        }
+
+        std::mutex lock;
+        // Waiters of all addresses mapped to this bucket in arrival order.
+        WaitNode* head;
+        WaitNode* tail;
+#if defined(WALRUS_USE_FUTEX)
+        // Notify skips the system call when no thread waits in the kernel.
+        std::atomic<uint32_t> futexWaiterCount;
+        // Incremented before and after the wake system call of notify,
+        // so the waiters can tell a notify from a spurious wake.
+        std::atomic<uint32_t> futexNotifyStart;
+        std::atomic<uint32_t> futexNotifyEnd;
+#endif
+    };
+
+    Bucket& bucketFor(uint8_t* address)
+    {
+        // Fibonacci hashing, the low bits of the address are always zero.
+        uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(address) >> 2) * 0x9E3779B97F4A7C15ull;
+        return m_buckets[hash >> 58];
+    }
+
+    static void append(Bucket& bucket, WaitNode* node);
+    static void remove(Bucket& bucket, WaitNode* node);
+
+#if defined(WALRUS_USE_FUTEX)
+    uint32_t futexWait(uint8_t* address, uint32_t expect, int64_t timeout);
+#endif
+
+    Bucket m_buckets[kBucketCount];
+};
+
+static_assert(WaiterTable::kBucketCount == (1 << 6), "bucketFor uses the top 6 bits of the hash");
+
+} // namespace Walrus
+
+#endif // __WalrusWaiterTable__
@@ -3,6 +3,7 @@
 #include <sstream>
 #include <iomanip>
 #include <inttypes.h>
+#include <thread>
 
 #if defined(WALRUS_GOOGLE_PERF)
 #include <gperftools/profiler.h>
@@ -20,6 +21,7 @@
 #include "runtime/Global.h"
 #include "runtime/Tag.h"
 #include "runtime/Trap.h"
+#include "runtime/Profiler.h"
 #include "parser/WASMParser.h"
 #include "parser/WASMComponentParser.h"
 
@@ -34,6 +36,13 @@
 #include "wasi/WASI02.h"
 #endif
 
+#if defined(OS_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 struct spectestseps : std::numpunct<char> {
     char do_thousands_sep() const { return '_'; }
     std::string do_grouping() const { return "\3"; }
@@ -42,6 +51,15 @@ struct spectestseps : std::numpunct<char> {
 struct ParseOptions {
     std::string exportToRun;
     std::vector<std::string> fileNames;
+    bool memoryGuardPages = false;
+    bool gcStats = false;
+    std::string profileFile;
+    uint32_t JITThreadCount = 1;
+    uint32_t JITOptLevel = 1;
+    uint32_t JITInlineSize = Walrus::Engine::kDefaultJITInlineSize;
+    uint32_t JITTierUpThreshold = Walrus::Engine::kDefaultJITTierUpThreshold;
+    // Zero when epoch interruption is disabled.
+    uint32_t epochTimeout = 0;
 
     // WASI options
 #ifdef ENABLE_WASI
@@ -53,6 +71,7 @@ struct ParseOptions {
 
 static uint32_t s_JITFlags = 0;
 static uint32_t s_FeatureFlags = 0;
+static std::string s_cacheDir;
 
 using namespace Walrus;
 
@@ -157,10 +176,74 @@ static ExternalValue* findExternalValue(size_t value)
     return externalValues.back();
 }
 
+static std::pair<Optional<Module*>, std::string> parseModule(Store* store, const std::string& filename, const std::vector<uint8_t>& src, uint32_t featureFlags)
+{
+#if defined(OS_POSIX)
+    if (s_cacheDir.empty()) {
+        return WASMParser::parseBinary(store, filename, src.data(), src.size(), s_JITFlags, featureFlags);
+    }
+
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016" PRIx64, WASMParser::hashBinary(src.data(), src.size()));
+    std::string cachePath = s_cacheDir + "/" + hash + ".wcache";
+
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        std::pair<Optional<Module*>, std::string> result;
+        bool hasResult = false;
+
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            // Mapped only while the module is loaded from it.
+            void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (data != MAP_FAILED) {
+                // The file name only depends on a hash, so the source is compared as well.
+                result = WASMParser::parseSerialized(store, filename, reinterpret_cast<uint8_t*>(data), st.st_size,
+                                                     src.data(), src.size(), s_JITFlags, featureFlags);
+                // The module copies everything it needs, so the mapping can be released.
+                munmap(data, st.st_size);
+                hasResult = result.second.empty();
+            }
+        }
+        close(fd);
+
+        if (hasResult) {
+            return result;
+        }
+        // Stale, corrupted or colliding cache file: fall back to parsing and rewrite it.
+    }
+
+    auto parseResult = WASMParser::parseBinary(store, filename, src.data(), src.size(), s_JITFlags, featureFlags);
+    if (!parseResult.second.empty()) {
+        return parseResult;
+    }
+
+    std::vector<uint8_t> serialized;
+    if (!WASMParser::serialize(parseResult.first.value(), src.data(), src.size(), serialized)) {
+        return parseResult;
+    }
+
+    // Write to a temporary file first, so concurrent readers never see a partial cache file.
+    std::string tmpPath = cachePath + ".tmp." + std::to_string(getpid());
+    FILE* fp = fopen(tmpPath.c_str(), "wb");
+    if (fp) {
+        bool written = fwrite(serialized.data(), 1, serialized.size(), fp) == serialized.size();
+        written = (fclose(fp) == 0) && written;
+        if (!written || rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+            unlink(tmpPath.c_str());
+        }
+    }
+
+    return parseResult;
+#else
+    return WASMParser::parseBinary(store, filename, src.data(), src.size(), s_JITFlags, featureFlags);
+#endif
+}
+
 static Trap::TrapResult executeWASM(Store* store, const std::string& filename, const std::vector<uint8_t>& src,
                                     std::map<std::string, Instance*>* registeredInstanceMap = nullptr)
 {
-    auto parseResult = WASMParser::parseBinary(store, filename, src.data(), src.size(), s_JITFlags, s_FeatureFlags);
+    auto parseResult = parseModule(store, filename, src, s_FeatureFlags);
     if (!parseResult.second.empty()) {
         Trap::TrapResult tr;
         tr.exception = Exception::create(parseResult.second);
@@ -298,6 +381,23 @@ static Trap::TrapResult executeWASM(Store* store, const std::string& filename, c
                 }
                 hasWasiImport = true;
             }
+        } else if (import->moduleName() == "wasi") {
+            WASI::WasiFuncInfo* wasiImportFunc = WASI::findThreadFunction(import->fieldName());
+            if (wasiImportFunc) {
+                FunctionType* ft = store->getDefinedFunctionType(wasiImportFunc->functionType);
+                if (ft->equals(import->functionType())) {
+                    importValues.push_back(WasiFunction::createWasiFunction(
+                        store,
+                        ft,
+                        wasiImportFunc->ptr));
+                }
+                hasWasiImport = true;
+            }
+        } else if (registeredInstanceMap == nullptr && import->moduleName() == "env" && import->importType() == ImportType::Memory) {
+            // Modules using wasi-threads import their shared memory.
+            const MemoryType* memoryType = import->memoryType();
+            importValues.push_back(Memory::createMemory(store, memoryType->initialSize() * Memory::s_memoryPageSize,
+                                                        memoryType->maximumSize() * Memory::s_memoryPageSize, memoryType->isShared(), memoryType->is64()));
 #endif
         } else if (registeredInstanceMap) {
             auto iter = registeredInstanceMap->find(import->moduleName());
@@ -1132,7 +1232,7 @@ static void executeWAST(Store* store, const std::string& filename, const std::ve
 
 static void runExports(Store* store, const std::string& filename, const std::vector<uint8_t>& src, std::string& exportToRun)
 {
-    auto parseResult = WASMParser::parseBinary(store, filename, src.data(), src.size(), s_JITFlags);
+    auto parseResult = parseModule(store, filename, src, 0);
     if (!parseResult.second.empty()) {
         fprintf(stderr, "parse error: %s\n", parseResult.second.c_str());
         return;
@@ -1241,10 +1341,48 @@ static void parseArguments(int argc, const char* argv[], ParseOptions& options)
                 } else if (strcmp(argv[i], "--enable-web-assembly3") == 0) {
                     s_FeatureFlags |= wabt::FeatureFlagValue::enableWebAssembly3;
                     continue;
+                } else if (strcmp(argv[i], "--memory-guard-pages") == 0) {
+                    options.memoryGuardPages = true;
+                    continue;
+#ifdef ENABLE_GC
+                } else if (strcmp(argv[i], "--gc-stats") == 0) {
+                    options.gcStats = true;
+                    continue;
+#endif
+#if defined(WALRUS_ENABLE_PROFILER)
+                } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+                    if (argv[i][10] == '\0') {
+                        fprintf(stderr, "error: --profile requires a file name\n");
+                        exit(1);
+                    }
+                    options.profileFile = argv[i] + 10;
+                    // Names and code offsets are only used by the profile.
+                    s_FeatureFlags |= wabt::FeatureFlagValue::readFunctionNames | wabt::FeatureFlagValue::recordCodeOffsets;
+                    continue;
+#endif
+                } else if (strcmp(argv[i], "--epoch-timeout") == 0) {
+                    if (i + 1 == argc || argv[i + 1][0] == '-') {
+                        fprintf(stderr, "error: --epoch-timeout requires an argument\n");
+                        exit(1);
+                    }
+                    ++i;
+                    options.epochTimeout = static_cast<uint32_t>(std::max(atoi(argv[i]), 1));
+                    continue;
+                } else if (strcmp(argv[i], "--cache-dir") == 0) {
+                    if (i + 1 == argc || argv[i + 1][0] == '-') {
+                        fprintf(stderr, "error: --cache-dir requires an argument\n");
+                        exit(1);
+                    }
+                    ++i;
+                    s_cacheDir = argv[i];
+                    continue;
 #if defined(WALRUS_ENABLE_JIT)
                 } else if (strcmp(argv[i], "--jit") == 0) {
                     s_JITFlags |= JITFlagValue::useJIT;
                     continue;
+                } else if (strcmp(argv[i], "--jit-tiered") == 0) {
+                    s_JITFlags |= JITFlagValue::useJIT | JITFlagValue::tieredJIT;
+                    continue;
                 } else if (strcmp(argv[i], "--jit-verbose") == 0) {
                     s_JITFlags |= JITFlagValue::JITVerbose;
                     continue;
@@ -1254,6 +1392,44 @@ static void parseArguments(int argc, const char* argv[], ParseOptions& options)
                 } else if (strcmp(argv[i], "--jit-no-reg-alloc") == 0) {
                     s_JITFlags |= JITFlagValue::disableRegAlloc;
                     continue;
+                } else if (strcmp(argv[i], "--perf-map") == 0) {
+                    s_JITFlags |= JITFlagValue::perfMap;
+                    continue;
+                } else if (strcmp(argv[i], "--perf-jitdump") == 0) {
+                    s_JITFlags |= JITFlagValue::perfJITDump;
+                    continue;
+                } else if (strcmp(argv[i], "--jit-threads") == 0) {
+                    if (i + 1 == argc || argv[i + 1][0] == '-') {
+                        fprintf(stderr, "error: --jit-threads requires an argument\n");
+                        exit(1);
+                    }
+                    ++i;
+                    options.JITThreadCount = static_cast<uint32_t>(std::max(atoi(argv[i]), 1));
+                    continue;
+                } else if (strcmp(argv[i], "--jit-opt-level") == 0) {
+                    if (i + 1 == argc || argv[i + 1][0] == '-') {
+                        fprintf(stderr, "error: --jit-opt-level requires an argument\n");
+                        exit(1);
+                    }
+                    ++i;
+                    options.JITOptLevel = static_cast<uint32_t>(std::max(atoi(argv[i]), 0));
+                    continue;
+                } else if (strcmp(argv[i], "--jit-inline-size") == 0) {
+                    if (i + 1 == argc || argv[i + 1][0] == '-') {
+                        fprintf(stderr, "error: --jit-inline-size requires an argument\n");
+                        exit(1);
+                    }
+                    ++i;
+                    options.JITInlineSize = static_cast<uint32_t>(std::max(atoi(argv[i]), 0));
+                    continue;
+                } else if (strcmp(argv[i], "--jit-tier-up-threshold") == 0) {
+                    if (i + 1 == argc || argv[i + 1][0] == '-') {
+                        fprintf(stderr, "error: --jit-tier-up-threshold requires an argument\n");
+                        exit(1);
+                    }
+                    ++i;
+                    options.JITTierUpThreshold = static_cast<uint32_t>(std::max(atoi(argv[i]), 1));
+                    continue;
 #endif
                 } else if (strcmp(argv[i], "--env") == 0) {
                     if (i + 1 == argc || argv[i + 1][0] == '-') {
@@ -1294,9 +1470,25 @@ static void parseArguments(int argc, const char* argv[], ParseOptions& options)
                     fprintf(stdout, "\t--enable-web-assembly3\n\t\tEnable support for web assembly3 features.\n\n");
 #if defined(WALRUS_ENABLE_JIT)
                     fprintf(stdout, "\t--jit\n\t\tEnable just-in-time interpretation.\n\n");
+                    fprintf(stdout, "\t--jit-tiered\n\t\tInterpret functions first, and compile them in the background when they become hot.\n\n");
+                    fprintf(stdout, "\t--jit-tier-up-threshold <N>\n\t\tCompile the functions of --jit-tiered after N calls and loop iterations (default 1000).\n\n");
                     fprintf(stdout, "\t--jit-verbose\n\t\tEnable verbose output for just-in-time interpretation.\n\n");
                     fprintf(stdout, "\t--jit-verbose-color\n\t\tEnable colored verbose output for just-in-time interpretation.\n\n");
+                    fprintf(stdout, "\t--jit-threads <N>\n\t\tCompile the functions of a module on N threads.\n\n");
+                    fprintf(stdout, "\t--jit-opt-level <N>\n\t\tOptimization level of the JIT compiler: 0 disables the optimizations, 1 (default) folds constants\n\t\tand propagates copies, 2 also simplifies algebraic identities and removes unused results.\n\n");
+                    fprintf(stdout, "\t--jit-inline-size <N>\n\t\tInline the calls of functions without branches and calls, which have at most N byte codes\n\t\t(default 16). Zero disables inlining.\n\n");
+                    fprintf(stdout, "\t--perf-map\n\t\tWrite the symbols of the compiled functions to /tmp/perf-<pid>.map for perf.\n\t\tInterpreted functions are not listed, use --profile for them.\n\n");
+                    fprintf(stdout, "\t--perf-jitdump\n\t\tWrite the compiled code and its wasm code offsets to a jitdump file for perf inject.\n\n");
+#endif
+                    fprintf(stdout, "\t--memory-guard-pages\n\t\tReserve the address space of 32 bit memories, and catch out of bounds accesses of JIT code with guard pages.\n\n");
+#ifdef ENABLE_GC
+                    fprintf(stdout, "\t--gc-stats\n\t\tPrint the pause times of the garbage collector at exit.\n\n");
 #endif
+#if defined(WALRUS_ENABLE_PROFILER)
+                    fprintf(stdout, "\t--profile=<FILE>\n\t\tSample the wasm call stacks, and write them to FILE as folded stacks for flamegraph tools.\n\n");
+#endif
+                    fprintf(stdout, "\t--epoch-timeout <MS>\n\t\tTrap when a module runs longer than MS milliseconds, checked at loop headers and function entries.\n\n");
+                    fprintf(stdout, "\t--cache-dir <DIR>\n\t\tStore parsed modules in DIR, and load them from there when the same module is run again.\n\n");
                     fprintf(stdout, "\t--mapdirs <HOST_DIR> <VIRTUAL_DIR>\n\t\tMap real directories to virtual ones for WASI functions to use.\n\t\tExample: ./walrus test.wasm --mapdirs this/real/directory/ this/virtual/directory\n\n");
                     fprintf(stdout, "\t--env\n\t\tShare host environment to walrus WASI.\n\n");
                     fprintf(stdout, "\t--args <MODULE_FILE_NAME> [<ARG1> <ARG2> ... <ARGN>]\n\t\tRun Webassembly module with arguments: must be followed by the name of the Webassembly module file, then optionally following arguments which are passed on to the module\n\t\tExample: ./walrus --args test.wasm 'hello' 'world' 42\n\n");
@@ -1340,12 +1532,41 @@ int main(int argc, const char* argv[])
     ProfilerStart("gperf_result");
 #endif
 
+    ParseOptions options;
+
+    parseArguments(argc, argv, options);
+
     Engine* engine = new Engine();
+    engine->setUseMemoryGuardPages(options.memoryGuardPages);
+    engine->setReportGCStats(options.gcStats);
+    engine->setJITThreadCount(options.JITThreadCount);
+    engine->setJITOptLevel(options.JITOptLevel);
+    engine->setJITInlineSize(options.JITInlineSize);
+    engine->setJITTierUpThreshold(options.JITTierUpThreshold);
+    engine->setEpochInterruption(options.epochTimeout > 0);
     Store* store = new Store(engine);
 
-    ParseOptions options;
+    // The epoch is incremented in every millisecond.
+    std::atomic<bool> stopEpochTicker(false);
+    std::thread epochTicker;
+    if (options.epochTimeout > 0) {
+        store->setEpochDeadline(options.epochTimeout);
+        epochTicker = std::thread([engine, &stopEpochTicker] {
+            while (!stopEpochTicker.load(std::memory_order_relaxed)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                engine->incrementEpoch();
+            }
+        });
+    }
 
-    parseArguments(argc, argv, options);
+    if (!options.profileFile.empty()) {
+        if (!Profiler::start(options.profileFile.c_str())) {
+            fprintf(stderr, "error: cannot start the profiler with %s\n", options.profileFile.c_str());
+            exit(1);
+        }
+        // The profile is also written when the program calls exit.
+        atexit(Profiler::stop);
+    }
 
 #ifdef ENABLE_WASI
     // initialize WASI
@@ -1424,7 +1645,22 @@ int main(int argc, const char* argv[])
         }
     }
 
+    Profiler::stop();
+
+    if (epochTicker.joinable()) {
+        stopEpochTicker.store(true, std::memory_order_relaxed);
+        epochTicker.join();
+    }
+
 #ifdef ENABLE_WASI
+    if (WASI::hasRunningThreads()) {
+        // The program ends when its main thread returns, and the
+        // remaining threads may still use the store.
+        fflush(stdout);
+        fflush(stderr);
+        std::_Exit(result);
+    }
+
     uvwasi_destroy(&uvwasi);
     // Wasi 0.2
     destroyWasi02Data(store->wasiData());
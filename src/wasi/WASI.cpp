@@ -20,6 +20,22 @@
 #include "runtime/Value.h"
 #include "runtime/Memory.h"
 #include "runtime/Instance.h"
+#include "runtime/Module.h"
+#include "runtime/Global.h"
+#include "runtime/Table.h"
+#include "runtime/Tag.h"
+#include "runtime/Trap.h"
+#include "runtime/Engine.h"
+
+#if defined(OS_POSIX)
+#include <pthread.h>
+#else
+#include <thread>
+#endif
+
+#ifdef ENABLE_GC
+#include "GCUtil.h"
+#endif /* ENABLE_GC */
 
 // https://github.com/WebAssembly/WASI/blob/main/legacy/preview1/docs.md
 
@@ -27,6 +43,9 @@ namespace Walrus {
 
 uvwasi_t* WASI::g_uvwasi;
 WASI::WasiFuncInfo WASI::g_wasiFunctions[WasiFuncIndex::FuncEnd];
+WASI::WasiFuncInfo WASI::g_threadSpawnFunction;
+std::atomic<uint32_t> WASI::g_nextThreadId(1);
+std::atomic<uint32_t> WASI::g_runningThreadCount(0);
 
 static void* get_memory_pointer(Instance* instance, Value& value, size_t size)
 {
@@ -90,6 +109,10 @@ void WASI::initialize(uvwasi_t* uvwasi)
     g_wasiFunctions[WasiFuncIndex::NAME##FUNC].ptr = &WASI::NAME;
     FOR_EACH_WASI_FUNC(WASI_FUNC_TABLE)
 #undef WASI_FUNC_TABLE
+
+    g_threadSpawnFunction.name = "thread-spawn";
+    g_threadSpawnFunction.functionType = Store::I32_RI32;
+    g_threadSpawnFunction.ptr = &WASI::thread_spawn;
 }
 
 WASI::WasiFuncInfo* WASI::find(const std::string& funcName)
@@ -102,6 +125,24 @@ WASI::WasiFuncInfo* WASI::find(const std::string& funcName)
     return nullptr;
 }
 
+WASI::WasiFuncInfo* WASI::findThreadFunction(const std::string& funcName)
+{
+    if (g_threadSpawnFunction.name == funcName) {
+        return &g_threadSpawnFunction;
+    }
+    return nullptr;
+}
+
+bool WASI::hasRunningThreads()
+{
+    return g_runningThreadCount.load() != 0;
+}
+
+void WASI::threadFinished()
+{
+    g_runningThreadCount.fetch_sub(1);
+}
+
 void WASI::args_get(ExecutionState& state, Value* argv, Value* result, Instance* instance)
 {
     uvwasi_size_t argc;
@@ -604,6 +645,179 @@ void WASI::sched_yield(ExecutionState& state, Value* argv, Value* result, Instan
     result[0] = Value(uvwasi_sched_yield(WASI::g_uvwasi));
 }
 
+// Thread ids must be in the [1, 0x1FFFFFFF] range.
+static const uint32_t s_maxThreadId = 0x1FFFFFFF;
+
+struct WasiThreadStart {
+    WasiThreadStart(Function* function, int32_t threadId, int32_t startArg)
+        : function(function)
+        , threadId(threadId)
+        , startArg(startArg)
+    {
+    }
+
+    Function* function;
+    int32_t threadId;
+    int32_t startArg;
+};
+
+static void runWasiThread(WasiThreadStart* start)
+{
+#ifdef ENABLE_GC
+    struct GC_stack_base stackBase;
+    GC_get_stack_base(&stackBase);
+    GC_register_my_thread(&stackBase);
+#endif /* ENABLE_GC */
+
+    Trap trap;
+    auto trapResult = trap.run([](ExecutionState& state, void* data) {
+        WasiThreadStart* start = reinterpret_cast<WasiThreadStart*>(data);
+        Value argv[2] = { Value(start->threadId), Value(start->startArg) };
+        start->function->call(state, argv, nullptr);
+    },
+                               start);
+
+    if (trapResult.exception) {
+        // A trap in any thread terminates the whole program.
+        fprintf(stderr, "Uncaught Exception in thread %d: %s\n", start->threadId, trapResult.exception->message().data());
+        fflush(stdout);
+        std::_Exit(1);
+    }
+
+    Engine::releaseThreadResources();
+
+#ifdef ENABLE_GC
+    GC_unregister_my_thread();
+#endif /* ENABLE_GC */
+
+    delete start;
+    WASI::threadFinished();
+}
+
+#if defined(OS_POSIX)
+static void* wasiThreadEntry(void* data)
+{
+    runWasiThread(reinterpret_cast<WasiThreadStart*>(data));
+    return nullptr;
+}
+#endif
+
+static bool startWasiThread(WasiThreadStart* start)
+{
+#if defined(OS_POSIX)
+    pthread_attr_t attributes;
+    pthread_t thread;
+
+    // The stack limit of ExecutionState must fit into the stack.
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, STACK_LIMIT_FROM_BASE + 1024 * 1024);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    int error = pthread_create(&thread, &attributes, wasiThreadEntry, start);
+    pthread_attr_destroy(&attributes);
+    return error == 0;
+#else
+    try {
+        std::thread(runWasiThread, start).detach();
+    } catch (const std::system_error&) {
+        return false;
+    }
+    return true;
+#endif
+}
+
+void WASI::thread_spawn(ExecutionState& state, Value* argv, Value* result, Instance* instance)
+{
+    Module* module = instance->module();
+    Store* store = module->store();
+    const int32_t failure = -static_cast<int32_t>(WasiErrNo::again);
+
+    if (module->numberOfMemoryTypes() == 0 || !instance->memory(0)->isShared()) {
+        result[0] = Value(failure);
+        return;
+    }
+
+    // The new instance gets the imports of the current one, so it shares
+    // the memory. Wasi functions are bound to their running instance, so
+    // they are created again.
+    const VectorWithFixedSize<ImportType*, std::allocator<ImportType*>>& importTypes = module->imports();
+    ExternVector importValues;
+    size_t funcIndex = 0;
+    size_t globIndex = 0;
+    size_t tableIndex = 0;
+    size_t memIndex = 0;
+    size_t tagIndex = 0;
+
+    importValues.reserve(importTypes.size());
+
+    for (size_t i = 0; i < importTypes.size(); i++) {
+        switch (importTypes[i]->importType()) {
+        case ImportType::Function: {
+            Function* function = instance->function(funcIndex++);
+
+            if (function->kind() == Function::WasiFunctionKind) {
+                function = WasiFunction::createWasiFunction(store, const_cast<FunctionType*>(function->functionType()),
+                                                            function->asWasiFunction()->callback());
+            }
+            importValues.push_back(function);
+            break;
+        }
+        case ImportType::Global:
+            importValues.push_back(instance->global(globIndex++));
+            break;
+        case ImportType::Table:
+            importValues.push_back(instance->table(tableIndex++));
+            break;
+        case ImportType::Memory:
+            importValues.push_back(instance->memory(memIndex++));
+            break;
+        case ImportType::Tag:
+            importValues.push_back(instance->tag(tagIndex++));
+            break;
+        default:
+            RELEASE_ASSERT_NOT_REACHED();
+            break;
+        }
+    }
+
+    if (memIndex == 0) {
+        // A memory defined by the module would not be shared with the new instance.
+        result[0] = Value(failure);
+        return;
+    }
+
+    // Runs the start function on the current thread, and
+    // traps are propagated to the caller.
+    Instance* threadInstance = module->instantiate(state, importValues);
+    std::string startName = "wasi_thread_start";
+    Function* startFunction = threadInstance->resolveExportFunction(startName);
+
+    if (startFunction == nullptr || !startFunction->functionType()->equals(store->getDefinedFunctionType(Store::I32I32R))) {
+        result[0] = Value(failure);
+        return;
+    }
+
+    uint32_t threadId = g_nextThreadId.fetch_add(1);
+
+    if (threadId > s_maxThreadId) {
+        result[0] = Value(failure);
+        return;
+    }
+
+    g_runningThreadCount.fetch_add(1);
+
+    WasiThreadStart* start = new WasiThreadStart(startFunction, static_cast<int32_t>(threadId), argv[0].asI32());
+
+    if (!startWasiThread(start)) {
+        // The thread owns start only when it is created.
+        delete start;
+        g_runningThreadCount.fetch_sub(1);
+        result[0] = Value(failure);
+        return;
+    }
+
+    result[0] = Value(static_cast<int32_t>(threadId));
+}
+
 } // namespace Walrus
 
 #endif
@@ -24,6 +24,7 @@
 #include "runtime/ObjectType.h"
 #include "runtime/Store.h"
 #include <uvwasi.h>
+#include <atomic>
 
 namespace Walrus {
 
@@ -179,14 +180,25 @@ public:
     static void initialize(uvwasi_t* uvwasi);
     static WasiFuncInfo* find(const std::string& funcName);
 
+    // wasi-threads, the functions are imported from the "wasi" module
+    // https://github.com/WebAssembly/wasi-threads
+    static WasiFuncInfo* findThreadFunction(const std::string& funcName);
+    static bool hasRunningThreads();
+    static void threadFinished();
+
 private:
     // wasi functions
 #define DECLARE_FUNCTION(NAME, FUNCTYPE) static void NAME(ExecutionState& state, Value* argv, Value* result, Instance* instance);
     FOR_EACH_WASI_FUNC(DECLARE_FUNCTION)
 #undef DECLARE_FUNCTION
 
+    static void thread_spawn(ExecutionState& state, Value* argv, Value* result, Instance* instance);
+
     static uvwasi_t* g_uvwasi;
     static WasiFuncInfo g_wasiFunctions[FuncEnd];
+    static WasiFuncInfo g_threadSpawnFunction;
+    static std::atomic<uint32_t> g_nextThreadId;
+    static std::atomic<uint32_t> g_runningThreadCount;
 };
 
 } // namespace Walrus
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Helpers shared by the benchmarks and tests of this directory. The C
+ * programs include wasm.h before this file, the C++ programs use the
+ * internal interface of the engine.
+ */
+
+#ifndef __WalrusBenchmark__
+#define __WalrusBenchmark__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Monotonic time in seconds.
+static inline double benchmarkTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static inline int benchmarkUsage(const char* program, const char* arguments)
+{
+    fprintf(stderr, "usage: %s %s\n", program, arguments);
+    return 1;
+}
+
+// Prints the time of count operations named by unit, and returns failed.
+static inline int benchmarkReport(const char* name, unsigned long long count, const char* unit, double seconds, int failed)
+{
+    printf("%s: %llu %ss, %.3f s, %.1f ns/%s%s\n", name, count, unit, seconds,
+           seconds * 1e9 / (double)count, unit, failed ? " (FAILED)" : "");
+    return failed;
+}
+
+#if defined(WASM_H)
+typedef struct {
+    wasm_engine_t* engine;
+    wasm_store_t* store;
+    wasm_module_t* module;
+    wasm_instance_t* instance;
+    wasm_extern_vec_t exports;
+} BenchmarkInstance;
+
+// Instantiates a module without imports, returns nonzero on failure.
+static inline int benchmarkInstantiate(BenchmarkInstance* instance, wasm_engine_t* engine, const byte_t* data, size_t size)
+{
+    memset(instance, 0, sizeof(BenchmarkInstance));
+    instance->engine = engine;
+    instance->store = wasm_store_new(engine);
+
+    wasm_byte_vec_t binary;
+    wasm_byte_vec_new(&binary, size, (const wasm_byte_t*)data);
+    instance->module = wasm_module_new(instance->store, &binary);
+    wasm_byte_vec_delete(&binary);
+
+    if (instance->module == NULL) {
+        fprintf(stderr, "error: failed to compile module\n");
+        return 1;
+    }
+
+    wasm_extern_vec_t imports = WASM_EMPTY_VEC;
+    instance->instance = wasm_instance_new(instance->store, instance->module, &imports, NULL);
+
+    if (instance->instance == NULL) {
+        fprintf(stderr, "error: failed to instantiate module\n");
+        return 1;
+    }
+
+    wasm_instance_exports(instance->instance, &instance->exports);
+    return 0;
+}
+
+static inline void benchmarkDelete(BenchmarkInstance* instance)
+{
+    if (instance->instance != NULL) {
+        wasm_extern_vec_delete(&instance->exports);
+        wasm_instance_delete(instance->instance);
+    }
+    if (instance->module != NULL) {
+        wasm_module_delete(instance->module);
+    }
+    wasm_store_delete(instance->store);
+    wasm_engine_delete(instance->engine);
+}
+#endif /* WASM_H */
+
+#if defined(__cplusplus)
+#include "Walrus.h"
+#include "runtime/Engine.h"
+#include "runtime/Store.h"
+#include "runtime/Module.h"
+#include "runtime/Instance.h"
+#include "runtime/Function.h"
+#include "runtime/Trap.h"
+#include "parser/WASMParser.h"
+
+// The optional "jit" argument at index selects the JIT compiler.
+static inline uint32_t benchmarkJITFlags(int argc, const char* argv[], int index)
+{
+    return (argc > index && strcmp(argv[index], "jit") == 0) ? Walrus::JITFlagValue::useJIT : 0;
+}
+
+static inline Walrus::Module* benchmarkParse(Walrus::Store* store, const uint8_t* data, size_t size, uint32_t JITFlags)
+{
+    auto parseResult = Walrus::WASMParser::parseBinary(store, std::string(), data, size, JITFlags);
+    if (!parseResult.first.hasValue()) {
+        fprintf(stderr, "error: %s\n", parseResult.second.c_str());
+        return nullptr;
+    }
+    return parseResult.first.unwrap();
+}
+
+struct BenchmarkCall {
+    Walrus::Module* module;
+    const Walrus::ExternVector* imports;
+    const char* name;
+    int32_t argument;
+    int32_t result;
+};
+
+// Instantiates the module, and calls its (i32) -> i32 export.
+static inline Walrus::Trap::TrapResult benchmarkCall(Walrus::Module* module, const Walrus::ExternVector& imports,
+                                                     const char* name, int32_t argument, int32_t& result)
+{
+    BenchmarkCall call = { module, &imports, name, argument, 0 };
+
+    Walrus::Trap trap;
+    auto trapResult = trap.run([](Walrus::ExecutionState& state, void* d) {
+        BenchmarkCall* call = reinterpret_cast<BenchmarkCall*>(d);
+        Walrus::Instance* instance = call->module->instantiate(state, *call->imports);
+        std::string exportName(call->name);
+        Walrus::Value argv[1] = { Walrus::Value(call->argument) };
+        Walrus::Value result[1];
+
+        instance->resolveExportFunction(exportName)->call(state, argv, result);
+        call->result = result[0].asI32();
+    },
+                               &call);
+
+    result = call.result;
+    return trapResult;
+}
+#endif /* __cplusplus */
+
+#endif // __WalrusBenchmark__
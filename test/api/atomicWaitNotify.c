@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Contention benchmark of memory.atomic.wait and memory.atomic.notify.
+ * The threads are paired, and the two threads of a pair take turns on
+ * a shared counter, so every turn is a notify and a wait.
+ *
+ * usage: atomicWaitNotify [threads] [turns] [32|64]
+ */
+
+#include <pthread.h>
+
+#include "wasm.h"
+#include "Benchmark.h"
+
+/*
+ * (module
+ *   (memory (export "memory") 1 1 shared)
+ *
+ *   ;; Takes count turns on the counter at addr with the other thread of the
+ *   ;; pair, a turn is taken when the parity of the counter matches.
+ *   (func (export "pingPong32") (param $addr i32) (param $parity i32) (param $count i32)
+ *     (local $value i32)
+ *     (block $done
+ *       (loop $turn
+ *         (br_if $done (i32.eqz (local.get $count)))
+ *         (block $ready
+ *           (loop $wait
+ *             (local.set $value (i32.atomic.load (local.get $addr)))
+ *             (br_if $ready (i32.eq (i32.and (local.get $value) (i32.const 1)) (local.get $parity)))
+ *             (drop (memory.atomic.wait32 (local.get $addr) (local.get $value) (i64.const -1)))
+ *             (br $wait)))
+ *         (i32.atomic.store (local.get $addr) (i32.add (local.get $value) (i32.const 1)))
+ *         (drop (memory.atomic.notify (local.get $addr) (i32.const 1)))
+ *         (local.set $count (i32.sub (local.get $count) (i32.const 1)))
+ *         (br $turn))))
+ *
+ *   (func (export "pingPong64") (param $addr i32) (param $parity i32) (param $count i32)
+ *     (local $value i64)
+ *     (block $done
+ *       (loop $turn
+ *         (br_if $done (i32.eqz (local.get $count)))
+ *         (block $ready
+ *           (loop $wait
+ *             (local.set $value (i64.atomic.load (local.get $addr)))
+ *             (br_if $ready (i64.eq (i64.and (local.get $value) (i64.const 1)) (i64.extend_i32_u (local.get $parity))))
+ *             (drop (memory.atomic.wait64 (local.get $addr) (local.get $value) (i64.const -1)))
+ *             (br $wait)))
+ *         (i64.atomic.store (local.get $addr) (i64.add (local.get $value) (i64.const 1)))
+ *         (drop (memory.atomic.notify (local.get $addr) (i32.const 1)))
+ *         (local.set $count (i32.sub (local.get $count) (i32.const 1)))
+ *         (br $turn))))
+ * )
+ */
+static const byte_t pingPongWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x03, 0x7f, 0x7f, 0x7f, 0x00, 0x03, 0x03, 0x02, 0x00, 0x00, 0x05, 0x04,
+    0x01, 0x03, 0x01, 0x01, 0x07, 0x24, 0x03, 0x06, 0x6d, 0x65, 0x6d, 0x6f,
+    0x72, 0x79, 0x02, 0x00, 0x0a, 0x70, 0x69, 0x6e, 0x67, 0x50, 0x6f, 0x6e,
+    0x67, 0x33, 0x32, 0x00, 0x00, 0x0a, 0x70, 0x69, 0x6e, 0x67, 0x50, 0x6f,
+    0x6e, 0x67, 0x36, 0x34, 0x00, 0x01, 0x0a, 0xa6, 0x01, 0x02, 0x51, 0x01,
+    0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x02, 0x45, 0x0d, 0x01, 0x02,
+    0x40, 0x03, 0x40, 0x20, 0x00, 0xfe, 0x10, 0x02, 0x00, 0x21, 0x03, 0x20,
+    0x03, 0x41, 0x01, 0x71, 0x20, 0x01, 0x46, 0x0d, 0x01, 0x20, 0x00, 0x20,
+    0x03, 0x42, 0x7f, 0xfe, 0x01, 0x02, 0x00, 0x1a, 0x0c, 0x00, 0x0b, 0x0b,
+    0x20, 0x00, 0x20, 0x03, 0x41, 0x01, 0x6a, 0xfe, 0x17, 0x02, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0xfe, 0x00, 0x02, 0x00, 0x1a, 0x20, 0x02, 0x41, 0x01,
+    0x6b, 0x21, 0x02, 0x0c, 0x00, 0x0b, 0x0b, 0x0b, 0x52, 0x01, 0x01, 0x7e,
+    0x02, 0x40, 0x03, 0x40, 0x20, 0x02, 0x45, 0x0d, 0x01, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x00, 0xfe, 0x11, 0x03, 0x00, 0x21, 0x03, 0x20, 0x03, 0x42,
+    0x01, 0x83, 0x20, 0x01, 0xad, 0x51, 0x0d, 0x01, 0x20, 0x00, 0x20, 0x03,
+    0x42, 0x7f, 0xfe, 0x02, 0x03, 0x00, 0x1a, 0x0c, 0x00, 0x0b, 0x0b, 0x20,
+    0x00, 0x20, 0x03, 0x42, 0x01, 0x7c, 0xfe, 0x18, 0x03, 0x00, 0x20, 0x00,
+    0x41, 0x01, 0xfe, 0x00, 0x02, 0x00, 0x1a, 0x20, 0x02, 0x41, 0x01, 0x6b,
+    0x21, 0x02, 0x0c, 0x00, 0x0b, 0x0b, 0x0b,
+};
+
+// Counters of the pairs are placed into separate cache lines.
+#define COUNTER_DISTANCE 64
+
+typedef struct {
+    const wasm_func_t* func;
+    int32_t address;
+    int32_t parity;
+    int32_t turns;
+    int failed;
+} ThreadData;
+
+static void* runThread(void* arg)
+{
+    ThreadData* data = (ThreadData*)arg;
+    wasm_val_t args[3] = { WASM_I32_VAL(data->address), WASM_I32_VAL(data->parity), WASM_I32_VAL(data->turns) };
+    wasm_val_vec_t argsVec = WASM_ARRAY_VEC(args);
+    wasm_val_vec_t resultsVec = WASM_EMPTY_VEC;
+
+    wasm_trap_t* trap = wasm_func_call(data->func, &argsVec, &resultsVec);
+    if (trap != NULL) {
+        wasm_trap_delete(trap);
+        data->failed = 1;
+    }
+    return NULL;
+}
+
+int main(int argc, const char* argv[])
+{
+    int threadCount = argc > 1 ? atoi(argv[1]) : 4;
+    int turns = argc > 2 ? atoi(argv[2]) : 100000;
+    int is64 = argc > 3 && strcmp(argv[3], "64") == 0;
+    int failed = 0;
+
+    threadCount &= ~1;
+    if (threadCount <= 0 || threadCount * COUNTER_DISTANCE / 2 > 65536 || turns <= 0) {
+        return benchmarkUsage(argv[0], "[threads] [turns] [32|64]");
+    }
+
+    BenchmarkInstance instance;
+    if (benchmarkInstantiate(&instance, wasm_engine_new(), pingPongWasm, sizeof(pingPongWasm))) {
+        benchmarkDelete(&instance);
+        return 1;
+    }
+
+    wasm_memory_t* memory = wasm_extern_as_memory(instance.exports.data[0]);
+    const wasm_func_t* func = wasm_extern_as_func(instance.exports.data[is64 ? 2 : 1]);
+
+    ThreadData* data = (ThreadData*)calloc(threadCount, sizeof(ThreadData));
+    pthread_t* threads = (pthread_t*)calloc(threadCount, sizeof(pthread_t));
+    double start = benchmarkTime();
+
+    for (int i = 0; i < threadCount; i++) {
+        data[i].func = func;
+        data[i].address = (i / 2) * COUNTER_DISTANCE;
+        data[i].parity = i & 1;
+        data[i].turns = turns;
+        pthread_create(&threads[i], NULL, runThread, &data[i]);
+    }
+
+    for (int i = 0; i < threadCount; i++) {
+        pthread_join(threads[i], NULL);
+        failed |= data[i].failed;
+    }
+
+    double seconds = benchmarkTime() - start;
+
+    // Each counter is increased by both threads of its pair.
+    byte_t* memoryData = wasm_memory_data(memory);
+    for (int i = 0; i < threadCount / 2; i++) {
+        uint32_t counter;
+        memcpy(&counter, memoryData + i * COUNTER_DISTANCE, sizeof(counter));
+        if (counter != (uint32_t)turns * 2) {
+            failed = 1;
+        }
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "wait%d with %d threads", is64 ? 64 : 32, threadCount);
+    failed = benchmarkReport(name, (unsigned long long)turns * threadCount, "turn", seconds, failed);
+
+    free(threads);
+    free(data);
+    benchmarkDelete(&instance);
+    return failed;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Epoch interruption benchmark. A loop which calls a small function is
+ * run without and with epoch checks, which are executed at every loop
+ * header and function entry. The deadline itself is tested by
+ * epochDeadline.cpp.
+ *
+ * usage: epochCheck [iterations] [jit]
+ */
+
+#include "Benchmark.h"
+
+using namespace Walrus;
+
+/*
+ * (module
+ *   (func $inc (param i32) (result i32)
+ *     (i32.add (local.get 0) (i32.const 1)))
+ *   (func (export "run") (param $n i32) (result i32)
+ *     (local $acc i32)
+ *     (loop $loop
+ *       (local.set $acc (call $inc (local.get $acc)))
+ *       (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+ *     (local.get $acc)))
+ */
+static const uint8_t epochCheckWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x07, 0x01,
+    0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x22, 0x02, 0x07, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0x6a, 0x0b, 0x18, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20,
+    0x01, 0x10, 0x00, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00,
+    0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b
+};
+
+static bool measure(bool epochInterruption, uint32_t JITFlags, int32_t iterations, const char* name)
+{
+    Engine* engine = new Engine();
+    engine->setEpochInterruption(epochInterruption);
+    Store* store = new Store(engine);
+    Module* module = benchmarkParse(store, epochCheckWasm, sizeof(epochCheckWasm), JITFlags);
+    bool failed = true;
+
+    if (module != nullptr) {
+        ExternVector importValues;
+        int32_t result;
+        double start = benchmarkTime();
+        auto trapResult = benchmarkCall(module, importValues, "run", iterations, result);
+        double seconds = benchmarkTime() - start;
+
+        failed = benchmarkReport(name, iterations, "iteration", seconds, trapResult.exception != nullptr || result != iterations);
+    }
+
+    delete store;
+    delete engine;
+    return failed;
+}
+
+int main(int argc, const char* argv[])
+{
+    int32_t iterations = argc > 1 ? atoi(argv[1]) : 100000000;
+    uint32_t JITFlags = benchmarkJITFlags(argc, argv, 2);
+
+    if (iterations <= 0) {
+        return benchmarkUsage(argv[0], "[iterations] [jit]");
+    }
+
+    bool failed = measure(false, JITFlags, iterations, "no epoch checks");
+    failed |= measure(true, JITFlags, iterations, "epoch checks");
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Epoch deadline test. The loop of the module traps when the deadline
+ * of its store is reached, unless the deadline callback extends it.
+ * Both the interpreter and the JIT compiled code are tested.
+ *
+ * usage: epochDeadline
+ */
+
+#include "Benchmark.h"
+
+using namespace Walrus;
+
+/*
+ * (module
+ *   (func $inc (param i32) (result i32)
+ *     (i32.add (local.get 0) (i32.const 1)))
+ *   (func (export "run") (param $n i32) (result i32)
+ *     (local $acc i32)
+ *     (loop $loop
+ *       (local.set $acc (call $inc (local.get $acc)))
+ *       (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+ *     (local.get $acc)))
+ */
+static const uint8_t epochDeadlineWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x07, 0x01,
+    0x03, 0x72, 0x75, 0x6e, 0x00, 0x01, 0x0a, 0x22, 0x02, 0x07, 0x00, 0x20,
+    0x00, 0x41, 0x01, 0x6a, 0x0b, 0x18, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20,
+    0x01, 0x10, 0x00, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00,
+    0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b
+};
+
+static size_t extendOnce(ExecutionState& state, void* data)
+{
+    int* calls = reinterpret_cast<int*>(data);
+    return (*calls)++ == 0 ? 1 : 0;
+}
+
+static bool check(bool failed, const char* mode, const char* name)
+{
+    printf("%s %s: %s\n", mode, name, failed ? "FAILED" : "ok");
+    return failed;
+}
+
+static bool test(uint32_t JITFlags, const char* mode)
+{
+    Engine* engine = new Engine();
+    engine->setEpochInterruption(true);
+    Store* store = new Store(engine);
+    Module* module = benchmarkParse(store, epochDeadlineWasm, sizeof(epochDeadlineWasm), JITFlags);
+
+    if (module == nullptr) {
+        delete store;
+        delete engine;
+        return check(true, mode, "parse");
+    }
+
+    ExternVector importValues;
+    int32_t result;
+    bool failed;
+
+    engine->incrementEpoch();
+    failed = benchmarkCall(module, importValues, "run", 1000, result).exception != nullptr || result != 1000;
+    bool anyFailed = check(failed, mode, "no deadline");
+
+    store->setEpochDeadline(1);
+    engine->incrementEpoch();
+    auto trapResult = benchmarkCall(module, importValues, "run", 1000, result);
+    failed = trapResult.exception == nullptr || trapResult.exception->message() != "epoch deadline reached";
+    anyFailed |= check(failed, mode, "deadline reached");
+
+    int calls = 0;
+    store->setEpochDeadline(1);
+    store->setEpochDeadlineCallback(extendOnce, &calls);
+    engine->incrementEpoch();
+    failed = benchmarkCall(module, importValues, "run", 1000, result).exception != nullptr || result != 1000 || calls != 1;
+    anyFailed |= check(failed, mode, "deadline extended");
+
+    engine->incrementEpoch();
+    failed = benchmarkCall(module, importValues, "run", 1000, result).exception == nullptr || calls != 2;
+    anyFailed |= check(failed, mode, "extended deadline reached");
+
+    delete store;
+    delete engine;
+    return anyFailed;
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc > 1) {
+        return benchmarkUsage(argv[0], "");
+    }
+
+    bool failed = test(0, "interpreter");
+#if defined(WALRUS_ENABLE_JIT)
+    failed |= test(JITFlagValue::useJIT, "jit");
+#endif
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Embedder call benchmark. A small exported function is called from
+ * the host with wasm_func_call, then with a prepared call.
+ *
+ * usage: funcCall [calls]
+ */
+
+#include "wasm.h"
+#include "Benchmark.h"
+
+/*
+ * (module
+ *   (func (export "add") (param i32 i32) (result i32)
+ *     (i32.add (local.get 0) (local.get 1))))
+ */
+static const byte_t addWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x07, 0x01,
+    0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x0a, 0x09, 0x01, 0x07, 0x00, 0x20,
+    0x00, 0x20, 0x01, 0x6a, 0x0b
+};
+
+int main(int argc, const char* argv[])
+{
+    int calls = argc > 1 ? atoi(argv[1]) : 10000000;
+    int result = 0;
+
+    if (calls <= 0) {
+        return benchmarkUsage(argv[0], "[calls]");
+    }
+
+    BenchmarkInstance instance;
+    if (benchmarkInstantiate(&instance, wasm_engine_new(), addWasm, sizeof(addWasm))) {
+        benchmarkDelete(&instance);
+        return 1;
+    }
+
+    const wasm_func_t* func = wasm_extern_as_func(instance.exports.data[0]);
+
+    // Sum of 0 .. calls - 1 modulo 2^32.
+    uint32_t expected = (uint32_t)((uint64_t)calls * (uint64_t)(calls - 1) / 2);
+    double start;
+
+    {
+        wasm_val_t args[2] = { WASM_I32_VAL(0), WASM_I32_VAL(0) };
+        wasm_val_t results[1] = { WASM_INIT_VAL };
+        wasm_val_vec_t argsVec = WASM_ARRAY_VEC(args);
+        wasm_val_vec_t resultsVec = WASM_ARRAY_VEC(results);
+        int failed = 0;
+
+        start = benchmarkTime();
+
+        for (int i = 0; i < calls; i++) {
+            args[1].of.i32 = i;
+            if (wasm_func_call(func, &argsVec, &resultsVec) != NULL) {
+                failed = 1;
+                break;
+            }
+            args[0].of.i32 = results[0].of.i32;
+        }
+
+        failed |= (uint32_t)args[0].of.i32 != expected;
+        result |= benchmarkReport("wasm_func_call", calls, "call", benchmarkTime() - start, failed);
+    }
+
+    {
+        wasm_val_t args[2] = { WASM_I32_VAL(0), WASM_I32_VAL(0) };
+        wasm_val_t results[1] = { WASM_INIT_VAL };
+        wasm_func_prepared_t* prepared = wasm_func_prepare(func);
+        int failed = 0;
+
+        start = benchmarkTime();
+
+        for (int i = 0; i < calls; i++) {
+            args[1].of.i32 = i;
+            if (wasm_func_prepared_call(prepared, args, results) != NULL) {
+                failed = 1;
+                break;
+            }
+            args[0].of.i32 = results[0].of.i32;
+        }
+
+        failed |= (uint32_t)args[0].of.i32 != expected;
+        result |= benchmarkReport("wasm_func_prepared_call", calls, "call", benchmarkTime() - start, failed);
+        wasm_func_prepared_delete(prepared);
+    }
+
+    benchmarkDelete(&instance);
+    return result;
+}
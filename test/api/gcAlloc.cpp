@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*
+ * WasmGC allocation benchmark. A linked list is built from struct.new
+ * in a loop, then a binary tree is built by recursive calls.
+ *
+ * usage: gcAlloc [nodes] [depth] [jit]
+ */
+
+#include "Benchmark.h"
+
+using namespace Walrus;
+
+/*
+ * (module
+ *   (type $node (struct (field $value i32) (field $next (ref null $node))))
+ *   (type $tree (struct (field $left (ref null $tree)) (field $right (ref null $tree))))
+ *
+ *   (func $list (export "list") (param $n i32) (result i32)
+ *     (local $head (ref null $node))
+ *     (local $sum i32)
+ *     (loop $build
+ *       (local.set $head (struct.new $node (local.get $n) (local.get $head)))
+ *       (br_if $build (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+ *     (loop $walk
+ *       (local.set $sum (i32.add (local.get $sum) (struct.get $node $value (local.get $head))))
+ *       (br_if $walk (i32.eqz (ref.is_null (local.tee $head (struct.get $node $next (local.get $head)))))))
+ *     (local.get $sum))
+ *
+ *   (func $build (param $depth i32) (result (ref $tree))
+ *     (if (result (ref $tree)) (i32.eqz (local.get $depth))
+ *       (then (struct.new_default $tree))
+ *       (else
+ *         (struct.new $tree
+ *           (call $build (i32.sub (local.get $depth) (i32.const 1)))
+ *           (call $build (i32.sub (local.get $depth) (i32.const 1)))))))
+ *
+ *   (func $count (param $tree (ref null $tree)) (result i32)
+ *     (if (result i32) (ref.is_null (local.get $tree))
+ *       (then (i32.const 0))
+ *       (else
+ *         (i32.add (i32.const 1)
+ *           (i32.add
+ *             (call $count (struct.get $tree $left (local.get $tree)))
+ *             (call $count (struct.get $tree $right (local.get $tree))))))))
+ *
+ *   (func (export "tree") (param $depth i32) (result i32)
+ *     (call $count (call $build (local.get $depth)))))
+ */
+static const uint8_t gcAllocWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x21, 0x05, 0x5f,
+    0x02, 0x7f, 0x00, 0x63, 0x00, 0x00, 0x5f, 0x02, 0x63, 0x01, 0x00, 0x63,
+    0x01, 0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x64,
+    0x01, 0x60, 0x01, 0x63, 0x01, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x02, 0x03,
+    0x04, 0x02, 0x07, 0x0f, 0x02, 0x04, 0x6c, 0x69, 0x73, 0x74, 0x00, 0x00,
+    0x04, 0x74, 0x72, 0x65, 0x65, 0x00, 0x03, 0x0a, 0x82, 0x01, 0x04, 0x38,
+    0x02, 0x01, 0x63, 0x00, 0x01, 0x7f, 0x03, 0x40, 0x20, 0x00, 0x20, 0x01,
+    0xfb, 0x00, 0x00, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00,
+    0x0d, 0x00, 0x0b, 0x03, 0x40, 0x20, 0x02, 0x20, 0x01, 0xfb, 0x02, 0x00,
+    0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0xfb, 0x02, 0x00, 0x01, 0x22, 0x01,
+    0xd1, 0x45, 0x0d, 0x00, 0x0b, 0x20, 0x02, 0x0b, 0x1e, 0x00, 0x20, 0x00,
+    0x45, 0x04, 0x64, 0x01, 0xfb, 0x01, 0x01, 0x05, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x10, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x01, 0xfb, 0x00,
+    0x01, 0x0b, 0x0b, 0x1f, 0x00, 0x20, 0x00, 0xd1, 0x04, 0x7f, 0x41, 0x00,
+    0x05, 0x41, 0x01, 0x20, 0x00, 0xfb, 0x02, 0x01, 0x00, 0x10, 0x02, 0x20,
+    0x00, 0xfb, 0x02, 0x01, 0x01, 0x10, 0x02, 0x6a, 0x6a, 0x0b, 0x0b, 0x08,
+    0x00, 0x20, 0x00, 0x10, 0x01, 0x10, 0x02, 0x0b
+};
+
+static bool run(Module* module, const char* name, int32_t argument, uint32_t expected, uint64_t allocations)
+{
+    ExternVector importValues;
+    int32_t result;
+    double start = benchmarkTime();
+    auto trapResult = benchmarkCall(module, importValues, name, argument, result);
+    double seconds = benchmarkTime() - start;
+
+    return benchmarkReport(name, allocations, "object", seconds, trapResult.exception != nullptr || static_cast<uint32_t>(result) != expected);
+}
+
+int main(int argc, const char* argv[])
+{
+    int32_t nodes = argc > 1 ? atoi(argv[1]) : 10000000;
+    int32_t depth = argc > 2 ? atoi(argv[2]) : 22;
+    uint32_t JITFlags = benchmarkJITFlags(argc, argv, 3);
+
+    if (nodes <= 0 || depth < 0 || depth > 30) {
+        return benchmarkUsage(argv[0], "[nodes] [depth] [jit]");
+    }
+
+    Engine* engine = new Engine();
+    Store* store = new Store(engine);
+    Module* module = benchmarkParse(store, gcAllocWasm, sizeof(gcAllocWasm), JITFlags);
+
+    if (module == nullptr) {
+        delete store;
+        delete engine;
+        return 1;
+    }
+
+    // Sum of 1 .. nodes modulo 2^32.
+    uint64_t nodes64 = static_cast<uint64_t>(nodes);
+    bool failed = run(module, "list", nodes, static_cast<uint32_t>(nodes64 * (nodes64 + 1) / 2), nodes64);
+
+    uint64_t treeNodes = (static_cast<uint64_t>(1) << (depth + 1)) - 1;
+    failed |= run(module, "tree", depth, static_cast<uint32_t>(treeNodes), treeNodes);
+
+    delete store;
+    delete engine;
+    return failed ? 1 : 0;
+}
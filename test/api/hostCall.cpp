@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Host call benchmark. A trivial (i32, i32) -> i32 import is called
+ * from a loop, first as an imported function which receives boxed
+ * Values, then as a typed function.
+ *
+ * usage: hostCall [calls] [jit]
+ */
+
+#include "Benchmark.h"
+
+using namespace Walrus;
+
+/*
+ * (module
+ *   (import "env" "add" (func $add (param i32 i32) (result i32)))
+ *   (func (export "run") (param $n i32) (result i32)
+ *     (local $acc i32)
+ *     (loop $loop
+ *       (local.set $acc (call $add (local.get $acc) (local.get $n)))
+ *       (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+ *     (local.get $acc)))
+ */
+static const uint8_t hostCallWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x0b,
+    0x01, 0x03, 0x65, 0x6e, 0x76, 0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x03,
+    0x02, 0x01, 0x01, 0x07, 0x07, 0x01, 0x03, 0x72, 0x75, 0x6e, 0x00, 0x01,
+    0x0a, 0x1c, 0x01, 0x1a, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x20,
+    0x00, 0x10, 0x00, 0x21, 0x01, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00,
+    0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b
+};
+
+static int32_t add(int32_t left, int32_t right)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(left) + static_cast<uint32_t>(right));
+}
+
+static int32_t typedAdd(ExecutionState& state, void* data, int32_t left, int32_t right)
+{
+    return add(left, right);
+}
+
+static bool run(Module* module, Function* function, int32_t calls, const char* name)
+{
+    ExternVector importValues;
+    importValues.push_back(function);
+
+    int32_t result;
+    double start = benchmarkTime();
+    auto trapResult = benchmarkCall(module, importValues, "run", calls, result);
+    double seconds = benchmarkTime() - start;
+
+    // Sum of 1 .. calls modulo 2^32.
+    uint64_t calls64 = static_cast<uint64_t>(calls);
+    uint32_t expected = static_cast<uint32_t>(calls64 * (calls64 + 1) / 2);
+    return benchmarkReport(name, calls, "call", seconds, trapResult.exception != nullptr || static_cast<uint32_t>(result) != expected);
+}
+
+int main(int argc, const char* argv[])
+{
+    int32_t calls = argc > 1 ? atoi(argv[1]) : 100000000;
+    uint32_t JITFlags = benchmarkJITFlags(argc, argv, 2);
+
+    if (calls <= 0) {
+        return benchmarkUsage(argv[0], "[calls] [jit]");
+    }
+
+    Engine* engine = new Engine();
+    Store* store = new Store(engine);
+    Module* module = benchmarkParse(store, hostCallWasm, sizeof(hostCallWasm), JITFlags);
+
+    if (module == nullptr) {
+        delete store;
+        delete engine;
+        return 1;
+    }
+
+    Function* importedAdd = ImportedFunction::createImportedFunction(
+        store,
+        store->getDefinedFunctionType(Store::I32I32_RI32),
+        [](ExecutionState& state, Value* argv, Value* result, void* data) {
+            result[0] = Value(add(argv[0].asI32(), argv[1].asI32()));
+        },
+        nullptr);
+    Function* typedFunctionAdd = TypedFunction::createTypedFunction(store, typedAdd, nullptr);
+
+    bool failed = run(module, importedAdd, calls, "imported");
+    failed |= run(module, typedFunctionAdd, calls, "typed");
+
+    delete store;
+    delete engine;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * JIT compilation time benchmark. A function with many blocks and a
+ * large frame is generated, and the time of parsing it with and without
+ * the JIT compiler is measured. The results of the interpreted and the
+ * compiled function are compared afterwards.
+ *
+ * usage: jitCompile [blocks] [frame size in bytes]
+ */
+
+#include "Benchmark.h"
+
+#include <sys/resource.h>
+
+using namespace Walrus;
+
+static void appendU32(std::vector<uint8_t>& out, uint32_t value)
+{
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        out.push_back(value != 0 ? (byte | 0x80) : byte);
+    } while (value != 0);
+}
+
+static void appendSection(std::vector<uint8_t>& out, uint8_t id, const std::vector<uint8_t>& content)
+{
+    out.push_back(id);
+    appendU32(out, content.size());
+    out.insert(out.end(), content.begin(), content.end());
+}
+
+/*
+ * (module
+ *   (func (export "run") (param $n i32) (result i32)
+ *     (local i32 ...)
+ *     (loop $loop
+ *       (block
+ *         (local.set $b (i32.add (local.get $a) (local.get $n)))
+ *         (br_if 0 (i32.and (local.get $n) (i32.const K)))
+ *         (local.set $c (i32.xor (local.get $c) (i32.const 1))))
+ *       ... repeated for each block
+ *       (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+ *     (local.get 1)))
+ */
+static std::vector<uint8_t> generate(uint32_t blocks, uint32_t localCount)
+{
+    std::vector<uint8_t> out = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+
+    appendSection(out, 1, { 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f });
+    appendSection(out, 3, { 0x01, 0x00 });
+    appendSection(out, 7, { 0x01, 0x03, 'r', 'u', 'n', 0x00, 0x00 });
+
+    std::vector<uint8_t> body;
+    body.push_back(0x01);
+    appendU32(body, localCount - 1);
+    body.push_back(0x7f);
+
+    body.insert(body.end(), { 0x03, 0x40 });
+
+    for (uint32_t i = 0; i < blocks; i++) {
+        uint32_t a = (i * 7) % localCount;
+        uint32_t b = 1 + (i * 13) % (localCount - 1);
+        uint32_t c = 1 + (i * 31) % (localCount - 1);
+
+        body.insert(body.end(), { 0x02, 0x40, 0x20 });
+        appendU32(body, a);
+        body.insert(body.end(), { 0x20, 0x00, 0x6a, 0x21 });
+        appendU32(body, b);
+        body.insert(body.end(), { 0x20, 0x00, 0x41, static_cast<uint8_t>(i & 0x7), 0x71, 0x0d, 0x00, 0x20 });
+        appendU32(body, c);
+        body.insert(body.end(), { 0x41, 0x01, 0x73, 0x21 });
+        appendU32(body, c);
+        body.push_back(0x0b);
+    }
+
+    body.insert(body.end(), { 0x20, 0x00, 0x41, 0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b });
+
+    std::vector<uint8_t> code;
+    code.push_back(0x01);
+    appendU32(code, body.size());
+    code.insert(code.end(), body.begin(), body.end());
+    appendSection(out, 10, code);
+    return out;
+}
+
+static bool measure(const std::vector<uint8_t>& wasm, uint32_t JITFlags, const char* name, uint32_t blocks, int32_t& result)
+{
+    Engine* engine = new Engine();
+    Store* store = new Store(engine);
+
+    double start = benchmarkTime();
+    Module* module = benchmarkParse(store, wasm.data(), wasm.size(), JITFlags);
+    double seconds = benchmarkTime() - start;
+    bool failed = true;
+
+    if (module != nullptr) {
+        ExternVector importValues;
+        failed = benchmarkCall(module, importValues, "run", 5, result).exception != nullptr;
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+
+        failed = benchmarkReport(name, blocks, "block", seconds, failed);
+        printf("%s: max rss %ld KB\n", name, static_cast<long>(usage.ru_maxrss));
+    }
+
+    delete store;
+    delete engine;
+    return failed;
+}
+
+int main(int argc, const char* argv[])
+{
+    int blocks = argc > 1 ? atoi(argv[1]) : 10000;
+    int frameSize = argc > 2 ? atoi(argv[2]) : 4096;
+
+    if (blocks <= 0 || frameSize < 8) {
+        return benchmarkUsage(argv[0], "[blocks] [frame size in bytes]");
+    }
+
+    std::vector<uint8_t> wasm = generate(blocks, frameSize / sizeof(int32_t));
+    int32_t interpreterResult;
+    int32_t jitResult;
+
+    printf("%d blocks, %d byte frame, %zu byte module\n", blocks, frameSize, wasm.size());
+
+    bool failed = measure(wasm, 0, "parse", blocks, interpreterResult);
+    failed |= measure(wasm, JITFlagValue::useJIT, "parse and compile", blocks, jitResult);
+
+    if (interpreterResult != jitResult) {
+        printf("result mismatch: %d != %d\n", interpreterResult, jitResult);
+        failed = true;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Exception handling benchmark. A function throws an exception which
+ * is caught by its caller in a tight loop.
+ *
+ * usage: throwCatch [throws]
+ */
+
+#include "wasm.h"
+#include "Benchmark.h"
+
+/*
+ * (module
+ *   (tag $e (param i32))
+ *   (func $thrower (param i32)
+ *     (throw $e (local.get 0)))
+ *   (func (export "run") (param $n i32) (result i32)
+ *     (local $acc i32)
+ *     (loop $loop
+ *       (try
+ *         (do
+ *           (call $thrower (local.get $n)))
+ *         (catch $e
+ *           (local.set $acc (i32.add (local.get $acc)))))
+ *       (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+ *     (local.get $acc)))
+ */
+static const byte_t throwCatchWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0a, 0x02, 0x60,
+    0x01, 0x7f, 0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00,
+    0x01, 0x0d, 0x03, 0x01, 0x00, 0x00, 0x07, 0x07, 0x01, 0x03, 0x72, 0x75,
+    0x6e, 0x00, 0x01, 0x0a, 0x29, 0x02, 0x06, 0x00, 0x20, 0x00, 0x08, 0x00,
+    0x0b, 0x20, 0x01, 0x01, 0x7f, 0x03, 0x40, 0x06, 0x40, 0x20, 0x00, 0x10,
+    0x00, 0x07, 0x00, 0x20, 0x01, 0x6a, 0x21, 0x01, 0x0b, 0x20, 0x00, 0x41,
+    0x01, 0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x20, 0x01, 0x0b
+};
+
+int main(int argc, const char* argv[])
+{
+    int throws = argc > 1 ? atoi(argv[1]) : 10000000;
+
+    if (throws <= 0) {
+        return benchmarkUsage(argv[0], "[throws]");
+    }
+
+    BenchmarkInstance instance;
+    if (benchmarkInstantiate(&instance, wasm_engine_new(), throwCatchWasm, sizeof(throwCatchWasm))) {
+        benchmarkDelete(&instance);
+        return 1;
+    }
+
+    const wasm_func_t* func = wasm_extern_as_func(instance.exports.data[0]);
+
+    wasm_val_t args[1] = { WASM_I32_VAL(throws) };
+    wasm_val_t results[1] = { WASM_INIT_VAL };
+    wasm_val_vec_t argsVec = WASM_ARRAY_VEC(args);
+    wasm_val_vec_t resultsVec = WASM_ARRAY_VEC(results);
+
+    double start = benchmarkTime();
+    wasm_trap_t* trap = wasm_func_call(func, &argsVec, &resultsVec);
+    double seconds = benchmarkTime() - start;
+
+    // Sum of 1 .. throws modulo 2^32.
+    uint32_t expected = (uint32_t)((uint64_t)throws * (uint64_t)(throws + 1) / 2);
+    int failed = benchmarkReport("throw/catch", throws, "throw", seconds,
+                                 trap != NULL || (uint32_t)results[0].of.i32 != expected);
+
+    if (trap != NULL) {
+        wasm_trap_delete(trap);
+    }
+    benchmarkDelete(&instance);
+    return failed;
+}
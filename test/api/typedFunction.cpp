@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Typed host function test. Imports with different arities and value
+ * types are called directly, through a table and from the embedder, a
+ * trap thrown by a callback is propagated, and the canonical type of a
+ * typed function is checked by ref.test. Both the interpreter and the
+ * JIT compiled code are tested.
+ *
+ * usage: typedFunction
+ */
+
+#include "Benchmark.h"
+
+using namespace Walrus;
+
+/*
+ * (module
+ *   (type $i64 (func (param i64 i64 i64) (result i64)))
+ *   (type $f32 (func (param f32 f32) (result f32)))
+ *   (type $f64 (func (param f64 i32 f64 i64) (result f64)))
+ *   (type $void (func (param i32)))
+ *   (type $i32 (func (param i32) (result i32)))
+ *   (type $none (func (result i32)))
+ *   (import "env" "i64" (func $i64 (type $i64)))
+ *   (import "env" "f32" (func $f32 (type $f32)))
+ *   (import "env" "f64" (func $f64 (type $f64)))
+ *   (import "env" "void" (func $void (type $void)))
+ *   (import "env" "trap" (func $trap (type $i32)))
+ *   (import "env" "none" (func $none (type $none)))
+ *   (table 1 funcref)
+ *   (elem (i32.const 0) $trap)
+ *   (func (export "i64") (type $i64)
+ *     (call $i64 (local.get 0) (local.get 1) (local.get 2)))
+ *   (func (export "f32") (type $f32)
+ *     (call $f32 (local.get 0) (local.get 1)))
+ *   (func (export "f64") (type $f64)
+ *     (call $f64 (local.get 0) (local.get 1) (local.get 2) (local.get 3)))
+ *   (func (export "void") (type $i32)
+ *     (call $void (local.get 0))
+ *     (i32.add (local.get 0) (i32.const 1)))
+ *   (func (export "trap") (type $i32)
+ *     (call $trap (local.get 0)))
+ *   (func (export "none") (type $none)
+ *     (call $none))
+ *   (func (export "indirect") (type $i32)
+ *     (call_indirect (type $i32) (local.get 0) (i32.const 0)))
+ *   (func (export "refTest") (type $none)
+ *     (ref.test (ref $i32) (ref.func $trap))))
+ */
+static const uint8_t typedFunctionWasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x23, 0x06, 0x60,
+    0x03, 0x7e, 0x7e, 0x7e, 0x01, 0x7e, 0x60, 0x02, 0x7d, 0x7d, 0x01, 0x7d,
+    0x60, 0x04, 0x7c, 0x7f, 0x7c, 0x7e, 0x01, 0x7c, 0x60, 0x01, 0x7f, 0x00,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x02, 0x40, 0x06,
+    0x03, 0x65, 0x6e, 0x76, 0x03, 0x69, 0x36, 0x34, 0x00, 0x00, 0x03, 0x65,
+    0x6e, 0x76, 0x03, 0x66, 0x33, 0x32, 0x00, 0x01, 0x03, 0x65, 0x6e, 0x76,
+    0x03, 0x66, 0x36, 0x34, 0x00, 0x02, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x76,
+    0x6f, 0x69, 0x64, 0x00, 0x03, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x74, 0x72,
+    0x61, 0x70, 0x00, 0x04, 0x03, 0x65, 0x6e, 0x76, 0x04, 0x6e, 0x6f, 0x6e,
+    0x65, 0x00, 0x05, 0x03, 0x09, 0x08, 0x00, 0x01, 0x02, 0x04, 0x04, 0x05,
+    0x04, 0x05, 0x04, 0x04, 0x01, 0x70, 0x00, 0x01, 0x07, 0x3d, 0x08, 0x03,
+    0x69, 0x36, 0x34, 0x00, 0x06, 0x03, 0x66, 0x33, 0x32, 0x00, 0x07, 0x03,
+    0x66, 0x36, 0x34, 0x00, 0x08, 0x04, 0x76, 0x6f, 0x69, 0x64, 0x00, 0x09,
+    0x04, 0x74, 0x72, 0x61, 0x70, 0x00, 0x0a, 0x04, 0x6e, 0x6f, 0x6e, 0x65,
+    0x00, 0x0b, 0x08, 0x69, 0x6e, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74, 0x00,
+    0x0c, 0x07, 0x72, 0x65, 0x66, 0x54, 0x65, 0x73, 0x74, 0x00, 0x0d, 0x09,
+    0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x04, 0x0a, 0x4c, 0x08, 0x0a,
+    0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0x10, 0x00, 0x0b, 0x08, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0x10, 0x01, 0x0b, 0x0c, 0x00, 0x20, 0x00, 0x20,
+    0x01, 0x20, 0x02, 0x20, 0x03, 0x10, 0x02, 0x0b, 0x0b, 0x00, 0x20, 0x00,
+    0x10, 0x03, 0x20, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x06, 0x00, 0x20, 0x00,
+    0x10, 0x04, 0x0b, 0x04, 0x00, 0x10, 0x05, 0x0b, 0x09, 0x00, 0x20, 0x00,
+    0x41, 0x00, 0x11, 0x04, 0x00, 0x0b, 0x07, 0x00, 0xd2, 0x04, 0xfb, 0x14,
+    0x04, 0x0b
+};
+
+static int64_t typedI64(ExecutionState& state, void* data, int64_t a, int64_t b, int64_t c)
+{
+    return a * 1000000 + b * 1000 + c;
+}
+
+static float typedF32(ExecutionState& state, void* data, float a, float b)
+{
+    return a - b * 2;
+}
+
+static double typedF64(ExecutionState& state, void* data, double a, int32_t i, double b, int64_t l)
+{
+    return a * i - b + static_cast<double>(l);
+}
+
+static void typedVoid(ExecutionState& state, void* data, int32_t value)
+{
+    *reinterpret_cast<int32_t*>(data) += value;
+}
+
+static int32_t typedTrap(ExecutionState& state, void* data, int32_t value)
+{
+    if (value == 0) {
+        Trap::throwException(state, "typed trap");
+    }
+    return value * 2;
+}
+
+static int32_t typedNone(ExecutionState& state, void* data)
+{
+    return 42;
+}
+
+struct CallData {
+    Function* function;
+    Value* argv;
+    Value* result;
+};
+
+static Trap::TrapResult callFunction(Function* function, Value* argv, Value* result)
+{
+    CallData data = { function, argv, result };
+
+    Trap trap;
+    return trap.run([](ExecutionState& state, void* d) {
+        CallData* data = reinterpret_cast<CallData*>(d);
+        data->function->call(state, data->argv, data->result);
+    },
+                    &data);
+}
+
+static Trap::TrapResult call(Instance* instance, const char* name, Value* argv, Value* result)
+{
+    std::string exportName(name);
+    return callFunction(instance->resolveExportFunction(exportName), argv, result);
+}
+
+static bool check(bool failed, const char* mode, const char* name)
+{
+    printf("%s %s: %s\n", mode, name, failed ? "FAILED" : "ok");
+    return failed;
+}
+
+static bool test(uint32_t JITFlags, const char* mode)
+{
+    Engine* engine = new Engine();
+    Store* store = new Store(engine);
+    Module* module = benchmarkParse(store, typedFunctionWasm, sizeof(typedFunctionWasm), JITFlags);
+
+    if (module == nullptr) {
+        delete store;
+        delete engine;
+        return check(true, mode, "parse");
+    }
+
+    int32_t voidSum = 0;
+    ExternVector importValues;
+    importValues.push_back(TypedFunction::createTypedFunction(store, typedI64, nullptr));
+    importValues.push_back(TypedFunction::createTypedFunction(store, typedF32, nullptr));
+    importValues.push_back(TypedFunction::createTypedFunction(store, typedF64, nullptr));
+    importValues.push_back(TypedFunction::createTypedFunction(store, typedVoid, &voidSum));
+    importValues.push_back(TypedFunction::createTypedFunction(store, typedTrap, nullptr));
+    importValues.push_back(TypedFunction::createTypedFunction(store, typedNone, nullptr));
+
+    // Equal types share their canonical type.
+    bool anyFailed = check(importValues[4]->asFunction()->functionType() != store->getDefinedFunctionType(Store::I32_RI32), mode, "canonical type");
+
+    struct InstantiateData {
+        Module* module;
+        ExternVector* importValues;
+        Instance* instance;
+    } instantiateData = { module, &importValues, nullptr };
+
+    Trap trap;
+    auto trapResult = trap.run([](ExecutionState& state, void* d) {
+        InstantiateData* data = reinterpret_cast<InstantiateData*>(d);
+        data->instance = data->module->instantiate(state, *data->importValues);
+    },
+                               &instantiateData);
+
+    if (trapResult.exception != nullptr) {
+        delete store;
+        delete engine;
+        return check(true, mode, "instantiate");
+    }
+
+    Instance* instance = instantiateData.instance;
+    Value result[1];
+    bool failed;
+
+    Value i64Args[3] = { Value(static_cast<int64_t>(1) << 40), Value(static_cast<int64_t>(2)), Value(static_cast<int64_t>(3)) };
+    failed = call(instance, "i64", i64Args, result).exception != nullptr || result[0].asI64() != (static_cast<int64_t>(1) << 40) * 1000000 + 2003;
+    anyFailed |= check(failed, mode, "i64 result");
+
+    Value f32Args[2] = { Value(1.5f), Value(0.25f) };
+    failed = call(instance, "f32", f32Args, result).exception != nullptr || result[0].asF32() != 1.0f;
+    anyFailed |= check(failed, mode, "f32 result");
+
+    Value f64Args[4] = { Value(2.5), Value(static_cast<int32_t>(4)), Value(0.5), Value(static_cast<int64_t>(3)) };
+    failed = call(instance, "f64", f64Args, result).exception != nullptr || result[0].asF64() != 12.5;
+    anyFailed |= check(failed, mode, "mixed arguments");
+
+    Value i32Args[1] = { Value(static_cast<int32_t>(5)) };
+    failed = call(instance, "void", i32Args, result).exception != nullptr || result[0].asI32() != 6 || voidSum != 5;
+    anyFailed |= check(failed, mode, "void result");
+
+    failed = call(instance, "none", nullptr, result).exception != nullptr || result[0].asI32() != 42;
+    anyFailed |= check(failed, mode, "no arguments");
+
+    failed = call(instance, "trap", i32Args, result).exception != nullptr || result[0].asI32() != 10;
+    Value zeroArgs[1] = { Value(static_cast<int32_t>(0)) };
+    trapResult = call(instance, "trap", zeroArgs, result);
+    failed |= trapResult.exception == nullptr || trapResult.exception->message() != "typed trap";
+    // The runtime state is consistent after the trap.
+    failed |= call(instance, "trap", i32Args, result).exception != nullptr || result[0].asI32() != 10;
+    anyFailed |= check(failed, mode, "trap");
+
+    failed = call(instance, "indirect", i32Args, result).exception != nullptr || result[0].asI32() != 10;
+    anyFailed |= check(failed, mode, "call_indirect");
+
+    failed = call(instance, "refTest", nullptr, result).exception != nullptr || result[0].asI32() != 1;
+    anyFailed |= check(failed, mode, "ref.test");
+
+    // Called by the embedder, which boxes the arguments.
+    failed = callFunction(importValues[4]->asFunction(), i32Args, result).exception != nullptr || result[0].asI32() != 10;
+    anyFailed |= check(failed, mode, "embedder call");
+
+    delete store;
+    delete engine;
+    return anyFailed;
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc > 1) {
+        return benchmarkUsage(argv[0], "");
+    }
+
+    bool failed = test(0, "interpreter");
+#if defined(WALRUS_ENABLE_JIT)
+    failed |= test(JITFlagValue::useJIT, "jit");
+#endif
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+(module
+  (tag $e (param i32))
+  (type $t (func (param i32) (result i32)))
+  (table 1 funcref)
+  (elem (i32.const 0) $sum_indirect)
+
+  (func $sum (export "sum") (param i32) (result i32)
+    (if (result i32) (i32.eqz (local.get 0))
+      (then (i32.const 0))
+      (else (i32.add (local.get 0) (call $sum (i32.sub (local.get 0) (i32.const 1)))))
+    )
+  )
+
+  (func $sum_indirect (export "sum_indirect") (param i32) (result i32)
+    (if (result i32) (i32.eqz (local.get 0))
+      (then (i32.const 0))
+      (else (i32.add (local.get 0)
+                     (call_indirect (type $t) (i32.sub (local.get 0) (i32.const 1)) (i32.const 0))))
+    )
+  )
+
+  ;; Throws at the bottom of the recursion.
+  (func $dive (param i32) (result i32)
+    (if (i32.eqz (local.get 0))
+      (then (throw $e (i32.const 42)))
+    )
+    (i32.add (i32.const 1) (call $dive (i32.sub (local.get 0) (i32.const 1))))
+  )
+
+  (func (export "catch_outer") (param i32) (result i32)
+    (try (result i32)
+      (do (call $dive (local.get 0)))
+      (catch $e)
+    )
+  )
+
+  ;; Catches in the middle of the recursion, then the frames above it return.
+  (func $catch_middle (export "catch_middle") (param i32) (param i32) (result i32)
+    (if (i32.eq (local.get 0) (local.get 1))
+      (then
+        (return
+          (try (result i32)
+            (do (call $dive (local.get 0)))
+            (catch $e)
+          )
+        )
+      )
+    )
+    (i32.add (i32.const 1) (call $catch_middle (local.get 0) (i32.add (local.get 1) (i32.const 1))))
+  )
+
+  ;; The tail call reuses the frame of the caller.
+  (func $count (param i32) (param i32) (result i32)
+    (local i64 i64 i64 i64)
+    (if (i32.eqz (local.get 0))
+      (then (return (local.get 1)))
+    )
+    (return_call $count_small (i32.sub (local.get 0) (i32.const 1)) (i32.add (local.get 1) (i32.const 1)))
+  )
+
+  (func $count_small (param i32) (param i32) (result i32)
+    (return_call $count (local.get 0) (local.get 1))
+  )
+
+  (func (export "tail_call") (param i32) (result i32)
+    (i32.add (i32.const 1) (call $count (local.get 0) (i32.const 0)))
+  )
+
+  (func $infinite (export "infinite")
+    (call $infinite)
+  )
+)
+
+(assert_return (invoke "sum" (i32.const 10000)) (i32.const 50005000))
+(assert_return (invoke "sum_indirect" (i32.const 10000)) (i32.const 50005000))
+(assert_return (invoke "catch_outer" (i32.const 10000)) (i32.const 42))
+(assert_return (invoke "catch_middle" (i32.const 1000) (i32.const 0)) (i32.const 1042))
+(assert_return (invoke "tail_call" (i32.const 1000000)) (i32.const 1000001))
+(assert_exhaustion (invoke "infinite") "call stack exhausted")
+(assert_return (invoke "sum" (i32.const 10000)) (i32.const 50005000))
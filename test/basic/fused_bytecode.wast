@@ -0,0 +1,165 @@
+(module
+  (memory 1)
+  (data (i32.const 0) "\01\00\00\00\02\00\00\00\03\00\00\00\04\00\00\00\05\00\00\00\06\00\00\00\07\00\00\00\08\00\00\00")
+
+  ;; Comparisons followed by br_if
+  (func (export "br_if_eq") (param i32 i32) (result i32) (block (br_if 0 (i32.eq (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_ne") (param i32 i32) (result i32) (block (br_if 0 (i32.ne (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_lt_s") (param i32 i32) (result i32) (block (br_if 0 (i32.lt_s (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_lt_u") (param i32 i32) (result i32) (block (br_if 0 (i32.lt_u (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_le_s") (param i32 i32) (result i32) (block (br_if 0 (i32.le_s (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_le_u") (param i32 i32) (result i32) (block (br_if 0 (i32.le_u (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_gt_s") (param i32 i32) (result i32) (block (br_if 0 (i32.gt_s (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_gt_u") (param i32 i32) (result i32) (block (br_if 0 (i32.gt_u (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_ge_s") (param i32 i32) (result i32) (block (br_if 0 (i32.ge_s (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+  (func (export "br_if_ge_u") (param i32 i32) (result i32) (block (br_if 0 (i32.ge_u (local.get 0) (local.get 1))) (return (i32.const 0))) (i32.const 1))
+
+  ;; Comparisons followed by if, which jumps when the condition is false
+  (func (export "if_eq") (param i32 i32) (result i32) (if (result i32) (i32.eq (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_ne") (param i32 i32) (result i32) (if (result i32) (i32.ne (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_lt_s") (param i32 i32) (result i32) (if (result i32) (i32.lt_s (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_lt_u") (param i32 i32) (result i32) (if (result i32) (i32.lt_u (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_le_s") (param i32 i32) (result i32) (if (result i32) (i32.le_s (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_le_u") (param i32 i32) (result i32) (if (result i32) (i32.le_u (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_gt_s") (param i32 i32) (result i32) (if (result i32) (i32.gt_s (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_gt_u") (param i32 i32) (result i32) (if (result i32) (i32.gt_u (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_ge_s") (param i32 i32) (result i32) (if (result i32) (i32.ge_s (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+  (func (export "if_ge_u") (param i32 i32) (result i32) (if (result i32) (i32.ge_u (local.get 0) (local.get 1)) (then (i32.const 1)) (else (i32.const 0))))
+
+  (func (export "count") (param i32) (result i32)
+    (local $i i32) (local $odd i32)
+    (loop $loop
+      (if (i32.ne (i32.and (local.get $i) (i32.const 1)) (i32.const 0))
+        (then (local.set $odd (i32.add (local.get $odd) (i32.const 1))))
+      )
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (br_if $loop (i32.lt_s (local.get $i) (local.get 0)))
+    )
+    (i32.add (i32.mul (local.get $i) (i32.const 1000)) (local.get $odd))
+  )
+
+  ;; The comparison writes the local, which must be kept.
+  (func (export "compare_to_local") (param i32) (result i32)
+    (local $c i32)
+    (block $b
+      (local.set $c (i32.gt_s (local.get 0) (i32.const 5)))
+      (br_if $b (local.get $c))
+      (local.set $c (i32.add (local.get $c) (i32.const 10)))
+    )
+    (local.get $c)
+  )
+
+  ;; Binary operations with a constant operand
+  (func (export "add_imm") (param i32) (result i32) (i32.add (local.get 0) (i32.const 100)))
+  (func (export "add_imm_left") (param i32) (result i32) (i32.add (i32.const 100) (local.get 0)))
+  (func (export "sub_imm") (param i32) (result i32) (i32.sub (local.get 0) (i32.const 100)))
+  (func (export "sub_imm_left") (param i32) (result i32) (i32.sub (i32.const 100) (local.get 0)))
+  (func (export "mul_imm") (param i32) (result i32) (i32.mul (local.get 0) (i32.const -3)))
+  (func (export "shl_imm") (param i32) (result i32) (i32.shl (local.get 0) (i32.const 33)))
+  (func (export "shr_s_imm") (param i32) (result i32) (i32.shr_s (local.get 0) (i32.const 36)))
+  (func (export "shr_u_imm") (param i32) (result i32) (i32.shr_u (local.get 0) (i32.const 36)))
+
+  ;; Too many constants for the constant area
+  (func (export "many_consts") (param i32) (result i32)
+    (i32.sub (i32.const 12345)
+      (i32.xor (i32.add (i32.mul (i32.sub (i32.or (i32.and (i32.shl (i32.shr_u (i32.shr_s (local.get 0)
+        (i32.const 1)) (i32.const 2)) (i32.const 3)) (i32.const 0xff0)) (i32.const 0x10000))
+        (i32.const 7)) (i32.const 3)) (i32.const 1000)) (i32.const 0x5555)))
+  )
+
+  ;; Loads from an address computed by an addition
+  (func (export "load_add") (param i32) (result i32) (i32.load offset=4 (i32.add (local.get 0) (i32.const 8))))
+  (func (export "load_sub") (param i32) (result i32) (i32.load (i32.sub (local.get 0) (i32.const 4))))
+  (func (export "load64_add") (param i32) (result i64) (i64.load offset=8 (i32.add (local.get 0) (i32.const 8))))
+  (func (export "load_add_local") (param i32) (result i32)
+    (local $p i32)
+    (local.set $p (i32.add (local.get 0) (i32.const 4)))
+    (i32.add (i32.load (local.get $p)) (local.get $p))
+  )
+)
+
+(assert_return (invoke "br_if_eq" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "br_if_eq" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "br_if_eq" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "br_if_ne" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "br_if_ne" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "br_if_ne" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "br_if_lt_s" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "br_if_lt_s" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "br_if_lt_s" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "br_if_lt_u" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "br_if_lt_u" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "br_if_lt_u" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "br_if_le_s" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "br_if_le_s" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "br_if_le_s" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "br_if_le_u" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "br_if_le_u" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "br_if_le_u" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "br_if_gt_s" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "br_if_gt_s" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "br_if_gt_s" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "br_if_gt_u" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "br_if_gt_u" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "br_if_gt_u" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "br_if_ge_s" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "br_if_ge_s" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "br_if_ge_s" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "br_if_ge_u" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "br_if_ge_u" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "br_if_ge_u" (i32.const 2) (i32.const 2)) (i32.const 1))
+
+(assert_return (invoke "if_eq" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "if_eq" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "if_eq" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "if_ne" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "if_ne" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "if_ne" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "if_lt_s" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "if_lt_s" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "if_lt_s" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "if_lt_u" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "if_lt_u" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "if_lt_u" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "if_le_s" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "if_le_s" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "if_le_s" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "if_le_u" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "if_le_u" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "if_le_u" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "if_gt_s" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "if_gt_s" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "if_gt_s" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "if_gt_u" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "if_gt_u" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "if_gt_u" (i32.const 2) (i32.const 2)) (i32.const 0))
+(assert_return (invoke "if_ge_s" (i32.const -1) (i32.const 1)) (i32.const 0))
+(assert_return (invoke "if_ge_s" (i32.const 1) (i32.const -1)) (i32.const 1))
+(assert_return (invoke "if_ge_s" (i32.const 2) (i32.const 2)) (i32.const 1))
+(assert_return (invoke "if_ge_u" (i32.const -1) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "if_ge_u" (i32.const 1) (i32.const -1)) (i32.const 0))
+(assert_return (invoke "if_ge_u" (i32.const 2) (i32.const 2)) (i32.const 1))
+
+(assert_return (invoke "count" (i32.const 10)) (i32.const 10005))
+(assert_return (invoke "count" (i32.const -5)) (i32.const 1000))
+(assert_return (invoke "compare_to_local" (i32.const 7)) (i32.const 1))
+(assert_return (invoke "compare_to_local" (i32.const 3)) (i32.const 10))
+
+(assert_return (invoke "add_imm" (i32.const 0x7fffffff)) (i32.const 0x80000063))
+(assert_return (invoke "add_imm_left" (i32.const -1)) (i32.const 99))
+(assert_return (invoke "sub_imm" (i32.const 0x80000000)) (i32.const 0x7fffff9c))
+(assert_return (invoke "sub_imm_left" (i32.const 1)) (i32.const 99))
+(assert_return (invoke "mul_imm" (i32.const 7)) (i32.const -21))
+(assert_return (invoke "shl_imm" (i32.const 0x40000001)) (i32.const 0x80000002))
+(assert_return (invoke "shr_s_imm" (i32.const -256)) (i32.const -16))
+(assert_return (invoke "shr_u_imm" (i32.const -256)) (i32.const 0x0ffffff0))
+(assert_return (invoke "many_consts" (i32.const 0)) (i32.const -206413))
+(assert_return (invoke "many_consts" (i32.const 100)) (i32.const -205165))
+(assert_return (invoke "many_consts" (i32.const -100)) (i32.const -210845))
+
+(assert_return (invoke "load_add" (i32.const 0)) (i32.const 4))
+(assert_return (invoke "load_add" (i32.const -8)) (i32.const 2))
+(assert_trap (invoke "load_add" (i32.const 65524)) "out of bounds memory access")
+(assert_return (invoke "load_sub" (i32.const 8)) (i32.const 2))
+(assert_return (invoke "load64_add" (i32.const 0)) (i64.const 0x0000000600000005))
+(assert_return (invoke "load_add_local" (i32.const 4)) (i32.const 11))
@@ -0,0 +1,37 @@
+(module
+  (type $box (struct (field i32)))
+  (type $bytes (array (mut i8)))
+
+  ;; Allocates garbage, which may start a collection.
+  (func $churn (param $n i32) (result i32)
+    (loop $loop
+      (drop (struct.new $box (local.get $n)))
+      (drop (array.new_default $bytes (i32.const 256)))
+      (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1))))
+    )
+    (i32.const 0)
+  )
+
+  (func $first (param (ref $box)) (param i32) (result (ref $box))
+    (local.get 0)
+  )
+
+  ;; The boxes are kept in a local and on the operand stack of every
+  ;; frame, while the deeper frames allocate.
+  (func $nest (export "nest") (param $depth i32) (result i32)
+    (local $b (ref null $box))
+    (local.set $b (struct.new $box (local.get $depth)))
+    (if (i32.eqz (local.get $depth))
+      (then (return (i32.const 0)))
+    )
+    (i32.add
+      (i32.add
+        (struct.get $box 0 (call $first (struct.new $box (local.get $depth)) (call $churn (i32.const 1000))))
+        (call $nest (i32.sub (local.get $depth) (i32.const 1))))
+      (struct.get $box 0 (local.get $b)))
+  )
+)
+
+(assert_return (invoke "nest" (i32.const 1)) (i32.const 2))
+(assert_return (invoke "nest" (i32.const 10)) (i32.const 110))
+(assert_return (invoke "nest" (i32.const 100)) (i32.const 10100))
@@ -0,0 +1,98 @@
+(module
+  (tag $e0 (param i32))
+  (tag $e1 (param i64 f64 i32))
+  (tag $e2)
+
+  (func $thrower (param i32)
+    (throw $e0 (local.get 0))
+  )
+
+  (func $deep (param i32) (param i32)
+    (if (i32.eqz (local.get 1))
+      (then (call $thrower (local.get 0)))
+      (else (call $deep (local.get 0) (i32.sub (local.get 1) (i32.const 1))))
+    )
+  )
+
+  (func (export "same-frame") (param i32) (result i32)
+    (try (result i32)
+      (do
+        (throw $e0 (i32.add (local.get 0) (i32.const 1)))
+      )
+      (catch $e0)
+    )
+  )
+
+  (func (export "deep") (param i32) (param i32) (result i32)
+    (try (result i32)
+      (do
+        (call $deep (local.get 0) (local.get 1))
+        (i32.const -1)
+      )
+      (catch $e0)
+    )
+  )
+
+  (func (export "loop") (param $n i32) (result i32)
+    (local $acc i32)
+    (loop $loop
+      (try
+        (do
+          (call $thrower (local.get $n))
+        )
+        (catch $e0
+          (local.set $acc (i32.add (local.get $acc)))
+        )
+      )
+      (br_if $loop (local.tee $n (i32.sub (local.get $n) (i32.const 1))))
+    )
+    (local.get $acc)
+  )
+
+  (func $multi (param i64 f64 i32)
+    (throw $e1 (local.get 0) (local.get 1) (local.get 2))
+  )
+
+  (func (export "multi") (result i64 f64 i32)
+    (try (result i64 f64 i32)
+      (do
+        (call $multi (i64.const 0x123456789) (f64.const 2.5) (i32.const 7))
+        (i64.const 0) (f64.const 0) (i32.const 0)
+      )
+      (catch $e1)
+    )
+  )
+
+  (func (export "catch-all") (param i32) (result i32)
+    (try (result i32)
+      (do
+        (call $deep (local.get 0) (i32.const 3))
+        (i32.const -1)
+      )
+      (catch $e2
+        (i32.const -2)
+      )
+      (catch_all
+        (i32.const 42)
+      )
+    )
+  )
+
+  (func (export "uncaught") (param i32)
+    (try
+      (do
+        (call $deep (local.get 0) (i32.const 2))
+      )
+      (catch $e2)
+    )
+  )
+)
+
+(assert_return (invoke "same-frame" (i32.const 5)) (i32.const 6))
+(assert_return (invoke "deep" (i32.const 11) (i32.const 0)) (i32.const 11))
+(assert_return (invoke "deep" (i32.const 12) (i32.const 100)) (i32.const 12))
+(assert_return (invoke "loop" (i32.const 100)) (i32.const 5050))
+(assert_return (invoke "multi") (i64.const 0x123456789) (f64.const 2.5) (i32.const 7))
+(assert_return (invoke "catch-all" (i32.const 1)) (i32.const 42))
+(assert_exception (invoke "uncaught" (i32.const 1)))
+(assert_return (invoke "deep" (i32.const 13) (i32.const 2)) (i32.const 13))
@@ -0,0 +1,150 @@
+(module
+  (memory 1 2)
+
+  (func (export "fill") (param i32 i32 i32)
+    (local i32)
+    (loop $loop
+      (i32.store8 (i32.add (local.get 0) (local.get 3)) (local.get 2))
+      (br_if $loop (i32.lt_u (local.tee 3 (i32.add (local.get 3) (i32.const 1))) (local.get 1)))
+    )
+  )
+
+  (func (export "sum") (param i32 i32) (result i32)
+    (local i32 i32)
+    (loop $loop
+      (local.set 3 (i32.add (local.get 3)
+        (i32.load offset=8 (i32.add (local.get 0) (i32.shl (local.get 2) (i32.const 2))))))
+      (local.set 2 (i32.add (local.get 2) (i32.const 1)))
+      (br_if $loop (i32.lt_s (local.get 2) (local.get 1)))
+    )
+    (local.get 3)
+  )
+
+  (func (export "copy") (param i32 i32 i32)
+    (local i32)
+    (loop $loop
+      (i64.store (i32.add (local.get 1) (local.get 3))
+        (i64.load (i32.add (local.get 0) (local.get 3))))
+      (local.set 3 (i32.add (local.get 3) (i32.const 8)))
+      (br_if $loop (i32.gt_s (local.get 2) (local.get 3)))
+    )
+  )
+
+  (func (export "constLimit") (param i32) (result i32)
+    (local i32 i32)
+    (loop $loop
+      (if (i32.and (local.get 1) (i32.const 1))
+        (then (local.set 2 (i32.add (local.get 2) (i32.load8_u (i32.add (local.get 0) (local.get 1))))))
+      )
+      (br_if $loop (i32.gt_u (i32.const 16) (local.tee 1 (i32.add (local.get 1) (i32.const 1)))))
+    )
+    (local.get 2)
+  )
+
+  (func (export "load8") (param i32) (result i32)
+    (i32.load8_u (local.get 0))
+  )
+
+  (func (export "grow") (param i32) (result i32)
+    (memory.grow (local.get 0))
+  )
+)
+
+(invoke "fill" (i32.const 100) (i32.const 16) (i32.const 3))
+(assert_return (invoke "sum" (i32.const 100) (i32.const 2)) (i32.const 0x06060606))
+(assert_return (invoke "sum" (i32.const 92) (i32.const 4)) (i32.const 0x0c0c0c0c))
+(assert_return (invoke "constLimit" (i32.const 100)) (i32.const 24))
+(invoke "copy" (i32.const 100) (i32.const 200) (i32.const 16))
+(assert_return (invoke "load8" (i32.const 215)) (i32.const 3))
+(assert_return (invoke "load8" (i32.const 216)) (i32.const 0))
+
+(; The loop variable is zero when the limit is not greater than it. ;)
+(invoke "fill" (i32.const 300) (i32.const 0) (i32.const 5))
+(assert_return (invoke "load8" (i32.const 300)) (i32.const 5))
+(assert_return (invoke "load8" (i32.const 301)) (i32.const 0))
+
+(; Out of bounds accesses in late iterations: the earlier stores must be visible. ;)
+(assert_trap (invoke "fill" (i32.const 65530) (i32.const 8) (i32.const 7)) "out of bounds memory access")
+(assert_return (invoke "load8" (i32.const 65535)) (i32.const 7))
+(assert_trap (invoke "sum" (i32.const 65500) (i32.const 100)) "out of bounds memory access")
+(assert_trap (invoke "fill" (i32.const -1) (i32.const 4) (i32.const 1)) "out of bounds memory access")
+(assert_trap (invoke "fill" (i32.const 0) (i32.const -1) (i32.const 1)) "out of bounds memory access")
+(assert_return (invoke "load8" (i32.const 65535)) (i32.const 1))
+
+(; The loop runs on the fast path after the memory is grown. ;)
+(assert_return (invoke "grow" (i32.const 1)) (i32.const 1))
+(invoke "fill" (i32.const 65530) (i32.const 8) (i32.const 9))
+(assert_return (invoke "load8" (i32.const 65537)) (i32.const 9))
+(assert_trap (invoke "fill" (i32.const 131070) (i32.const 4) (i32.const 1)) "out of bounds memory access")
+(assert_return (invoke "load8" (i32.const 131071)) (i32.const 1))
+
+(; Same loops on a 64 bit memory. ;)
+(module
+  (memory i64 1 2)
+
+  (func (export "fill") (param i64 i64 i32)
+    (local i64)
+    (loop $loop
+      (i32.store8 (i64.add (local.get 0) (local.get 3)) (local.get 2))
+      (br_if $loop (i64.lt_u (local.tee 3 (i64.add (local.get 3) (i64.const 1))) (local.get 1)))
+    )
+  )
+
+  (func (export "sum") (param i64 i64) (result i32)
+    (local i64 i32)
+    (loop $loop
+      (local.set 3 (i32.add (local.get 3)
+        (i32.load offset=8 (i64.add (local.get 0) (i64.shl (local.get 2) (i64.const 2))))))
+      (local.set 2 (i64.add (local.get 2) (i64.const 1)))
+      (br_if $loop (i64.lt_s (local.get 2) (local.get 1)))
+    )
+    (local.get 3)
+  )
+
+  (func (export "copy") (param i64 i64 i64)
+    (local i64)
+    (loop $loop
+      (i64.store (i64.add (local.get 1) (local.get 3))
+        (i64.load (i64.add (local.get 0) (local.get 3))))
+      (local.set 3 (i64.add (local.get 3) (i64.const 8)))
+      (br_if $loop (i64.gt_s (local.get 2) (local.get 3)))
+    )
+  )
+
+  (func (export "load8") (param i64) (result i32)
+    (i32.load8_u (local.get 0))
+  )
+
+  (func (export "grow") (param i64) (result i64)
+    (memory.grow (local.get 0))
+  )
+)
+
+(invoke "fill" (i64.const 100) (i64.const 16) (i32.const 3))
+(assert_return (invoke "sum" (i64.const 100) (i64.const 2)) (i32.const 0x06060606))
+(assert_return (invoke "sum" (i64.const 92) (i64.const 4)) (i32.const 0x0c0c0c0c))
+(invoke "copy" (i64.const 100) (i64.const 200) (i64.const 16))
+(assert_return (invoke "load8" (i64.const 215)) (i32.const 3))
+(assert_return (invoke "load8" (i64.const 216)) (i32.const 0))
+
+(; Out of bounds accesses in late iterations: the earlier stores must be visible. ;)
+(assert_trap (invoke "fill" (i64.const 65530) (i64.const 8) (i32.const 7)) "out of bounds memory access")
+(assert_return (invoke "load8" (i64.const 65535)) (i32.const 7))
+(assert_trap (invoke "sum" (i64.const 65500) (i64.const 100)) "out of bounds memory access")
+(assert_trap (invoke "copy" (i64.const 100) (i64.const 65520) (i64.const 32)) "out of bounds memory access")
+(assert_return (invoke "load8" (i64.const 65527)) (i32.const 3))
+(assert_return (invoke "load8" (i64.const 65535)) (i32.const 3))
+
+(; Addresses above 4G and above the limit of the hoisted check. ;)
+(assert_trap (invoke "fill" (i64.const 0x100000000) (i64.const 4) (i32.const 1)) "out of bounds memory access")
+(assert_trap (invoke "fill" (i64.const 0x10000000000) (i64.const 4) (i32.const 1)) "out of bounds memory access")
+(assert_trap (invoke "fill" (i64.const -1) (i64.const 4) (i32.const 1)) "out of bounds memory access")
+(assert_trap (invoke "fill" (i64.const 0) (i64.const -1) (i32.const 1)) "out of bounds memory access")
+(assert_return (invoke "load8" (i64.const 65535)) (i32.const 1))
+
+(; The loop runs on the fast path after the memory is grown. ;)
+(assert_return (invoke "grow" (i64.const 1)) (i64.const 1))
+(invoke "fill" (i64.const 65530) (i64.const 8) (i32.const 9))
+(assert_return (invoke "load8" (i64.const 65537)) (i32.const 9))
+(assert_trap (invoke "fill" (i64.const 131070) (i64.const 4) (i32.const 1)) "out of bounds memory access")
+(assert_return (invoke "load8" (i64.const 131071)) (i32.const 1))
@@ -0,0 +1,122 @@
+(module $exporter
+  (type $binop (func (param i32 i32) (result i32)))
+  (table (export "table") 2 funcref)
+  (func $sub (export "sub") (type $binop)
+    (i32.sub (local.get 0) (local.get 1))
+  )
+  (func (export "call") (param i32 i32 i32) (result i32)
+    (call_indirect (type $binop) (local.get 1) (local.get 2) (local.get 0))
+  )
+  (elem (i32.const 0) $sub)
+)
+
+(register "exporter" $exporter)
+
+(module
+  (type $binop (func (param i32 i32) (result i32)))
+  (type $unop (func (param i32) (result i32)))
+  (type $multi (func (param i64 f64) (result f64 i64)))
+  (type $rec (func (param i32) (result i32)))
+
+  (import "exporter" "sub" (func $sub (type $binop)))
+  (import "exporter" "table" (table $other 2 funcref))
+
+  (table $table 8 funcref)
+  (tag $except (param i32))
+
+  (func $add (type $binop)
+    (i32.add (local.get 0) (local.get 1))
+  )
+
+  (func $neg (type $unop)
+    (i32.sub (i32.const 0) (local.get 0))
+  )
+
+  (func $swap (type $multi)
+    (local.get 1)
+    (local.get 0)
+  )
+
+  (func $fact (type $rec)
+    (if (result i32) (i32.le_u (local.get 0) (i32.const 1))
+      (then (i32.const 1))
+      (else
+        (i32.mul (local.get 0)
+          (call_indirect (type $rec) (i32.sub (local.get 0) (i32.const 1)) (i32.const 5)))
+      )
+    )
+  )
+
+  (func $div (type $binop)
+    (i32.div_s (local.get 0) (local.get 1))
+  )
+
+  (func $throw (type $binop)
+    (throw $except (i32.add (local.get 0) (local.get 1)))
+  )
+
+  (elem (table $table) (i32.const 0) func $add $neg $swap $sub $div $fact $throw)
+
+  (func (export "binop") (param i32 i32 i32) (result i32)
+    (call_indirect $table (type $binop) (local.get 1) (local.get 2) (local.get 0))
+  )
+
+  (func (export "unop") (param i32 i32) (result i32)
+    (call_indirect $table (type $unop) (local.get 1) (local.get 0))
+  )
+
+  (func (export "multi") (param i32 i64 f64) (result f64 i64)
+    (call_indirect $table (type $multi) (local.get 1) (local.get 2) (local.get 0))
+  )
+
+  (func (export "fact") (param i32) (result i32)
+    (call_indirect $table (type $rec) (local.get 0) (i32.const 5))
+  )
+
+  (func (export "catch") (param i32 i32 i32) (result i32)
+    (try (result i32)
+      (do
+        (call_indirect $table (type $binop) (local.get 1) (local.get 2) (local.get 0))
+      )
+      (catch $except)
+    )
+  )
+
+  (func (export "set") (param i32 i32)
+    (table.set $table (local.get 0) (table.get $other (local.get 1)))
+  )
+
+  (func (export "sum") (param i32 i32) (result i32)
+    (local i32)
+    (loop $loop
+      (local.set 2 (call_indirect $table (type $binop) (local.get 2) (local.get 1) (i32.const 0)))
+      (br_if $loop (local.tee 0 (i32.sub (local.get 0) (i32.const 1))))
+    )
+    (local.get 2)
+  )
+)
+
+(assert_return (invoke "binop" (i32.const 0) (i32.const 5) (i32.const 7)) (i32.const 12))
+(assert_return (invoke "unop" (i32.const 1) (i32.const 9)) (i32.const -9))
+(assert_return (invoke "multi" (i32.const 2) (i64.const 3) (f64.const 0.5)) (f64.const 0.5) (i64.const 3))
+(assert_return (invoke "fact" (i32.const 6)) (i32.const 720))
+(assert_return (invoke "sum" (i32.const 10) (i32.const 3)) (i32.const 30))
+
+(; Imported functions and functions of other instances use the generic call. ;)
+(assert_return (invoke "binop" (i32.const 3) (i32.const 5) (i32.const 7)) (i32.const -2))
+(invoke "set" (i32.const 7) (i32.const 0))
+(assert_return (invoke "binop" (i32.const 7) (i32.const 10) (i32.const 4)) (i32.const 6))
+
+(; Traps and exceptions of the callee. ;)
+(assert_return (invoke "binop" (i32.const 4) (i32.const 12) (i32.const 4)) (i32.const 3))
+(assert_trap (invoke "binop" (i32.const 4) (i32.const 1) (i32.const 0)) "integer divide by zero")
+(assert_return (invoke "catch" (i32.const 6) (i32.const 2) (i32.const 3)) (i32.const 5))
+(assert_return (invoke "catch" (i32.const 0) (i32.const 2) (i32.const 3)) (i32.const 5))
+
+(; Failed checks of the fast path. ;)
+(assert_trap (invoke "binop" (i32.const 1) (i32.const 1) (i32.const 2)) "indirect call type mismatch")
+(assert_trap (invoke "unop" (i32.const 0) (i32.const 1)) "indirect call type mismatch")
+(assert_trap (invoke "binop" (i32.const 8) (i32.const 1) (i32.const 2)) "undefined element")
+(assert_trap (invoke "binop" (i32.const -1) (i32.const 1) (i32.const 2)) "undefined element")
+(invoke "set" (i32.const 0) (i32.const 1))
+(assert_trap (invoke "binop" (i32.const 0) (i32.const 1) (i32.const 2)) "uninitialized element")
@@ -0,0 +1,157 @@
+(module
+  (tag $except0 (param i32))
+
+  (func $fib (export "fib") (param i32) (result i32)
+    local.get 0
+    i32.const 2
+    i32.lt_u
+    if (result i32)
+      local.get 0
+    else
+      local.get 0
+      i32.const 1
+      i32.sub
+      call $fib
+      local.get 0
+      i32.const 2
+      i32.sub
+      call $fib
+      i32.add
+    end
+  )
+
+  (func $swap (param i32 i64 f32 f64 v128) (result v128 f64 f32 i64 i32)
+    local.get 4
+    local.get 3
+    local.get 2
+    local.get 1
+    local.get 0
+  )
+
+  (func (export "multi") (param i32 i64 f32 f64) (result i32 i64 f32 f64 i64)
+    (local v128)
+    local.get 0
+    local.get 1
+    local.get 2
+    local.get 3
+    v128.const i64x2 0x123456789a 0x1
+    call $swap
+    local.set 0
+    local.set 1
+    local.set 2
+    local.set 3
+    local.set 4
+    local.get 0
+    local.get 1
+    local.get 2
+    local.get 3
+    local.get 4
+    i64x2.extract_lane 0
+  )
+
+  (func $div (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    i32.div_s
+  )
+
+  (func (export "div") (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    call $div
+    i32.const 1
+    i32.add
+  )
+
+  (func $throw (param i32)
+    local.get 0
+    throw $except0
+  )
+
+  (func $nested (param i32) (result i32)
+    local.get 0
+    call $throw
+    i32.const -1
+  )
+
+  (func (export "catch") (param i32) (result i32)
+    (try (result i32)
+      (do
+        local.get 0
+        call $nested
+      )
+      (catch $except0
+        i32.const 100
+        i32.add
+      )
+    )
+  )
+
+  (func (export "uncaught") (param i32) (result i32)
+    local.get 0
+    call $nested
+  )
+
+  (func $runaway (param i32) (result i32)
+    local.get 0
+    i32.const 1
+    i32.add
+    call $runaway
+  )
+
+  (func (export "runaway") (result i32)
+    i32.const 0
+    call $runaway
+  )
+)
+
+(assert_return (invoke "fib" (i32.const 0)) (i32.const 0))
+(assert_return (invoke "fib" (i32.const 1)) (i32.const 1))
+(assert_return (invoke "fib" (i32.const 20)) (i32.const 6765))
+(assert_return (invoke "multi" (i32.const -5) (i64.const 0x1234567890) (f32.const 3.5) (f64.const -7.25))
+  (i32.const -5) (i64.const 0x1234567890) (f32.const 3.5) (f64.const -7.25) (i64.const 0x123456789a))
+(assert_return (invoke "div" (i32.const 10) (i32.const 3)) (i32.const 4))
+(assert_trap (invoke "div" (i32.const 10) (i32.const 0)) "integer divide by zero")
+(assert_trap (invoke "div" (i32.const 0x80000000) (i32.const -1)) "integer overflow")
+(assert_return (invoke "catch" (i32.const 23)) (i32.const 123))
+(assert_exception (invoke "uncaught" (i32.const 5)))
+(assert_exhaustion (invoke "runaway") "call stack exhausted")
+(assert_return (invoke "fib" (i32.const 10)) (i32.const 55))
+
+;; Directly called functions have no execution state, so the traps, the
+;; exceptions and the host calls of the callees are attributed to the
+;; function which entered compiled code.
+(module
+  (import "spectest" "print_i32" (func $print_i32 (param i32)))
+
+  (func $leaf (param i32) (result i32)
+    local.get 0
+    call $print_i32
+    local.get 0
+    i32.eqz
+    if
+      unreachable
+    end
+    local.get 0
+    i32.const 1
+    i32.sub
+  )
+
+  (func $chain (param i32) (result i32)
+    local.get 0
+    call $leaf
+    call $leaf
+    call $leaf
+  )
+
+  (func (export "chain") (param i32) (result i32)
+    local.get 0
+    call $chain
+    i32.const 10
+    i32.mul
+  )
+)
+
+(assert_return (invoke "chain" (i32.const 5)) (i32.const 20))
+(assert_trap (invoke "chain" (i32.const 2)) "unreachable")
+(assert_return (invoke "chain" (i32.const 3)) (i32.const 0))
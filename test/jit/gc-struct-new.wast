@@ -0,0 +1,63 @@
+(module
+  (type $small (struct (field i8) (field i16) (field i32) (field i64) (field f32) (field f64) (field v128) (field (ref null $small))))
+  (type $large (struct (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64)
+                       (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64)
+                       (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64)
+                       (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64) (field i64)))
+
+  (func $new (param i32) (param (ref null $small)) (result (ref $small))
+    (struct.new $small
+      (local.get 0) (local.get 0) (local.get 0)
+      (i64.extend_i32_u (local.get 0))
+      (f32.convert_i32_u (local.get 0))
+      (f64.convert_i32_u (local.get 0))
+      (i32x4.splat (local.get 0))
+      (local.get 1))
+  )
+
+  (func (export "fields") (result i32 i32 i32 i64 f32 f64 i32)
+    (local $s (ref null $small))
+    (local.set $s (call $new (i32.const 0x12345) (struct.new_default $small)))
+    (struct.get_u $small 0 (local.get $s))
+    (struct.get_s $small 1 (local.get $s))
+    (struct.get $small 2 (local.get $s))
+    (struct.get $small 3 (local.get $s))
+    (struct.get $small 4 (local.get $s))
+    (struct.get $small 5 (local.get $s))
+    (i32x4.extract_lane 3 (struct.get $small 6 (local.get $s)))
+  )
+
+  (func (export "default") (result i32 i64 f64 i32)
+    (local $s (ref null $small))
+    (local.set $s (struct.new_default $small))
+    (struct.get $small 2 (local.get $s))
+    (struct.get $small 3 (local.get $s))
+    (struct.get $small 5 (local.get $s))
+    (ref.is_null (struct.get $small 7 (local.get $s)))
+  )
+
+  (func (export "list") (param $n i32) (result i32)
+    (local $head (ref null $small))
+    (local $sum i32)
+    (loop $build
+      (local.set $head (call $new (local.get $n) (local.get $head)))
+      (br_if $build (local.tee $n (i32.sub (local.get $n) (i32.const 1)))))
+    (loop $walk
+      (local.set $sum (i32.add (local.get $sum) (struct.get $small 2 (local.get $head))))
+      (br_if $walk (i32.eqz (ref.is_null (local.tee $head (struct.get $small 7 (local.get $head)))))))
+    (local.get $sum)
+  )
+
+  (func (export "large") (result i64 i64)
+    (local $s (ref null $large))
+    (local.set $s (struct.new_default $large))
+    (struct.set $large 31 (local.get $s) (i64.const 7))
+    (struct.get $large 0 (local.get $s))
+    (struct.get $large 31 (local.get $s))
+  )
+)
+
+(assert_return (invoke "fields") (i32.const 0x45) (i32.const 0x2345) (i32.const 0x12345) (i64.const 0x12345) (f32.const 0x12345) (f64.const 0x12345) (i32.const 0x12345))
+(assert_return (invoke "default") (i32.const 0) (i64.const 0) (f64.const 0) (i32.const 1))
+(assert_return (invoke "list" (i32.const 10000)) (i32.const 50005000))
+(assert_return (invoke "large") (i64.const 0) (i64.const 7))
@@ -0,0 +1,77 @@
+(module
+  (memory 1)
+
+  (func $add (param i32 i32) (result i32)
+    (i32.add (local.get 0) (local.get 1))
+  )
+
+  (func $mix (param i64 f32 f64) (result f64 i64)
+    (f64.add (f64.promote_f32 (local.get 1)) (local.get 2))
+    (i64.mul (local.get 0) (i64.const 3))
+  )
+
+  (func $load (param i32) (result i32)
+    (i32.load offset=4 (local.get 0))
+  )
+
+  (func $store (param i32 i32)
+    (i32.store (local.get 0) (local.get 1))
+  )
+
+  (func $div (param i32 i32) (result i32)
+    (local i32)
+    (local.set 2 (i32.div_s (local.get 0) (local.get 1)))
+    (i32.add (local.get 2) (i32.const 1))
+  )
+
+  (func $trap
+    (unreachable)
+  )
+
+  (func $branch (param i32) (result i32)
+    (if (result i32) (local.get 0)
+      (then (i32.const 1))
+      (else (i32.const 2))
+    )
+  )
+
+  (func (export "add") (param i32) (result i32)
+    (call $add (call $add (local.get 0) (i32.const 1)) (local.get 0))
+  )
+
+  (func (export "mix") (param i64) (result f64 i64)
+    (call $mix (local.get 0) (f32.const 1.5) (f64.const 0.25))
+  )
+
+  (func (export "memory") (param i32 i32) (result i32)
+    (call $store (i32.add (local.get 0) (i32.const 4)) (local.get 1))
+    (i32.add (call $load (local.get 0)) (call $load (local.get 0)))
+  )
+
+  (func (export "div") (param i32 i32) (result i32)
+    (local i32)
+    (local.set 2 (i32.const 100))
+    (i32.add (call $div (local.get 0) (local.get 1)) (local.get 2))
+  )
+
+  (func (export "trap") (param i32) (result i32)
+    (call $trap)
+    (local.get 0)
+  )
+
+  (func (export "branch") (param i32) (result i32)
+    (i32.add (call $branch (local.get 0)) (call $add (local.get 0) (i32.const 10)))
+  )
+)
+
+(assert_return (invoke "add" (i32.const 5)) (i32.const 11))
+(assert_return (invoke "add" (i32.const -1)) (i32.const -1))
+(assert_return (invoke "mix" (i64.const 7)) (f64.const 1.75) (i64.const 21))
+(assert_return (invoke "memory" (i32.const 16) (i32.const 21)) (i32.const 42))
+(assert_trap (invoke "memory" (i32.const 65532) (i32.const 1)) "out of bounds memory access")
+(assert_return (invoke "div" (i32.const 12) (i32.const 4)) (i32.const 104))
+(assert_trap (invoke "div" (i32.const 1) (i32.const 0)) "integer divide by zero")
+(assert_trap (invoke "div" (i32.const 0x80000000) (i32.const -1)) "integer overflow")
+(assert_trap (invoke "trap" (i32.const 1)) "unreachable")
+(assert_return (invoke "branch" (i32.const 0)) (i32.const 12))
+(assert_return (invoke "branch" (i32.const 3)) (i32.const 14))
@@ -0,0 +1,56 @@
+(module
+  (memory 1 4)
+
+  (func (export "load") (param i32) (result i32)
+    (i32.load (local.get 0))
+  )
+
+  (func (export "load_offset") (param i32) (result i64)
+    (i64.load offset=0xfffffff0 (local.get 0))
+  )
+
+  (func (export "store") (param i32 i32)
+    (i32.store offset=4 (local.get 0) (local.get 1))
+  )
+
+  (func (export "load_const") (result i32)
+    (i32.load (i32.const 65536))
+  )
+
+  (func (export "grow") (param i32) (result i32)
+    (memory.grow (local.get 0))
+  )
+
+  (func (export "sum") (param i32 i32) (result i32)
+    (local i32)
+    (block
+      (loop
+        (br_if 1 (i32.eqz (local.get 1)))
+        (local.set 2 (i32.add (local.get 2) (i32.load8_u (local.get 0))))
+        (local.set 0 (i32.add (local.get 0) (i32.const 1)))
+        (local.set 1 (i32.sub (local.get 1) (i32.const 1)))
+        (br 0)
+      )
+    )
+    (local.get 2)
+  )
+)
+
+(assert_return (invoke "load" (i32.const 0)) (i32.const 0))
+(assert_return (invoke "load" (i32.const 65532)) (i32.const 0))
+(assert_trap (invoke "load" (i32.const 65533)) "out of bounds memory access")
+(assert_trap (invoke "load" (i32.const -1)) "out of bounds memory access")
+(assert_trap (invoke "load_offset" (i32.const 0)) "out of bounds memory access")
+(assert_trap (invoke "load_offset" (i32.const -1)) "out of bounds memory access")
+(assert_return (invoke "store" (i32.const 65528) (i32.const 0x01020304)))
+(assert_trap (invoke "store" (i32.const 65529) (i32.const 1)) "out of bounds memory access")
+(assert_trap (invoke "load_const") "out of bounds memory access")
+(assert_return (invoke "sum" (i32.const 65532) (i32.const 4)) (i32.const 10))
+(assert_trap (invoke "sum" (i32.const 65532) (i32.const 5)) "out of bounds memory access")
+
+(assert_return (invoke "grow" (i32.const 1)) (i32.const 1))
+(assert_return (invoke "load_const") (i32.const 0))
+(assert_return (invoke "load" (i32.const 131068)) (i32.const 0))
+(assert_trap (invoke "load" (i32.const 131069)) "out of bounds memory access")
+(assert_return (invoke "sum" (i32.const 65532) (i32.const 5)) (i32.const 10))
+(assert_return (invoke "grow" (i32.const 3)) (i32.const -1))
@@ -0,0 +1,102 @@
+(module
+(func (export "fold32") (result i32 i32 i32 i32 i32 i32)
+  (; Constant folding of 32 bit integer operations. ;)
+  (i32.add (i32.const 0x7fffffff) (i32.const 1))
+  (i32.mul (i32.const 0x10001) (i32.const 0x10001))
+  (i32.shl (i32.const 1) (i32.const 33))
+  (i32.shr_s (i32.const -256) (i32.const 4))
+  (i32.rotl (i32.const 0x80000001) (i32.const 1))
+  (i32.rem_s (i32.const 0x80000000) (i32.const -1))
+)
+
+(func (export "fold64") (result i64 i64 i64 i32 i64 i64)
+  (i64.sub (i64.const 0) (i64.const 1))
+  (i64.div_u (i64.const -1) (i64.const 3))
+  (i64.shr_u (i64.const -1) (i64.const 64))
+  (i64.lt_s (i64.const -1) (i64.const 0))
+  (i64.extend_i32_s (i32.const -2))
+  (i64.rotr (i64.const 1) (i64.const 1))
+)
+
+(func (export "unary") (result i32 i32 i32 i32 i64 i32)
+  (i32.clz (i32.const 0))
+  (i32.ctz (i32.const 0x100))
+  (i32.popcnt (i32.const -1))
+  (i32.extend8_s (i32.const 0x80))
+  (i64.extend16_s (i64.const 0x8000))
+  (i32.wrap_i64 (i64.const 0x123456789))
+)
+
+(func (export "float") (result f32 f64 i32 i32 f64 i32)
+  (f32.add (f32.const 1.5) (f32.const 2.25))
+  (f64.div (f64.const 1) (f64.const 0))
+  (f32.eq (f32.const nan) (f32.const nan))
+  (i32.reinterpret_f32 (f32.neg (f32.const 0)))
+  (f64.reinterpret_i64 (i64.const 0x4000000000000000))
+  (f64.ne (f64.div (f64.const 0) (f64.const 0)) (f64.const 0))
+)
+
+(func (export "divZero") (result i32)
+  (i32.div_u (i32.const 1) (i32.const 0))
+)
+
+(func (export "divOverflow") (result i64)
+  (i64.div_s (i64.const 0x8000000000000000) (i64.const -1))
+)
+
+(func (export "truncNaN") (result i32)
+  (drop (i32.trunc_f32_s (f32.const nan)))
+  (i32.const 0)
+)
+
+(func (export "identities") (param i32 i64) (result i32 i32 i32 i32 i64 i64 i64 i32)
+  (i32.add (local.get 0) (i32.const 0))
+  (i32.sub (local.get 0) (local.get 0))
+  (i32.or (i32.const -1) (local.get 0))
+  (i32.le_u (local.get 0) (local.get 0))
+  (i64.mul (local.get 1) (i64.const 1))
+  (i64.and (local.get 1) (i64.const 0))
+  (i64.shr_s (local.get 1) (i64.const 64))
+  (i64.ne (local.get 1) (local.get 1))
+)
+
+(func (export "copies") (param i32) (result i32) (local i32 i32 f32)
+  (local.set 1 (local.get 0))
+  (local.set 2 (local.get 1))
+  (local.set 0 (i32.const 7))
+  (local.set 3 (f32.reinterpret_i32 (local.get 2)))
+  (local.set 1 (i32.add (local.get 2) (local.get 1)))
+  (i32.add (local.get 1) (i32.reinterpret_f32 (local.get 3)))
+)
+
+(func (export "loop") (param i32) (result i32) (local i32 i32)
+  (local.set 1 (i32.const 1))
+  (loop $loop
+    (local.set 2 (i32.mul (local.get 1) (i32.const 3)))
+    (local.set 1 (i32.add (local.get 1) (local.get 1)))
+    (br_if $loop (local.tee 0 (i32.sub (local.get 0) (i32.const 1))))
+  )
+  (i32.add (local.get 1) (local.get 2))
+)
+
+(func (export "branch") (param i32) (result i32) (local i32)
+  (local.set 1 (i32.const 10))
+  (if (local.get 0)
+    (then (local.set 1 (i32.const 20)))
+  )
+  (local.get 1)
+)
+)
+
+(assert_return (invoke "fold32") (i32.const 0x80000000) (i32.const 0x20001) (i32.const 2) (i32.const -16) (i32.const 3) (i32.const 0))
+(assert_return (invoke "fold64") (i64.const -1) (i64.const 0x5555555555555555) (i64.const -1) (i32.const 1) (i64.const -2) (i64.const 0x8000000000000000))
+(assert_return (invoke "unary") (i32.const 32) (i32.const 8) (i32.const 32) (i32.const -128) (i64.const -32768) (i32.const 0x23456789))
+(assert_return (invoke "float") (f32.const 3.75) (f64.const inf) (i32.const 0) (i32.const 0x80000000) (f64.const 2) (i32.const 1))
+(assert_trap (invoke "divZero") "integer divide by zero")
+(assert_trap (invoke "divOverflow") "integer overflow")
+(assert_trap (invoke "truncNaN") "invalid conversion to integer")
+(assert_return (invoke "identities" (i32.const 5) (i64.const -9)) (i32.const 5) (i32.const 0) (i32.const -1) (i32.const 1) (i64.const -9) (i64.const 0) (i64.const -9) (i32.const 0))
+(assert_return (invoke "copies" (i32.const 3)) (i32.const 9))
+(assert_return (invoke "loop" (i32.const 4)) (i32.const 40))
+(assert_return (invoke "branch" (i32.const 0)) (i32.const 10))
+(assert_return (invoke "branch" (i32.const 1)) (i32.const 20))
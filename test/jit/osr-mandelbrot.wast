@@ -0,0 +1,86 @@
+(module
+  (tag $tag (param i32))
+  (global $catches (mut i32) (i32.const 0))
+
+  ;; The whole kernel runs in a single call, so the compiled
+  ;; code can only be reached through on-stack replacement.
+  (func (export "mandelbrotDouble") (param $width i32) (param $height i32) (result i32)
+    (local $i i32) (local $j i32) (local $k i32) (local $count i32)
+    (local $cr f64) (local $ci f64) (local $zr f64) (local $zi f64) (local $t f64)
+    (loop $rows
+      (local.set $ci (f64.add (f64.mul (f64.convert_i32_s (local.get $i)) (f64.const 0.013)) (f64.const -1.3)))
+      (local.set $j (i32.const 0))
+      (loop $columns
+        (local.set $cr (f64.add (f64.mul (f64.convert_i32_s (local.get $j)) (f64.const 0.013)) (f64.const -2.0)))
+        (local.set $zr (f64.const 0))
+        (local.set $zi (f64.const 0))
+        (local.set $k (i32.const 0))
+        (block $escaped
+          (loop $iterate
+            (br_if $escaped (f64.gt (f64.add (f64.mul (local.get $zr) (local.get $zr))
+                                             (f64.mul (local.get $zi) (local.get $zi)))
+                                    (f64.const 4.0)))
+            (local.set $t (f64.add (f64.sub (f64.mul (local.get $zr) (local.get $zr))
+                                            (f64.mul (local.get $zi) (local.get $zi)))
+                                   (local.get $cr)))
+            (local.set $zi (f64.add (f64.mul (f64.mul (f64.const 2.0) (local.get $zr)) (local.get $zi))
+                                    (local.get $ci)))
+            (local.set $zr (local.get $t))
+            (local.set $k (i32.add (local.get $k) (i32.const 1)))
+            (br_if $iterate (i32.lt_s (local.get $k) (i32.const 20)))
+          )
+          (local.set $count (i32.add (local.get $count) (i32.const 1)))
+        )
+        (local.set $j (i32.add (local.get $j) (i32.const 1)))
+        (br_if $columns (i32.lt_s (local.get $j) (local.get $width)))
+      )
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (br_if $rows (i32.lt_s (local.get $i) (local.get $height)))
+    )
+    (local.get $count)
+  )
+
+  (func (export "loop_catch") (param $n i32) (result i32)
+    (local $i i32)
+    (try (result i32)
+      (do
+        (loop $loop
+          (local.set $i (i32.add (local.get $i) (i32.const 1)))
+          (if (i32.eq (local.get $i) (local.get $n))
+            (then (throw $tag (local.get $i)))
+          )
+          (br $loop)
+        )
+        (i32.const -1)
+      )
+      (catch $tag)
+    )
+  )
+
+  (func (export "loop_rethrow") (param $n i32)
+    (local $i i32)
+    (try
+      (do
+        (loop $loop
+          (local.set $i (i32.add (local.get $i) (i32.const 1)))
+          (br_if $loop (i32.ne (local.get $i) (local.get $n)))
+        )
+        (throw $tag (local.get $i))
+      )
+      (catch_all
+        (global.set $catches (i32.add (global.get $catches) (i32.const 1)))
+        (throw $tag (i32.const 0))
+      )
+    )
+  )
+
+  (func (export "catches") (result i32)
+    (global.get $catches)
+  )
+)
+
+(assert_return (invoke "mandelbrotDouble" (i32.const 200) (i32.const 200)) (i32.const 10409))
+(assert_return (invoke "mandelbrotDouble" (i32.const 200) (i32.const 200)) (i32.const 10409))
+(assert_return (invoke "loop_catch" (i32.const 500000)) (i32.const 500000))
+(assert_exception (invoke "loop_rethrow" (i32.const 500000)))
+(assert_return (invoke "catches") (i32.const 1))
@@ -0,0 +1,297 @@
+(module
+  (tag $tag (param i32))
+
+  (func $f0 (export "f0") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f1 (local.get 0)) (i32.const 0))))
+      (return (i32.sub (call $f1 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f1 (local.get 0))))
+    )
+  )
+
+  (func $f1 (export "f1") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f2 (local.get 0)) (i32.const 1))))
+      (return (i32.sub (call $f2 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f2 (local.get 0))))
+    )
+  )
+
+  (func $f2 (export "f2") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f3 (local.get 0)) (i32.const 2))))
+      (return (i32.sub (call $f3 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f3 (local.get 0))))
+    )
+  )
+
+  (func $f3 (export "f3") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f4 (local.get 0)) (i32.const 3))))
+      (return (i32.sub (call $f4 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f4 (local.get 0))))
+    )
+  )
+
+  (func $f4 (export "f4") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f5 (local.get 0)) (i32.const 4))))
+      (return (i32.sub (call $f5 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f5 (local.get 0))))
+    )
+  )
+
+  (func $f5 (export "f5") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f6 (local.get 0)) (i32.const 5))))
+      (return (i32.sub (call $f6 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f6 (local.get 0))))
+    )
+  )
+
+  (func $f6 (export "f6") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f7 (local.get 0)) (i32.const 6))))
+      (return (i32.sub (call $f7 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f7 (local.get 0))))
+    )
+  )
+
+  (func $f7 (export "f7") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f8 (local.get 0)) (i32.const 7))))
+      (return (i32.sub (call $f8 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f8 (local.get 0))))
+    )
+  )
+
+  (func $f8 (export "f8") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f9 (local.get 0)) (i32.const 8))))
+      (return (i32.sub (call $f9 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f9 (local.get 0))))
+    )
+  )
+
+  (func $f9 (export "f9") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f10 (local.get 0)) (i32.const 9))))
+      (return (i32.sub (call $f10 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f10 (local.get 0))))
+    )
+  )
+
+  (func $f10 (export "f10") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f11 (local.get 0)) (i32.const 10))))
+      (return (i32.sub (call $f11 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f11 (local.get 0))))
+    )
+  )
+
+  (func $f11 (export "f11") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f12 (local.get 0)) (i32.const 11))))
+      (return (i32.sub (call $f12 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f12 (local.get 0))))
+    )
+  )
+
+  (func $f12 (export "f12") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f13 (local.get 0)) (i32.const 12))))
+      (return (i32.sub (call $f13 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f13 (local.get 0))))
+    )
+  )
+
+  (func $f13 (export "f13") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f14 (local.get 0)) (i32.const 13))))
+      (return (i32.sub (call $f14 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f14 (local.get 0))))
+    )
+  )
+
+  (func $f14 (export "f14") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f15 (local.get 0)) (i32.const 14))))
+      (return (i32.sub (call $f15 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f15 (local.get 0))))
+    )
+  )
+
+  (func $f15 (export "f15") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f16 (local.get 0)) (i32.const 15))))
+      (return (i32.sub (call $f16 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f16 (local.get 0))))
+    )
+  )
+
+  (func $f16 (export "f16") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f17 (local.get 0)) (i32.const 16))))
+      (return (i32.sub (call $f17 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f17 (local.get 0))))
+    )
+  )
+
+  (func $f17 (export "f17") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f18 (local.get 0)) (i32.const 17))))
+      (return (i32.sub (call $f18 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f18 (local.get 0))))
+    )
+  )
+
+  (func $f18 (export "f18") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f19 (local.get 0)) (i32.const 18))))
+      (return (i32.sub (call $f19 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f19 (local.get 0))))
+    )
+  )
+
+  (func $f19 (export "f19") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f20 (local.get 0)) (i32.const 19))))
+      (return (i32.sub (call $f20 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f20 (local.get 0))))
+    )
+  )
+
+  (func $f20 (export "f20") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f21 (local.get 0)) (i32.const 20))))
+      (return (i32.sub (call $f21 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f21 (local.get 0))))
+    )
+  )
+
+  (func $f21 (export "f21") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f22 (local.get 0)) (i32.const 21))))
+      (return (i32.sub (call $f22 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f22 (local.get 0))))
+    )
+  )
+
+  (func $f22 (export "f22") (param i32) (result i32)
+    (block $b2 (block $b1 (block $b0
+      (br_table $b0 $b1 $b2 (i32.rem_u (local.get 0) (i32.const 3))))
+      (return (i32.add (call $f23 (local.get 0)) (i32.const 22))))
+      (return (i32.sub (call $f23 (local.get 0)) (i32.const 1))))
+    (try (result i32)
+      (do (call $thrower (local.get 0)))
+      (catch $tag (i32.add (call $f23 (local.get 0))))
+    )
+  )
+
+  (func $f23 (export "f23") (param i32) (result i32)
+    (i32.mul (local.get 0) (i32.const 2))
+  )
+
+  (func $thrower (param i32) (result i32)
+    (throw $tag (local.get 0))
+  )
+
+  (func $fac (export "fac") (param i64) (result i64)
+    (if (result i64) (i64.eqz (local.get 0))
+      (then (i64.const 1))
+      (else (i64.mul (local.get 0) (call $fac (i64.sub (local.get 0) (i64.const 1)))))
+    )
+  )
+)
+
+(assert_return (invoke "f0" (i32.const 0)) (i32.const 253))
+(assert_return (invoke "f0" (i32.const 1)) (i32.const -21))
+(assert_return (invoke "f0" (i32.const 2)) (i32.const 50))
+(assert_return (invoke "f0" (i32.const 7)) (i32.const -9))
+(assert_return (invoke "f5" (i32.const 0)) (i32.const 243))
+(assert_return (invoke "f5" (i32.const 1)) (i32.const -16))
+(assert_return (invoke "f5" (i32.const 2)) (i32.const 40))
+(assert_return (invoke "f5" (i32.const 7)) (i32.const -4))
+(assert_return (invoke "f11" (i32.const 0)) (i32.const 198))
+(assert_return (invoke "f11" (i32.const 1)) (i32.const -10))
+(assert_return (invoke "f11" (i32.const 2)) (i32.const 28))
+(assert_return (invoke "f11" (i32.const 7)) (i32.const 2))
+(assert_return (invoke "f17" (i32.const 0)) (i32.const 117))
+(assert_return (invoke "f17" (i32.const 1)) (i32.const -4))
+(assert_return (invoke "f17" (i32.const 2)) (i32.const 16))
+(assert_return (invoke "f17" (i32.const 7)) (i32.const 8))
+(assert_return (invoke "f22" (i32.const 0)) (i32.const 22))
+(assert_return (invoke "f22" (i32.const 1)) (i32.const 1))
+(assert_return (invoke "f22" (i32.const 2)) (i32.const 6))
+(assert_return (invoke "f22" (i32.const 7)) (i32.const 13))
+(assert_return (invoke "f23" (i32.const 0)) (i32.const 0))
+(assert_return (invoke "f23" (i32.const 1)) (i32.const 2))
+(assert_return (invoke "f23" (i32.const 2)) (i32.const 4))
+(assert_return (invoke "f23" (i32.const 7)) (i32.const 14))
+(assert_return (invoke "fac" (i64.const 20)) (i64.const 2432902008176640000))
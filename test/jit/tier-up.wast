@@ -0,0 +1,54 @@
+(module
+  (tag $tag (param i32))
+
+  (func $add (param i32 i32) (result i32)
+    (i32.add (local.get 0) (local.get 1))
+  )
+
+  (func $check (param i32) (result i32)
+    (if (i32.eq (i32.and (local.get 0) (i32.const 1023)) (i32.const 1023))
+      (then (throw $tag (local.get 0)))
+    )
+    (local.get 0)
+  )
+
+  (func $body (param i32) (result i32)
+    (try (result i32)
+      (do (call $check (local.get 0)))
+      (catch $tag (i32.const 0))
+    )
+  )
+
+  (func (export "sum") (param i32) (result i32)
+    (local i32)
+    (loop $loop
+      (local.set 1 (call $add (local.get 1) (call $body (local.get 0))))
+      (local.set 0 (i32.sub (local.get 0) (i32.const 1)))
+      (br_if $loop (local.get 0))
+    )
+    (local.get 1)
+  )
+
+  (func (export "div") (param i32 i32) (result i32)
+    (i32.div_s (local.get 0) (local.get 1))
+  )
+
+  (func (export "loop_div") (param i32) (result i32)
+    (local i32)
+    (loop $loop
+      (local.set 1 (i32.add (local.get 1) (i32.div_u (i32.const 100000) (local.get 0))))
+      (local.set 0 (i32.sub (local.get 0) (i32.const 1)))
+      (br_if $loop (i32.ge_s (local.get 0) (i32.const 0)))
+    )
+    (local.get 1)
+  )
+)
+
+(assert_return (invoke "sum" (i32.const 10)) (i32.const 55))
+(assert_return (invoke "sum" (i32.const 5000)) (i32.const 12492264))
+(assert_return (invoke "sum" (i32.const 5000)) (i32.const 12492264))
+(assert_return (invoke "sum" (i32.const 100)) (i32.const 5050))
+(assert_trap (invoke "loop_div" (i32.const 3000)) "integer divide by zero")
+(assert_trap (invoke "loop_div" (i32.const 3000)) "integer divide by zero")
+(assert_return (invoke "div" (i32.const 7) (i32.const 2)) (i32.const 3))
+(assert_trap (invoke "div" (i32.const 1) (i32.const 0)) "integer divide by zero")
@@ -0,0 +1,59 @@
+(module $Mem
+  (memory (export "memory") 1 1 shared)
+)
+(register "env" $Mem)
+
+(module
+  (import "env" "memory" (memory 1 1 shared))
+  (import "wasi" "thread-spawn" (func $thread_spawn (param i32) (result i32)))
+
+  (func (export "wasi_thread_start") (param $tid i32) (param $arg i32)
+    (drop (i32.atomic.rmw.add (local.get $arg) (i32.const 1)))
+    (drop (memory.atomic.notify (local.get $arg) (i32.const 1)))
+  )
+
+  ;; Spawns count threads, and waits until all of them increased the counter at addr.
+  (func (export "run") (param $addr i32) (param $count i32) (result i32)
+    (local $i i32)
+    (local $value i32)
+    (loop $spawn
+      (if (i32.le_s (call $thread_spawn (local.get $addr)) (i32.const 0))
+        (then (return (i32.const -1)))
+      )
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (br_if $spawn (i32.lt_u (local.get $i) (local.get $count)))
+    )
+    (block $done
+      (loop $wait
+        (local.set $value (i32.atomic.load (local.get $addr)))
+        (br_if $done (i32.eq (local.get $value) (local.get $count)))
+        (drop (memory.atomic.wait32 (local.get $addr) (local.get $value) (i64.const -1)))
+        (br $wait)
+      )
+    )
+    (local.get $value)
+  )
+
+  ;; Thread ids are positive.
+  (func (export "spawn") (param $addr i32) (result i32)
+    (i32.gt_s (call $thread_spawn (local.get $addr)) (i32.const 0))
+  )
+)
+
+(assert_return (invoke "run" (i32.const 0) (i32.const 1)) (i32.const 1))
+(assert_return (invoke "run" (i32.const 16) (i32.const 8)) (i32.const 8))
+(assert_return (invoke "spawn" (i32.const 32)) (i32.const 1))
+
+;; The memory must be imported, otherwise it is not shared with the new thread.
+(module
+  (import "wasi" "thread-spawn" (func $thread_spawn (param i32) (result i32)))
+  (memory 1 1 shared)
+
+  (func (export "wasi_thread_start") (param $tid i32) (param $arg i32))
+
+  (func (export "spawn") (result i32)
+    (i32.lt_s (call $thread_spawn (i32.const 0)) (i32.const 0))
+  )
+)
+
+(assert_return (invoke "spawn") (i32.const 1))
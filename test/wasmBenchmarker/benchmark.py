@@ -44,9 +44,11 @@ expectedValues = {
     "mandelbrotFloat": 775014,
     "mandelbrotDouble": 775014,
     "matrixMultiply": 3920.0,
+    "memoryGrow": 32768,
     "miniWalrus": 27449,
     "nbody": -0.16904405,
     "nqueens": 246,
+    "parallelMatrixMultiply": 3920.0,
     "prime": 70657,
     "quickSort": 0,
     "redBlack": 13354000,
@@ -69,6 +71,9 @@ simdTests = [
     "simdMatrixMultiply",
 ]
 
+# Compiled with wasi-sdk, since they use wasi-threads
+threadTests = ["parallelMatrixMultiply"]
+
 errorList = []
 
 
@@ -142,7 +147,7 @@ def parse_args():
                       action="store_true", default=False)
   parser.add_argument(
       "--results",
-      choices=["i", "j", "n", "j2i", "i2j", "n2j", "j2n", "n2i", "i2n"],
+      choices=["i", "j", "n", "e", "j2i", "i2j", "n2j", "j2n", "n2i", "i2n", "e2j"],
       help="Type of results to show, seperated by spaces, default: i j n",
       nargs="*",
       default=["i", "j", "n"],
@@ -153,6 +158,13 @@ def parse_args():
       type=int,
       default=-2,
   )
+  parser.add_argument(
+      "--epoch-timeout",
+      metavar="MS",
+      help="epoch timeout of the JIT_EPOCH (e) runs, long enough to never trap, default: 3600000",
+      default=3600000,
+      type=int,
+  )
   parser.add_argument("--summary", help="Generate summary",
                       action="store_true", default=False)
   parser.add_argument("--arch",
@@ -186,6 +198,12 @@ def parse_args():
       "j2n" in args.results) in args.results and "n" not in args.results:
     args.results.append("n")
 
+  if "e2j" in args.results and "j" not in args.results:
+    args.results.append("j")
+
+  if "e2j" in args.results and "e" not in args.results:
+    args.results.append("e")
+
   if args.no_time and not args.mem:
     raise Exception("You couldn't use --no-time without --mem")
 
@@ -282,6 +300,12 @@ def compile_tests(emcc_path, path, only_game, only_simd, compile_anyway, run,
         (run is not None and name != run)):
       continue
 
+    wasi_sdk_path = os.getenv("WASI_SDK_PATH")
+    if name in threadTests and wasi_sdk_path is None:
+      if verbose:
+        print(f"WASI_SDK_PATH is not set; {name} skipped")
+      continue
+
     test_names.append(name)
 
     if not compile_anyway and os.path.exists(f"{path}/wasm/{name}.wasm"):
@@ -289,7 +313,20 @@ def compile_tests(emcc_path, path, only_game, only_simd, compile_anyway, run,
         print(f"{name}.wasm is found; compilation skipped")
       continue
 
+    if name in threadTests:
+      command = (f"{wasi_sdk_path}/bin/clang --target=wasm32-wasip1-threads"
+                 " -pthread -O2"
+                 " -Wl,--import-memory,--export-memory,--max-memory=67108864"
+                 f" {path}/{file} -o {path}/wasm/{name}.wasm")
+      if verbose:
+        print(f"compiling {name}")
+        print(command)
+      os.system(command)
+      continue
+
     flags = "-msimd128" if file.startswith("simd") else ""
+    if name == "memoryGrow":
+      flags += " -s ALLOW_MEMORY_GROWTH=1 -s MAXIMUM_MEMORY=4GB"
     flags += (" -s WASM=1 -s EXPORTED_FUNCTIONS=_runtime"
               " -s EXPORTED_RUNTIME_METHODS=ccall,cwrap"
               " -O2"
@@ -304,14 +341,20 @@ def compile_tests(emcc_path, path, only_game, only_simd, compile_anyway, run,
   return test_names
 
 
-def run_wasm(engine, path, test_name, jit, jit_no_reg_alloc):
+def engine_flags(engine, jit, jit_no_reg_alloc, epoch_timeout):
+  flags = " --jit" if ((jit or jit_no_reg_alloc) and
+                       "walrus" in engine) else ""
+  flags += " --jit-no-reg-alloc" if jit_no_reg_alloc else ""
+  flags += f" --epoch-timeout {epoch_timeout}" if epoch_timeout else ""
+  return flags
+
+
+def run_wasm(engine, path, test_name, jit, jit_no_reg_alloc, epoch_timeout):
   if not os.path.exists(path):
     raise Exception(f"Invalid path for run: {path}")
 
   tc_path = f"{path}/wasm/{test_name}.wasm"
-  flags = " --jit" if ((jit or jit_no_reg_alloc) and
-                       "walrus" in engine) else ""
-  flags += " --jit-no-reg-alloc" if jit_no_reg_alloc else ""
+  flags = engine_flags(engine, jit, jit_no_reg_alloc, epoch_timeout)
 
   result = subprocess.check_output(f"{engine} {flags} {tc_path}", shell=True)
 
@@ -323,22 +366,21 @@ def run_wasm(engine, path, test_name, jit, jit_no_reg_alloc):
     raise Exception(message)
 
 
-def measure_time(path, name, function, engine, jit, jit_no_reg_alloc):
+def measure_time(path, name, function, engine, jit, jit_no_reg_alloc,
+                 epoch_timeout):
   start_time = time.perf_counter_ns()
-  function(engine, path, name, jit, jit_no_reg_alloc)
+  function(engine, path, name, jit, jit_no_reg_alloc, epoch_timeout)
   end_time = time.perf_counter_ns()
   return end_time - start_time
 
 
-def measure_memory(path, name, engine, jit, jit_no_reg_alloc):
+def measure_memory(path, name, engine, jit, jit_no_reg_alloc, epoch_timeout):
   if not os.path.exists(path):
     raise Exception(f"Invalid path for run: {path}")
 
   mem_tool = "/usr/bin/time -f %M"
   tc_path = f"{path}/wasm/{name}.wasm"
-  flags = " --jit" if ((jit or jit_no_reg_alloc) and
-                       "walrus" in engine) else ""
-  flags += " --jit-no-reg-alloc" if jit_no_reg_alloc else ""
+  flags = engine_flags(engine, jit, jit_no_reg_alloc, epoch_timeout)
   run_cmd = f"{mem_tool} {engine} {flags} {tc_path}"
 
   outputs = subprocess.check_output(run_cmd, shell=True,
@@ -359,6 +401,8 @@ def run_tests(
     jit,
     jit_no_reg_alloc,
     interpreter,
+    jit_epoch,
+    epoch_timeout,
     verbose,
 ):
   ret_time_val = list()
@@ -372,6 +416,7 @@ def run_tests(
           "path": engine,
           "jit": False,
           "jit_no_reg_alloc": False,
+          "epoch_timeout": 0,
       })
 
     if jit:
@@ -380,6 +425,7 @@ def run_tests(
           "path": engine,
           "jit": True,
           "jit_no_reg_alloc": False,
+          "epoch_timeout": 0,
       })
 
     if jit_no_reg_alloc:
@@ -388,6 +434,17 @@ def run_tests(
           "path": engine,
           "jit": True,
           "jit_no_reg_alloc": True,
+          "epoch_timeout": 0,
+      })
+
+    # Measures the cost of the epoch checks of the JIT.
+    if jit_epoch and "walrus" in engine:
+      _engines.append({
+          "name": f"{engine_display_name(engine)} JIT_EPOCH",
+          "path": engine,
+          "jit": True,
+          "jit_no_reg_alloc": False,
+          "epoch_timeout": epoch_timeout,
       })
 
   for name in test_names:
@@ -421,6 +478,7 @@ def run_tests(
                     engine["path"],
                     engine["jit"],
                     engine["jit_no_reg_alloc"],
+                    engine["epoch_timeout"],
                 ))
           if mem:
             mem_results[engine["name"]].append(
@@ -430,6 +488,7 @@ def run_tests(
                     engine["path"],
                     engine["jit"],
                     engine["jit_no_reg_alloc"],
+                    engine["epoch_timeout"],
                 ))
         except Exception as e:
           errorList.append(f"{name} {engine['name']} {e}")
@@ -545,10 +604,12 @@ def compare(
     interpreter_to_jit,
     interpreter_to_jit_no_reg_alloc,
     jit_to_jit_no_reg_alloc,
+    jit_epoch_to_jit=False,
 ):
   if (not jit_to_interpreter and not jit_no_reg_alloc_to_interpreter and
       not jit_no_reg_alloc_to_jit and not interpreter_to_jit and
-      not interpreter_to_jit_no_reg_alloc and not jit_to_jit_no_reg_alloc):
+      not interpreter_to_jit_no_reg_alloc and not jit_to_jit_no_reg_alloc and
+      not jit_epoch_to_jit):
     return
   for i in range(len(data)):
     test = data[i]["test"]
@@ -597,6 +658,13 @@ def compare(
             f"{jit} ({'{:.2f}'.format(-1 if float(jit) < 0 or float(jit_no_reg_alloc) < 0 else float(jit_no_reg_alloc) / float(jit))}x)"
         )
 
+      if jit_epoch_to_jit and "walrus" in engine:
+        jit = data[i][f"{engine_display_name(engine)} JIT"]
+        jit_epoch = data[i][f"{engine_display_name(engine)} JIT_EPOCH"]
+        data[i][f"{engine_display_name(engine)} JIT_EPOCH/JIT"] = (
+            f"{jit} ({'{:.2f}'.format(-1 if float(jit) < 0 or float(jit_epoch) < 0 else float(jit_epoch) / float(jit))}x)"
+        )
+
 
 def orderData(data, engines, orig_results):
   orderedData = list()
@@ -615,6 +683,16 @@ def orderData(data, engines, orig_results):
           record[engine_display_name(engine) +
                  " JIT_NO_REG_ALLOC"] = test[engine_display_name(engine) +
                                              " JIT_NO_REG_ALLOC"]
+        elif result == "e":
+          if "walrus" in engine:
+            record[engine_display_name(engine) +
+                   " JIT_EPOCH"] = test[engine_display_name(engine) +
+                                        " JIT_EPOCH"]
+        elif result == "e2j":
+          if "walrus" in engine:
+            record[engine_display_name(engine) +
+                   " JIT_EPOCH/JIT"] = test[engine_display_name(engine) +
+                                            " JIT_EPOCH/JIT"]
         elif result == "j2i":
           record[engine_display_name(engine) +
                  " INTERPRETER/JIT"] = test[engine_display_name(engine) +
@@ -720,6 +798,8 @@ def main():
       "j" in args.results,
       "n" in args.results,
       "i" in args.results,
+      "e" in args.results,
+      args.epoch_timeout,
       args.verbose,
   )
   if not args.no_time:
@@ -732,6 +812,7 @@ def main():
         "i2j" in args.results,
         "i2n" in args.results,
         "j2n" in args.results,
+        "e2j" in args.results,
     )
     result_data["time"] = orderData(result_data["time"], args.engines,
                                     args.orig_results)
@@ -748,6 +829,7 @@ def main():
         "i2j" in args.results,
         "i2n" in args.results,
         "j2n" in args.results,
+        "e2j" in args.results,
     )
     result_data["mem"] = orderData(result_data["mem"], args.engines,
                                    args.orig_results)
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026-present Samsung Electronics Co., Ltd
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define PAGE_SIZE 65536
+#define TARGET_PAGES 32768 // 2GiB
+
+/*
+ * Grows the memory page by page up to 2GiB. A value is
+ * written into every new page, so the pages must be
+ * preserved (or copied) by each grow operation.
+ */
+uint64_t runtime() {
+    size_t initialPages = __builtin_wasm_memory_size(0);
+    uint64_t errors = 0;
+
+    while (__builtin_wasm_memory_size(0) < TARGET_PAGES) {
+        size_t page = __builtin_wasm_memory_grow(0, 1);
+
+        if (page == (size_t)-1) {
+            break;
+        }
+
+        volatile uint32_t* address = (volatile uint32_t*)(page * PAGE_SIZE);
+        *address = (uint32_t)page;
+    }
+
+    for (size_t page = initialPages; page < TARGET_PAGES; page++) {
+        errors += *(volatile uint32_t*)(page * PAGE_SIZE) != page;
+    }
+
+    return __builtin_wasm_memory_size(0) + errors;
+}
+
+int main() {
+    printf("%llu\n", (long long unsigned int) runtime());
+    return 0;
+}
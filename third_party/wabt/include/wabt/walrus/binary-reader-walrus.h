@@ -104,6 +104,8 @@ public:
     virtual void OnTagType(Index index, Index sigIndex) = 0;
 
     virtual void OnStartFunction(Index funcIndex) = 0;
+    // Only called when the readFunctionNames feature flag is set.
+    virtual void OnFunctionName(Index funcIndex, std::string name) { }
 
     virtual void BeginFunctionBody(Index index, Offset size) = 0;
 
@@ -114,7 +116,8 @@ public:
     virtual void OnStartPreprocess() = 0;
     virtual void OnEndPreprocess() = 0;
 
-    virtual void OnOpcode(uint32_t opcode) = 0;
+    // The offset is the position of the first byte of the instruction.
+    virtual void OnOpcode(uint32_t opcode, size_t offset) = 0;
 
     virtual void OnCallExpr(Index index) = 0;
     virtual void OnCallIndirectExpr(Index sigIndex, Index tableIndex) = 0;
@@ -396,6 +399,10 @@ protected:
 
 enum FeatureFlagValue : uint32_t {
     enableWebAssembly3 = 1 << 0,
+    // Function names of the name section are passed to OnFunctionName.
+    readFunctionNames = 1 << 1,
+    // The wasm code offsets of the byte code are recorded for profiling.
+    recordCodeOffsets = 1 << 2,
 };
 
 std::string ReadWasmBinary(const std::string& filename, const uint8_t *data, size_t size, WASMBinaryReaderDelegate* delegate, const uint32_t featureFlags);
@@ -479,7 +479,8 @@ public:
     Result OnOpcode(Opcode opcode) override {
         SHOULD_GENERATE_BYTECODE;
         Opcode::Enum e = opcode;
-        m_externalDelegate->OnOpcode(e);
+        Offset length = opcode.HasPrefix() ? 1 + U32Leb128Length(opcode.GetCode()) : 1;
+        m_externalDelegate->OnOpcode(e, state->offset - length);
         return Result::Ok;
     }
     Result OnOpcodeBare() override {
@@ -1193,60 +1194,47 @@ public:
 
     /* Names section */
     Result BeginNamesSection(Offset size) override {
-        abort();
         return Result::Ok;
     }
     Result OnModuleNameSubsection(Index index, uint32_t name_type, Offset subsection_size) override {
-        abort();
         return Result::Ok;
     }
     Result OnModuleName(nonstd::string_view name) override {
-        abort();
         return Result::Ok;
     }
     Result OnFunctionNameSubsection(Index index, uint32_t name_type, Offset subsection_size) override {
-        abort();
         return Result::Ok;
     }
     Result OnFunctionNamesCount(Index num_functions) override {
-        abort();
         return Result::Ok;
     }
     Result OnFunctionName(Index function_index, nonstd::string_view function_name) override {
-        abort();
+        m_externalDelegate->OnFunctionName(function_index, std::string(function_name));
         return Result::Ok;
     }
     Result OnLocalNameSubsection(Index index, uint32_t name_type, Offset subsection_size) override {
-        abort();
         return Result::Ok;
     }
     Result OnLocalNameFunctionCount(Index num_functions) override {
-        abort();
         return Result::Ok;
     }
     Result OnLocalNameLocalCount(Index function_index, Index num_locals) override {
-        abort();
         return Result::Ok;
     }
     Result OnLocalName(Index function_index, Index local_index, nonstd::string_view local_name) override {
-        abort();
         return Result::Ok;
     }
     Result EndNamesSection() override {
-        abort();
         return Result::Ok;
     }
 
     Result OnNameSubsection(Index index, NameSectionSubsection subsection_type, Offset subsection_size) override {
-        abort();
         return Result::Ok;
     }
     Result OnNameCount(Index num_names) override {
-        abort();
         return Result::Ok;
     }
     Result OnNameEntry(NameSectionSubsection type, Index index, nonstd::string_view name) override {
-        abort();
         return Result::Ok;
     }
 
@@ -1603,10 +1591,11 @@ public:
 };
 
 std::string ReadWasmBinary(const std::string &filename, const uint8_t *data, size_t size, WASMBinaryReaderDelegate *delegate, const uint32_t featureFlags) {
-    const bool kReadDebugNames = false;
+    const bool readDebugNames = (featureFlags & FeatureFlagValue::readFunctionNames) != 0;
     const bool kStopOnFirstError = true;
-    const bool kFailOnCustomSectionError = true;
-    ReadBinaryOptions options(getFeatures(featureFlags), nullptr, kReadDebugNames, kStopOnFirstError, kFailOnCustomSectionError);
+    // A malformed name section must not prevent running the module.
+    const bool failOnCustomSectionError = !readDebugNames;
+    ReadBinaryOptions options(getFeatures(featureFlags), nullptr, readDebugNames, kStopOnFirstError, failOnCustomSectionError);
     BinaryReaderDelegateWalrus binaryReaderDelegateWalrus(delegate, filename, featureFlags);
     Result result = ReadBinary(ByteSpan(data, size), &binaryReaderDelegateWalrus, options);
 
@@ -48,6 +48,12 @@ DEFAULT_RUNNERS = []
 JIT_EXCLUDE_FILES = []
 jit = False
 jit_no_reg_alloc = False
+jit_tiered = False
+memory_guard_pages = False
+jit_threads = None
+jit_opt_level = None
+jit_tier_up_threshold = None
+cache_dir = None
 web_assembly3 = False
 
 
@@ -66,13 +72,19 @@ class runner(object):
 def _run_wast_tests(engine, files, is_fail, args=None):
     fails = 0
     for file in files:
-        if jit or jit_no_reg_alloc:
+        if jit or jit_no_reg_alloc or jit_tiered:
             filename = os.path.basename(file)
             if filename in JIT_EXCLUDE_FILES:
                 continue
         subprocess_args =  qemu + [engine, "--mapdirs", "./test/wasi", "/var"]
-        if jit or jit_no_reg_alloc: subprocess_args.append("--jit")
+        if jit_tiered: subprocess_args.append("--jit-tiered")
+        elif jit or jit_no_reg_alloc: subprocess_args.append("--jit")
         if jit_no_reg_alloc: subprocess_args.append("--jit-no-reg-alloc")
+        if memory_guard_pages: subprocess_args.append("--memory-guard-pages")
+        if jit_threads: subprocess_args.extend(["--jit-threads", str(jit_threads)])
+        if jit_opt_level is not None: subprocess_args.extend(["--jit-opt-level", str(jit_opt_level)])
+        if jit_tier_up_threshold: subprocess_args.extend(["--jit-tier-up-threshold", str(jit_tier_up_threshold)])
+        if cache_dir: subprocess_args.extend(["--cache-dir", cache_dir])
         if web_assembly3: subprocess_args.append("--enable-web-assembly3")
         if args: subprocess_args.append("--args")
         subprocess_args.append(file)
@@ -223,6 +235,12 @@ def main():
                         help='test suite to run (%s; default: %s)' % (', '.join(sorted(RUNNERS.keys())), ' '.join(sorted(DEFAULT_RUNNERS))))
     parser.add_argument('--jit', action='store_true', help='test with JIT')
     parser.add_argument('--jit-no-reg-alloc', action='store_true', help='test with JIT without register allocation')
+    parser.add_argument('--jit-tiered', action='store_true', help='test with tiered JIT compilation')
+    parser.add_argument('--memory-guard-pages', action='store_true', help='test with guard pages instead of memory bounds checks')
+    parser.add_argument('--jit-threads', metavar='N', type=int, default=None, help='compile the functions of a module on N threads')
+    parser.add_argument('--jit-opt-level', metavar='N', type=int, default=None, help='optimization level of the JIT compiler')
+    parser.add_argument('--jit-tier-up-threshold', metavar='N', type=int, default=None, help='compile the functions of --jit-tiered after N calls and loop iterations')
+    parser.add_argument('--cache-dir', metavar='PATH', default=None, help='load and store the parsed modules in PATH')
     args = parser.parse_args()
     global jit
     jit = args.jit
@@ -230,13 +248,31 @@ def main():
     global jit_no_reg_alloc
     jit_no_reg_alloc = args.jit_no_reg_alloc
 
+    global jit_tiered
+    jit_tiered = args.jit_tiered
+
+    global memory_guard_pages
+    memory_guard_pages = args.memory_guard_pages
+
+    global jit_threads
+    jit_threads = args.jit_threads
+
+    global jit_opt_level
+    jit_opt_level = args.jit_opt_level
+
+    global jit_tier_up_threshold
+    jit_tier_up_threshold = args.jit_tier_up_threshold
+
+    global cache_dir
+    cache_dir = args.cache_dir
+
     global qemu
     qemu = [args.qemu] if args.qemu else []
 
     if jit and jit_no_reg_alloc:
         parser.error('jit and jit-no-reg-alloc cannot be used together')
 
-    if jit or jit_no_reg_alloc:
+    if jit or jit_no_reg_alloc or jit_tiered:
         exclude_list_file = join(PROJECT_SOURCE_DIR, 'tools', 'jit_exclude_list.txt')
         with open(exclude_list_file) as f:
             global JIT_EXCLUDE_FILES
@@ -255,6 +291,8 @@ def main():
             text = " with jit"
         elif jit_no_reg_alloc:
             text = " with jit without register allocation"
+        elif jit_tiered:
+            text = " with tiered jit"
         print(COLOR_PURPLE + f'running test suite{text}: ' + suite + COLOR_RESET)
         try:
             RUNNERS[suite](args.engine)